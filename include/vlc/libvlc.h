@@ -559,6 +559,41 @@ static inline int64_t libvlc_delay(int64_t pts)
 
 /** @} */
 
+/** \defgroup libvlc_memory LibVLC memory usage
+ * These functions report the memory held by the buffers of LibVLC.
+ * @{
+ */
+
+/**
+ * Subsystems whose buffers are accounted.
+ */
+typedef enum libvlc_memory_usage_t
+{
+    libvlc_memory_decoder = 0,  /**< demuxed data waiting to be decoded */
+    libvlc_memory_picture,      /**< picture buffers */
+    libvlc_memory_timeshift,    /**< timeshift commands kept in memory */
+    libvlc_memory_stream,       /**< stream caches and read-ahead buffers */
+    libvlc_memory_adaptive,     /**< adaptive streaming (DASH, HLS...) data */
+} libvlc_memory_usage_t;
+
+/**
+ * Get the memory held by the buffers of a subsystem.
+ *
+ * The usage is accounted for the whole process, all LibVLC instances and
+ * media players included.
+ *
+ * \param type the subsystem
+ * \param current where to store the number of bytes currently held [OUT]
+ * \param peak where to store the highest number of bytes held so far [OUT]
+ * \return 0 on success, -1 if the subsystem is unknown
+ * \version LibVLC 4.0.0 and later.
+ */
+LIBVLC_API
+int libvlc_memory_usage_get( libvlc_memory_usage_t type,
+                             size_t *current, size_t *peak );
+
+/** @} */
+
 # ifdef __cplusplus
 }
 # endif
@@ -416,6 +416,9 @@ typedef unsigned (*libvlc_video_format_cb)(void **opaque, char *chroma,
  *
  * \param opaque private pointer as passed to libvlc_video_set_format_callbacks()
  *               (and possibly modified by @ref libvlc_video_format_cb) [IN]
+ *
+ * \note With libvlc_video_set_direct_rendering(), this callback may be
+ * invoked late, see there.
  */
 typedef void (*libvlc_video_cleanup_cb)(void *opaque);
 
@@ -499,6 +502,41 @@ void libvlc_video_set_format_callbacks( libvlc_media_player_t *mp,
                                         libvlc_video_format_cb setup,
                                         libvlc_video_cleanup_cb cleanup );
 
+/**
+ * Let the video decoder render directly into the application buffers,
+ * instead of copying each picture between the lock and unlock callbacks.
+ * This only works in combination with libvlc_video_set_format_callbacks().
+ *
+ * If the format callback keeps the decoded chroma and dimensions, the lock
+ * callback is invoked right after it, once for each of the picture buffers it
+ * returned the count of. Each call must return a different buffer.
+ * The decoder then writes into those buffers, which belong to LibVLC until
+ * the cleanup callback is invoked.
+ *
+ * In that case, the cleanup callback is invoked once the last of those
+ * buffers is released, rather than when the video output stops:
+ * - it may be invoked from any LibVLC thread, typically the decoder thread,
+ *   even after the end of the playback;
+ * - when the video format changes, it may be invoked after the format
+ *   callback and lock callbacks of the next format. It always receives the
+ *   opaque pointer returned by the format callback of the same buffers.
+ *
+ * The unlock and display callbacks are invoked with the buffer that holds the
+ * picture. The displayed buffer is not modified until the next display
+ * callback.
+ *
+ * If the pictures cannot be decoded directly into those buffers (the decoder
+ * needs more buffers, video filters or subpictures are used...), they are
+ * copied as usual, into another buffer returned by the lock callback.
+ *
+ * \param mp the media player
+ * \param enable true to render directly into the application buffers
+ * \version LibVLC 4.0.0 or later
+ */
+LIBVLC_API
+void libvlc_video_set_direct_rendering( libvlc_media_player_t *mp,
+                                        bool enable );
+
 
 typedef struct libvlc_video_setup_device_cfg_t
 {
@@ -1877,6 +1915,70 @@ LIBVLC_API
 void libvlc_chapter_descriptions_release( libvlc_chapter_description_t **p_chapters,
                                           unsigned i_count );
 
+/** Number of buckets of a latency histogram */
+#define LIBVLC_LATENCY_BUCKETS 24
+
+/**
+ * Latency histogram
+ *
+ * Bucket N counts the samples in the [2^N, 2^(N+1)[ microseconds range. The
+ * first bucket also counts lower values, and the last one higher values.
+ */
+typedef struct libvlc_latency_histogram_t
+{
+    uint64_t i_count; /**< number of samples */
+    int64_t i_total; /**< sum of all samples (in microseconds) */
+    int64_t i_max; /**< highest sample (in microseconds) */
+    uint64_t pi_buckets[LIBVLC_LATENCY_BUCKETS];
+} libvlc_latency_histogram_t;
+
+/**
+ * Latency statistics of a track
+ */
+typedef struct libvlc_track_latency_t
+{
+    int i_id; /**< track identifier, as libvlc_media_track_t::i_id */
+    libvlc_track_type_t i_type;
+    unsigned i_fifo_depth; /**< current number of blocks waiting to be decoded */
+    unsigned i_fifo_depth_max; /**< highest number of blocks waiting */
+
+    libvlc_latency_histogram_t fifo_wait; /**< wait in the decoder FIFO */
+    libvlc_latency_histogram_t decode; /**< decoding, per input block */
+    libvlc_latency_histogram_t filter; /**< video or audio filtering */
+    libvlc_latency_histogram_t display_slack; /**< video time left before
+                                                   the display deadline */
+    libvlc_latency_histogram_t output; /**< audio output latency */
+} libvlc_track_latency_t;
+
+/**
+ * Get the latency statistics of the tracks being decoded
+ *
+ * The statistics are only collected if the "stats" option is enabled (this is
+ * the default).
+ *
+ * \version LibVLC 4.0.0 and later.
+ *
+ * \param p_mi the media player
+ * \param pp_latencies address to store an allocated array of track latency
+ *        statistics (must be freed with libvlc_track_latencies_release()
+ *        by the caller) [OUT]
+ *
+ * \return the number of tracks (-1 on error)
+ */
+LIBVLC_API int
+libvlc_media_player_get_latency_stats( libvlc_media_player_t *p_mi,
+                                       libvlc_track_latency_t **pp_latencies );
+
+/**
+ * Release track latency statistics
+ *
+ * \version LibVLC 4.0.0 and later.
+ *
+ * \param p_latencies array returned by libvlc_media_player_get_latency_stats()
+ */
+LIBVLC_API
+void libvlc_track_latencies_release( libvlc_track_latency_t *p_latencies );
+
 /**
  * Set/unset the video crop ratio.
  *
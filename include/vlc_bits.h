@@ -298,6 +298,224 @@ static inline int_fast32_t bs_read_se( bs_t *s )
                         : -(int_fast32_t)(val / 2);
 }
 
+/**
+ * \defgroup bits_fast Fast bitstream reader
+ *
+ * Unlike bs_t, this reader keeps up to 64 bits in a cache word, and only
+ * accesses memory to refill it. There are no byte forwarding callbacks:
+ * emulation prevention bytes (the 0x03 byte in 0x00 0x00 0x03 sequences of
+ * H.264, HEVC or VC-1 payloads) can be stripped while refilling instead.
+ * Words without any zero byte are then loaded at once, and only the others
+ * are inspected byte per byte.
+ *
+ * Reads are limited to 32 bits. Reading past the end returns zero bits and
+ * sets the error flag.
+ * @{
+ */
+typedef struct
+{
+    const uint8_t *p;       /* next byte to load in the cache */
+    const uint8_t *p_end;
+    uint64_t i_cache;       /* unread bits, most significant first */
+    unsigned i_cached;      /* number of unread bits in i_cache */
+    unsigned i_zeros;       /* number of trailing zero bytes loaded */
+    size_t   i_loaded;      /* number of bytes loaded, excluding escapes */
+    bool     b_ep3b;
+    bool     b_error;
+} bs_fast_t;
+
+static inline void bs_fast_init( bs_fast_t *s, const void *p_data,
+                                 size_t i_data )
+{
+    s->p = (const uint8_t *)p_data;
+    s->p_end = s->p + i_data;
+    s->i_cache = 0;
+    s->i_cached = 0;
+    s->i_zeros = 0;
+    s->i_loaded = 0;
+    s->b_ep3b = false;
+    s->b_error = false;
+}
+
+/* Same as bs_fast_init(), but strips emulation prevention bytes */
+static inline void bs_fast_init_ep3b( bs_fast_t *s, const void *p_data,
+                                      size_t i_data )
+{
+    bs_fast_init( s, p_data, i_data );
+    s->b_ep3b = true;
+}
+
+static inline void bs_fast_refill_bytes( bs_fast_t *s )
+{
+    while( s->i_cached <= 56 && s->p < s->p_end )
+    {
+        uint8_t i_byte = *s->p++;
+
+        if( s->b_ep3b )
+        {
+            /* never escape the last byte */
+            if( i_byte == 0x03 && s->i_zeros >= 2 && s->p < s->p_end )
+            {
+                s->i_zeros = 0;
+                continue;
+            }
+            s->i_zeros = i_byte ? 0 : s->i_zeros + 1;
+        }
+
+        s->i_cache |= (uint64_t) i_byte << (56 - s->i_cached);
+        s->i_cached += 8;
+        s->i_loaded++;
+    }
+}
+
+static inline void bs_fast_refill( bs_fast_t *s )
+{
+    unsigned i_bytes = (64 - s->i_cached) / 8;
+
+    if( i_bytes == 0 )
+        return;
+
+    if( s->p_end - s->p < 8 )
+    {
+        bs_fast_refill_bytes( s );
+        return;
+    }
+
+    uint64_t i_word = GetQWBE( s->p );
+
+    if( s->b_ep3b )
+    {
+        /* Flag the zero bytes among the ones to load (false positives only
+         * occur next to actual zero bytes) */
+        uint64_t i_zeros = (i_word - UINT64_C(0x0101010101010101)) & ~i_word
+                         & UINT64_C(0x8080808080808080);
+        i_zeros &= UINT64_MAX << (64 - 8 * i_bytes);
+        if( i_zeros != 0 || s->i_zeros >= 2 )
+        {
+            bs_fast_refill_bytes( s );
+            return;
+        }
+        s->i_zeros = 0;
+    }
+
+    i_word >>= 64 - 8 * i_bytes;
+    s->i_cache |= i_word << (64 - 8 * i_bytes - s->i_cached);
+    s->i_cached += 8 * i_bytes;
+    s->i_loaded += i_bytes;
+    s->p += i_bytes;
+}
+
+static inline void bs_fast_consume( bs_fast_t *s, unsigned i_count )
+{
+    if( i_count < 64 )
+        s->i_cache <<= i_count;
+    else
+        s->i_cache = 0;
+    s->i_cached -= i_count;
+}
+
+static inline bool bs_fast_error( const bs_fast_t *s )
+{
+    return s->b_error;
+}
+
+static inline bool bs_fast_eof( bs_fast_t *s )
+{
+    if( s->i_cached == 0 )
+        bs_fast_refill( s );
+    return s->i_cached == 0;
+}
+
+static inline size_t bs_fast_pos( const bs_fast_t *s )
+{
+    return 8 * s->i_loaded - s->i_cached;
+}
+
+static inline bool bs_fast_aligned( const bs_fast_t *s )
+{
+    return s->i_cached % 8 == 0;
+}
+
+static inline void bs_fast_align( bs_fast_t *s )
+{
+    bs_fast_consume( s, s->i_cached % 8 );
+}
+
+static inline void bs_fast_skip( bs_fast_t *s, size_t i_count )
+{
+    while( i_count > s->i_cached )
+    {
+        i_count -= s->i_cached;
+        s->i_cache = 0;
+        s->i_cached = 0;
+
+        bs_fast_refill( s );
+        if( s->i_cached == 0 )
+        {
+            s->b_error = true;
+            return;
+        }
+    }
+    bs_fast_consume( s, i_count );
+}
+
+static inline uint32_t bs_fast_read( bs_fast_t *s, unsigned i_count )
+{
+    if( s->i_cached < i_count )
+        bs_fast_refill( s );
+
+    if( i_count == 0 )
+        return 0;
+
+    uint32_t i_result = s->i_cache >> (64 - i_count);
+
+    if( unlikely(s->i_cached < i_count) )
+    {
+        /* truncated read */
+        s->b_error = true;
+        bs_fast_consume( s, s->i_cached );
+    }
+    else
+        bs_fast_consume( s, i_count );
+
+    return i_result;
+}
+
+static inline uint32_t bs_fast_read1( bs_fast_t *s )
+{
+    return bs_fast_read( s, 1 );
+}
+
+/* Read unsigned Exp-Golomb code */
+static inline uint_fast32_t bs_fast_read_ue( bs_fast_t *s )
+{
+    if( s->i_cached < 32 )
+        bs_fast_refill( s );
+
+    /* the cache holds at least 57 bits unless the end is reached */
+    unsigned i = s->i_cache ? vlc_clzll( s->i_cache ) : 64;
+    if( unlikely(i >= s->i_cached || i > 31) )
+    {
+        s->b_error = true;
+        bs_fast_consume( s, s->i_cached );
+        return 0;
+    }
+
+    bs_fast_consume( s, i + 1 );
+    return (UINT32_C(1) << i) - 1 + bs_fast_read( s, i );
+}
+
+/* Read signed Exp-Golomb code */
+static inline int_fast32_t bs_fast_read_se( bs_fast_t *s )
+{
+    uint_fast32_t val = bs_fast_read_ue( s );
+
+    return (val & 0x01) ? (int_fast32_t)((val + 1) / 2)
+                        : -(int_fast32_t)(val / 2);
+}
+
+/** @} */
+
 #undef bs_forward
 
 #endif
@@ -439,6 +439,7 @@ static inline block_t *block_ChainGather( block_t *p_list )
  */
 
 #include <vlc_queue.h>
+#include <vlc_memusage.h>
 
 /**
  * Creates a thread-safe FIFO queue of blocks.
@@ -626,6 +627,17 @@ VLC_API size_t vlc_fifo_GetCount(const vlc_fifo_t *) VLC_USED;
  */
 VLC_API size_t vlc_fifo_GetBytes(const vlc_fifo_t *) VLC_USED;
 
+/**
+ * Accounts the bytes queued in a FIFO to a subsystem.
+ *
+ * The bytes queued and dequeued afterwards are reported with
+ * vlc_memusage_Add() and vlc_memusage_Sub().
+ *
+ * @warning This function must be called while the FIFO is empty, typically
+ * right after block_FifoNew().
+ */
+VLC_API void vlc_fifo_SetMemUsage(vlc_fifo_t *, enum vlc_memusage_tag);
+
 VLC_USED static inline bool vlc_fifo_IsEmpty(const vlc_fifo_t *fifo)
 {
     return vlc_queue_IsEmpty(vlc_fifo_queue(fifo));
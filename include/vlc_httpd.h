@@ -106,6 +106,9 @@ typedef struct httpd_message_t
 
 typedef struct httpd_url_t      httpd_url_t;
 typedef struct httpd_callback_sys_t httpd_callback_sys_t;
+/* A callback can defer its answer by returning VLC_SUCCESS without setting
+ * answer->i_type: it is then called again with the same query until it
+ * answers, or until the client connection times out. */
 typedef int    (*httpd_callback_t)( httpd_callback_sys_t *, httpd_client_t *, httpd_message_t *answer, const httpd_message_t *query );
 /* register a new url */
 VLC_API httpd_url_t * httpd_UrlNew( httpd_host_t *, const char *psz_url, const char *psz_user, const char *psz_password ) VLC_USED;
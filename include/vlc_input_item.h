@@ -31,6 +31,7 @@
 
 #include <vlc_meta.h>
 #include <vlc_epg.h>
+#include <vlc_es.h>
 #include <vlc_events.h>
 #include <vlc_list.h>
 
@@ -531,6 +532,55 @@ struct input_stats_t
     int64_t i_lost_abuffers;
 };
 
+/**
+ * Number of buckets of a latency histogram
+ *
+ * Bucket N counts the samples in the [2^N, 2^(N+1)[ microseconds range. The
+ * first bucket also counts lower values, and the last one higher values.
+ */
+#define VLC_LATENCY_BUCKETS 24
+
+/**
+ * Latency histogram
+ */
+struct vlc_latency_histogram
+{
+    uint64_t count; /**< Number of samples */
+    vlc_tick_t total; /**< Sum of all samples */
+    vlc_tick_t max; /**< Highest sample */
+    uint64_t buckets[VLC_LATENCY_BUCKETS]; /**< log2 buckets */
+};
+
+/**
+ * Instrumented stages of the playback pipeline
+ */
+enum vlc_latency_stage
+{
+    /** Time spent by a block in the decoder FIFO */
+    VLC_LATENCY_FIFO_WAIT,
+    /** Time spent in the decoder per input block */
+    VLC_LATENCY_DECODE,
+    /** Time spent in the video filter chains or the audio filters */
+    VLC_LATENCY_FILTER,
+    /** Time left before the display deadline once a picture is prepared */
+    VLC_LATENCY_DISPLAY_SLACK,
+    /** Audio output latency, i.e. delay until a buffer is played */
+    VLC_LATENCY_OUTPUT,
+};
+#define VLC_LATENCY_STAGE_COUNT (VLC_LATENCY_OUTPUT + 1)
+
+/**
+ * Per elementary stream latency statistics
+ */
+struct vlc_es_latency
+{
+    int i_id; /**< ES identifier, as set by the demuxer */
+    enum es_format_category_e i_cat; /**< ES category */
+    size_t fifo_depth; /**< Current number of blocks in the decoder FIFO */
+    size_t fifo_depth_max; /**< Highest number of blocks in the decoder FIFO */
+    struct vlc_latency_histogram stages[VLC_LATENCY_STAGE_COUNT];
+};
+
 /**
  * Access pf_readdir helper struct
  * \see vlc_readdir_helper_init()
@@ -91,6 +91,21 @@ VLC_API int intf_Create( libvlc_int_t *, const char * );
 
 VLC_API void libvlc_Quit( libvlc_int_t * );
 
+/**
+ * Registers a LibVLC instance clean-up callback.
+ *
+ * The callback is invoked once, when the instance is destroyed, after the
+ * interfaces and the playlist, but before the logger and the plug-ins are
+ * released. This is meant for state shared by all the objects of a plug-in
+ * within an instance. Callbacks are invoked in reverse registration order.
+ *
+ * @param cb callback to invoke
+ * @param opaque data pointer for the callback
+ * @return VLC_SUCCESS or VLC_ENOMEM
+ */
+VLC_API int libvlc_AddCleanup( libvlc_int_t *, void (*cb)(void *),
+                               void *opaque );
+
 /**
  * Recover the main playlist from an interface module
  *
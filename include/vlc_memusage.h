@@ -0,0 +1,79 @@
+/*****************************************************************************
+ * vlc_memusage.h: memory usage accounting
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef VLC_MEMUSAGE_H
+#define VLC_MEMUSAGE_H 1
+
+/**
+ * \defgroup memusage Memory usage
+ * \ingroup misc
+ * Accounting of the memory held by the buffers of each subsystem
+ *
+ * The owners of the largest buffers (data waiting to be decoded, pictures,
+ * caches...) report what they allocate and release, so that the current and
+ * peak usage of each subsystem can be known in a running process.
+ * @{
+ * \file
+ * Memory usage accounting interface
+ */
+
+/**
+ * Subsystems whose memory is accounted.
+ */
+enum vlc_memusage_tag
+{
+    VLC_MEMUSAGE_DECODER,   /**< demuxed data waiting to be decoded */
+    VLC_MEMUSAGE_PICTURE,   /**< picture buffers */
+    VLC_MEMUSAGE_TIMESHIFT, /**< timeshift commands kept in memory */
+    VLC_MEMUSAGE_STREAM,    /**< stream filters caches */
+    VLC_MEMUSAGE_ADAPTIVE,  /**< adaptive streaming demuxed data */
+};
+
+#define VLC_MEMUSAGE_MAX (VLC_MEMUSAGE_ADAPTIVE + 1)
+
+/**
+ * Accounts memory allocated by a subsystem.
+ *
+ * \param tag subsystem holding the memory
+ * \param size number of bytes
+ */
+VLC_API void vlc_memusage_Add(enum vlc_memusage_tag tag, size_t size);
+
+/**
+ * Accounts memory released by a subsystem.
+ *
+ * \param tag subsystem that held the memory
+ * \param size number of bytes, previously accounted with vlc_memusage_Add()
+ */
+VLC_API void vlc_memusage_Sub(enum vlc_memusage_tag tag, size_t size);
+
+/**
+ * Gets the memory held by a subsystem.
+ *
+ * \param tag subsystem
+ * \param current where to store the number of bytes currently held
+ * \param peak where to store the highest number of bytes held so far
+ */
+VLC_API void vlc_memusage_Get(enum vlc_memusage_tag tag, size_t *current,
+                              size_t *peak);
+
+/** @} */
+
+#endif
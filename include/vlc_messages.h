@@ -155,6 +155,14 @@ struct vlc_logger_operations
 {
     vlc_log_cb log;
     void (*destroy)(void *data);
+    /**
+     * Flushes buffered messages (optional, can be NULL).
+     *
+     * This is only invoked by the asynchronous message log (\c --log-async),
+     * once all pending messages have been written. Loggers can thus buffer
+     * their output freely in that mode.
+     */
+    void (*flush)(void *data);
 };
 
 /**
@@ -33,6 +33,10 @@ typedef struct meta_fetcher_t
     struct vlc_object_t obj;
     input_item_t *p_item;
     meta_fetcher_scope_t e_scope;
+    /** Set by the modules if they could not complete the search (because of
+     * a network error, for instance): a search without results is then not
+     * considered as final. */
+    bool b_incomplete;
 } meta_fetcher_t;
 
 #endif
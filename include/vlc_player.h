@@ -912,6 +912,21 @@ vlc_player_GetSignal(vlc_player_t *player, float *quality, float *strength);
 VLC_API const struct input_stats_t *
 vlc_player_GetStatistics(vlc_player_t *player);
 
+/**
+ * Get the latency statistics of the current media
+ *
+ * This returns a snapshot of the latency histograms of each decoded
+ * elementary stream: decoder FIFO wait, decoding, filtering, display slack
+ * and audio output latency. The statistics are only collected if the "stats"
+ * option is enabled.
+ *
+ * @param player locked player instance
+ * @param count pointer to the number of returned elements
+ * @return an array of per-ES statistics (to be freed with free()), or NULL
+ */
+VLC_API struct vlc_es_latency *
+vlc_player_GetLatencyStats(vlc_player_t *player, size_t *count);
+
 /**
  * Restore the previous playback position of the current media
  */
@@ -160,6 +160,7 @@ enum stream_query_e
     STREAM_GET_SIGNAL,      /**< arg1=double *pf_quality, arg2=double *pf_strength   res=can fail */
     STREAM_GET_TAGS,        /**< arg1=const block_t ** res=can fail */
     STREAM_GET_TYPE,        /**< arg1=int*             res=can fail */
+    STREAM_GET_BUFFER_LEVEL,/**< arg1=size_t *level, arg2=size_t *size res=can fail */
 
     STREAM_SET_PAUSE_STATE = 0x200, /**< arg1= bool        res=can fail */
     STREAM_SET_TITLE,       /**< arg1= int          res=can fail */
@@ -112,6 +112,65 @@ vlc_thumbnailer_RequestByPos( vlc_thumbnailer_t *thumbnailer,
                               input_item_t *input_item, vlc_tick_t timeout,
                               vlc_thumbnailer_cb cb, void* user_data );
 
+/**
+ * \brief vlc_thumbnailer_batch_cb defines a callback invoked for each
+ * thumbnail of a batch request
+ *
+ * This callback is called exactly once for each requested time, provided
+ * vlc_thumbnailer_RequestBatch returned a non NULL request, and provided the
+ * request is not cancelled before its completion.
+ * Thumbnails are provided by increasing time, which is not necessarily the
+ * order of the requested times.
+ * The picture, if any, is owned by the thumbnailer, and must be acquired by
+ * using \link picture_Hold \endlink to use it past the callback's scope.
+ *
+ * \param data Is the opaque pointer passed as vlc_thumbnailer_RequestBatch
+ * last parameter
+ * \param index The index of the thumbnail in the requested times array
+ * \param thumbnail The generated thumbnail, or NULL in case of failure or
+ * timeout
+ */
+typedef void(*vlc_thumbnailer_batch_cb)( void* data, size_t index,
+                                         picture_t* thumbnail );
+
+/**
+ * \brief vlc_thumbnailer_RequestBatch Requests thumbnails at several times
+ * \param thumbnailer A thumbnailer object
+ * \param times The times at which the thumbnails should be taken
+ * \param count The number of times (must not be 0)
+ * \param speed The seeking speed \sa{enum vlc_thumbnailer_seek_speed}
+ * \param width The thumbnails width, or 0
+ * \param height The thumbnails height, or 0
+ * \param input_item The input item to generate the thumbnails for
+ * \param timeout A timeout value for each thumbnail, or VLC_TICK_INVALID to
+ * disable timeout
+ * \param cb A user callback to be called for each thumbnail (success & error)
+ * \param user_data An opaque value, provided as cb's first parameter
+ * \return An opaque request object, or NULL in case of failure
+ *
+ * Contrary to multiple vlc_thumbnailer_RequestByTime() calls, the input item
+ * is opened only once: the times are sorted, and the thumbnails are taken
+ * while seeking forward.
+ *
+ * With VLC_THUMBNAILER_SEEK_FAST, the thumbnails are the key frames closest
+ * to the requested times.
+ *
+ * If both width and height are 0, the thumbnails are provided with their
+ * original size. If only one of them is 0, it is computed to preserve the
+ * aspect ratio.
+ *
+ * The same lifetime rules as vlc_thumbnailer_RequestByTime() apply: the
+ * request object must not be used after the last callback invocation.
+ * The times array is copied and can be released after calling this function.
+ */
+VLC_API vlc_thumbnailer_request_t*
+vlc_thumbnailer_RequestBatch( vlc_thumbnailer_t *thumbnailer,
+                              const vlc_tick_t *times, size_t count,
+                              enum vlc_thumbnailer_seek_speed speed,
+                              unsigned width, unsigned height,
+                              input_item_t *input_item, vlc_tick_t timeout,
+                              vlc_thumbnailer_batch_cb cb, void* user_data );
+
 /**
  * \brief vlc_thumbnailer_Cancel Cancel a thumbnail request
  * \param thumbnailer A thumbnailer object
@@ -320,6 +320,21 @@ struct vlc_display_operations
      * \param vp viewpoint to use on the next render
      */
     int        (*set_viewpoint)(vout_display_t *, const vlc_viewpoint_t *vp);
+
+    /**
+     * Provides pictures for the decoder to render into (optional).
+     *
+     * This is only called if the decoder output format matches the display
+     * format, so that the pictures can be displayed without being converted
+     * or copied into the display buffers in \ref prepare.
+     *
+     * May be NULL.
+     *
+     * \param count number of pictures needed by the decoder
+     * \return a pool of at least count pictures, owned by the caller,
+     * or NULL if the decoder should allocate its own pictures
+     */
+    picture_pool_t *(*pool)(vout_display_t *, unsigned count);
 };
 
 struct vout_display_t {
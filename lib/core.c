@@ -29,6 +29,7 @@
 #include <vlc/vlc.h>
 
 #include <vlc_interface.h>
+#include <vlc_memusage.h>
 
 #include <stdarg.h>
 #include <limits.h>
@@ -222,4 +223,21 @@ int64_t libvlc_clock(void)
     return US_FROM_VLC_TICK(vlc_tick_now());
 }
 
+int libvlc_memory_usage_get( libvlc_memory_usage_t type,
+                             size_t *current, size_t *peak )
+{
+    static_assert( libvlc_memory_decoder == (int)VLC_MEMUSAGE_DECODER &&
+                   libvlc_memory_picture == (int)VLC_MEMUSAGE_PICTURE &&
+                   libvlc_memory_timeshift == (int)VLC_MEMUSAGE_TIMESHIFT &&
+                   libvlc_memory_stream == (int)VLC_MEMUSAGE_STREAM &&
+                   libvlc_memory_adaptive == (int)VLC_MEMUSAGE_ADAPTIVE,
+                   "memory usage types mismatch" );
+
+    if( (unsigned)type >= VLC_MEMUSAGE_MAX )
+        return -1;
+
+    vlc_memusage_Get( (enum vlc_memusage_tag)type, current, peak );
+    return 0;
+}
+
 const char vlc_module_name[] = "libvlc";
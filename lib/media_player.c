@@ -604,6 +604,7 @@ libvlc_media_player_new( libvlc_instance_t *instance )
     var_Create (mp, "vmem-data", VLC_VAR_ADDRESS);
     var_Create (mp, "vmem-setup", VLC_VAR_ADDRESS);
     var_Create (mp, "vmem-cleanup", VLC_VAR_ADDRESS);
+    var_Create (mp, "vmem-direct", VLC_VAR_BOOL);
     var_Create (mp, "vmem-chroma", VLC_VAR_STRING | VLC_VAR_DOINHERIT);
     var_Create (mp, "vmem-width", VLC_VAR_INTEGER | VLC_VAR_DOINHERIT);
     var_Create (mp, "vmem-height", VLC_VAR_INTEGER | VLC_VAR_DOINHERIT);
@@ -1013,6 +1014,12 @@ void libvlc_video_set_format_callbacks( libvlc_media_player_t *mp,
     var_SetAddress( mp, "vmem-cleanup", cleanup );
 }
 
+void libvlc_video_set_direct_rendering( libvlc_media_player_t *mp,
+                                        bool enable )
+{
+    var_SetBool( mp, "vmem-direct", enable );
+}
+
 void libvlc_video_set_format( libvlc_media_player_t *mp, const char *chroma,
                               unsigned width, unsigned height, unsigned pitch )
 {
@@ -1550,6 +1557,69 @@ void libvlc_chapter_descriptions_release( libvlc_chapter_description_t **p_chapt
     free( p_chapters );
 }
 
+static void latency_histogram_Copy( libvlc_latency_histogram_t *dst,
+                                    const struct vlc_latency_histogram *src )
+{
+    static_assert( LIBVLC_LATENCY_BUCKETS == VLC_LATENCY_BUCKETS,
+                   "latency histogram size mismatch" );
+
+    dst->i_count = src->count;
+    dst->i_total = US_FROM_VLC_TICK( src->total );
+    dst->i_max = US_FROM_VLC_TICK( src->max );
+    for( size_t i = 0; i < LIBVLC_LATENCY_BUCKETS; i++ )
+        dst->pi_buckets[i] = src->buckets[i];
+}
+
+int libvlc_media_player_get_latency_stats( libvlc_media_player_t *p_mi,
+                                           libvlc_track_latency_t **pp_latencies )
+{
+    assert( p_mi );
+
+    vlc_player_t *player = p_mi->player;
+    size_t count;
+
+    vlc_player_Lock(player);
+    struct vlc_es_latency *stats = vlc_player_GetLatencyStats(player, &count);
+    vlc_player_Unlock(player);
+
+    libvlc_track_latency_t *latencies = vlc_alloc( count, sizeof(*latencies) );
+    if( count > 0 && latencies == NULL )
+    {
+        free( stats );
+        return -1;
+    }
+
+    for( size_t i = 0; i < count; i++ )
+    {
+        libvlc_track_latency_t *latency = &latencies[i];
+        const struct vlc_es_latency *es = &stats[i];
+
+        latency->i_id = es->i_id;
+        latency->i_type = track_type_from_cat( es->i_cat );
+        latency->i_fifo_depth = es->fifo_depth;
+        latency->i_fifo_depth_max = es->fifo_depth_max;
+        latency_histogram_Copy( &latency->fifo_wait,
+                                &es->stages[VLC_LATENCY_FIFO_WAIT] );
+        latency_histogram_Copy( &latency->decode,
+                                &es->stages[VLC_LATENCY_DECODE] );
+        latency_histogram_Copy( &latency->filter,
+                                &es->stages[VLC_LATENCY_FILTER] );
+        latency_histogram_Copy( &latency->display_slack,
+                                &es->stages[VLC_LATENCY_DISPLAY_SLACK] );
+        latency_histogram_Copy( &latency->output,
+                                &es->stages[VLC_LATENCY_OUTPUT] );
+    }
+    free( stats );
+
+    *pp_latencies = latencies;
+    return count;
+}
+
+void libvlc_track_latencies_release( libvlc_track_latency_t *p_latencies )
+{
+    free( p_latencies );
+}
+
 void libvlc_media_player_next_chapter( libvlc_media_player_t *p_mi )
 {
     vlc_player_t *player = p_mi->player;
@@ -24,7 +24,12 @@
 
 #include <assert.h>
 #include <vlc_common.h>
+#include <vlc_interface.h>
+#include <vlc_list.h>
+#include <vlc_memstream.h>
+#include <vlc_modules.h>
 #include <vlc_network.h>
+#include <vlc_plugin.h>
 #include <vlc_tls.h>
 #include <vlc_url.h>
 #include "transport.h"
@@ -96,51 +101,629 @@ static char *vlc_http_proxy_find(const char *hostname, unsigned port,
 }
 
 
-struct vlc_http_mgr
+/** Maximum number of idle HTTP/1 connections kept per origin */
+#define VLC_HTTP_POOL_MAX_IDLE 4
+#ifndef VLC_HTTP_POOL_IDLE_TIMEOUT
+/** Delay after which an unused connection is closed */
+# define VLC_HTTP_POOL_IDLE_TIMEOUT VLC_TICK_FROM_SEC(30)
+#endif
+
+/**
+ * TLS client credentials for a given TLS configuration
+ *
+ * Credentials are created on the LibVLC instance rather than on a manager
+ * object, as they must outlive the manager along with the pooled connections.
+ * The TLS options of the manager object are copied to a holder object, so that
+ * the credentials see the same options.
+ */
+struct vlc_http_pool_creds
+{
+    vlc_object_t *obj; /**< Holder of the TLS options */
+    vlc_tls_client_t *tls;
+    char *config; /**< TLS options, as "name=value" lines */
+    struct vlc_list node;
+};
+
+/**
+ * Pooled connection
+ *
+ * HTTP/2 connections stay in the pool while in use, as any number of
+ * managers can multiplex streams over them. HTTP/1 connections only carry one
+ * stream at a time: they are taken out of the pool by a manager, and put back
+ * when the manager is done with them.
+ */
+struct vlc_http_pool_conn
+{
+    struct vlc_http_conn *conn;
+    const struct vlc_http_pool_creds *creds; /**< TLS credentials (HTTPS) */
+    char *host;
+    char *proxy; /**< Proxy URL, or NULL if none */
+    unsigned port;
+    bool http2;
+    vlc_tick_t last_used;
+    struct vlc_list node;
+};
+
+/**
+ * Connection pool
+ *
+ * One pool is shared by all the connection managers of a LibVLC instance. It
+ * lives as long as the instance, so that sequential inputs can reuse the
+ * connections of their predecessors. Idle connections are closed by a timer.
+ */
+struct vlc_http_pool
 {
+    libvlc_int_t *libvlc;
     struct vlc_logger *logger;
+    vlc_timer_t timer; /**< Closes idle connections */
+    vlc_tick_t deadline; /**< Timer deadline, or 0 if disarmed */
+    struct vlc_list creds; /**< List of vlc_http_pool_creds.node */
+    struct vlc_list conns; /**< List of vlc_http_pool_conn.node */
+    struct vlc_http_pool_stats stats;
+    struct vlc_list node;
+};
+
+static vlc_mutex_t pools_lock = VLC_STATIC_MUTEX;
+static struct vlc_list pools = VLC_LIST_INITIALIZER(&pools);
+
+struct vlc_http_mgr
+{
     vlc_object_t *obj;
-    vlc_tls_client_t *creds;
+    struct vlc_http_pool *pool;
+    const struct vlc_http_pool_creds *creds; /**< TLS credentials, or NULL */
     struct vlc_http_cookie_jar_t *jar;
-    struct vlc_http_conn *conn;
+    struct vlc_http_pool_conn *conn; /**< HTTP/1 connection in use */
 };
 
-static struct vlc_http_conn *vlc_http_mgr_find(struct vlc_http_mgr *mgr,
-                                               const char *host, unsigned port)
+static bool vlc_http_pool_conn_match(const struct vlc_http_pool_conn *pc,
+                                     const struct vlc_http_pool_creds *creds,
+                                     const char *host, unsigned port,
+                                     const char *proxy)
+{
+    /* HTTPS connections are only reused with the same TLS configuration */
+    if (pc->creds != creds || pc->port != port || strcmp(pc->host, host))
+        return false;
+    if (pc->proxy == NULL || proxy == NULL)
+        return pc->proxy == proxy;
+    return !strcmp(pc->proxy, proxy);
+}
+
+static struct vlc_http_pool_conn *
+vlc_http_pool_conn_new(struct vlc_http_conn *conn,
+                       const struct vlc_http_pool_creds *creds, bool http2,
+                       const char *host, unsigned port, const char *proxy)
+{
+    struct vlc_http_pool_conn *pc = malloc(sizeof (*pc));
+    if (unlikely(pc == NULL))
+        return NULL;
+
+    pc->host = strdup(host);
+    pc->proxy = (proxy != NULL) ? strdup(proxy) : NULL;
+    if (unlikely(pc->host == NULL || (proxy != NULL && pc->proxy == NULL)))
+    {
+        free(pc->proxy);
+        free(pc->host);
+        free(pc);
+        return NULL;
+    }
+
+    pc->conn = conn;
+    pc->creds = creds;
+    pc->port = port;
+    pc->http2 = http2;
+    pc->last_used = vlc_tick_now();
+    return pc;
+}
+
+/**
+ * Closes a connection (deferred until its streams are closed).
+ *
+ * This must not be called with the pools lock held, as closing an HTTP/2
+ * connection waits for its thread.
+ */
+static void vlc_http_pool_conn_close(struct vlc_http_pool_conn *pc)
+{
+    vlc_http_conn_release(pc->conn);
+    free(pc->proxy);
+    free(pc->host);
+    free(pc);
+}
+
+/** Closes a list of connections removed from the pool */
+static void vlc_http_pool_conn_close_all(struct vlc_list *list)
+{
+    struct vlc_http_pool_conn *pc;
+
+    vlc_list_foreach(pc, list, node)
+        vlc_http_pool_conn_close(pc);
+}
+
+/**
+ * Moves a connection from the pool to a list of connections to close
+ * once the pools lock is released.
+ */
+static void vlc_http_pool_remove(struct vlc_http_pool *pool,
+                                 struct vlc_http_pool_conn *pc,
+                                 struct vlc_list *dead)
+{
+    vlc_list_remove(&pc->node);
+    vlc_list_append(&pc->node, dead);
+    pool->stats.closed++;
+}
+
+/** Removes the connections that have not been used for too long */
+static void vlc_http_pool_expire(struct vlc_http_pool *pool,
+                                 struct vlc_list *dead)
+{
+    vlc_tick_t deadline = vlc_tick_now() - VLC_HTTP_POOL_IDLE_TIMEOUT;
+    struct vlc_http_pool_conn *pc;
+
+    vlc_list_foreach(pc, &pool->conns, node)
+        if (pc->last_used < deadline)
+            vlc_http_pool_remove(pool, pc, dead);
+}
+
+/** Arms the timer for a connection added to the pool, if not armed yet */
+static void vlc_http_pool_arm(struct vlc_http_pool *pool,
+                              const struct vlc_http_pool_conn *pc)
+{
+    if (pool->deadline != 0)
+        return; /* The timer is rearmed for this connection when it fires */
+
+    pool->deadline = pc->last_used + VLC_HTTP_POOL_IDLE_TIMEOUT;
+    vlc_timer_schedule(pool->timer, true, pool->deadline, 0);
+}
+
+static void vlc_http_pool_timer(void *data)
+{
+    struct vlc_http_pool *pool = data;
+    struct vlc_http_pool_conn *pc;
+    struct vlc_list dead;
+
+    vlc_list_init(&dead);
+    vlc_mutex_lock(&pools_lock);
+    vlc_http_pool_expire(pool, &dead);
+
+    /* Rearm for the least recently used remaining connection */
+    pool->deadline = 0;
+    vlc_list_foreach(pc, &pool->conns, node)
+        if (pool->deadline == 0
+         || pc->last_used + VLC_HTTP_POOL_IDLE_TIMEOUT < pool->deadline)
+            pool->deadline = pc->last_used + VLC_HTTP_POOL_IDLE_TIMEOUT;
+    if (pool->deadline != 0)
+        vlc_timer_schedule(pool->timer, true, pool->deadline, 0);
+    vlc_mutex_unlock(&pools_lock);
+    vlc_http_pool_conn_close_all(&dead);
+}
+
+/** Destroys the pool of a LibVLC instance being destroyed */
+static void vlc_http_pool_destroy(void *data)
+{
+    struct vlc_http_pool *pool = data;
+    struct vlc_http_pool_conn *pc;
+    struct vlc_http_pool_creds *c;
+
+    vlc_mutex_lock(&pools_lock);
+    vlc_list_remove(&pool->node);
+    vlc_mutex_unlock(&pools_lock);
+
+    vlc_timer_destroy(pool->timer);
+    /* All managers are gone: every connection is in the pool */
+    vlc_list_foreach(pc, &pool->conns, node)
+    {
+        vlc_http_pool_conn_close(pc);
+        pool->stats.closed++;
+    }
+
+    vlc_http_dbg(pool->logger, "connection pool: %u opened, %u reused, "
+                 "%u closed", pool->stats.opened, pool->stats.reused,
+                 pool->stats.closed);
+
+    vlc_list_foreach(c, &pool->creds, node)
+    {
+        vlc_tls_ClientDelete(c->tls);
+        vlc_object_delete(c->obj);
+        free(c->config);
+        free(c);
+    }
+    free(pool);
+}
+
+static struct vlc_http_pool *vlc_http_pool_get(vlc_object_t *obj)
+{
+    libvlc_int_t *libvlc = vlc_object_instance(obj);
+    struct vlc_http_pool *pool;
+
+    vlc_mutex_lock(&pools_lock);
+    vlc_list_foreach(pool, &pools, node)
+        if (pool->libvlc == libvlc)
+            goto out;
+
+    pool = malloc(sizeof (*pool));
+    if (unlikely(pool == NULL))
+        goto out;
+
+    pool->libvlc = libvlc;
+    pool->logger = VLC_OBJECT(libvlc)->logger;
+    pool->deadline = 0;
+    vlc_list_init(&pool->creds);
+    vlc_list_init(&pool->conns);
+    memset(&pool->stats, 0, sizeof (pool->stats));
+
+    if (vlc_timer_create(&pool->timer, vlc_http_pool_timer, pool))
+    {
+        free(pool);
+        pool = NULL;
+        goto out;
+    }
+
+    if (libvlc_AddCleanup(libvlc, vlc_http_pool_destroy, pool))
+    {
+        vlc_timer_destroy(pool->timer);
+        free(pool);
+        pool = NULL;
+        goto out;
+    }
+    vlc_list_append(&pool->node, &pools);
+out:
+    vlc_mutex_unlock(&pools_lock);
+    return pool;
+}
+
+/**
+ * Copies the options of the TLS client plugins, as seen by an object, to
+ * another object.
+ *
+ * @return the options as "name=value" lines, or NULL on error
+ */
+static char *vlc_http_tls_config(vlc_object_t *obj, vlc_object_t *holder)
+{
+    module_t **mods;
+    ssize_t total = vlc_module_match("tls client", NULL, false, &mods, NULL);
+    struct vlc_memstream stream;
+
+    if (total < 0)
+        return NULL;
+
+    vlc_memstream_open(&stream);
+
+    for (ssize_t i = 0; i < total; i++)
+    {
+        unsigned count;
+        module_config_t *tab = module_config_get(mods[i], &count);
+
+        for (unsigned j = 0; j < count; j++)
+        {
+            const char *name = tab[j].psz_name;
+            int type;
+            vlc_value_t val;
+
+            if (!CONFIG_ITEM(tab[j].i_type) || name == NULL)
+                continue;
+
+            type = config_GetType(name);
+            if (type == 0 || var_Inherit(obj, name, type, &val))
+                continue;
+
+            var_Create(holder, name, type);
+            var_Set(holder, name, val);
+
+            switch (type)
+            {
+                case VLC_VAR_BOOL:
+                    vlc_memstream_printf(&stream, "%s=%d\n", name,
+                                         val.b_bool);
+                    break;
+                case VLC_VAR_INTEGER:
+                    vlc_memstream_printf(&stream, "%s=%"PRId64"\n", name,
+                                         val.i_int);
+                    break;
+                case VLC_VAR_FLOAT:
+                    vlc_memstream_printf(&stream, "%s=%f\n", name,
+                                         val.f_float);
+                    break;
+                case VLC_VAR_STRING:
+                    vlc_memstream_printf(&stream, "%s=%s\n", name,
+                                         (val.psz_string != NULL)
+                                             ? val.psz_string : "");
+                    free(val.psz_string);
+                    break;
+            }
+        }
+        module_config_free(tab);
+    }
+    free(mods);
+
+    if (vlc_memstream_close(&stream))
+        return NULL;
+    return stream.ptr;
+}
+
+/**
+ * Gets the TLS credentials for the TLS configuration of an object.
+ *
+ * Credentials are shared by all the managers with the same configuration,
+ * so that pooled connections can be reused and TLS sessions resumed.
+ */
+static const struct vlc_http_pool_creds *
+vlc_http_pool_get_creds(struct vlc_http_pool *pool, vlc_object_t *obj)
+{
+    struct vlc_http_pool_creds *c = malloc(sizeof (*c));
+    if (unlikely(c == NULL))
+        return NULL;
+
+    c->obj = vlc_object_create(VLC_OBJECT(pool->libvlc), sizeof (*c->obj));
+    if (unlikely(c->obj == NULL))
+    {
+        free(c);
+        return NULL;
+    }
+
+    c->config = vlc_http_tls_config(obj, c->obj);
+    if (unlikely(c->config == NULL))
+        goto error;
+
+    struct vlc_http_pool_creds *p;
+
+    vlc_mutex_lock(&pools_lock);
+    vlc_list_foreach(p, &pool->creds, node)
+        if (!strcmp(p->config, c->config))
+        {
+            vlc_mutex_unlock(&pools_lock);
+            free(c->config);
+            vlc_object_delete(c->obj);
+            free(c);
+            return p;
+        }
+
+    /* First TLS connection with this configuration: load x509 credentials */
+    c->tls = vlc_tls_ClientCreate(c->obj);
+    if (c->tls != NULL)
+        vlc_list_append(&c->node, &pool->creds);
+    vlc_mutex_unlock(&pools_lock);
+
+    if (c->tls != NULL)
+        return c;
+    free(c->config);
+error:
+    vlc_object_delete(c->obj);
+    free(c);
+    return NULL;
+}
+
+/** Adds a new connection to the pool */
+static struct vlc_http_pool_conn *
+vlc_http_pool_add(struct vlc_http_pool *pool, struct vlc_http_conn *conn,
+                  const struct vlc_http_pool_creds *creds, bool http2,
+                  const char *host, unsigned port, const char *proxy)
+{
+    struct vlc_http_pool_conn *pc =
+        vlc_http_pool_conn_new(conn, creds, http2, host, port, proxy);
+
+    vlc_mutex_lock(&pools_lock);
+    pool->stats.opened++;
+    if (likely(pc != NULL) && http2)
+    {
+        vlc_list_append(&pc->node, &pool->conns);
+        vlc_http_pool_arm(pool, pc);
+    }
+    vlc_mutex_unlock(&pools_lock);
+    return pc;
+}
+
+/**
+ * Opens a stream on a shared HTTP/2 connection, or takes an idle HTTP/1
+ * connection out of the pool.
+ *
+ * An HTTP/2 connection is taken out of the pool while a stream is opened on
+ * it, so that the pools lock is not held while waiting for the connection.
+ */
+static struct vlc_http_stream *
+vlc_http_pool_find(struct vlc_http_pool *pool,
+                   const struct vlc_http_pool_creds *creds, const char *host,
+                   unsigned port, const char *proxy,
+                   const struct vlc_http_msg *req, bool payload,
+                   struct vlc_http_pool_conn **restrict h1p,
+                   struct vlc_http_pool_conn **restrict h2p)
+{
+    *h1p = *h2p = NULL;
+
+    for (;;)
+    {
+        struct vlc_http_pool_conn *pc, *h1 = NULL, *h2 = NULL;
+        struct vlc_list dead;
+
+        vlc_list_init(&dead);
+        vlc_mutex_lock(&pools_lock);
+        vlc_http_pool_expire(pool, &dead);
+
+        vlc_list_foreach(pc, &pool->conns, node)
+        {
+            if (!vlc_http_pool_conn_match(pc, creds, host, port, proxy))
+                continue;
+
+            if (pc->http2)
+            {
+                h2 = pc;
+                break;
+            }
+            /* Most recently used first, as it is the least likely to have
+             * been closed by the server. */
+            if (h1 == NULL || pc->last_used > h1->last_used)
+                h1 = pc;
+        }
+
+        if (h2 != NULL)
+            vlc_list_remove(&h2->node);
+        else if (h1 != NULL)
+        {
+            vlc_list_remove(&h1->node);
+            pool->stats.reused++;
+        }
+        vlc_mutex_unlock(&pools_lock);
+        vlc_http_pool_conn_close_all(&dead);
+
+        if (h2 == NULL)
+        {
+            *h1p = h1;
+            return NULL;
+        }
+
+        struct vlc_http_stream *stream =
+            vlc_http_stream_open(h2->conn, req, payload);
+
+        vlc_mutex_lock(&pools_lock);
+        if (stream != NULL)
+        {   /* Still usable: put it back for other managers */
+            h2->last_used = vlc_tick_now();
+            vlc_list_append(&h2->node, &pool->conns);
+            vlc_http_pool_arm(pool, h2);
+            pool->stats.reused++;
+        }
+        else
+            pool->stats.closed++;
+        vlc_mutex_unlock(&pools_lock);
+
+        if (stream != NULL)
+        {
+            *h2p = h2;
+            return stream;
+        }
+        /* Get rid of closing connection */
+        vlc_http_pool_conn_close(h2);
+    }
+}
+
+/** Drops a shared HTTP/2 connection that failed */
+static void vlc_http_pool_drop(struct vlc_http_pool *pool,
+                               struct vlc_http_pool_conn *pc)
 {
-    (void) host; (void) port;
-    return mgr->conn;
+    struct vlc_http_pool_conn *p;
+    struct vlc_list dead;
+
+    vlc_list_init(&dead);
+    vlc_mutex_lock(&pools_lock);
+    /* The connection may already have been dropped by another manager */
+    vlc_list_foreach(p, &pool->conns, node)
+        if (p == pc)
+        {
+            vlc_http_pool_remove(pool, pc, &dead);
+            break;
+        }
+    vlc_mutex_unlock(&pools_lock);
+    vlc_http_pool_conn_close_all(&dead);
+}
+
+/** Puts an HTTP/1 connection back in the pool */
+static void vlc_http_pool_put(struct vlc_http_pool *pool,
+                              struct vlc_http_pool_conn *pc)
+{
+    struct vlc_list dead;
+
+    assert(!pc->http2);
+    vlc_list_init(&dead);
+
+    vlc_mutex_lock(&pools_lock);
+    pc->last_used = vlc_tick_now();
+    vlc_list_prepend(&pc->node, &pool->conns);
+    vlc_http_pool_arm(pool, pc);
+
+    if (pc->conn->tls == NULL)
+        /* Connection failed or cannot be reused */
+        vlc_http_pool_remove(pool, pc, &dead);
+    else
+    {   /* Limit the number of idle connections to the same origin */
+        struct vlc_http_pool_conn *p;
+        unsigned count = 0;
+
+        vlc_list_foreach(p, &pool->conns, node)
+            if (!p->http2
+             && vlc_http_pool_conn_match(p, pc->creds, pc->host, pc->port,
+                                         pc->proxy)
+             && ++count > VLC_HTTP_POOL_MAX_IDLE)
+                vlc_http_pool_remove(pool, p, &dead);
+    }
+    vlc_mutex_unlock(&pools_lock);
+    vlc_http_pool_conn_close_all(&dead);
 }
 
 static void vlc_http_mgr_release(struct vlc_http_mgr *mgr,
-                                 struct vlc_http_conn *conn)
+                                 struct vlc_http_pool_conn *pc)
 {
-    assert(mgr->conn == conn);
+    struct vlc_http_pool *pool = mgr->pool;
+
+    assert(mgr->conn == pc);
     mgr->conn = NULL;
 
-    vlc_http_conn_release(conn);
+    vlc_mutex_lock(&pools_lock);
+    pool->stats.closed++;
+    vlc_mutex_unlock(&pools_lock);
+    vlc_http_pool_conn_close(pc);
+}
+
+/** Sets the HTTP/1 connection used by the manager */
+static void vlc_http_mgr_set(struct vlc_http_mgr *mgr,
+                             struct vlc_http_pool_conn *pc)
+{
+    /* The previous connection may still carry a stream: do not pool it */
+    if (mgr->conn != NULL)
+        vlc_http_mgr_release(mgr, mgr->conn);
+    mgr->conn = pc;
 }
 
 static
 struct vlc_http_msg *vlc_http_mgr_reuse(struct vlc_http_mgr *mgr,
+                                        const struct vlc_http_pool_creds *creds,
                                         const char *host, unsigned port,
+                                        const char *proxy,
                                         const struct vlc_http_msg *req,
                                         bool payload)
 {
-    struct vlc_http_conn *conn = vlc_http_mgr_find(mgr, host, port);
-    if (conn == NULL)
-        return NULL;
+    struct vlc_http_pool_conn *pc = mgr->conn;
+    struct vlc_http_stream *stream;
 
-    struct vlc_http_stream *stream = vlc_http_stream_open(conn, req, payload);
-    if (stream != NULL)
+    if (pc != NULL
+     && vlc_http_pool_conn_match(pc, creds, host, port, proxy))
+    {   /* Try the connection already used by this manager first */
+        stream = vlc_http_stream_open(pc->conn, req, payload);
+        if (stream != NULL)
+        {
+            struct vlc_http_msg *m = vlc_http_msg_get_initial(stream);
+            if (m != NULL)
+                return m;
+        }
+        /* Get rid of closing or reset connection */
+        vlc_http_mgr_release(mgr, pc);
+    }
+
+    for (;;)
     {
-        struct vlc_http_msg *m = vlc_http_msg_get_initial(stream);
-        if (m != NULL)
-            return m;
+        struct vlc_http_pool_conn *h2;
+
+        stream = vlc_http_pool_find(mgr->pool, creds, host, port, proxy,
+                                    req, payload, &pc, &h2);
+        if (stream != NULL)
+        {   /* Stream multiplexed on a shared HTTP/2 connection */
+            struct vlc_http_msg *m = vlc_http_msg_get_initial(stream);
+            if (m != NULL)
+                return m;
+            vlc_http_pool_drop(mgr->pool, h2);
+            continue;
+        }
+
+        if (pc == NULL)
+            return NULL; /* No more pooled connection */
+
+        vlc_http_mgr_set(mgr, pc);
+        stream = vlc_http_stream_open(pc->conn, req, payload);
+        if (stream != NULL)
+        {
+            struct vlc_http_msg *m = vlc_http_msg_get_initial(stream);
+            if (m != NULL)
+                return m;
+        }
+        vlc_http_mgr_release(mgr, pc);
     }
-    /* Get rid of closing or reset connection */
-    vlc_http_mgr_release(mgr, conn);
-    return NULL;
 }
 
 static struct vlc_http_msg *vlc_https_request(struct vlc_http_mgr *mgr,
@@ -148,18 +731,17 @@ static struct vlc_http_msg *vlc_https_request(struct vlc_http_mgr *mgr,
                                               const struct vlc_http_msg *req,
                                               bool idempotent, bool payload)
 {
+    if (mgr->creds == NULL) /* First TLS connection */
+        mgr->creds = vlc_http_pool_get_creds(mgr->pool, mgr->obj);
+
+    const struct vlc_http_pool_creds *creds = mgr->creds;
     vlc_tls_t *tls;
     bool http2 = true;
 
-    if (mgr->creds == NULL && mgr->conn != NULL)
-        return NULL; /* switch from HTTP to HTTPS not implemented */
+    if (creds == NULL)
+        return NULL;
 
-    if (mgr->creds == NULL)
-    {   /* First TLS connection: load x509 credentials */
-        mgr->creds = vlc_tls_ClientCreate(mgr->obj);
-        if (mgr->creds == NULL)
-            return NULL;
-    }
+    char *proxy = vlc_http_proxy_find(host, port, true);
 
     if (idempotent)
     {   /* If the request is idempotent, try to reuse an existing connection.
@@ -167,24 +749,26 @@ static struct vlc_http_msg *vlc_https_request(struct vlc_http_mgr *mgr,
          * the nonidempotent request was processed if the connection fails
          * before the response is received.
          */
-        struct vlc_http_msg *resp = vlc_http_mgr_reuse(mgr, host, port, req,
-                                                       payload);
+        struct vlc_http_msg *resp = vlc_http_mgr_reuse(mgr, creds, host, port,
+                                                       proxy, req, payload);
         if (resp != NULL)
+        {
+            free(proxy);
             return resp; /* existing connection reused */
+        }
     }
 
-    char *proxy = vlc_http_proxy_find(host, port, true);
     if (proxy != NULL)
-    {
-        tls = vlc_https_connect_proxy(mgr->creds, mgr->creds,
-                                      host, port, &http2, proxy);
-        free(proxy);
-    }
+        tls = vlc_https_connect_proxy(creds->tls, creds->tls, host, port,
+                                      &http2, proxy);
     else
-        tls = vlc_https_connect(mgr->creds, host, port, &http2);
+        tls = vlc_https_connect(creds->tls, host, port, &http2);
 
     if (tls == NULL)
+    {
+        free(proxy);
         return NULL;
+    }
 
     struct vlc_http_conn *conn;
 
@@ -194,23 +778,48 @@ static struct vlc_http_msg *vlc_https_request(struct vlc_http_mgr *mgr,
      * should not be used. HTTP 1.0 should only be used if ALPN is not
      * supported by the server.
      * NOTE: We do not enforce TLS version 1.2 for HTTP 2.0 explicitly.
+     * NOTE: Pooled connections outlive the manager, so they log through the
+     * LibVLC instance.
      */
     if (http2)
-        conn = vlc_h2_conn_create(mgr->logger, tls);
+        conn = vlc_h2_conn_create(mgr->pool->logger, tls);
     else
-        conn = vlc_h1_conn_create(mgr->logger, tls, false);
+        conn = vlc_h1_conn_create(mgr->pool->logger, tls, false);
 
     if (unlikely(conn == NULL))
     {
+        free(proxy);
         vlc_tls_Close(tls);
         return NULL;
     }
 
-    if (mgr->conn != NULL)
-        vlc_http_mgr_release(mgr, mgr->conn);
+    struct vlc_http_pool_conn *pc = vlc_http_pool_add(mgr->pool, conn, creds,
+                                                      http2, host, port,
+                                                      proxy);
+    free(proxy);
+    if (unlikely(pc == NULL))
+    {
+        vlc_http_conn_release(conn);
+        return NULL;
+    }
+
+    struct vlc_http_stream *stream = vlc_http_stream_open(conn, req, payload);
+    struct vlc_http_msg *resp = NULL;
 
-    mgr->conn = conn;
-    return vlc_http_mgr_reuse(mgr, host, port, req, payload);
+    if (stream != NULL)
+        resp = vlc_http_msg_get_initial(stream);
+
+    if (http2)
+    {
+        if (resp == NULL)
+            vlc_http_pool_drop(mgr->pool, pc);
+        return resp;
+    }
+
+    vlc_http_mgr_set(mgr, pc);
+    if (resp == NULL)
+        vlc_http_mgr_release(mgr, pc);
+    return resp;
 }
 
 static struct vlc_http_msg *vlc_http_request(struct vlc_http_mgr *mgr,
@@ -218,30 +827,30 @@ static struct vlc_http_msg *vlc_http_request(struct vlc_http_mgr *mgr,
                                              const struct vlc_http_msg *req,
                                              bool idempotent, bool payload)
 {
-    if (mgr->creds != NULL && mgr->conn != NULL)
-        return NULL; /* switch from HTTPS to HTTP not implemented */
+    char *proxy = vlc_http_proxy_find(host, port, false);
 
     if (idempotent)
     {
-        struct vlc_http_msg *resp = vlc_http_mgr_reuse(mgr, host, port, req,
-                                                       payload);
+        struct vlc_http_msg *resp = vlc_http_mgr_reuse(mgr, NULL, host, port,
+                                                       proxy, req, payload);
         if (resp != NULL)
+        {
+            free(proxy);
             return resp;
+        }
     }
 
     struct vlc_http_conn *conn;
     struct vlc_http_stream *stream;
 
-    char *proxy = vlc_http_proxy_find(host, port, false);
     if (proxy != NULL)
     {
         vlc_url_t url;
 
         vlc_UrlParse(&url, proxy);
-        free(proxy);
 
         if (url.psz_host != NULL)
-            stream = vlc_h1_request(mgr->logger, url.psz_host,
+            stream = vlc_h1_request(mgr->pool->logger, url.psz_host,
                                     url.i_port ? url.i_port : 80, true, req,
                                     idempotent, payload, &conn);
         else
@@ -250,23 +859,30 @@ static struct vlc_http_msg *vlc_http_request(struct vlc_http_mgr *mgr,
         vlc_UrlClean(&url);
     }
     else
-        stream = vlc_h1_request(mgr->logger, host, port ? port : 80, false,
-                                req, idempotent, payload, &conn);
+        stream = vlc_h1_request(mgr->pool->logger, host, port ? port : 80,
+                                false, req, idempotent, payload, &conn);
 
     if (stream == NULL)
+    {
+        free(proxy);
         return NULL;
+    }
+
+    struct vlc_http_pool_conn *pc = vlc_http_pool_add(mgr->pool, conn, NULL,
+                                                      false, host, port,
+                                                      proxy);
+    free(proxy);
 
     struct vlc_http_msg *resp = vlc_http_msg_get_initial(stream);
-    if (resp == NULL)
-    {
+    if (unlikely(pc == NULL))
+    {   /* Cannot be pooled: close once the response is done */
         vlc_http_conn_release(conn);
-        return NULL;
+        return resp;
     }
 
-    if (mgr->conn != NULL)
-        vlc_http_mgr_release(mgr, mgr->conn);
-
-    mgr->conn = conn;
+    vlc_http_mgr_set(mgr, pc);
+    if (resp == NULL)
+        vlc_http_mgr_release(mgr, pc);
     return resp;
 }
 
@@ -287,6 +903,25 @@ struct vlc_http_cookie_jar_t *vlc_http_mgr_get_jar(struct vlc_http_mgr *mgr)
     return mgr->jar;
 }
 
+void vlc_http_mgr_get_stats(struct vlc_http_mgr *mgr,
+                            struct vlc_http_pool_stats *restrict stats)
+{
+    struct vlc_http_pool *pool = mgr->pool;
+    struct vlc_http_pool_conn *pc;
+
+    vlc_mutex_lock(&pools_lock);
+    *stats = pool->stats;
+    stats->idle = stats->shared = 0;
+    vlc_list_foreach(pc, &pool->conns, node)
+    {
+        if (pc->http2)
+            stats->shared++;
+        else
+            stats->idle++;
+    }
+    vlc_mutex_unlock(&pools_lock);
+}
+
 struct vlc_http_mgr *vlc_http_mgr_create(vlc_object_t *obj,
                                          struct vlc_http_cookie_jar_t *jar)
 {
@@ -294,7 +929,13 @@ struct vlc_http_mgr *vlc_http_mgr_create(vlc_object_t *obj,
     if (unlikely(mgr == NULL))
         return NULL;
 
-    mgr->logger = obj->logger;
+    mgr->pool = vlc_http_pool_get(obj);
+    if (unlikely(mgr->pool == NULL))
+    {
+        free(mgr);
+        return NULL;
+    }
+
     mgr->obj = obj;
     mgr->creds = NULL;
     mgr->jar = jar;
@@ -304,9 +945,8 @@ struct vlc_http_mgr *vlc_http_mgr_create(vlc_object_t *obj,
 
 void vlc_http_mgr_destroy(struct vlc_http_mgr *mgr)
 {
+    /* All streams have been closed by now: keep the connection for later */
     if (mgr->conn != NULL)
-        vlc_http_mgr_release(mgr, mgr->conn);
-    if (mgr->creds != NULL)
-        vlc_tls_ClientDelete(mgr->creds);
+        vlc_http_pool_put(mgr->pool, mgr->conn);
     free(mgr);
 }
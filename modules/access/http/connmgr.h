@@ -57,10 +57,36 @@ struct vlc_http_msg *vlc_http_mgr_request(struct vlc_http_mgr *mgr, bool https,
 
 struct vlc_http_cookie_jar_t *vlc_http_mgr_get_jar(struct vlc_http_mgr *);
 
+/**
+ * HTTP connection pool statistics
+ */
+struct vlc_http_pool_stats
+{
+    unsigned opened; /**< Connections established */
+    unsigned reused; /**< Requests sent over an existing connection */
+    unsigned closed; /**< Connections closed */
+    unsigned idle; /**< Idle HTTP/1 connections */
+    unsigned shared; /**< HTTP/2 connections */
+};
+
+/**
+ * Gets HTTP connection pool statistics
+ *
+ * Connections are pooled and shared by all the HTTP connection managers of
+ * a LibVLC instance. The pool lives as long as the instance.
+ *
+ * @param mgr HTTP connection manager
+ * @param stats storage space for the statistics [OUT]
+ */
+void vlc_http_mgr_get_stats(struct vlc_http_mgr *mgr,
+                            struct vlc_http_pool_stats *stats);
+
 /**
  * Creates an HTTP connection manager
  *
  * Allocates an HTTP client connections manager.
+ * HTTPS connections are only shared by managers whose parent objects have the
+ * same TLS options.
  *
  * @param obj parent VLC object
  * @param jar HTTP cookies jar (NULL to disable cookies)
@@ -72,7 +98,11 @@ struct vlc_http_mgr *vlc_http_mgr_create(vlc_object_t *obj,
  * Destroys an HTTP connection manager
  *
  * Deallocates an HTTP client connections manager created by
- * vlc_http_msg_destroy(). Any remaining connection is closed and destroyed.
+ * vlc_http_msg_destroy(). Any remaining connection is kept in the pool, for
+ * reuse by other managers, until it expires.
+ *
+ * @note All the HTTP messages received through the manager must have been
+ * destroyed.
  */
 void vlc_http_mgr_destroy(struct vlc_http_mgr *mgr);
 
@@ -0,0 +1,452 @@
+/*****************************************************************************
+ * connmgr_test.c: HTTP connection pool test
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#undef NDEBUG
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vlc_common.h>
+#include <vlc_variables.h>
+
+#define VLC_HTTP_POOL_IDLE_TIMEOUT VLC_TICK_FROM_MS(100)
+#include "connmgr.c"
+
+const char vlc_module_name[] = "test_http_connmgr";
+
+/* Fake connections */
+struct fake_conn
+{
+    struct vlc_http_conn conn;
+    bool http2;
+    bool broken; /**< Fails to open streams */
+    bool released;
+    unsigned streams; /**< Opened streams */
+};
+
+struct fake_stream
+{
+    struct vlc_http_stream stream;
+    struct fake_conn *conn;
+};
+
+#define MAX_CONNS 16
+
+static struct fake_conn conns[MAX_CONNS];
+static unsigned conn_count;
+static unsigned connects; /**< TCP/TLS connections established */
+static bool server_h2; /**< Whether the server negotiates HTTP/2 */
+static char dummy_tls, dummy_creds;
+
+static struct vlc_http_msg *stream_read_headers(struct vlc_http_stream *s)
+{
+    struct vlc_http_msg *m = vlc_http_resp_create(200);
+    assert(m != NULL);
+    vlc_http_msg_attach(m, s);
+    return m;
+}
+
+static void stream_close(struct vlc_http_stream *s, bool abort)
+{
+    struct fake_stream *fs = container_of(s, struct fake_stream, stream);
+
+    assert(fs->conn->streams > 0);
+    fs->conn->streams--;
+    free(fs);
+    (void) abort;
+}
+
+static const struct vlc_http_stream_cbs stream_cbs =
+{
+    stream_read_headers, NULL, NULL, stream_close,
+};
+
+static struct vlc_http_stream *conn_stream_open(struct vlc_http_conn *c,
+                                                const struct vlc_http_msg *m,
+                                                bool has_data)
+{
+    struct fake_conn *fc = container_of(c, struct fake_conn, conn);
+
+    assert(!fc->released);
+    if (fc->broken || (!fc->http2 && fc->streams > 0))
+        return NULL;
+
+    struct fake_stream *fs = malloc(sizeof (*fs));
+    assert(fs != NULL);
+    fs->stream.cbs = &stream_cbs;
+    fs->conn = fc;
+    fc->streams++;
+    (void) m; (void) has_data;
+    return &fs->stream;
+}
+
+static void conn_release(struct vlc_http_conn *c)
+{
+    struct fake_conn *fc = container_of(c, struct fake_conn, conn);
+
+    assert(!fc->released);
+    fc->released = true;
+}
+
+static const struct vlc_http_conn_cbs conn_cbs =
+{
+    conn_stream_open, conn_release,
+};
+
+static struct vlc_http_conn *conn_create(struct vlc_tls *tls, bool http2)
+{
+    assert(conn_count < MAX_CONNS);
+
+    struct fake_conn *fc = &conns[conn_count++];
+    fc->conn.cbs = &conn_cbs;
+    fc->conn.tls = tls;
+    fc->http2 = http2;
+    return &fc->conn;
+}
+
+/* Instance mocks */
+static void (*cleanup_cb)(void *);
+static void *cleanup_opaque;
+
+int libvlc_AddCleanup(libvlc_int_t *libvlc, void (*cb)(void *), void *opaque)
+{
+    (void) libvlc;
+    assert(cleanup_cb == NULL); /* One pool per instance */
+    cleanup_cb = cb;
+    cleanup_opaque = opaque;
+    return VLC_SUCCESS;
+}
+
+/* A single TLS client plugin, with a single option */
+#define TLS_OPTION "test-tls-trust"
+
+static char dummy_module;
+
+ssize_t vlc_module_match(const char *capability, const char *names,
+                         bool strict, module_t ***restrict modules,
+                         size_t *restrict strict_matches)
+{
+    assert(!strcmp(capability, "tls client"));
+    (void) names; (void) strict; (void) strict_matches;
+    *modules = malloc(sizeof (module_t *));
+    assert(*modules != NULL);
+    (*modules)[0] = (module_t *)&dummy_module;
+    return 1;
+}
+
+module_config_t *module_config_get(const module_t *module, unsigned *count)
+{
+    assert(module == (module_t *)&dummy_module);
+    module_config_t *tab = calloc(1, sizeof (*tab));
+    assert(tab != NULL);
+    tab->i_type = CONFIG_ITEM_STRING;
+    tab->psz_name = TLS_OPTION;
+    *count = 1;
+    return tab;
+}
+
+void module_config_free(module_config_t *tab)
+{
+    free(tab);
+}
+
+int config_GetType(const char *name)
+{
+    return strcmp(name, TLS_OPTION) ? 0 : VLC_VAR_STRING;
+}
+
+/* Transport mocks */
+static unsigned creds_count;
+
+vlc_tls_client_t *vlc_tls_ClientCreate(vlc_object_t *obj)
+{
+    /* The credentials see the options of the manager object */
+    char *trust = var_InheritString(obj, TLS_OPTION);
+    assert(trust != NULL);
+    free(trust);
+    creds_count++;
+    return (vlc_tls_client_t *)&dummy_creds;
+}
+
+void vlc_tls_ClientDelete(vlc_tls_client_t *creds)
+{
+    assert(creds == (vlc_tls_client_t *)&dummy_creds);
+    assert(creds_count > 0);
+    creds_count--;
+}
+
+vlc_tls_t *vlc_tls_SocketOpenTLS(vlc_tls_client_t *creds, const char *name,
+                                 unsigned port, const char *service,
+                                 const char *const *alpn, char **alp)
+{
+    (void) creds; (void) name; (void) port; (void) service; (void) alpn;
+    connects++;
+    *alp = strdup(server_h2 ? "h2" : "http/1.1");
+    return (vlc_tls_t *)&dummy_tls;
+}
+
+struct vlc_tls *vlc_https_connect_proxy(void *ctx,
+                                        struct vlc_tls_client *creds,
+                                        const char *name, unsigned port,
+                                        bool *restrict two, const char *proxy)
+{
+    (void) ctx; (void) creds; (void) name; (void) port; (void) two;
+    (void) proxy;
+    abort();
+}
+
+struct vlc_http_conn *vlc_h1_conn_create(void *ctx, struct vlc_tls *tls,
+                                         bool proxy)
+{
+    (void) ctx; (void) proxy;
+    return conn_create(tls, false);
+}
+
+struct vlc_http_conn *vlc_h2_conn_create(void *ctx, struct vlc_tls *tls)
+{
+    (void) ctx;
+    return conn_create(tls, true);
+}
+
+struct vlc_http_stream *vlc_h1_request(void *ctx, const char *hostname,
+                                       unsigned port, bool proxy,
+                                       const struct vlc_http_msg *req,
+                                       bool idempotent, bool has_data,
+                                       struct vlc_http_conn **restrict connp)
+{
+    (void) ctx; (void) hostname; (void) port; (void) idempotent;
+    connects++;
+    *connp = vlc_h1_conn_create(NULL, (struct vlc_tls *)&dummy_tls, proxy);
+    return vlc_http_stream_open(*connp, req, has_data);
+}
+
+/* Callback for vlc_http_msg_h2_frame */
+#include "h2frame.h"
+
+struct vlc_h2_frame *
+vlc_h2_frame_headers(uint_fast32_t id, uint_fast32_t mtu, bool eos,
+                     unsigned count, const char *const tab[][2])
+{
+    (void) id; (void) mtu; (void) eos; (void) count; (void) tab;
+    abort();
+}
+
+static struct vlc_http_msg *request(struct vlc_http_mgr *mgr, bool https,
+                                    const char *host, unsigned port)
+{
+    struct vlc_http_msg *req = vlc_http_req_create("GET",
+                                                   https ? "https" : "http",
+                                                   host, "/");
+    assert(req != NULL);
+
+    struct vlc_http_msg *resp = vlc_http_mgr_request(mgr, https, host, port,
+                                                     req, true, false);
+    vlc_http_msg_destroy(req);
+    assert(resp != NULL);
+    assert(vlc_http_msg_get_status(resp) == 200);
+    return resp;
+}
+
+static void check_stats(struct vlc_http_mgr *mgr, unsigned opened,
+                        unsigned reused, unsigned closed, unsigned idle,
+                        unsigned shared)
+{
+    struct vlc_http_pool_stats stats;
+
+    vlc_http_mgr_get_stats(mgr, &stats);
+    assert(stats.opened == opened);
+    assert(stats.reused == reused);
+    assert(stats.closed == closed);
+    assert(stats.idle == idle);
+    assert(stats.shared == shared);
+}
+
+/* HTTP/2 connections are shared, per origin */
+static void test_h2(vlc_object_t *obj)
+{
+    struct vlc_http_mgr *a = vlc_http_mgr_create(obj, NULL);
+    struct vlc_http_mgr *b = vlc_http_mgr_create(obj, NULL);
+    assert(a != NULL && b != NULL);
+
+    server_h2 = true;
+    struct vlc_http_msg *m1 = request(a, true, "www.example.com", 443);
+    struct vlc_http_msg *m2 = request(b, true, "www.example.com", 443);
+    assert(connects == 1 && conn_count == 1 && conns[0].streams == 2);
+    check_stats(a, 1, 1, 0, 0, 1);
+
+    /* Same host, other port: other connection */
+    struct vlc_http_msg *m3 = request(b, true, "www.example.com", 8443);
+    assert(connects == 2);
+    check_stats(a, 2, 1, 0, 0, 2);
+
+    /* A closing connection is replaced */
+    conns[0].broken = true;
+    struct vlc_http_msg *m4 = request(a, true, "www.example.com", 443);
+    assert(connects == 3 && conns[0].released && conns[2].streams == 1);
+    check_stats(a, 3, 1, 1, 0, 2);
+
+    vlc_http_msg_destroy(m4);
+    vlc_http_msg_destroy(m3);
+    vlc_http_msg_destroy(m2);
+    vlc_http_msg_destroy(m1);
+    vlc_http_mgr_destroy(b);
+    vlc_http_mgr_destroy(a);
+}
+
+/* HTTP/1 connections are put back in the pool by the manager */
+static void test_h1(vlc_object_t *obj, bool https)
+{
+    struct vlc_http_mgr *a = vlc_http_mgr_create(obj, NULL);
+    assert(a != NULL);
+
+    server_h2 = false;
+    unsigned base = conn_count;
+    struct vlc_http_pool_stats before;
+    vlc_http_mgr_get_stats(a, &before);
+
+    struct vlc_http_msg *m = request(a, https, "www.example.org", 0);
+    vlc_http_msg_destroy(m);
+    /* The manager keeps its connection for its next request */
+    m = request(a, https, "www.example.org", 0);
+    vlc_http_msg_destroy(m);
+    assert(conn_count == base + 1);
+    vlc_http_mgr_destroy(a);
+
+    /* Put back in the pool, and taken by the next manager */
+    struct vlc_http_mgr *b = vlc_http_mgr_create(obj, NULL);
+    assert(b != NULL);
+    check_stats(b, before.opened + 1, before.reused, before.closed,
+                before.idle + 1, before.shared);
+    m = request(b, https, "www.example.org", 0);
+    assert(conn_count == base + 1);
+    check_stats(b, before.opened + 1, before.reused + 1, before.closed,
+                before.idle, before.shared);
+
+    /* While in use, another manager needs its own connection */
+    struct vlc_http_mgr *c = vlc_http_mgr_create(obj, NULL);
+    assert(c != NULL);
+    struct vlc_http_msg *m2 = request(c, https, "www.example.org", 0);
+    assert(conn_count == base + 2);
+    vlc_http_msg_destroy(m2);
+    vlc_http_msg_destroy(m);
+    vlc_http_mgr_destroy(c);
+
+    /* A connection that cannot be reused is not put back */
+    conns[base].conn.tls = NULL;
+    vlc_http_mgr_destroy(b);
+    assert(conns[base].released && !conns[base + 1].released);
+    a = vlc_http_mgr_create(obj, NULL);
+    assert(a != NULL);
+    check_stats(a, before.opened + 2, before.reused + 1, before.closed + 1,
+                before.idle + 1, before.shared);
+    vlc_http_mgr_destroy(a);
+}
+
+/* Unused connections are closed after a while */
+static void test_expiry(vlc_object_t *obj)
+{
+    struct vlc_http_mgr *a = vlc_http_mgr_create(obj, NULL);
+    assert(a != NULL);
+
+    struct vlc_http_pool_stats before;
+    vlc_http_mgr_get_stats(a, &before);
+    assert(before.idle > 0 || before.shared > 0);
+
+    vlc_tick_wait(vlc_tick_now() + 2 * VLC_HTTP_POOL_IDLE_TIMEOUT);
+
+    /* Closed by the pool timer, without any further request */
+    check_stats(a, before.opened, before.reused,
+                before.closed + before.idle + before.shared, 0, 0);
+    for (unsigned i = 0; i < conn_count; i++)
+        assert(conns[i].released);
+
+    server_h2 = true;
+    struct vlc_http_msg *m = request(a, true, "www.example.net", 443);
+    check_stats(a, before.opened + 1, before.reused,
+                before.closed + before.idle + before.shared, 0, 1);
+    for (unsigned i = 0; i < conn_count - 1; i++)
+        assert(conns[i].released);
+    vlc_http_msg_destroy(m);
+    vlc_http_mgr_destroy(a);
+}
+
+/* HTTPS connections are only shared with the same TLS options */
+static void test_tls_config(vlc_object_t *obj)
+{
+    vlc_object_t *other = vlc_object_create(obj, sizeof (*other));
+    assert(other != NULL);
+    var_Create(other, TLS_OPTION, VLC_VAR_STRING);
+    var_SetString(other, TLS_OPTION, "/other/ca");
+
+    struct vlc_http_mgr *a = vlc_http_mgr_create(obj, NULL);
+    struct vlc_http_mgr *b = vlc_http_mgr_create(other, NULL);
+    struct vlc_http_mgr *c = vlc_http_mgr_create(obj, NULL);
+    assert(a != NULL && b != NULL && c != NULL);
+
+    server_h2 = true;
+    unsigned base = connects, count = creds_count;
+    struct vlc_http_msg *m1 = request(a, true, "www.example.edu", 443);
+    struct vlc_http_msg *m2 = request(b, true, "www.example.edu", 443);
+    /* Only the other configuration needs new credentials */
+    assert(connects == base + 2 && creds_count == count + 1);
+    struct vlc_http_msg *m3 = request(c, true, "www.example.edu", 443);
+    assert(connects == base + 2 && creds_count == count + 1);
+
+    vlc_http_msg_destroy(m3);
+    vlc_http_msg_destroy(m2);
+    vlc_http_msg_destroy(m1);
+    vlc_http_mgr_destroy(c);
+    vlc_http_mgr_destroy(b);
+    vlc_http_mgr_destroy(a);
+    vlc_object_delete(other);
+}
+
+int main(void)
+{
+    unsetenv("http_proxy");
+    unsetenv("https_proxy");
+
+    vlc_object_t *obj = vlc_object_create((vlc_object_t *)NULL, sizeof (*obj));
+    assert(obj != NULL);
+    var_Create(obj, TLS_OPTION, VLC_VAR_STRING);
+    var_SetString(obj, TLS_OPTION, "/etc/ssl/certs");
+
+    /* The pool outlives the managers: each test starts with none */
+    test_h2(obj);
+    test_h1(obj, true);
+    test_h1(obj, false);
+    test_tls_config(obj);
+    test_expiry(obj);
+
+    /* Instance destruction */
+    assert(cleanup_cb != NULL);
+    cleanup_cb(cleanup_opaque);
+    assert(creds_count == 0);
+    for (unsigned i = 0; i < conn_count; i++)
+        assert(conns[i].released && conns[i].streams == 0);
+
+    vlc_object_delete(obj);
+    return 0;
+}
@@ -219,6 +219,8 @@ static struct vlc_http_msg *vlc_h1_stream_wait(struct vlc_http_stream *stream)
                 vlc_http_msg_destroy(resp);
                 return vlc_h1_stream_fatal(conn);
             }
+            /* The chunked decoder tracks the end of the payload */
+            conn->content_length = 0;
         }
     }
     else
@@ -290,7 +292,9 @@ static void vlc_h1_stream_close(struct vlc_http_stream *stream, bool abort)
 
     assert(conn->active);
 
-    if (abort)
+    /* The connection cannot be reused if the payload was not fully read or
+     * if the server is about to close it. */
+    if (abort || conn->connection_close || conn->content_length != 0)
         vlc_h1_stream_fatal(conn);
 
     conn->active = false;
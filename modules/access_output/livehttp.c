@@ -43,6 +43,8 @@
 #include <vlc_fs.h>
 #include <vlc_strings.h>
 #include <vlc_charset.h>
+#include <vlc_httpd.h>
+#include <vlc_memstream.h>
 
 #include <gcrypt.h>
 #include <vlc_gcrypt.h>
@@ -105,6 +107,21 @@ static void Close( vlc_object_t * );
 #define INTITIAL_SEG_TEXT N_("Number of first segment")
 #define INITIAL_SEG_LONGTEXT N_("The number of the first segment generated")
 
+#define PART_TEXT N_("Partial segment length (ms)")
+#define PART_LONGTEXT N_("Target length of the low-latency HLS partial "\
+                         "segments, 0 to disable them. Partial segments "\
+                         "need fragmented MP4 (CMAF) input from the mp4frag "\
+                         "muxer, with fragments shorter than this length.")
+
+#define HTTPD_TEXT N_("Serve from memory")
+#define HTTPD_LONGTEXT N_("Serve the index and the segments from memory "\
+                          "through the HTTP server instead of writing files. "\
+                          "The index and segment paths are then used as URLs, "\
+                          "and playlist reloads can block until the requested "\
+                          "segment or partial segment is available. The "\
+                          "number of segments must be limited, old segments "\
+                          "are always deleted.")
+
 vlc_module_begin ()
     set_description( N_("HTTP Live streaming output") )
     set_shortname( N_("LiveHTTP" ))
@@ -115,6 +132,8 @@ vlc_module_begin ()
     add_integer( SOUT_CFG_PREFIX "seglen", 10, SEGLEN_TEXT, SEGLEN_LONGTEXT, false )
     add_integer( SOUT_CFG_PREFIX "numsegs", 0, NUMSEGS_TEXT, NUMSEGS_LONGTEXT, false )
     add_integer( SOUT_CFG_PREFIX "initial-segment-number", 1, INTITIAL_SEG_TEXT, INITIAL_SEG_LONGTEXT, false )
+    add_integer( SOUT_CFG_PREFIX "part-length", 0, PART_TEXT, PART_LONGTEXT, false )
+        change_integer_range( 0, 10000 )
     add_bool( SOUT_CFG_PREFIX "splitanywhere", false,
               SPLITANYWHERE_TEXT, SPLITANYWHERE_LONGTEXT, true )
     add_bool( SOUT_CFG_PREFIX "delsegs", true,
@@ -125,6 +144,8 @@ vlc_module_begin ()
               NOCACHE_TEXT, NOCACHE_LONGTEXT, true )
     add_bool( SOUT_CFG_PREFIX "generate-iv", false,
               RANDOMIV_TEXT, RANDOMIV_LONGTEXT, true )
+    add_bool( SOUT_CFG_PREFIX "httpd", false,
+              HTTPD_TEXT, HTTPD_LONGTEXT, true )
     add_string( SOUT_CFG_PREFIX "index", NULL,
                 INDEX_TEXT, INDEX_LONGTEXT, false )
     add_string( SOUT_CFG_PREFIX "index-url", NULL,
@@ -156,12 +177,22 @@ static const char *const ppsz_sout_options[] = {
     "key-loadfile",
     "generate-iv",
     "initial-segment-number",
+    "part-length",
+    "httpd",
     NULL
 };
 
 static ssize_t Write( sout_access_out_t *, block_t * );
 static int Control( sout_access_out_t *, int, va_list );
 
+typedef struct output_part
+{
+    size_t i_offset;
+    size_t i_size;
+    vlc_tick_t length;
+    bool b_independent;
+} output_part_t;
+
 typedef struct output_segment
 {
     char *psz_filename;
@@ -171,6 +202,17 @@ typedef struct output_segment
     vlc_tick_t segment_length;
     uint32_t i_segment_number;
     uint8_t aes_ivs[16];
+    size_t i_written;
+    output_part_t *p_parts;
+    size_t i_parts;
+
+    /* served from memory, protected by the access lock */
+    sout_access_out_t *p_access;
+    httpd_url_t *p_url;
+    uint8_t *p_data;
+    size_t i_alloc;
+    size_t i_available;
+    bool b_complete;
 } output_segment_t;
 
 typedef struct
@@ -202,6 +244,34 @@ typedef struct
     uint8_t stuffing_bytes[16];
     ssize_t stuffing_size;
     vlc_array_t segments_t;
+    bool b_segment_open;
+
+    /* fragmented MP4 (CMAF) input */
+    bool b_input_checked;
+    bool b_cmaf;
+    block_t *init_segment;
+    block_t **init_segment_end;
+    output_segment_t *p_init;
+    size_t i_fragment_left;
+    vlc_tick_t fragment_length;
+    bool b_fragment_independent;
+    vlc_tick_t ongoing_length;
+    bool b_ongoing_independent;
+
+    /* LL-HLS partial segments */
+    vlc_tick_t part_max_length;
+
+    /* in-memory serving */
+    bool b_httpd;
+    httpd_host_t *p_httpd_host;
+    httpd_url_t *p_index_url;
+    vlc_mutex_t lock;
+    char *psz_index;
+    size_t i_index;
+    uint32_t i_index_segment;
+    size_t i_index_parts;
+    bool b_index_segment_complete;
+    bool b_index_end;
 } sout_access_out_sys_t;
 
 static int LoadCryptFile( sout_access_out_t *p_access);
@@ -209,6 +279,10 @@ static int CryptSetup( sout_access_out_t *p_access, char *keyfile );
 static int CheckSegmentChange( sout_access_out_t *p_access, block_t *p_buffer );
 static ssize_t writeSegment( sout_access_out_t *p_access );
 static ssize_t openNextFile( sout_access_out_t *p_access, sout_access_out_sys_t *p_sys );
+static ssize_t commitFragments( sout_access_out_t *p_access, bool b_part );
+static ssize_t endFragment( sout_access_out_t *p_access );
+static int IndexCallback( httpd_callback_sys_t *, httpd_client_t *,
+                          httpd_message_t *, const httpd_message_t * );
 /*****************************************************************************
  * Open: open the file
  *****************************************************************************/
@@ -247,6 +321,13 @@ static int Open( vlc_object_t *p_this )
     p_sys->b_caching = var_GetBool( p_access, SOUT_CFG_PREFIX "caching") ;
     p_sys->b_generate_iv = var_GetBool( p_access, SOUT_CFG_PREFIX "generate-iv") ;
     p_sys->b_segment_has_data = false;
+    p_sys->part_max_length = VLC_TICK_FROM_MS(
+                var_GetInteger( p_access, SOUT_CFG_PREFIX "part-length" ) );
+    p_sys->b_httpd = var_GetBool( p_access, SOUT_CFG_PREFIX "httpd" );
+
+    p_sys->init_segment = NULL;
+    p_sys->init_segment_end = &p_sys->init_segment;
+    vlc_mutex_init( &p_sys->lock );
 
     vlc_array_init( &p_sys->segments_t );
 
@@ -265,7 +346,7 @@ static int Open( vlc_object_t *p_this )
             return VLC_ENOMEM;
         }
         p_sys->psz_indexPath = psz_tmp;
-        if( p_sys->i_initial_segment != 1 )
+        if( p_sys->i_initial_segment != 1 && !p_sys->b_httpd )
             vlc_unlink( p_sys->psz_indexPath );
     }
 
@@ -292,14 +373,67 @@ static int Open( vlc_object_t *p_this )
         return VLC_EGENERIC;
     }
 
+    if( p_sys->part_max_length && p_sys->key_uri )
+    {
+        msg_Warn( p_access, "partial segments are not supported with encryption" );
+        p_sys->part_max_length = 0;
+    }
+
+    if( p_sys->b_httpd )
+    {
+        if( !p_sys->psz_indexPath || p_sys->psz_indexPath[0] != '/' ||
+            p_access->psz_path[0] != '/' )
+        {
+            msg_Err( p_access, "index and segments need absolute URL paths "
+                     "to be served from memory" );
+            goto error;
+        }
+        if( p_sys->i_numsegs == 0 )
+        {
+            msg_Err( p_access, "the number of segments (numsegs) must be "
+                     "limited to serve them from memory" );
+            goto error;
+        }
+
+        p_sys->p_httpd_host = vlc_http_HostNew( VLC_OBJECT(p_access) );
+        if( !p_sys->p_httpd_host )
+            goto error;
+
+        p_sys->p_index_url = httpd_UrlNew( p_sys->p_httpd_host,
+                                           p_sys->psz_indexPath, NULL, NULL );
+        if( !p_sys->p_index_url )
+        {
+            msg_Err( p_access, "cannot add index URL %s", p_sys->psz_indexPath );
+            httpd_HostDelete( p_sys->p_httpd_host );
+            goto error;
+        }
+        httpd_UrlCatch( p_sys->p_index_url, HTTPD_MSG_HEAD, IndexCallback,
+                        (httpd_callback_sys_t *)p_access );
+        httpd_UrlCatch( p_sys->p_index_url, HTTPD_MSG_GET, IndexCallback,
+                        (httpd_callback_sys_t *)p_access );
+    }
+
     p_sys->i_handle = -1;
     p_sys->i_segment = p_sys->i_initial_segment-1;
+    p_sys->i_index_segment = p_sys->i_segment;
     p_sys->psz_cursegPath = NULL;
 
     p_access->pf_write = Write;
     p_access->pf_control = Control;
 
     return VLC_SUCCESS;
+
+error:
+    if( p_sys->key_uri )
+    {
+        gcry_cipher_close( p_sys->aes_ctx );
+        free( p_sys->key_uri );
+    }
+    free( p_sys->psz_keyfile );
+    free( p_sys->psz_indexUrl );
+    free( p_sys->psz_indexPath );
+    free( p_sys );
+    return VLC_EGENERIC;
 }
 
 /************************************************************************
@@ -499,8 +633,34 @@ static char *formatSegmentPath( char *psz_path, uint32_t i_seg )
     return psz_result;
 }
 
+/*****************************************************************************
+ * formatInitPath: create the initialization segment path name
+ *****************************************************************************/
+static char *formatInitPath( char *psz_path )
+{
+    char *psz_result;
+    char *psz_firstNumSign;
+
+    if ( ! ( psz_result  = vlc_strftime( psz_path ) ) )
+        return NULL;
+
+    psz_firstNumSign = psz_result + strcspn( psz_result, SEG_NUMBER_PLACEHOLDER );
+    int i_cnt = strspn( psz_firstNumSign, SEG_NUMBER_PLACEHOLDER );
+    char *psz_newResult;
+
+    *psz_firstNumSign = '\0';
+    if ( asprintf( &psz_newResult, "%sinit%s", psz_result, psz_firstNumSign + i_cnt ) < 0 )
+        psz_newResult = NULL;
+    free( psz_result );
+    return psz_newResult;
+}
+
 static void destroySegment( output_segment_t *segment )
 {
+    if( segment->p_url )
+        httpd_UrlDelete( segment->p_url );
+    free( segment->p_data );
+    free( segment->p_parts );
     free( segment->psz_filename );
     free( segment->psz_duration );
     free( segment->psz_uri );
@@ -508,6 +668,213 @@ static void destroySegment( output_segment_t *segment )
     free( segment );
 }
 
+/*****************************************************************************
+ * answerMessage: answer a request for in-memory data
+ *****************************************************************************/
+static void answerMessage( httpd_message_t *answer, const httpd_message_t *query,
+                           int i_status, const char *psz_mime,
+                           const void *p_data, size_t i_data )
+{
+    answer->i_proto  = HTTPD_PROTO_HTTP;
+    answer->i_version= 1;
+    answer->i_type   = HTTPD_MSG_ANSWER;
+    answer->i_status = i_status;
+
+    if( query->i_type != HTTPD_MSG_HEAD && i_data > 0 )
+    {
+        answer->p_body = malloc( i_data );
+        if( unlikely( !answer->p_body ) )
+        {
+            answer->i_status = 500;
+            i_data = 0;
+        }
+        else
+        {
+            memcpy( answer->p_body, p_data, i_data );
+            answer->i_body = i_data;
+        }
+    }
+
+    if( psz_mime )
+        httpd_MsgAdd( answer, "Content-Type", "%s", psz_mime );
+    httpd_MsgAdd( answer, "Cache-Control", "no-cache" );
+    if( httpd_MsgGet( query, "Connection" ) != NULL )
+        httpd_MsgAdd( answer, "Connection", "close" );
+    httpd_MsgAdd( answer, "Content-Length", "%zu", i_data );
+}
+
+/*****************************************************************************
+ * IndexCallback: serve the index, blocking until the requested segment
+ * or partial segment is available (LL-HLS _HLS_msn/_HLS_part directives)
+ *****************************************************************************/
+static int IndexCallback( httpd_callback_sys_t *p_cbsys, httpd_client_t *cl,
+                          httpd_message_t *answer, const httpd_message_t *query )
+{
+    sout_access_out_t *p_access = (sout_access_out_t *)p_cbsys;
+    sout_access_out_sys_t *p_sys = p_access->p_sys;
+    VLC_UNUSED(cl);
+
+    if( !answer || !query )
+        return VLC_SUCCESS;
+
+    const char *psz_args = (const char *)query->psz_args;
+    const char *psz_msn = psz_args ? strstr( psz_args, "_HLS_msn=" ) : NULL;
+    const char *psz_part = psz_args ? strstr( psz_args, "_HLS_part=" ) : NULL;
+
+    vlc_mutex_lock( &p_sys->lock );
+    if( psz_msn && !p_sys->b_index_end )
+    {
+        unsigned long i_msn = strtoul( psz_msn + 9, NULL, 10 );
+        unsigned long i_part = psz_part ? strtoul( psz_part + 10, NULL, 10 ) : 0;
+
+        if( i_msn > p_sys->i_index_segment + 2UL )
+        {
+            vlc_mutex_unlock( &p_sys->lock );
+            answerMessage( answer, query, 400, NULL, NULL, 0 );
+            return VLC_SUCCESS;
+        }
+
+        if( i_msn > p_sys->i_index_segment ||
+            ( i_msn == p_sys->i_index_segment &&
+              ( psz_part ? i_part >= p_sys->i_index_parts
+                         : !p_sys->b_index_segment_complete ) ) )
+        {
+            /* not available yet, answer later */
+            vlc_mutex_unlock( &p_sys->lock );
+            return VLC_SUCCESS;
+        }
+    }
+
+    answerMessage( answer, query, p_sys->psz_index ? 200 : 404,
+                   "application/vnd.apple.mpegurl",
+                   p_sys->psz_index, p_sys->i_index );
+    vlc_mutex_unlock( &p_sys->lock );
+    return VLC_SUCCESS;
+}
+
+/*****************************************************************************
+ * SegmentCallback: serve a segment, or a byte range of it
+ *****************************************************************************/
+static int SegmentCallback( httpd_callback_sys_t *p_cbsys, httpd_client_t *cl,
+                            httpd_message_t *answer, const httpd_message_t *query )
+{
+    output_segment_t *segment = (output_segment_t *)p_cbsys;
+    sout_access_out_sys_t *p_sys = segment->p_access->p_sys;
+    VLC_UNUSED(cl);
+
+    if( !answer || !query )
+        return VLC_SUCCESS;
+
+    /* partial segments are byte ranges of their segment */
+    size_t i_start = 0, i_end = SIZE_MAX;
+    const char *psz_range = httpd_MsgGet( query, "Range" );
+    bool b_range = psz_range &&
+        sscanf( psz_range, "bytes=%zu-%zu", &i_start, &i_end ) >= 1;
+    const char *psz_mime = p_sys->b_cmaf ? "video/mp4" : "video/MP2T";
+
+    vlc_mutex_lock( &p_sys->lock );
+    if( !segment->b_complete &&
+        ( !b_range || i_start == segment->i_available ) )
+    {
+        /* wait for the whole segment, or for its next partial segment
+         * (preload hint) */
+        vlc_mutex_unlock( &p_sys->lock );
+        return VLC_SUCCESS;
+    }
+
+    if( !b_range )
+        answerMessage( answer, query, 200, psz_mime,
+                       segment->p_data, segment->i_available );
+    else if( i_start >= segment->i_available || i_end < i_start )
+    {
+        answerMessage( answer, query, 416, NULL, NULL, 0 );
+        httpd_MsgAdd( answer, "Content-Range", "bytes */%zu",
+                      segment->i_available );
+    }
+    else
+    {
+        i_end = __MIN( i_end, segment->i_available - 1 );
+        answerMessage( answer, query, 206, psz_mime,
+                       &segment->p_data[i_start], i_end - i_start + 1 );
+        if( segment->b_complete )
+            httpd_MsgAdd( answer, "Content-Range", "bytes %zu-%zu/%zu",
+                          i_start, i_end, segment->i_available );
+        else
+            httpd_MsgAdd( answer, "Content-Range", "bytes %zu-%zu/*",
+                          i_start, i_end );
+    }
+    vlc_mutex_unlock( &p_sys->lock );
+    return VLC_SUCCESS;
+}
+
+/*****************************************************************************
+ * segmentUrlNew: serve a segment from memory
+ *****************************************************************************/
+static int segmentUrlNew( sout_access_out_t *p_access, output_segment_t *segment )
+{
+    sout_access_out_sys_t *p_sys = p_access->p_sys;
+
+    segment->p_access = p_access;
+    segment->p_url = httpd_UrlNew( p_sys->p_httpd_host, segment->psz_filename,
+                                   NULL, NULL );
+    if( !segment->p_url )
+    {
+        msg_Err( p_access, "cannot add segment URL %s", segment->psz_filename );
+        return VLC_EGENERIC;
+    }
+    httpd_UrlCatch( segment->p_url, HTTPD_MSG_HEAD, SegmentCallback,
+                    (httpd_callback_sys_t *)segment );
+    httpd_UrlCatch( segment->p_url, HTTPD_MSG_GET, SegmentCallback,
+                    (httpd_callback_sys_t *)segment );
+    return VLC_SUCCESS;
+}
+
+/*****************************************************************************
+ * segmentWrite: append data to the segment file, or to its in-memory copy
+ *****************************************************************************/
+static ssize_t segmentWrite( sout_access_out_sys_t *p_sys, output_segment_t *segment,
+                             const uint8_t *p_data, size_t i_data )
+{
+    if( !p_sys->b_httpd )
+    {
+        ssize_t val = vlc_write( p_sys->i_handle, p_data, i_data );
+        if( val > 0 )
+            segment->i_written += val;
+        return val;
+    }
+
+    vlc_mutex_lock( &p_sys->lock );
+    if( segment->i_written + i_data > segment->i_alloc )
+    {
+        size_t i_alloc = __MAX( 2 * segment->i_alloc, segment->i_written + i_data );
+        uint8_t *p_realloc = realloc( segment->p_data, i_alloc );
+        if( unlikely( !p_realloc ) )
+        {
+            vlc_mutex_unlock( &p_sys->lock );
+            errno = ENOMEM;
+            return -1;
+        }
+        segment->p_data = p_realloc;
+        segment->i_alloc = i_alloc;
+    }
+    memcpy( &segment->p_data[segment->i_written], p_data, i_data );
+    segment->i_written += i_data;
+    vlc_mutex_unlock( &p_sys->lock );
+    return i_data;
+}
+
+/*****************************************************************************
+ * segmentPublish: make the written data available to the HTTP clients
+ *****************************************************************************/
+static void segmentPublish( sout_access_out_sys_t *p_sys, output_segment_t *segment,
+                            bool b_complete )
+{
+    vlc_mutex_lock( &p_sys->lock );
+    segment->i_available = segment->i_written;
+    segment->b_complete = b_complete;
+    vlc_mutex_unlock( &p_sys->lock );
+}
+
 /************************************************************************
  * segmentAmountNeeded: check that playlist has atleast 3*p_sys->segment_max_length of segments
  * return how many segments are needed for that (max of p_sys->i_segment )
@@ -575,30 +942,33 @@ static int updateIndexAndDel( sout_access_out_t *p_access, sout_access_out_sys_t
     if ( p_sys->psz_indexPath )
     {
         int val;
-        FILE *fp;
-        char *psz_idxTmp;
-        if ( asprintf( &psz_idxTmp, "%s.tmp", p_sys->psz_indexPath ) < 0)
-            return -1;
-
-        fp = vlc_fopen( psz_idxTmp, "wt");
-        if ( !fp )
+        struct vlc_memstream ms;
+        const unsigned i_version = p_sys->part_max_length ? 9 : p_sys->b_cmaf ? 6 : 3;
+
+        vlc_memstream_open( &ms );
+        vlc_memstream_printf( &ms, "#EXTM3U\n#EXT-X-TARGETDURATION:%.0f\n#EXT-X-VERSION:%u\n",
+                              ceil(secf_from_vlc_tick( p_sys->segment_max_length )), i_version );
+        /* removed from the protocol version 7 */
+        if ( i_version < 7 )
+            vlc_memstream_printf( &ms, "#EXT-X-ALLOW-CACHE:%s\n", p_sys->b_caching ? "YES" : "NO" );
+        vlc_memstream_printf( &ms, "%s#EXT-X-MEDIA-SEQUENCE:%"PRIu32"\n",
+                              p_sys->i_numsegs > 0 ? "" : b_isend ? "#EXT-X-PLAYLIST-TYPE:VOD\n" : "#EXT-X-PLAYLIST-TYPE:EVENT\n",
+                              i_firstseg );
+        if ( p_sys->part_max_length )
         {
-            msg_Err( p_access, "cannot open index file `%s'", psz_idxTmp );
-            free( psz_idxTmp );
-            return -1;
+            /* LL-HLS: players stay 3 partial segments behind the live edge */
+            const int64_t i_part_ms = MS_FROM_VLC_TICK( p_sys->part_max_length );
+            vlc_memstream_printf( &ms, "#EXT-X-SERVER-CONTROL:%sPART-HOLD-BACK=%"PRId64".%03"PRId64"\n"
+                                  "#EXT-X-PART-INF:PART-TARGET=%"PRId64".%03"PRId64"\n",
+                                  p_sys->b_httpd ? "CAN-BLOCK-RELOAD=YES," : "",
+                                  3 * i_part_ms / 1000, 3 * i_part_ms % 1000,
+                                  i_part_ms / 1000, i_part_ms % 1000 );
         }
+        if ( p_sys->p_init )
+            vlc_memstream_printf( &ms, "#EXT-X-MAP:URI=\"%s\"\n", p_sys->p_init->psz_uri );
+        if ( (p_sys->i_initial_segment > 1) && (p_sys->i_initial_segment == i_firstseg) )
+            vlc_memstream_puts( &ms, "#EXT-X-DISCONTINUITY\n" );
 
-        if ( fprintf( fp, "#EXTM3U\n#EXT-X-TARGETDURATION:%.0f\n#EXT-X-VERSION:3\n#EXT-X-ALLOW-CACHE:%s"
-                          "%s\n#EXT-X-MEDIA-SEQUENCE:%"PRIu32"\n%s", ceil(secf_from_vlc_tick( p_sys->segment_max_length )) ,
-                          p_sys->b_caching ? "YES" : "NO",
-                          p_sys->i_numsegs > 0 ? "" : b_isend ? "\n#EXT-X-PLAYLIST-TYPE:VOD" : "\n#EXT-X-PLAYLIST-TYPE:EVENT",
-                          i_firstseg, ((p_sys->i_initial_segment > 1) && (p_sys->i_initial_segment == i_firstseg)) ? "#EXT-X-DISCONTINUITY\n" : ""
-                          ) < 0 )
-        {
-            free( psz_idxTmp );
-            fclose( fp );
-            return -1;
-        }
         char *psz_current_uri=NULL;
 
 
@@ -612,7 +982,6 @@ static int updateIndexAndDel( sout_access_out_t *p_access, sout_access_out_sys_t
                 ( !psz_current_uri ||  strcmp( psz_current_uri, segment->psz_key_uri ) )
               )
             {
-                int ret = 0;
                 free( psz_current_uri );
                 psz_current_uri = strdup( segment->psz_key_uri );
                 if( p_sys->b_generate_iv )
@@ -626,60 +995,105 @@ static int updateIndexAndDel( sout_access_out_t *p_access, sout_access_out_sys_t
                         iv_lo <<= 8;
                         iv_lo |= segment->aes_ivs[8+j] & 0xff;
                     }
-                    ret = fprintf( fp, "#EXT-X-KEY:METHOD=AES-128,URI=\"%s\",IV=0X%16.16llx%16.16llx\n",
-                                   segment->psz_key_uri, iv_hi, iv_lo );
+                    vlc_memstream_printf( &ms, "#EXT-X-KEY:METHOD=AES-128,URI=\"%s\",IV=0X%16.16llx%16.16llx\n",
+                                          segment->psz_key_uri, iv_hi, iv_lo );
 
                 } else {
-                    ret = fprintf( fp, "#EXT-X-KEY:METHOD=AES-128,URI=\"%s\"\n", segment->psz_key_uri );
-                }
-                if( ret < 0 )
-                {
-                    free( psz_current_uri );
-                    free( psz_idxTmp );
-                    fclose( fp );
-                    return -1;
+                    vlc_memstream_printf( &ms, "#EXT-X-KEY:METHOD=AES-128,URI=\"%s\"\n", segment->psz_key_uri );
                 }
             }
 
-            val = fprintf( fp, "#EXTINF:%s,\n%s\n", segment->psz_duration, segment->psz_uri);
-            if ( val < 0 )
+            /* Partial segments are only listed near the live edge */
+            for( size_t j = 0; p_sys->i_segment - i < 3 && j < segment->i_parts; j++ )
             {
-                free( psz_current_uri );
-                free( psz_idxTmp );
-                fclose( fp );
-                return -1;
+                const output_part_t *part = &segment->p_parts[j];
+                const int64_t i_part_ms = MS_FROM_VLC_TICK( part->length );
+
+                vlc_memstream_printf( &ms, "#EXT-X-PART:DURATION=%"PRId64".%03"PRId64",URI=\"%s\","
+                                      "BYTERANGE=%zu@%zu%s\n", i_part_ms / 1000, i_part_ms % 1000,
+                                      segment->psz_uri, part->i_size, part->i_offset,
+                                      part->b_independent ? ",INDEPENDENT=YES" : "" );
             }
+
+            /* The ongoing segment only has partial segments */
+            if( segment->psz_duration )
+                vlc_memstream_printf( &ms, "#EXTINF:%s,\n%s\n", segment->psz_duration, segment->psz_uri );
         }
         free( psz_current_uri );
 
+        if ( p_sys->part_max_length && p_sys->b_segment_open && !b_isend )
+        {
+            output_segment_t *segment = vlc_array_item_at_index( &p_sys->segments_t, vlc_array_count( &p_sys->segments_t ) - 1 );
+            vlc_memstream_printf( &ms, "#EXT-X-PRELOAD-HINT:TYPE=PART,URI=\"%s\",BYTERANGE-START=%zu\n",
+                                  segment->psz_uri, segment->i_written );
+        }
+
         if ( b_isend )
+            vlc_memstream_puts( &ms, STR_ENDLIST );
+
+        if ( vlc_memstream_close( &ms ) )
+            return -1;
+
+        if ( p_sys->b_httpd )
         {
-            if ( fputs ( STR_ENDLIST, fp ) < 0)
+            output_segment_t *segment = vlc_array_item_at_index( &p_sys->segments_t, vlc_array_count( &p_sys->segments_t ) - 1 );
+
+            vlc_mutex_lock( &p_sys->lock );
+            free( p_sys->psz_index );
+            p_sys->psz_index = ms.ptr;
+            p_sys->i_index = ms.length;
+            p_sys->i_index_segment = p_sys->i_segment;
+            p_sys->i_index_parts = segment->i_parts;
+            p_sys->b_index_segment_complete = !p_sys->b_segment_open;
+            p_sys->b_index_end = b_isend;
+            vlc_mutex_unlock( &p_sys->lock );
+        }
+        else
+        {
+            FILE *fp;
+            char *psz_idxTmp;
+            if ( asprintf( &psz_idxTmp, "%s.tmp", p_sys->psz_indexPath ) < 0)
+            {
+                free( ms.ptr );
+                return -1;
+            }
+
+            fp = vlc_fopen( psz_idxTmp, "wt");
+            if ( !fp )
             {
+                msg_Err( p_access, "cannot open index file `%s'", psz_idxTmp );
                 free( psz_idxTmp );
-                fclose( fp ) ;
+                free( ms.ptr );
                 return -1;
             }
 
-        }
-        fclose( fp );
+            val = fwrite( ms.ptr, 1, ms.length, fp ) == ms.length ? 0 : -1;
+            free( ms.ptr );
+            if ( fclose( fp ) || val < 0 )
+            {
+                vlc_unlink( psz_idxTmp );
+                free( psz_idxTmp );
+                return -1;
+            }
 
-        val = vlc_rename ( psz_idxTmp, p_sys->psz_indexPath);
+            val = vlc_rename ( psz_idxTmp, p_sys->psz_indexPath);
 
-        if ( val < 0 )
-        {
-            vlc_unlink( psz_idxTmp );
-            msg_Err( p_access, "Error moving LiveHttp index file" );
-        }
-        else
-            msg_Dbg( p_access, "LiveHttpIndexComplete: %s" , p_sys->psz_indexPath );
+            if ( val < 0 )
+            {
+                vlc_unlink( psz_idxTmp );
+                msg_Err( p_access, "Error moving LiveHttp index file" );
+            }
+            else
+                msg_Dbg( p_access, "LiveHttpIndexComplete: %s" , p_sys->psz_indexPath );
 
-        free( psz_idxTmp );
+            free( psz_idxTmp );
+        }
     }
 
     // Then take care of deletion
     // Try to follow pantos draft 11 section 6.2.2
-    while( p_sys->b_delsegs && p_sys->i_numsegs &&
+    // Segments served from memory are always deleted
+    while( ( p_sys->b_delsegs || p_sys->b_httpd ) && p_sys->i_numsegs &&
            isFirstItemRemovable( p_sys, i_firstseg, i_index_offset )
          )
     {
@@ -687,7 +1101,7 @@ static int updateIndexAndDel( sout_access_out_t *p_access, sout_access_out_sys_t
          msg_Dbg( p_access, "Removing segment number %d", segment->i_segment_number );
          vlc_array_remove( &p_sys->segments_t, 0 );
 
-         if ( segment->psz_filename )
+         if ( segment->psz_filename && !p_sys->b_httpd )
          {
              vlc_unlink( segment->psz_filename );
          }
@@ -705,7 +1119,7 @@ static int updateIndexAndDel( sout_access_out_t *p_access, sout_access_out_sys_t
  *****************************************************************************/
 static void closeCurrentSegment( sout_access_out_t *p_access, sout_access_out_sys_t *p_sys, bool b_isend )
 {
-    if ( p_sys->i_handle >= 0 )
+    if ( p_sys->b_segment_open )
     {
         output_segment_t *segment = vlc_array_item_at_index( &p_sys->segments_t, vlc_array_count( &p_sys->segments_t ) - 1 );
 
@@ -719,7 +1133,7 @@ static void closeCurrentSegment( sout_access_out_t *p_access, sout_access_out_sy
                msg_Err( p_access, "Couldn't encrypt 16 bytes: %s", gpg_strerror(err) );
             } else {
 
-            int ret = vlc_write( p_sys->i_handle, p_sys->stuffing_bytes, 16 );
+            ssize_t ret = segmentWrite( p_sys, segment, p_sys->stuffing_bytes, 16 );
             if( ret != 16 )
                 msg_Err( p_access, "Couldn't write 16 bytes" );
             }
@@ -727,8 +1141,13 @@ static void closeCurrentSegment( sout_access_out_t *p_access, sout_access_out_sy
         }
 
 
-        vlc_close( p_sys->i_handle );
-        p_sys->i_handle = -1;
+        if( !p_sys->b_httpd )
+        {
+            vlc_close( p_sys->i_handle );
+            p_sys->i_handle = -1;
+        }
+        p_sys->b_segment_open = false;
+        segmentPublish( p_sys, segment, true );
 
         if( ! ( us_asprintf( &segment->psz_duration, "%.2f", secf_from_vlc_tick( p_sys->current_segment_length )) ) )
         {
@@ -757,38 +1176,49 @@ static void Close( vlc_object_t * p_this )
     sout_access_out_t *p_access = (sout_access_out_t*)p_this;
     sout_access_out_sys_t *p_sys = p_access->p_sys;
 
-    if( p_sys->ongoing_segment )
-        block_ChainLastAppend( &p_sys->full_segments_end, p_sys->ongoing_segment );
-    p_sys->ongoing_segment = NULL;
-    p_sys->ongoing_segment_end = &p_sys->ongoing_segment;
-
-    block_t *output_block = p_sys->full_segments;
-    p_sys->full_segments = NULL;
-    p_sys->full_segments_end = &p_sys->full_segments;
-
-    while( output_block )
+    if( p_sys->b_cmaf )
     {
-        block_t *p_next = output_block->p_next;
-        output_block->p_next = NULL;
-
-        Write( p_access, output_block );
-        output_block = p_next;
+        /* last fragment and partial segment */
+        if( p_sys->i_fragment_left )
+            endFragment( p_access );
+        if( commitFragments( p_access, p_sys->part_max_length != 0 ) < 0 )
+            msg_Err( p_access, "Error writing the last fragments" );
     }
-    if( p_sys->ongoing_segment )
+    else
     {
-        block_ChainLastAppend( &p_sys->full_segments_end, p_sys->ongoing_segment );
+        if( p_sys->ongoing_segment )
+            block_ChainLastAppend( &p_sys->full_segments_end, p_sys->ongoing_segment );
         p_sys->ongoing_segment = NULL;
         p_sys->ongoing_segment_end = &p_sys->ongoing_segment;
-    }
 
-    ssize_t writevalue = writeSegment( p_access );
-    msg_Dbg( p_access, "Writing.. %zd", writevalue );
-    if( unlikely( writevalue < 0 ) )
-    {
-        if( p_sys->full_segments )
-            block_ChainRelease( p_sys->full_segments );
+        block_t *output_block = p_sys->full_segments;
+        p_sys->full_segments = NULL;
+        p_sys->full_segments_end = &p_sys->full_segments;
+
+        while( output_block )
+        {
+            block_t *p_next = output_block->p_next;
+            output_block->p_next = NULL;
+
+            Write( p_access, output_block );
+            output_block = p_next;
+        }
         if( p_sys->ongoing_segment )
-            block_ChainRelease( p_sys->ongoing_segment );
+        {
+            block_ChainLastAppend( &p_sys->full_segments_end, p_sys->ongoing_segment );
+            p_sys->ongoing_segment = NULL;
+            p_sys->ongoing_segment_end = &p_sys->ongoing_segment;
+        }
+
+        ssize_t writevalue = writeSegment( p_access );
+        msg_Dbg( p_access, "Writing.. %zd", writevalue );
+        if( unlikely( writevalue < 0 ) )
+        {
+            if( p_sys->full_segments )
+                block_ChainRelease( p_sys->full_segments );
+            if( p_sys->ongoing_segment )
+                block_ChainRelease( p_sys->ongoing_segment );
+        }
     }
 
     closeCurrentSegment( p_access, p_sys, true );
@@ -799,11 +1229,15 @@ static void Close( vlc_object_t * p_this )
         free( p_sys->key_uri );
     }
 
+    if( p_sys->p_index_url )
+        httpd_UrlDelete( p_sys->p_index_url );
+
     while( vlc_array_count( &p_sys->segments_t ) > 0 )
     {
         output_segment_t *segment = vlc_array_item_at_index( &p_sys->segments_t, 0 );
         vlc_array_remove( &p_sys->segments_t, 0 );
-        if( p_sys->b_delsegs && p_sys->i_numsegs && segment->psz_filename )
+        if( p_sys->b_delsegs && p_sys->i_numsegs && segment->psz_filename &&
+            !p_sys->b_httpd )
         {
             msg_Dbg( p_access, "Removing segment number %d name %s", segment->i_segment_number, segment->psz_filename );
             vlc_unlink( segment->psz_filename );
@@ -812,6 +1246,19 @@ static void Close( vlc_object_t * p_this )
         destroySegment( segment );
     }
 
+    if( p_sys->p_init )
+    {
+        if( p_sys->b_delsegs && p_sys->i_numsegs && !p_sys->b_httpd )
+            vlc_unlink( p_sys->p_init->psz_filename );
+        destroySegment( p_sys->p_init );
+    }
+    if( p_sys->init_segment )
+        block_ChainRelease( p_sys->init_segment );
+
+    if( p_sys->p_httpd_host )
+        httpd_HostDelete( p_sys->p_httpd_host );
+
+    free( p_sys->psz_index );
     free( p_sys->psz_indexUrl );
     free( p_sys->psz_indexPath );
     free( p_sys );
@@ -844,7 +1291,7 @@ static int Control( sout_access_out_t *p_access, int i_query, va_list args )
  *****************************************************************************/
 static ssize_t openNextFile( sout_access_out_t *p_access, sout_access_out_sys_t *p_sys )
 {
-    int fd;
+    int fd = -1;
 
     uint32_t i_newseg = p_sys->i_segment + 1;
 
@@ -865,9 +1312,16 @@ static ssize_t openNextFile( sout_access_out_t *p_access, sout_access_out_sys_t
         return -1;
     }
 
-    fd = vlc_open( segment->psz_filename, O_WRONLY | O_CREAT | O_LARGEFILE |
-                     O_TRUNC, 0666 );
-    if ( fd == -1 )
+    if ( p_sys->b_httpd )
+    {
+        if ( segmentUrlNew( p_access, segment ) )
+        {
+            destroySegment( segment );
+            return -1;
+        }
+    }
+    else if ( ( fd = vlc_open( segment->psz_filename, O_WRONLY | O_CREAT |
+                               O_LARGEFILE | O_TRUNC, 0666 ) ) == -1 )
     {
         msg_Err( p_access, "cannot open `%s' (%s)", segment->psz_filename,
                  vlc_strerror_c(errno) );
@@ -895,7 +1349,10 @@ static ssize_t openNextFile( sout_access_out_t *p_access, sout_access_out_sys_t
     p_sys->i_handle = fd;
     p_sys->i_segment = i_newseg;
     p_sys->b_segment_has_data = false;
-    return fd;
+    p_sys->b_segment_open = true;
+    if( p_sys->b_cmaf )
+        p_sys->current_segment_length = 0;
+    return p_sys->b_httpd ? 0 : fd;
 }
 /*****************************************************************************
  * CheckSegmentChange: Check if segment needs to be closed and new opened
@@ -911,7 +1368,7 @@ static int CheckSegmentChange( sout_access_out_t *p_access, block_t *p_buffer )
     block_ChainProperties( p_sys->full_segments, NULL, NULL, &current_length );
     block_ChainProperties( p_sys->ongoing_segment, NULL, NULL, &ongoing_length );
 
-    if( p_sys->i_handle > 0 &&
+    if( p_sys->b_segment_open &&
        (( p_buffer->i_length + current_length + ongoing_length ) >= p_sys->segment_max_length ) )
     {
         writevalue = writeSegment( p_access );
@@ -924,7 +1381,7 @@ static int CheckSegmentChange( sout_access_out_t *p_access, block_t *p_buffer )
         return writevalue;
     }
 
-    if ( unlikely( p_sys->i_handle < 0 ) )
+    if ( unlikely( !p_sys->b_segment_open ) )
     {
         if ( openNextFile( p_access, p_sys ) < 0 )
            return -1;
@@ -937,16 +1394,23 @@ static ssize_t writeSegment( sout_access_out_t *p_access )
     sout_access_out_sys_t *p_sys = p_access->p_sys;
     msg_Dbg( p_access, "Writing all full segments" );
 
+    if( !p_sys->b_segment_open )
+        return p_sys->full_segments ? -1 : 0;
+
+    output_segment_t *segment = vlc_array_item_at_index( &p_sys->segments_t, vlc_array_count( &p_sys->segments_t ) - 1 );
     block_t *output = p_sys->full_segments;
     p_sys->full_segments = NULL;
     p_sys->full_segments_end = &p_sys->full_segments;
 
-    vlc_tick_t current_length = 0;
-    block_ChainProperties( output, NULL, NULL, &current_length );
-
     ssize_t i_write=0;
     bool crypted = false;
-    p_sys->current_segment_length = current_length;
+    if( !p_sys->b_cmaf )
+    {
+        /* fragmented MP4 segments are written in several times */
+        vlc_tick_t current_length = 0;
+        block_ChainProperties( output, NULL, NULL, &current_length );
+        p_sys->current_segment_length = current_length;
+    }
     while( output )
     {
         if( p_sys->key_uri && !crypted )
@@ -980,7 +1444,7 @@ static ssize_t writeSegment( sout_access_out_t *p_access )
 
         }
 
-        ssize_t val = vlc_write( p_sys->i_handle, output->p_buffer, output->i_buffer );
+        ssize_t val = segmentWrite( p_sys, segment, output->p_buffer, output->i_buffer );
         if ( val == -1 )
         {
            if ( errno == EINTR )
@@ -1006,6 +1470,250 @@ static ssize_t writeSegment( sout_access_out_t *p_access )
     return i_write;
 }
 
+/*****************************************************************************
+ * writeInitSegment: write the fragmented MP4 initialization segment
+ *****************************************************************************/
+static int writeInitSegment( sout_access_out_t *p_access )
+{
+    sout_access_out_sys_t *p_sys = p_access->p_sys;
+
+    block_t *p_init = block_ChainGather( p_sys->init_segment );
+    p_sys->init_segment = NULL;
+    p_sys->init_segment_end = &p_sys->init_segment;
+    if( unlikely( !p_init ) )
+        return -1;
+
+    output_segment_t *segment = calloc( 1, sizeof( *segment ) );
+    if( unlikely( !segment ) )
+    {
+        block_Release( p_init );
+        return -1;
+    }
+
+    segment->psz_filename = formatInitPath( p_access->psz_path );
+    char *psz_idxFormat = p_sys->psz_indexUrl ? p_sys->psz_indexUrl : p_access->psz_path;
+    segment->psz_uri = formatInitPath( psz_idxFormat );
+    if( unlikely( !segment->psz_filename || !segment->psz_uri ) )
+        goto error;
+
+    if( p_sys->b_httpd )
+    {
+        segment->p_data = malloc( p_init->i_buffer );
+        if( unlikely( !segment->p_data ) )
+            goto error;
+        memcpy( segment->p_data, p_init->p_buffer, p_init->i_buffer );
+        segment->i_written = segment->i_available = p_init->i_buffer;
+        segment->b_complete = true;
+        if( segmentUrlNew( p_access, segment ) )
+            goto error;
+    }
+    else
+    {
+        int fd = vlc_open( segment->psz_filename, O_WRONLY | O_CREAT |
+                           O_LARGEFILE | O_TRUNC, 0666 );
+        if( fd == -1 )
+        {
+            msg_Err( p_access, "cannot open `%s' (%s)", segment->psz_filename,
+                     vlc_strerror_c(errno) );
+            goto error;
+        }
+        ssize_t val = vlc_write( fd, p_init->p_buffer, p_init->i_buffer );
+        vlc_close( fd );
+        if( val < 0 || (size_t)val != p_init->i_buffer )
+        {
+            msg_Err( p_access, "cannot write `%s'", segment->psz_filename );
+            goto error;
+        }
+    }
+
+    msg_Dbg( p_access, "Initialization segment: %s", segment->psz_filename );
+    block_Release( p_init );
+    p_sys->p_init = segment;
+    return 0;
+
+error:
+    block_Release( p_init );
+    destroySegment( segment );
+    return -1;
+}
+
+/*****************************************************************************
+ * commitFragments: write the ongoing fragments to the segment, as a partial
+ * segment if b_part is set
+ *****************************************************************************/
+static ssize_t commitFragments( sout_access_out_t *p_access, bool b_part )
+{
+    sout_access_out_sys_t *p_sys = p_access->p_sys;
+
+    if( !p_sys->ongoing_segment || !p_sys->b_segment_open )
+        return 0;
+
+    output_segment_t *segment = vlc_array_item_at_index( &p_sys->segments_t, vlc_array_count( &p_sys->segments_t ) - 1 );
+    size_t i_offset = segment->i_written;
+
+    block_ChainLastAppend( &p_sys->full_segments_end, p_sys->ongoing_segment );
+    p_sys->ongoing_segment = NULL;
+    p_sys->ongoing_segment_end = &p_sys->ongoing_segment;
+
+    ssize_t writevalue = writeSegment( p_access );
+    if( unlikely( writevalue < 0 ) )
+        return writevalue;
+
+    p_sys->current_segment_length += p_sys->ongoing_length;
+    p_sys->b_segment_has_data = true;
+
+    if( b_part )
+    {
+        output_part_t *p_parts = realloc( segment->p_parts,
+                                          ( segment->i_parts + 1 ) * sizeof( *p_parts ) );
+        if( likely( p_parts ) )
+        {
+            output_part_t *part = &p_parts[segment->i_parts++];
+            part->i_offset = i_offset;
+            part->i_size = segment->i_written - i_offset;
+            part->length = p_sys->ongoing_length;
+            part->b_independent = p_sys->b_ongoing_independent;
+            segment->p_parts = p_parts;
+
+            if( part->length > p_sys->part_max_length )
+                msg_Warn( p_access, "partial segment longer than %"PRId64" ms, "
+                          "the muxer fragments are too long",
+                          MS_FROM_VLC_TICK( p_sys->part_max_length ) );
+        }
+    }
+    p_sys->ongoing_length = 0;
+
+    segmentPublish( p_sys, segment, false );
+    if( b_part )
+        updateIndexAndDel( p_access, p_sys, false );
+    return writevalue;
+}
+
+/*****************************************************************************
+ * endFragment: the whole fragment was received
+ *****************************************************************************/
+static ssize_t endFragment( sout_access_out_t *p_access )
+{
+    sout_access_out_sys_t *p_sys = p_access->p_sys;
+
+    p_sys->i_fragment_left = 0;
+    p_sys->ongoing_length += p_sys->fragment_length;
+
+    /* Publish the partial segment when another fragment would not fit */
+    if( p_sys->part_max_length &&
+        p_sys->ongoing_length + p_sys->fragment_length > p_sys->part_max_length )
+        return commitFragments( p_access, true );
+    return 0;
+}
+
+/*****************************************************************************
+ * startFragment: a fragment starts with this moof, check if segment needs
+ * to be closed and new opened
+ *****************************************************************************/
+static ssize_t startFragment( sout_access_out_t *p_access, block_t *p_moof )
+{
+    sout_access_out_sys_t *p_sys = p_access->p_sys;
+    ssize_t writevalue = 0;
+
+    if( p_sys->i_fragment_left )
+    {
+        writevalue = endFragment( p_access );
+        if( unlikely( writevalue < 0 ) )
+            return writevalue;
+    }
+
+    /* the muxer gives the fragment timing, and flags the fragments which
+     * start on a keyframe */
+    p_sys->fragment_length = p_moof->i_length;
+    p_sys->b_fragment_independent = p_moof->i_flags & BLOCK_FLAG_TYPE_I;
+
+    if( p_sys->b_segment_open && p_sys->b_fragment_independent &&
+        ( p_sys->current_segment_length || p_sys->ongoing_segment ) &&
+        ( p_sys->current_segment_length + p_sys->ongoing_length +
+          p_sys->fragment_length ) >= p_sys->segment_max_length )
+    {
+        ssize_t ret = commitFragments( p_access, p_sys->part_max_length != 0 );
+        if( unlikely( ret < 0 ) )
+            return ret;
+        writevalue += ret;
+        closeCurrentSegment( p_access, p_sys, false );
+    }
+
+    if( !p_sys->b_segment_open && openNextFile( p_access, p_sys ) < 0 )
+        return -1;
+
+    if( !p_sys->ongoing_segment )
+        p_sys->b_ongoing_independent = p_sys->b_fragment_independent;
+    p_sys->i_fragment_left = SIZE_MAX; /* until the mdat header */
+    return writevalue;
+}
+
+/*****************************************************************************
+ * WriteFragmented: write fragmented MP4 (CMAF), splitting segments and
+ * partial segments on fragment boundaries
+ *****************************************************************************/
+static ssize_t WriteFragmented( sout_access_out_t *p_access, block_t *p_buffer )
+{
+    size_t i_write = 0;
+    sout_access_out_sys_t *p_sys = p_access->p_sys;
+    while( p_buffer )
+    {
+        block_t *p_temp = p_buffer->p_next;
+        p_buffer->p_next = NULL;
+
+        if( p_buffer->i_flags & BLOCK_FLAG_HEADER )
+        {
+            /* ftyp and moov */
+            block_ChainLastAppend( &p_sys->init_segment_end, p_buffer );
+            p_buffer = p_temp;
+            continue;
+        }
+
+        if( !p_sys->p_init && p_sys->init_segment &&
+            writeInitSegment( p_access ) < 0 )
+            msg_Err( p_access, "Error writing the initialization segment" );
+
+        ssize_t ret = 0;
+        /* only the moof boxes have a frame type */
+        if( p_buffer->i_flags & BLOCK_FLAG_TYPE_MASK )
+            ret = startFragment( p_access, p_buffer );
+        else if( p_sys->i_fragment_left == SIZE_MAX &&
+                 p_buffer->i_buffer >= 8 &&
+                 !memcmp( &p_buffer->p_buffer[4], "mdat", 4 ) )
+            p_sys->i_fragment_left = GetDWBE( p_buffer->p_buffer );
+
+        if( ret < 0 )
+        {
+            msg_Err( p_access, "Error in write loop");
+            block_Release( p_buffer );
+            block_ChainRelease( p_temp );
+            return ret;
+        }
+        i_write += ret;
+
+        size_t i_buffer = p_buffer->i_buffer;
+        block_ChainLastAppend( &p_sys->ongoing_segment_end, p_buffer );
+        p_buffer = p_temp;
+
+        if( p_sys->i_fragment_left != SIZE_MAX && p_sys->i_fragment_left )
+        {
+            p_sys->i_fragment_left -= __MIN( p_sys->i_fragment_left, i_buffer );
+            if( p_sys->i_fragment_left == 0 )
+            {
+                ret = endFragment( p_access );
+                if( ret < 0 )
+                {
+                    block_ChainRelease( p_buffer );
+                    return ret;
+                }
+                i_write += ret;
+            }
+        }
+    }
+
+    return i_write;
+}
+
 /*****************************************************************************
  * Write: standard write on a file descriptor.
  *****************************************************************************/
@@ -1013,6 +1721,22 @@ static ssize_t Write( sout_access_out_t *p_access, block_t *p_buffer )
 {
     size_t i_write = 0;
     sout_access_out_sys_t *p_sys = p_access->p_sys;
+
+    if( !p_sys->b_input_checked && p_buffer )
+    {
+        p_sys->b_input_checked = true;
+        p_sys->b_cmaf = ( p_buffer->i_flags & BLOCK_FLAG_HEADER ) &&
+                        p_buffer->i_buffer >= 8 &&
+                        !memcmp( &p_buffer->p_buffer[4], "ftyp", 4 );
+        if( !p_sys->b_cmaf && p_sys->part_max_length )
+        {
+            msg_Warn( p_access, "partial segments need fragmented MP4 input" );
+            p_sys->part_max_length = 0;
+        }
+    }
+    if( p_sys->b_cmaf )
+        return WriteFragmented( p_access, p_buffer );
+
     while( p_buffer )
     {
         /* Check if current block is already past segment-length
@@ -0,0 +1,161 @@
+/*****************************************************************************
+ * biquad.h: multi-channel biquad filters
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef VLC_AUDIO_FILTER_BIQUAD_H
+#define VLC_AUDIO_FILTER_BIQUAD_H 1
+
+/* Biquad (second order IIR) sections applied to interleaved float samples.
+ *
+ * The channels of a sample frame are processed together, one channel per
+ * SIMD lane, so that 4 (SSE, NEON) or 8 (AVX) channels are filtered by each
+ * instruction. Two topologies are supported:
+ *  - a cascade of direct form 1 sections (parametric equalizer),
+ *  - a bank of band-pass sections sharing the same input, whose outputs are
+ *    mixed with the dry signal (graphic equalizer). */
+
+#include <stdlib.h>
+#include <string.h>
+#include <vlc_cpu.h>
+
+#define BIQUAD_MAX_SECTIONS 32
+
+#if defined __has_attribute
+#  if __has_attribute(__vector_size__)
+#    define BIQUAD_HAS_VECTORSIZE
+#  endif
+#endif
+
+#if defined(CAN_COMPILE_SSE2) && defined(BIQUAD_HAS_VECTORSIZE)
+#  define BIQUAD_X86 1
+#  ifdef __AVX__
+#    define BIQUAD_AVX
+#  else
+#    define BIQUAD_AVX __attribute__ ((__target__ ("avx")))
+#  endif
+#endif
+
+typedef struct biquad biquad_t;
+
+struct biquad
+{
+    unsigned sections;
+    unsigned channels;
+    float *state; /**< history, per group of lanes then per section */
+
+    /**
+     * Filters samples through a cascade of direct form 1 sections.
+     * \param coeffs b0, b1, b2, a1, a2 of each section (normalized by a0)
+     */
+    void (*cascade)( biquad_t *, float *out, const float *in,
+                     unsigned samples, const float *coeffs );
+    /**
+     * Filters samples through a bank of band-pass sections:
+     * y = alpha * (x[n] - x[n-2]) + gamma * y[n-1] - beta * y[n-2]
+     * out = gain * (dry * x + sum(amp * y))
+     */
+    void (*bank)( biquad_t *, float *out, const float *in, unsigned samples,
+                  const float *alpha, const float *beta, const float *gamma,
+                  const float *amp, float dry, float gain );
+};
+
+/* Scalar implementation, one lane */
+#define BIQUAD_VEC     float
+#define BIQUAD_LANES   1
+#define BIQUAD_FUNC(f) biquad_##f##_C
+#define BIQUAD_TARGET
+#include "biquad_kernel.h"
+
+#ifdef BIQUAD_HAS_VECTORSIZE
+/* Generic 128-bits vectors: SSE, NEON, AltiVec... */
+typedef float biquad_v4sf __attribute__((__vector_size__(16)));
+# define BIQUAD_VEC     biquad_v4sf
+# define BIQUAD_LANES   4
+# define BIQUAD_FUNC(f) biquad_##f##_V4
+# define BIQUAD_TARGET
+# include "biquad_kernel.h"
+#endif
+
+#ifdef BIQUAD_X86
+typedef float biquad_v8sf __attribute__((__vector_size__(32)));
+# define BIQUAD_VEC     biquad_v8sf
+# define BIQUAD_LANES   8
+# define BIQUAD_FUNC(f) biquad_##f##_AVX
+# define BIQUAD_TARGET  BIQUAD_AVX
+# include "biquad_kernel.h"
+#endif
+
+/**
+ * Resets the filter history.
+ */
+static inline void biquad_Reset( biquad_t *bq )
+{
+    /* Enough for the widest vectors: 8 lanes */
+    size_t groups = (bq->channels + 7) / 8;
+    memset( bq->state, 0, groups * 8 * (4 * bq->sections + 2)
+                          * sizeof(*bq->state) );
+}
+
+/**
+ * Initializes filters for the given number of sections and channels, and
+ * selects the best implementation for the CPU.
+ */
+static inline int biquad_Init( biquad_t *bq, unsigned sections,
+                               unsigned channels )
+{
+    if( sections == 0 || sections > BIQUAD_MAX_SECTIONS || channels == 0 )
+        return VLC_EGENERIC;
+
+    size_t groups = (channels + 7) / 8;
+    size_t size = groups * 8 * (4 * sections + 2) * sizeof(*bq->state);
+
+    bq->state = aligned_alloc( 32, size );
+    if( bq->state == NULL )
+        return VLC_ENOMEM;
+    bq->sections = sections;
+    bq->channels = channels;
+    biquad_Reset( bq );
+
+    bq->cascade = biquad_Cascade_C;
+    bq->bank = biquad_Bank_C;
+#ifdef BIQUAD_HAS_VECTORSIZE
+    /* Mono and stereo leave most lanes empty: the scalar code is faster */
+    if( channels > 2 )
+    {
+        bq->cascade = biquad_Cascade_V4;
+        bq->bank = biquad_Bank_V4;
+    }
+#endif
+#ifdef BIQUAD_X86
+    /* 8 lanes are only worth it with more than 4 channels */
+    if( vlc_CPU_AVX() && channels > 4 )
+    {
+        bq->cascade = biquad_Cascade_AVX;
+        bq->bank = biquad_Bank_AVX;
+    }
+#endif
+    return VLC_SUCCESS;
+}
+
+static inline void biquad_Clean( biquad_t *bq )
+{
+    aligned_free( bq->state );
+}
+
+#endif
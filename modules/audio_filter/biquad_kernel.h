@@ -0,0 +1,152 @@
+/*****************************************************************************
+ * biquad_kernel.h: multi-channel biquad filters kernels
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/* Included by biquad.h once per vector type, with:
+ *  - BIQUAD_VEC: the type holding BIQUAD_LANES floats,
+ *  - BIQUAD_FUNC(f): the name of the function f for that type,
+ *  - BIQUAD_TARGET: the attributes of the functions. */
+
+BIQUAD_TARGET
+static inline BIQUAD_VEC BIQUAD_FUNC(Load)( const float *p, unsigned n )
+{
+    BIQUAD_VEC v = (BIQUAD_VEC){ 0 };
+
+    if( likely(n == BIQUAD_LANES) )
+        memcpy( &v, p, sizeof (v) );
+    else
+    {
+        float *lane = (float *)&v;
+        for( unsigned i = 0; i < n; i++ )
+            lane[i] = p[i];
+    }
+    return v;
+}
+
+BIQUAD_TARGET
+static inline void BIQUAD_FUNC(Store)( float *p, BIQUAD_VEC v, unsigned n )
+{
+    if( likely(n == BIQUAD_LANES) )
+        memcpy( p, &v, sizeof (v) );
+    else
+    {
+        const float *lane = (const float *)&v;
+        for( unsigned i = 0; i < n; i++ )
+            p[i] = lane[i];
+    }
+}
+
+BIQUAD_TARGET
+static void BIQUAD_FUNC(Cascade)( biquad_t *bq, float *out, const float *in,
+                                  unsigned samples, const float *coeffs )
+{
+    const unsigned channels = bq->channels;
+    const unsigned sections = bq->sections;
+    BIQUAD_VEC c[BIQUAD_MAX_SECTIONS][5];
+
+    for( unsigned s = 0; s < sections; s++ )
+        for( unsigned k = 0; k < 5; k++ )
+            c[s][k] = (BIQUAD_VEC){ 0 } + coeffs[5 * s + k];
+
+    for( unsigned i = 0; i < samples; i++ )
+    {
+        BIQUAD_VEC *st = (BIQUAD_VEC *)bq->state;
+
+        for( unsigned ch = 0; ch < channels; ch += BIQUAD_LANES )
+        {
+            const unsigned n = __MIN(channels - ch, BIQUAD_LANES);
+            BIQUAD_VEC x = BIQUAD_FUNC(Load)( &in[ch], n );
+            BIQUAD_VEC y = x;
+
+            /* Direct form 1 IIRs */
+            for( unsigned s = 0; s < sections; s++, st += 4 )
+            {
+                y = x * c[s][0] + st[0] * c[s][1] + st[1] * c[s][2]
+                  - st[2] * c[s][3] - st[3] * c[s][4];
+                st[1] = st[0];
+                st[0] = x;
+                st[3] = st[2];
+                st[2] = y;
+                x = y;
+            }
+            st += 2;
+            BIQUAD_FUNC(Store)( &out[ch], y, n );
+        }
+        in += channels;
+        out += channels;
+    }
+}
+
+BIQUAD_TARGET
+static void BIQUAD_FUNC(Bank)( biquad_t *bq, float *out, const float *in,
+                               unsigned samples, const float *alpha,
+                               const float *beta, const float *gamma,
+                               const float *amp, float dry, float gain )
+{
+    const unsigned channels = bq->channels;
+    const unsigned sections = bq->sections;
+    BIQUAD_VEC a[BIQUAD_MAX_SECTIONS], b[BIQUAD_MAX_SECTIONS];
+    BIQUAD_VEC g[BIQUAD_MAX_SECTIONS], m[BIQUAD_MAX_SECTIONS];
+    const BIQUAD_VEC vdry = (BIQUAD_VEC){ 0 } + dry;
+    const BIQUAD_VEC vgain = (BIQUAD_VEC){ 0 } + gain;
+
+    for( unsigned s = 0; s < sections; s++ )
+    {
+        a[s] = (BIQUAD_VEC){ 0 } + alpha[s];
+        b[s] = (BIQUAD_VEC){ 0 } + beta[s];
+        g[s] = (BIQUAD_VEC){ 0 } + gamma[s];
+        m[s] = (BIQUAD_VEC){ 0 } + amp[s];
+    }
+
+    for( unsigned i = 0; i < samples; i++ )
+    {
+        BIQUAD_VEC *st = (BIQUAD_VEC *)bq->state;
+
+        for( unsigned ch = 0; ch < channels; ch += BIQUAD_LANES )
+        {
+            const unsigned n = __MIN(channels - ch, BIQUAD_LANES);
+            const BIQUAD_VEC x = BIQUAD_FUNC(Load)( &in[ch], n );
+            const BIQUAD_VEC dx = x - st[1];
+            BIQUAD_VEC o = (BIQUAD_VEC){ 0 };
+
+            /* Input history, then the output history of each band */
+            st[1] = st[0];
+            st[0] = x;
+            BIQUAD_VEC *sy = st + 2;
+            for( unsigned s = 0; s < sections; s++, sy += 2 )
+            {
+                BIQUAD_VEC y = a[s] * dx + g[s] * sy[0] - b[s] * sy[1];
+
+                sy[1] = sy[0];
+                sy[0] = y;
+                o += y * m[s];
+            }
+            st += 4 * sections + 2;
+
+            BIQUAD_FUNC(Store)( &out[ch], vgain * (vdry * x + o), n );
+        }
+        in += channels;
+        out += channels;
+    }
+}
+
+#undef BIQUAD_VEC
+#undef BIQUAD_LANES
+#undef BIQUAD_FUNC
+#undef BIQUAD_TARGET
@@ -38,9 +38,9 @@
 #include <vlc_filter.h>
 
 #include "equalizer_presets.h"
+#include "biquad.h"
 
 /* TODO:
- *  - optimize a bit (you can hardly do slower ;)
  *  - add tables for more bands (15 and 32 would be cool), maybe with auto coeffs
  *    computation (not too hard once the Q is found).
  *  - support for external preset
@@ -114,12 +114,10 @@ typedef struct
     bool b_2eqz;
 
     /* Filter state */
-    float x[32][2];
-    float y[32][128][2];
+    biquad_t eqz;
 
     /* Second filter state */
-    float x2[32][2];
-    float y2[32][128][2];
+    biquad_t eqz2;
 
     vlc_mutex_t lock;
 } filter_sys_t;
@@ -128,7 +126,7 @@ static block_t *DoWork( filter_t *, block_t * );
 
 #define EQZ_IN_FACTOR (0.25f)
 static int  EqzInit( filter_t *, int );
-static void EqzFilter( filter_t *, float *, float *, int, int );
+static void EqzFilter( filter_t *, float *, const float *, unsigned );
 static void EqzClean( filter_t * );
 
 static int PresetCallback ( vlc_object_t *, char const *, vlc_value_t,
@@ -192,8 +190,7 @@ static void Close( filter_t *p_filter )
 static block_t * DoWork( filter_t * p_filter, block_t * p_in_buf )
 {
     EqzFilter( p_filter, (float*)p_in_buf->p_buffer,
-               (float*)p_in_buf->p_buffer, p_in_buf->i_nb_samples,
-               aout_FormatNbChannels( &p_filter->fmt_in.audio ) );
+               (float*)p_in_buf->p_buffer, p_in_buf->i_nb_samples );
     return p_in_buf;
 }
 
@@ -281,7 +278,8 @@ static int EqzInit( filter_t *p_filter, int i_rate )
 {
     filter_sys_t *p_sys = p_filter->p_sys;
     eqz_config_t cfg;
-    int i, ch;
+    int i;
+    unsigned i_channels = aout_FormatNbChannels( &p_filter->fmt_in.audio );
     vlc_value_t val1, val2, val3;
     vlc_object_t *p_aout = vlc_object_parent(p_filter);
     int i_ret = VLC_ENOMEM;
@@ -317,20 +315,16 @@ static int EqzInit( filter_t *p_filter, int i_rate )
     }
 
     /* Filter state */
-    for( ch = 0; ch < 32; ch++ )
+    if( biquad_Init( &p_sys->eqz, p_sys->i_band, i_channels ) )
     {
-        p_sys->x[ch][0]  =
-        p_sys->x[ch][1]  =
-        p_sys->x2[ch][0] =
-        p_sys->x2[ch][1] = 0.0f;
-
-        for( i = 0; i < p_sys->i_band; i++ )
-        {
-            p_sys->y[ch][i][0]  =
-            p_sys->y[ch][i][1]  =
-            p_sys->y2[ch][i][0] =
-            p_sys->y2[ch][i][1] = 0.0f;
-        }
+        free( p_sys->f_amp );
+        goto error;
+    }
+    if( biquad_Init( &p_sys->eqz2, p_sys->i_band, i_channels ) )
+    {
+        biquad_Clean( &p_sys->eqz );
+        free( p_sys->f_amp );
+        goto error;
     }
 
     var_Create( p_aout, "equalizer-bands", VLC_VAR_STRING | VLC_VAR_DOINHERIT );
@@ -357,6 +351,8 @@ static int EqzInit( filter_t *p_filter, int i_rate )
     {
         msg_Err(p_filter, "No preset selected");
         free( val2.psz_string );
+        biquad_Clean( &p_sys->eqz );
+        biquad_Clean( &p_sys->eqz2 );
         free( p_sys->f_amp );
         i_ret = VLC_EGENERIC;
         goto error;
@@ -386,66 +382,28 @@ error:
     return i_ret;
 }
 
-static void EqzFilter( filter_t *p_filter, float *out, float *in,
-                       int i_samples, int i_channels )
+static void EqzFilter( filter_t *p_filter, float *out, const float *in,
+                       unsigned i_samples )
 {
     filter_sys_t *p_sys = p_filter->p_sys;
-    int i, ch, j;
 
     vlc_mutex_lock( &p_sys->lock );
-    for( i = 0; i < i_samples; i++ )
+    /* We add source PCM + filtered PCM */
+    if( p_sys->b_2eqz )
     {
-        for( ch = 0; ch < i_channels; ch++ )
-        {
-            const float x = in[ch];
-            float o = 0.0f;
-
-            for( j = 0; j < p_sys->i_band; j++ )
-            {
-                float y = p_sys->f_alpha[j] * ( x - p_sys->x[ch][1] ) +
-                          p_sys->f_gamma[j] * p_sys->y[ch][j][0] -
-                          p_sys->f_beta[j]  * p_sys->y[ch][j][1];
-
-                p_sys->y[ch][j][1] = p_sys->y[ch][j][0];
-                p_sys->y[ch][j][0] = y;
-
-                o += y * p_sys->f_amp[j];
-            }
-            p_sys->x[ch][1] = p_sys->x[ch][0];
-            p_sys->x[ch][0] = x;
-
-            /* Second filter */
-            if( p_sys->b_2eqz )
-            {
-                const float x2 = EQZ_IN_FACTOR * x + o;
-                o = 0.0f;
-                for( j = 0; j < p_sys->i_band; j++ )
-                {
-                    float y = p_sys->f_alpha[j] * ( x2 - p_sys->x2[ch][1] ) +
-                              p_sys->f_gamma[j] * p_sys->y2[ch][j][0] -
-                              p_sys->f_beta[j]  * p_sys->y2[ch][j][1];
-
-                    p_sys->y2[ch][j][1] = p_sys->y2[ch][j][0];
-                    p_sys->y2[ch][j][0] = y;
-
-                    o += y * p_sys->f_amp[j];
-                }
-                p_sys->x2[ch][1] = p_sys->x2[ch][0];
-                p_sys->x2[ch][0] = x2;
-
-                /* We add source PCM + filtered PCM */
-                out[ch] = p_sys->f_gamp * p_sys->f_gamp *( EQZ_IN_FACTOR * x2 + o );
-            }
-            else
-            {
-                /* We add source PCM + filtered PCM */
-                out[ch] = p_sys->f_gamp *( EQZ_IN_FACTOR * x + o );
-            }
-        }
-
-        in  += i_channels;
-        out += i_channels;
+        p_sys->eqz.bank( &p_sys->eqz, out, in, i_samples,
+                         p_sys->f_alpha, p_sys->f_beta, p_sys->f_gamma,
+                         p_sys->f_amp, EQZ_IN_FACTOR, 1.0f );
+        /* Second filter */
+        p_sys->eqz2.bank( &p_sys->eqz2, out, out, i_samples,
+                          p_sys->f_alpha, p_sys->f_beta, p_sys->f_gamma,
+                          p_sys->f_amp, EQZ_IN_FACTOR,
+                          p_sys->f_gamp * p_sys->f_gamp );
     }
+    else
+        p_sys->eqz.bank( &p_sys->eqz, out, in, i_samples,
+                         p_sys->f_alpha, p_sys->f_beta, p_sys->f_gamma,
+                         p_sys->f_amp, EQZ_IN_FACTOR, p_sys->f_gamp );
     vlc_mutex_unlock( &p_sys->lock );
 }
 
@@ -464,6 +422,9 @@ static void EqzClean( filter_t *p_filter )
     free( p_sys->f_gamma );
 
     free( p_sys->f_amp );
+
+    biquad_Clean( &p_sys->eqz );
+    biquad_Clean( &p_sys->eqz2 );
 }
 
 
@@ -36,6 +36,7 @@
 #include <stdatomic.h>
 #include <string.h> /* for memset */
 #include <limits.h> /* form INT_MIN */
+#include <math.h>
 
 /*****************************************************************************
  * Module descriptor
@@ -78,6 +79,10 @@ vlc_module_begin ()
 
 vlc_module_end ()
 
+/* Relative cost of a frequency domain search, per transform and
+ * n.log2(n), against a time domain multiply-add */
+#define FFT_COST 6.
+
 /*
  * Scaletempo works by producing audio in constant sized chunks (a "stride") but
  * consuming chunks proportional to the playback rate.
@@ -129,6 +134,10 @@ typedef struct
     void     *buf_pre_corr;
     void     *table_window;
     unsigned(*best_overlap_offset)( filter_t *p_filter );
+    /* best overlap, frequency domain */
+    unsigned  fft_size;
+    float    *fft_buf;
+    unsigned *fft_rev;
 #ifdef PITCH_SHIFTER
     /* pitch */
     filter_t * resampler;
@@ -139,30 +148,49 @@ typedef struct
 /*****************************************************************************
  * best_overlap_offset: calculate best offset for overlap
  *****************************************************************************/
+static void pre_correlate_float( filter_sys_t *p )
+{
+    const float *restrict pw = p->table_window;
+    const float *restrict po = (float *)p->buf_overlap + p->samples_per_frame;
+    float *restrict ppc = p->buf_pre_corr;
+    unsigned n = p->samples_overlap - p->samples_per_frame;
+
+    for( unsigned i = 0; i < n; i++ )
+        ppc[i] = pw[i] * po[i];
+}
+
+static float dot_product_float( const float *restrict a,
+                                const float *restrict b, unsigned n )
+{
+    /* independent partial sums, so that the loop gets vectorized */
+    float sums[8] = { 0 };
+    float corr = 0;
+    unsigned i = 0;
+
+    for( ; i + 8 <= n; i += 8 )
+        for( unsigned j = 0; j < 8; j++ )
+            sums[j] += a[i + j] * b[i + j];
+    for( ; i < n; i++ )
+        corr += a[i] * b[i];
+    for( unsigned j = 0; j < 8; j++ )
+        corr += sums[j];
+    return corr;
+}
+
 static unsigned best_overlap_offset_float( filter_t *p_filter )
 {
     filter_sys_t *p = p_filter->p_sys;
-    float *pw, *po, *ppc, *search_start;
+    const float *search_start;
     float best_corr = INT_MIN;
     unsigned best_off = 0;
-    unsigned i, off;
-
-    pw  = p->table_window;
-    po  = p->buf_overlap;
-    po += p->samples_per_frame;
-    ppc = p->buf_pre_corr;
-    for( i = p->samples_per_frame; i < p->samples_overlap; i++ ) {
-      *ppc++ = *pw++ * *po++;
-    }
+    unsigned off;
+
+    pre_correlate_float( p );
 
     search_start = (float *)p->buf_queue + p->samples_per_frame;
     for( off = 0; off < p->frames_search; off++ ) {
-      float corr = 0;
-      float *ps = search_start;
-      ppc = p->buf_pre_corr;
-      for( i = p->samples_per_frame; i < p->samples_overlap; i++ ) {
-        corr += *ppc++ * *ps++;
-      }
+      float corr = dot_product_float( p->buf_pre_corr, search_start,
+                                      p->samples_overlap - p->samples_per_frame );
       if( corr > best_corr ) {
         best_corr = corr;
         best_off  = off;
@@ -173,6 +201,125 @@ static unsigned best_overlap_offset_float( filter_t *p_filter )
     return best_off * p->bytes_per_frame;
 }
 
+/*
+ * The correlation of the overlap with each position of the search window is
+ * a cross correlation, computed here as a product of spectra.
+ *
+ * Each channel packs its windowed overlap (real part) and its search window
+ * (imaginary part) in a single complex transform. The cross spectra of all
+ * the channels are summed, so that only one inverse transform is needed.
+ *
+ * fft_buf holds 6 arrays of fft_size floats: the transform real and imaginary
+ * parts, the accumulated cross spectrum real and imaginary parts, and the
+ * twiddle factors cosines and sines (those of the stage of half size h start
+ * at index h).
+ */
+static void fft_float( const filter_sys_t *p, float *restrict re,
+                       float *restrict im )
+{
+    const unsigned n = p->fft_size;
+    const float *tw_re = p->fft_buf + 4 * n;
+    const float *tw_im = p->fft_buf + 5 * n;
+
+    for( unsigned i = 0; i < n; i++ )
+    {
+        unsigned j = p->fft_rev[i];
+        if( i < j )
+        {
+            float t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+
+    for( unsigned h = 1; h < n; h <<= 1 )
+    {
+        const float *restrict wr = tw_re + h;
+        const float *restrict wi = tw_im + h;
+        for( unsigned i = 0; i < n; i += 2 * h )
+        {
+            float *restrict r0 = re + i, *restrict r1 = re + i + h;
+            float *restrict i0 = im + i, *restrict i1 = im + i + h;
+            for( unsigned k = 0; k < h; k++ )
+            {
+                float tr = r1[k] * wr[k] - i1[k] * wi[k];
+                float ti = r1[k] * wi[k] + i1[k] * wr[k];
+                r1[k] = r0[k] - tr;
+                i1[k] = i0[k] - ti;
+                r0[k] += tr;
+                i0[k] += ti;
+            }
+        }
+    }
+}
+
+static unsigned best_overlap_offset_fft( filter_t *p_filter )
+{
+    filter_sys_t *p = p_filter->p_sys;
+    const unsigned n = p->fft_size;
+    const unsigned nch = p->samples_per_frame;
+    const unsigned frames_corr = p->samples_overlap / nch - 1;
+    const unsigned frames_in = frames_corr + p->frames_search - 1;
+    float *re = p->fft_buf, *im = re + n;
+    float *acc_re = im + n, *acc_im = acc_re + n;
+
+    pre_correlate_float( p );
+
+    memset( acc_re, 0, ( n / 2 + 1 ) * sizeof (float) );
+    memset( acc_im, 0, ( n / 2 + 1 ) * sizeof (float) );
+    for( unsigned c = 0; c < nch; c++ )
+    {
+        const float *ppc = (float *)p->buf_pre_corr + c;
+        const float *ps  = (float *)p->buf_queue + nch + c;
+
+        for( unsigned i = 0; i < frames_corr; i++ )
+            re[i] = ppc[i * nch];
+        memset( re + frames_corr, 0, ( n - frames_corr ) * sizeof (float) );
+        for( unsigned i = 0; i < frames_in; i++ )
+            im[i] = ps[i * nch];
+        memset( im + frames_in, 0, ( n - frames_in ) * sizeof (float) );
+
+        fft_float( p, re, im );
+
+        /* 2A = Z[k] + conj(Z[n-k]), 2B = (Z[k] - conj(Z[n-k])) / i,
+         * accumulate conj(A).B (the constant factor does not matter) */
+        for( unsigned k = 0; k <= n / 2; k++ )
+        {
+            unsigned nk = ( n - k ) & ( n - 1 );
+            float ar = re[k] + re[nk], ai = im[k] - im[nk];
+            float br = im[k] + im[nk], bi = re[nk] - re[k];
+            acc_re[k] += ar * br + ai * bi;
+            acc_im[k] += ar * bi - ai * br;
+        }
+    }
+
+    /* the cross spectrum is hermitian: its inverse transform is the real
+     * part of the transform of its conjugate (scaled by n) */
+    for( unsigned k = 0; k <= n / 2; k++ )
+    {
+        re[k] = acc_re[k];
+        im[k] = -acc_im[k];
+    }
+    for( unsigned k = n / 2 + 1; k < n; k++ )
+    {
+        re[k] = acc_re[n - k];
+        im[k] = acc_im[n - k];
+    }
+    fft_float( p, re, im );
+
+    float best_corr = re[0];
+    unsigned best_off = 0;
+    for( unsigned off = 1; off < p->frames_search; off++ )
+    {
+        if( re[off] > best_corr )
+        {
+            best_corr = re[off];
+            best_off  = off;
+        }
+    }
+
+    return best_off * p->bytes_per_frame;
+}
+
 /*****************************************************************************
  * output_overlap: blend end of previous stride with beginning of current stride
  *****************************************************************************/
@@ -181,14 +328,13 @@ static void output_overlap_float( filter_t        *p_filter,
                                   unsigned         bytes_off )
 {
     filter_sys_t *p = p_filter->p_sys;
-    float *pout = buf_out;
-    float *pb   = p->table_blend;
-    float *po   = p->buf_overlap;
-    float *pin  = (float *)( p->buf_queue + bytes_off );
-    unsigned i;
-    for( i = 0; i < p->samples_overlap; i++ ) {
-        *pout++ = *po - *pb++ * ( *po - *pin++ ); po++;
-    }
+    float *restrict pout      = buf_out;
+    const float *restrict pb  = p->table_blend;
+    const float *restrict po  = p->buf_overlap;
+    const float *restrict pin = (float *)( p->buf_queue + bytes_off );
+
+    for( unsigned i = 0; i < p->samples_overlap; i++ )
+        pout[i] = po[i] - pb[i] * ( po[i] - pin[i] );
 }
 
 /*****************************************************************************
@@ -352,6 +498,45 @@ static int reinit_buffers( filter_t *p_filter )
                 *pw++ = v;
         }
         p->best_overlap_offset = best_overlap_offset_float;
+
+        /* Searching in the frequency domain takes a transform per channel
+         * plus an inverse one, against a multiply-add per overlap sample and
+         * search position in the time domain: use the cheapest one for the
+         * channel count and the search and overlap lengths (which scale
+         * with the sample rate). */
+        unsigned fft_log = 1;
+        while( ( 1u << fft_log ) < p->frames_search + frames_overlap - 2 )
+            fft_log++;
+        unsigned fft_size = 1u << fft_log;
+        double cost_direct = (double)p->frames_search * ( frames_overlap - 1 )
+                           * p->samples_per_frame;
+        double cost_fft = FFT_COST * ( p->samples_per_frame + 1 )
+                        * fft_size * fft_log;
+        if( cost_fft < cost_direct )
+        {
+            p->fft_size = fft_size;
+            p->fft_buf  = vlc_alloc( 6 * fft_size, sizeof (float) );
+            p->fft_rev  = vlc_alloc( fft_size, sizeof (unsigned) );
+            if( !p->fft_buf || !p->fft_rev )
+                return VLC_ENOMEM;
+
+            float *tw_re = p->fft_buf + 4 * fft_size;
+            float *tw_im = p->fft_buf + 5 * fft_size;
+            for( unsigned h = 1; h < fft_size; h <<= 1 )
+                for( unsigned k = 0; k < h; k++ )
+                {
+                    tw_re[h + k] =  cos( M_PI * k / h );
+                    tw_im[h + k] = -sin( M_PI * k / h );
+                }
+            for( i = 0; i < fft_size; i++ )
+            {
+                unsigned rev = 0;
+                for( j = 0; j < fft_log; j++ )
+                    rev |= ( ( i >> j ) & 1 ) << ( fft_log - 1 - j );
+                p->fft_rev[i] = rev;
+            }
+            p->best_overlap_offset = best_overlap_offset_fft;
+        }
     }
 
     unsigned new_size = ( p->frames_search + frames_stride + frames_overlap ) * p->bytes_per_frame;
@@ -381,13 +566,13 @@ static int reinit_buffers( filter_t *p_filter )
     p->frames_stride_scaled = p->bytes_stride_scaled / p->bytes_per_frame;
 
     msg_Dbg( VLC_OBJECT(p_filter),
-             "%.3f scale, %.3f stride_in, %i stride_out, %i standing, %i overlap, %i search, %i queue, %s mode",
+             "%.3f scale, %.3f stride_in, %i stride_out, %i standing, %i overlap, %i search (%s), %i queue, %s mode",
              p->scale,
              p->frames_stride_scaled,
              (int)( p->bytes_stride / p->bytes_per_frame ),
              (int)( p->bytes_standing / p->bytes_per_frame ),
              (int)( p->bytes_overlap / p->bytes_per_frame ),
-             p->frames_search,
+             p->frames_search, p->fft_size ? "fft" : "direct",
              (int)( p->bytes_queue_max / p->bytes_per_frame ),
              "fl32");
 
@@ -430,6 +615,9 @@ static int Open( vlc_object_t *p_this )
     p_sys->table_blend    = NULL;
     p_sys->buf_pre_corr   = NULL;
     p_sys->table_window   = NULL;
+    p_sys->fft_size       = 0;
+    p_sys->fft_buf        = NULL;
+    p_sys->fft_rev        = NULL;
     p_sys->bytes_overlap  = 0;
     p_sys->bytes_queued   = 0;
     p_sys->bytes_to_slide = 0;
@@ -533,6 +721,8 @@ static void Close( filter_t *p_filter )
     free( p_sys->table_blend );
     free( p_sys->buf_pre_corr );
     free( p_sys->table_window );
+    free( p_sys->fft_buf );
+    free( p_sys->fft_rev );
     free( p_sys );
 }
 
@@ -31,9 +31,29 @@
 #include <stddef.h>
 #include <vlc_common.h>
 #include <vlc_plugin.h>
+#include <vlc_cpu.h>
 #include <vlc_aout.h>
 #include <vlc_aout_volume.h>
 
+#if defined(CAN_COMPILE_SSE2) && defined(HAVE_SSE2_INTRINSICS)
+# define MIXER_X86 1
+# include <immintrin.h>
+# ifdef __SSE2__
+#  define VLC_SSE2
+# else
+#  define VLC_SSE2 __attribute__ ((__target__ ("sse2")))
+# endif
+# ifdef __AVX__
+#  define VLC_AVX
+# else
+#  define VLC_AVX __attribute__ ((__target__ ("avx")))
+# endif
+#endif
+#if defined(__ARM_NEON)
+# define MIXER_NEON 1
+# include <arm_neon.h>
+#endif
+
 /*****************************************************************************
  * Local prototypes
  *****************************************************************************/
@@ -42,6 +62,7 @@ static int Create( vlc_object_t * );
 /*****************************************************************************
  * Module descriptor
  *****************************************************************************/
+#ifndef MIXER_TEST
 vlc_module_begin ()
     set_category( CAT_AUDIO )
     set_subcategory( SUBCAT_AUDIO_AFILTER )
@@ -49,6 +70,7 @@ vlc_module_begin ()
     set_capability( "audio volume", 10 )
     set_callback( Create )
 vlc_module_end ()
+#endif
 
 /**
  * Mixes a new output buffer
@@ -80,6 +102,105 @@ static void FilterFL64( audio_volume_t *p_volume, block_t *p_buffer,
     (void) p_volume;
 }
 
+#ifdef MIXER_X86
+VLC_SSE
+static void FilterFL32_SSE( audio_volume_t *p_volume, block_t *p_buffer,
+                            float f_multiplier )
+{
+    if( f_multiplier == 1.f )
+        return; /* nothing to do */
+
+    float *p = (float *)p_buffer->p_buffer;
+    size_t i = p_buffer->i_buffer / sizeof(*p);
+    const __m128 mult = _mm_set1_ps( f_multiplier );
+
+    for( ; i >= 4; i -= 4, p += 4 )
+        _mm_storeu_ps( p, _mm_mul_ps( _mm_loadu_ps( p ), mult ) );
+    for( ; i > 0; i-- )
+        *(p++) *= f_multiplier;
+
+    (void) p_volume;
+}
+
+VLC_AVX
+static void FilterFL32_AVX( audio_volume_t *p_volume, block_t *p_buffer,
+                            float f_multiplier )
+{
+    if( f_multiplier == 1.f )
+        return; /* nothing to do */
+
+    float *p = (float *)p_buffer->p_buffer;
+    size_t i = p_buffer->i_buffer / sizeof(*p);
+    const __m256 mult = _mm256_set1_ps( f_multiplier );
+
+    for( ; i >= 8; i -= 8, p += 8 )
+        _mm256_storeu_ps( p, _mm256_mul_ps( _mm256_loadu_ps( p ), mult ) );
+    for( ; i > 0; i-- )
+        *(p++) *= f_multiplier;
+
+    (void) p_volume;
+}
+
+VLC_SSE2
+static void FilterFL64_SSE2( audio_volume_t *p_volume, block_t *p_buffer,
+                             float f_multiplier )
+{
+    double *p = (double *)p_buffer->p_buffer;
+    double mult = f_multiplier;
+    if( mult == 1. )
+        return; /* nothing to do */
+
+    size_t i = p_buffer->i_buffer / sizeof(*p);
+    const __m128d vmult = _mm_set1_pd( mult );
+
+    for( ; i >= 2; i -= 2, p += 2 )
+        _mm_storeu_pd( p, _mm_mul_pd( _mm_loadu_pd( p ), vmult ) );
+    if( i > 0 )
+        *p *= mult;
+
+    (void) p_volume;
+}
+
+VLC_AVX
+static void FilterFL64_AVX( audio_volume_t *p_volume, block_t *p_buffer,
+                            float f_multiplier )
+{
+    double *p = (double *)p_buffer->p_buffer;
+    double mult = f_multiplier;
+    if( mult == 1. )
+        return; /* nothing to do */
+
+    size_t i = p_buffer->i_buffer / sizeof(*p);
+    const __m256d vmult = _mm256_set1_pd( mult );
+
+    for( ; i >= 4; i -= 4, p += 4 )
+        _mm256_storeu_pd( p, _mm256_mul_pd( _mm256_loadu_pd( p ), vmult ) );
+    for( ; i > 0; i-- )
+        *(p++) *= mult;
+
+    (void) p_volume;
+}
+#endif
+
+#ifdef MIXER_NEON
+static void FilterFL32_NEON( audio_volume_t *p_volume, block_t *p_buffer,
+                             float f_multiplier )
+{
+    if( f_multiplier == 1.f )
+        return; /* nothing to do */
+
+    float *p = (float *)p_buffer->p_buffer;
+    size_t i = p_buffer->i_buffer / sizeof(*p);
+
+    for( ; i >= 4; i -= 4, p += 4 )
+        vst1q_f32( p, vmulq_n_f32( vld1q_f32( p ), f_multiplier ) );
+    for( ; i > 0; i-- )
+        *(p++) *= f_multiplier;
+
+    (void) p_volume;
+}
+#endif
+
 /**
  * Initializes the mixer
  */
@@ -91,12 +212,111 @@ static int Create( vlc_object_t *p_this )
     {
         case VLC_CODEC_FL32:
             p_volume->amplify = FilterFL32;
+#ifdef MIXER_X86
+            if( vlc_CPU_AVX() )
+                p_volume->amplify = FilterFL32_AVX;
+            else if( vlc_CPU_SSE() )
+                p_volume->amplify = FilterFL32_SSE;
+#endif
+#ifdef MIXER_NEON
+            if( vlc_CPU_ARM_NEON() )
+                p_volume->amplify = FilterFL32_NEON;
+#endif
             break;
         case VLC_CODEC_FL64:
             p_volume->amplify = FilterFL64;
+#ifdef MIXER_X86
+            if( vlc_CPU_AVX() )
+                p_volume->amplify = FilterFL64_AVX;
+            else if( vlc_CPU_SSE2() )
+                p_volume->amplify = FilterFL64_SSE2;
+#endif
             break;
         default:
             return -1;
     }
     return 0;
 }
+
+#ifdef MIXER_TEST
+#include <stdio.h>
+
+#define BENCH_SAMPLES (48000 / 50 * 8) /* 20 ms of 7.1 at 48 kHz */
+#define BENCH_RUNS 5000
+
+static const float gains[] = { 0.f, 0.25f, 0.7071f, 1.f, 1.5f, 2.f };
+
+static void Fill( vlc_fourcc_t format, block_t *block, unsigned seed )
+{
+    srand( seed );
+    if( format == VLC_CODEC_FL32 )
+        for( size_t i = 0; i < block->i_buffer / sizeof(float); i++ )
+            ((float *)block->p_buffer)[i] = rand() / (RAND_MAX / 2.f) - 1.f;
+    else
+        for( size_t i = 0; i < block->i_buffer / sizeof(double); i++ )
+            ((double *)block->p_buffer)[i] = rand() / (RAND_MAX / 2.) - 1.;
+}
+
+static int Test( vlc_fourcc_t format, size_t sample_size,
+                 void (*ref)(audio_volume_t *, block_t *, float) )
+{
+    struct audio_volume vol = { .format = format };
+    if( Create( (vlc_object_t *)&vol ) )
+        return 1;
+
+    block_t *a = block_Alloc( (BENCH_SAMPLES + 3) * sample_size );
+    block_t *b = block_Alloc( (BENCH_SAMPLES + 3) * sample_size );
+    if( a == NULL || b == NULL )
+        abort();
+
+    /* Check against the C implementation, including unaligned tails */
+    for( size_t n = 0; n <= 67; n++ )
+        for( size_t g = 0; g < ARRAY_SIZE(gains); g++ )
+        {
+            a->i_buffer = b->i_buffer = n * sample_size;
+            Fill( format, a, n );
+            Fill( format, b, n );
+            ref( &vol, a, gains[g] );
+            vol.amplify( &vol, b, gains[g] );
+            if( memcmp( a->p_buffer, b->p_buffer, a->i_buffer ) )
+            {
+                fprintf( stderr, "%4.4s: mismatch (%zu samples, gain %f)\n",
+                         (const char *)&format, n, gains[g] );
+                return 1;
+            }
+        }
+
+#ifdef MIXER_BENCH
+    /* Benchmark */
+    a->i_buffer = b->i_buffer = BENCH_SAMPLES * sample_size;
+    Fill( format, a, 0 );
+    Fill( format, b, 0 );
+
+    vlc_tick_t start = vlc_tick_now();
+    for( unsigned i = 0; i < BENCH_RUNS; i++ )
+        ref( &vol, a, (i & 1) ? 0.5f : 2.f );
+    vlc_tick_t c = vlc_tick_now() - start;
+
+    start = vlc_tick_now();
+    for( unsigned i = 0; i < BENCH_RUNS; i++ )
+        vol.amplify( &vol, b, (i & 1) ? 0.5f : 2.f );
+    vlc_tick_t simd = vlc_tick_now() - start;
+
+    printf( "%4.4s: C %"PRId64" us, optimized %"PRId64" us (%u x %u samples)\n",
+            (const char *)&format, US_FROM_VLC_TICK(c),
+            US_FROM_VLC_TICK(simd), BENCH_RUNS, BENCH_SAMPLES );
+#endif
+
+    block_Release( a );
+    block_Release( b );
+    return 0;
+}
+
+int main( void )
+{
+    if( Test( VLC_CODEC_FL32, sizeof(float), FilterFL32 ) ||
+        Test( VLC_CODEC_FL64, sizeof(double), FilterFL64 ) )
+        return 1;
+    return 0;
+}
+#endif
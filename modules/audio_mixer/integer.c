@@ -27,11 +27,32 @@
 
 #include <vlc_common.h>
 #include <vlc_plugin.h>
+#include <vlc_cpu.h>
 #include <vlc_aout.h>
 #include <vlc_aout_volume.h>
 
+#if defined(CAN_COMPILE_SSE2) && defined(HAVE_SSE2_INTRINSICS)
+# define MIXER_X86 1
+# include <immintrin.h>
+# ifdef __SSE2__
+#  define VLC_SSE2
+# else
+#  define VLC_SSE2 __attribute__ ((__target__ ("sse2")))
+# endif
+# ifdef __SSE4_1__
+#  define VLC_SSE4_1
+# else
+#  define VLC_SSE4_1 __attribute__ ((__target__ ("sse4.1")))
+# endif
+#endif
+#if defined(__ARM_NEON)
+# define MIXER_NEON 1
+# include <arm_neon.h>
+#endif
+
 static int Activate (vlc_object_t *);
 
+#ifndef MIXER_TEST
 vlc_module_begin ()
     set_category (CAT_AUDIO)
     set_subcategory (SUBCAT_AUDIO_AFILTER)
@@ -39,16 +60,11 @@ vlc_module_begin ()
     set_capability ("audio volume", 9)
     set_callback(Activate)
 vlc_module_end ()
+#endif
 
-static void FilterS32N (audio_volume_t *vol, block_t *block, float volume)
+static void AmplifyS32N (int32_t *p, size_t n, int_fast32_t mult)
 {
-    int32_t *p = (int32_t *)block->p_buffer;
-
-    int_fast32_t mult = lroundf (volume * 0x1.p24f);
-    if (mult == (1 << 24))
-        return;
-
-    for (size_t n = block->i_buffer / sizeof (*p); n > 0; n--)
+    for (; n > 0; n--)
     {
         int_fast64_t s = (*p * (int_fast64_t)mult) >> INT64_C(24);
         if (s > INT32_MAX)
@@ -58,18 +74,21 @@ static void FilterS32N (audio_volume_t *vol, block_t *block, float volume)
             s = INT32_MIN;
         *(p++) = s;
     }
-    (void) vol;
 }
 
-static void FilterS16N (audio_volume_t *vol, block_t *block, float volume)
+static void FilterS32N (audio_volume_t *vol, block_t *block, float volume)
 {
-    int16_t *p = (int16_t *)block->p_buffer;
-
-    int_fast16_t mult = lroundf (volume * 0x1.p8f);
-    if (mult == (1 << 8))
+    int_fast32_t mult = lroundf (volume * 0x1.p24f);
+    if (mult == (1 << 24))
         return;
 
-    for (size_t n = block->i_buffer / sizeof (*p); n > 0; n--)
+    AmplifyS32N ((int32_t *)block->p_buffer, block->i_buffer / 4, mult);
+    (void) vol;
+}
+
+static void AmplifyS16N (int16_t *p, size_t n, int_fast16_t mult)
+{
+    for (; n > 0; n--)
     {
         int_fast32_t s = (*p * (int_fast32_t)mult) >> 8;
         if (s > INT16_MAX)
@@ -79,9 +98,133 @@ static void FilterS16N (audio_volume_t *vol, block_t *block, float volume)
             s = INT16_MIN;
         *(p++) = s;
     }
+}
+
+static void FilterS16N (audio_volume_t *vol, block_t *block, float volume)
+{
+    int_fast16_t mult = lroundf (volume * 0x1.p8f);
+    if (mult == (1 << 8))
+        return;
+
+    AmplifyS16N ((int16_t *)block->p_buffer, block->i_buffer / 2, mult);
+    (void) vol;
+}
+
+#ifdef MIXER_X86
+VLC_SSE2
+static void FilterS16N_SSE2 (audio_volume_t *vol, block_t *block, float volume)
+{
+    int16_t *p = (int16_t *)block->p_buffer;
+    size_t n = block->i_buffer / sizeof (*p);
+
+    int_fast16_t mult = lroundf (volume * 0x1.p8f);
+    if (mult == (1 << 8))
+        return;
+
+    if (likely(mult <= INT16_MAX))
+    {
+        const __m128i m = _mm_set1_epi16 (mult);
+
+        for (; n >= 8; n -= 8, p += 8)
+        {
+            __m128i s = _mm_loadu_si128 ((const __m128i *)p);
+            __m128i lo = _mm_mullo_epi16 (s, m);
+            __m128i hi = _mm_mulhi_epi16 (s, m);
+            __m128i a = _mm_srai_epi32 (_mm_unpacklo_epi16 (lo, hi), 8);
+            __m128i b = _mm_srai_epi32 (_mm_unpackhi_epi16 (lo, hi), 8);
+            _mm_storeu_si128 ((__m128i *)p, _mm_packs_epi32 (a, b));
+        }
+    }
+    AmplifyS16N (p, n, mult);
     (void) vol;
 }
 
+VLC_SSE4_1
+static void FilterS32N_SSE4_1 (audio_volume_t *vol, block_t *block,
+                               float volume)
+{
+    int32_t *p = (int32_t *)block->p_buffer;
+    size_t n = block->i_buffer / sizeof (*p);
+
+    int_fast32_t mult = lroundf (volume * 0x1.p24f);
+    if (mult == (1 << 24))
+        return;
+
+    /* Without amplification, the samples cannot overflow, and the low 32 bits
+     * of the products shifted by 24 are the result. */
+    if (mult < (1 << 24))
+    {
+        const __m128i m = _mm_set1_epi32 (mult);
+
+        for (; n >= 4; n -= 4, p += 4)
+        {
+            __m128i s = _mm_loadu_si128 ((const __m128i *)p);
+            __m128i even = _mm_mul_epi32 (s, m);
+            __m128i odd = _mm_mul_epi32 (_mm_srli_epi64 (s, 32), m);
+            even = _mm_srli_epi64 (even, 24);
+            odd = _mm_slli_epi64 (odd, 8);
+            _mm_storeu_si128 ((__m128i *)p, _mm_blend_epi16 (even, odd, 0xCC));
+        }
+    }
+    AmplifyS32N (p, n, mult);
+    (void) vol;
+}
+#endif
+
+#ifdef MIXER_NEON
+static void FilterS16N_NEON (audio_volume_t *vol, block_t *block, float volume)
+{
+    int16_t *p = (int16_t *)block->p_buffer;
+    size_t n = block->i_buffer / sizeof (*p);
+
+    int_fast16_t mult = lroundf (volume * 0x1.p8f);
+    if (mult == (1 << 8))
+        return;
+
+    if (likely(mult <= INT16_MAX))
+    {
+        const int16x4_t m = vdup_n_s16 (mult);
+
+        for (; n >= 8; n -= 8, p += 8)
+        {
+            int16x8_t s = vld1q_s16 (p);
+            int32x4_t lo = vmull_s16 (vget_low_s16 (s), m);
+            int32x4_t hi = vmull_s16 (vget_high_s16 (s), m);
+            vst1q_s16 (p, vcombine_s16 (vqshrn_n_s32 (lo, 8),
+                                        vqshrn_n_s32 (hi, 8)));
+        }
+    }
+    AmplifyS16N (p, n, mult);
+    (void) vol;
+}
+
+static void FilterS32N_NEON (audio_volume_t *vol, block_t *block, float volume)
+{
+    int32_t *p = (int32_t *)block->p_buffer;
+    size_t n = block->i_buffer / sizeof (*p);
+
+    int_fast32_t mult = lroundf (volume * 0x1.p24f);
+    if (mult == (1 << 24))
+        return;
+
+    if (likely(mult <= INT32_MAX))
+    {
+        const int32x2_t m = vdup_n_s32 (mult);
+
+        for (; n >= 4; n -= 4, p += 4)
+        {
+            int32x4_t s = vld1q_s32 (p);
+            int64x2_t lo = vmull_s32 (vget_low_s32 (s), m);
+            int64x2_t hi = vmull_s32 (vget_high_s32 (s), m);
+            vst1q_s32 (p, vcombine_s32 (vqshrn_n_s64 (lo, 24),
+                                        vqshrn_n_s64 (hi, 24)));
+        }
+    }
+    AmplifyS32N (p, n, mult);
+    (void) vol;
+}
+#endif
+
 static void FilterU8 (audio_volume_t *vol, block_t *block, float volume)
 {
     uint8_t *p = (uint8_t *)block->p_buffer;
@@ -111,9 +254,25 @@ static int Activate (vlc_object_t *obj)
     {
         case VLC_CODEC_S32N:
             vol->amplify = FilterS32N;
+#ifdef MIXER_X86
+            if (vlc_CPU_SSE4_1())
+                vol->amplify = FilterS32N_SSE4_1;
+#endif
+#ifdef MIXER_NEON
+            if (vlc_CPU_ARM_NEON())
+                vol->amplify = FilterS32N_NEON;
+#endif
             break;
         case VLC_CODEC_S16N:
             vol->amplify = FilterS16N;
+#ifdef MIXER_X86
+            if (vlc_CPU_SSE2())
+                vol->amplify = FilterS16N_SSE2;
+#endif
+#ifdef MIXER_NEON
+            if (vlc_CPU_ARM_NEON())
+                vol->amplify = FilterS16N_NEON;
+#endif
             break;
         case VLC_CODEC_U8:
             vol->amplify = FilterU8;
@@ -123,3 +282,83 @@ static int Activate (vlc_object_t *obj)
     }
     return 0;
 }
+
+#ifdef MIXER_TEST
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BENCH_SAMPLES (48000 / 50 * 8) /* 20 ms of 7.1 at 48 kHz */
+#define BENCH_RUNS 5000
+
+static const float gains[] = { 0.f, 0.25f, 0.7071f, 1.f, 1.5f, 2.f, 200.f };
+
+static void Fill (block_t *block, unsigned seed)
+{
+    srand (seed);
+    for (size_t i = 0; i < block->i_buffer; i++)
+        block->p_buffer[i] = rand ();
+}
+
+static int Test (vlc_fourcc_t format, size_t sample_size,
+                 void (*ref)(audio_volume_t *, block_t *, float))
+{
+    struct audio_volume vol = { .format = format };
+    if (Activate ((vlc_object_t *)&vol))
+        return 1;
+
+    block_t *a = block_Alloc ((BENCH_SAMPLES + 3) * sample_size);
+    block_t *b = block_Alloc ((BENCH_SAMPLES + 3) * sample_size);
+    if (a == NULL || b == NULL)
+        abort ();
+
+    /* Check against the C implementation, including unaligned tails */
+    for (size_t n = 0; n <= 67; n++)
+        for (size_t g = 0; g < ARRAY_SIZE(gains); g++)
+        {
+            a->i_buffer = b->i_buffer = n * sample_size;
+            Fill (a, n);
+            Fill (b, n);
+            ref (&vol, a, gains[g]);
+            vol.amplify (&vol, b, gains[g]);
+            if (memcmp (a->p_buffer, b->p_buffer, a->i_buffer))
+            {
+                fprintf (stderr, "%4.4s: mismatch (%zu samples, gain %f)\n",
+                         (const char *)&format, n, gains[g]);
+                return 1;
+            }
+        }
+
+#ifdef MIXER_BENCH
+    /* Benchmark */
+    a->i_buffer = b->i_buffer = BENCH_SAMPLES * sample_size;
+    Fill (a, 0);
+    Fill (b, 0);
+
+    vlc_tick_t start = vlc_tick_now ();
+    for (unsigned i = 0; i < BENCH_RUNS; i++)
+        ref (&vol, a, 0.5f);
+    vlc_tick_t c = vlc_tick_now () - start;
+
+    start = vlc_tick_now ();
+    for (unsigned i = 0; i < BENCH_RUNS; i++)
+        vol.amplify (&vol, b, 0.5f);
+    vlc_tick_t simd = vlc_tick_now () - start;
+
+    printf ("%4.4s: C %"PRId64" us, optimized %"PRId64" us (%u x %u samples)\n",
+            (const char *)&format, US_FROM_VLC_TICK(c),
+            US_FROM_VLC_TICK(simd), BENCH_RUNS, BENCH_SAMPLES);
+#endif
+
+    block_Release (a);
+    block_Release (b);
+    return 0;
+}
+
+int main (void)
+{
+    if (Test (VLC_CODEC_S16N, sizeof (int16_t), FilterS16N)
+     || Test (VLC_CODEC_S32N, sizeof (int32_t), FilterS32N))
+        return 1;
+    return 0;
+}
+#endif
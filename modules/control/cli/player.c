@@ -30,6 +30,7 @@
 
 #include <vlc_common.h>
 #include <vlc_interface.h>
+#include <vlc_memstream.h>
 #include <vlc_aout.h>
 #include <vlc_vout.h>
 #include <vlc_playlist.h>
@@ -936,6 +937,137 @@ static int Statistics(struct cli_client *cl, const char *const *args,
     return (item != NULL) ? 0 : VLC_ENOITEM;
 }
 
+static const char *const latency_stage_names[VLC_LATENCY_STAGE_COUNT] = {
+    [VLC_LATENCY_FIFO_WAIT] = "fifo_wait",
+    [VLC_LATENCY_DECODE] = "decode",
+    [VLC_LATENCY_FILTER] = "filter",
+    [VLC_LATENCY_DISPLAY_SLACK] = "display_slack",
+    [VLC_LATENCY_OUTPUT] = "output",
+};
+
+static const char *LatencyCategoryName(enum es_format_category_e cat)
+{
+    switch (cat)
+    {
+        case VIDEO_ES: return "video";
+        case AUDIO_ES: return "audio";
+        case SPU_ES:   return "spu";
+        default:       return "unknown";
+    }
+}
+
+/* Returns the upper bound (in us) of the bucket containing the percentile */
+static uint64_t LatencyPercentile(const struct vlc_latency_histogram *h,
+                                  unsigned percent)
+{
+    uint64_t target = (h->count * percent + 99) / 100;
+    uint64_t sum = 0;
+
+    for (unsigned i = 0; i < VLC_LATENCY_BUCKETS; i++)
+    {
+        sum += h->buckets[i];
+        if (sum >= target)
+            return UINT64_C(2) << i;
+    }
+    return UINT64_C(2) << (VLC_LATENCY_BUCKETS - 1);
+}
+
+static void LatencyPrintText(struct cli_client *cl,
+                             const struct vlc_es_latency *es, size_t count)
+{
+    cli_printf(cl, "+----[ begin of latency info ]");
+    for (size_t i = 0; i < count; i++)
+    {
+        cli_printf(cl, "+-[Track %d (%s)]", es[i].i_id,
+                   LatencyCategoryName(es[i].i_cat));
+        cli_printf(cl, "| %-14s : %zu (max %zu)", "fifo_depth",
+                   es[i].fifo_depth, es[i].fifo_depth_max);
+
+        for (unsigned s = 0; s < VLC_LATENCY_STAGE_COUNT; s++)
+        {
+            const struct vlc_latency_histogram *h = &es[i].stages[s];
+            if (h->count == 0)
+                continue;
+
+            cli_printf(cl, "| %-14s : %8"PRIu64" samples, avg %8.3f ms, "
+                       "p50 < %8.3f ms, p99 < %8.3f ms, max %8.3f ms",
+                       latency_stage_names[s], h->count,
+                       US_FROM_VLC_TICK(h->total) / (h->count * 1000.),
+                       LatencyPercentile(h, 50) / 1000.,
+                       LatencyPercentile(h, 99) / 1000.,
+                       US_FROM_VLC_TICK(h->max) / 1000.);
+        }
+        cli_printf(cl, "|");
+    }
+    cli_printf(cl, "+----[ end of latency info ]");
+}
+
+static void LatencyPrintJson(struct cli_client *cl,
+                             const struct vlc_es_latency *es, size_t count)
+{
+    struct vlc_memstream ms;
+
+    if (vlc_memstream_open(&ms))
+        return;
+
+    vlc_memstream_puts(&ms, "{\"tracks\":[");
+    for (size_t i = 0; i < count; i++)
+    {
+        vlc_memstream_printf(&ms, "%s{\"id\":%d,\"type\":\"%s\","
+                             "\"fifo_depth\":%zu,\"fifo_depth_max\":%zu",
+                             i ? "," : "", es[i].i_id,
+                             LatencyCategoryName(es[i].i_cat),
+                             es[i].fifo_depth, es[i].fifo_depth_max);
+
+        for (unsigned s = 0; s < VLC_LATENCY_STAGE_COUNT; s++)
+        {
+            const struct vlc_latency_histogram *h = &es[i].stages[s];
+
+            vlc_memstream_printf(&ms, ",\"%s\":{\"count\":%"PRIu64","
+                                 "\"total_us\":%"PRId64",\"max_us\":%"PRId64
+                                 ",\"buckets\":[", latency_stage_names[s],
+                                 h->count, US_FROM_VLC_TICK(h->total),
+                                 US_FROM_VLC_TICK(h->max));
+            for (unsigned b = 0; b < VLC_LATENCY_BUCKETS; b++)
+                vlc_memstream_printf(&ms, "%s%"PRIu64, b ? "," : "",
+                                     h->buckets[b]);
+            vlc_memstream_puts(&ms, "]}");
+        }
+        vlc_memstream_putc(&ms, '}');
+    }
+    vlc_memstream_puts(&ms, "]}");
+
+    if (vlc_memstream_close(&ms) == 0)
+    {
+        cli_printf(cl, "%s", ms.ptr);
+        free(ms.ptr);
+    }
+}
+
+static int Latency(struct cli_client *cl, const char *const *args,
+                   size_t count, void *data)
+{
+    vlc_player_t *player = data;
+    struct vlc_es_latency *es;
+    size_t n;
+    bool json = count > 1 && strcmp(args[1], "json") == 0;
+
+    vlc_player_Lock(player);
+    bool playing = vlc_player_GetCurrentMedia(player) != NULL;
+    es = vlc_player_GetLatencyStats(player, &n);
+    vlc_player_Unlock(player);
+
+    if (!playing)
+        return VLC_ENOITEM;
+
+    if (json)
+        LatencyPrintJson(cl, es, n);
+    else
+        LatencyPrintText(cl, es, n);
+    free(es);
+    return 0;
+}
+
 static int IsPlaying(struct cli_client *cl, const char *const *args,
                      size_t count, void *data)
 {
@@ -1028,6 +1160,7 @@ static const struct cli_handler cmds[] =
     { "is_playing", IsPlaying },
     { "status", PlayerStatus },
     { "stats", Statistics },
+    { "latency", Latency },
 
     /* DVD commands */
     { "seek", PlayerSeek },
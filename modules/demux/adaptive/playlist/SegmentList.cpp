@@ -94,11 +94,18 @@ void SegmentList::updateWith(AbstractMultipleSegmentBaseType *updated_,
     if(!updated || updated->segments.empty())
         return;
 
+    uint64_t firstnumber = updated->segments.front()->getSequenceNumber();
+
+    mergeSegments(updated, b_restamp);
+
+    pruneBySegmentNumber(firstnumber);
+}
+
+void SegmentList::mergeSegments(SegmentList *updated, bool b_restamp)
+{
     const Segment * lastSegment = (segments.empty()) ? nullptr : segments.back();
     const Segment * prevSegment = lastSegment;
 
-    uint64_t firstnumber = updated->segments.front()->getSequenceNumber();
-
     std::vector<Segment *>::iterator it;
     for(it = updated->segments.begin(); it != updated->segments.end(); ++it)
     {
@@ -121,8 +128,7 @@ void SegmentList::updateWith(AbstractMultipleSegmentBaseType *updated_,
             delete cur;
     }
     updated->segments.clear();
-
-    pruneBySegmentNumber(firstnumber);
+    updated->totalLength = 0;
 }
 
 void SegmentList::pruneByPlaybackTime(vlc_tick_t time)
@@ -45,6 +45,7 @@ namespace adaptive
                 void                    addSegment(Segment *seg);
                 virtual void            updateWith(AbstractMultipleSegmentBaseType *,
                                                    bool = false) override;
+                void                    mergeSegments(SegmentList *, bool = false);
                 void                    pruneBySegmentNumber(uint64_t);
                 void                    pruneByPlaybackTime(vlc_tick_t);
                 stime_t                 getTotalLength() const;
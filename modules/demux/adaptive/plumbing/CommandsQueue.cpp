@@ -26,8 +26,12 @@
 #include "FakeESOut.hpp"
 #include <vlc_es_out.h>
 #include <vlc_block.h>
+#include <vlc_memusage.h>
 #include <vlc_meta.h>
 #include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <new>
 #include <set>
 
 using namespace adaptive;
@@ -41,9 +45,138 @@ enum
     ES_OUT_PRIVATE_COMMAND_DISCONTINUITY
 };
 
+/*
+ * Commands allocation pool
+ */
+
+/* Enough for all the commands defined here, bigger ones are malloc'ed */
+#define COMMANDS_POOL_SLOT_PAYLOAD 64
+#define COMMANDS_POOL_CHUNK_SLOTS  256
+
+struct alignas(std::max_align_t) CommandsPool::Slot
+{
+    union
+    {
+        CommandsPool *pool; /* owner while allocated, NULL if malloc'ed */
+        Slot *next; /* next free slot */
+    };
+};
+
+struct alignas(std::max_align_t) CommandsPool::Chunk
+{
+    Chunk *next;
+};
+
+#define COMMANDS_POOL_SLOT_SIZE (sizeof(CommandsPool::Slot) + \
+                                 COMMANDS_POOL_SLOT_PAYLOAD)
+
+CommandsPool::CommandsPool()
+{
+    vlc_mutex_init( &lock );
+    freeslots = nullptr;
+    chunks = nullptr;
+    bump = bumpend = nullptr;
+    allocated = 0;
+}
+
+CommandsPool::~CommandsPool()
+{
+    assert( allocated == 0 );
+    while( chunks )
+    {
+        Chunk *next = chunks->next;
+        free( chunks );
+        chunks = next;
+    }
+}
+
+void * CommandsPool::allocate( size_t size )
+{
+    Slot *slot;
+
+    if( unlikely(size > COMMANDS_POOL_SLOT_PAYLOAD) )
+    {
+        slot = static_cast<Slot *>( malloc( sizeof(*slot) + size ) );
+        if( unlikely(slot == nullptr) )
+            return nullptr;
+        slot->pool = nullptr;
+        return slot + 1;
+    }
+
+    vlc_mutex_lock( &lock );
+    if( freeslots )
+    {
+        slot = freeslots;
+        freeslots = slot->next;
+    }
+    else
+    {
+        if( bump == bumpend )
+        {
+            Chunk *chunk = static_cast<Chunk *>(
+                malloc( sizeof(*chunk) +
+                        COMMANDS_POOL_SLOT_SIZE * COMMANDS_POOL_CHUNK_SLOTS ) );
+            if( unlikely(chunk == nullptr) )
+            {
+                vlc_mutex_unlock( &lock );
+                return nullptr;
+            }
+            chunk->next = chunks;
+            chunks = chunk;
+            bump = reinterpret_cast<uint8_t *>( chunk + 1 );
+            bumpend = bump + COMMANDS_POOL_SLOT_SIZE * COMMANDS_POOL_CHUNK_SLOTS;
+        }
+        slot = reinterpret_cast<Slot *>( bump );
+        bump += COMMANDS_POOL_SLOT_SIZE;
+    }
+    allocated++;
+    vlc_mutex_unlock( &lock );
+
+    slot->pool = this;
+    return slot + 1;
+}
+
+void CommandsPool::release( void *p )
+{
+    if( p == nullptr )
+        return;
+
+    Slot *slot = static_cast<Slot *>( p ) - 1;
+    CommandsPool *pool = slot->pool;
+
+    if( unlikely(pool == nullptr) )
+    {
+        free( slot );
+        return;
+    }
+
+    vlc_mutex_lock( &pool->lock );
+    slot->next = pool->freeslots;
+    pool->freeslots = slot;
+    assert( pool->allocated > 0 );
+    pool->allocated--;
+    vlc_mutex_unlock( &pool->lock );
+}
+
 AbstractCommand::AbstractCommand( int type_ )
 {
     type = type_;
+    prev = next = nullptr;
+}
+
+void * AbstractCommand::operator new( size_t size, CommandsPool *pool ) noexcept
+{
+    return pool->allocate( size );
+}
+
+void AbstractCommand::operator delete( void *p )
+{
+    CommandsPool::release( p );
+}
+
+void AbstractCommand::operator delete( void *p, CommandsPool * )
+{
+    CommandsPool::release( p );
 }
 
 AbstractCommand::~AbstractCommand()
@@ -71,10 +204,13 @@ EsOutSendCommand::EsOutSendCommand( FakeESOutID *p_es, block_t *p_block_ ) :
     AbstractFakeEsCommand( ES_OUT_PRIVATE_COMMAND_SEND, p_es )
 {
     p_block = p_block_;
+    block_ChainProperties( p_block, nullptr, &i_size, nullptr );
+    vlc_memusage_Add( VLC_MEMUSAGE_ADAPTIVE, i_size );
 }
 
 EsOutSendCommand::~EsOutSendCommand()
 {
+    vlc_memusage_Sub( VLC_MEMUSAGE_ADAPTIVE, i_size );
     if( p_block )
         block_Release( p_block );
 }
@@ -187,32 +323,32 @@ void EsOutMetaCommand::Execute( es_out_t *out )
 
 EsOutSendCommand * CommandsFactory::createEsOutSendCommand( FakeESOutID *id, block_t *p_block ) const
 {
-    return new (std::nothrow) EsOutSendCommand( id, p_block );
+    return new (&pool) EsOutSendCommand( id, p_block );
 }
 
 EsOutDelCommand * CommandsFactory::createEsOutDelCommand( FakeESOutID *id ) const
 {
-    return new (std::nothrow) EsOutDelCommand( id );
+    return new (&pool) EsOutDelCommand( id );
 }
 
 EsOutAddCommand * CommandsFactory::createEsOutAddCommand( FakeESOutID *id ) const
 {
-    return new (std::nothrow) EsOutAddCommand( id );
+    return new (&pool) EsOutAddCommand( id );
 }
 
 EsOutControlPCRCommand * CommandsFactory::createEsOutControlPCRCommand( int group, vlc_tick_t pcr ) const
 {
-    return new (std::nothrow) EsOutControlPCRCommand( group, pcr );
+    return new (&pool) EsOutControlPCRCommand( group, pcr );
 }
 
 EsOutDestroyCommand * CommandsFactory::createEsOutDestroyCommand() const
 {
-    return new (std::nothrow) EsOutDestroyCommand();
+    return new (&pool) EsOutDestroyCommand();
 }
 
 EsOutControlResetPCRCommand * CommandsFactory::creatEsOutControlResetPCRCommand() const
 {
-    return new (std::nothrow) EsOutControlResetPCRCommand();
+    return new (&pool) EsOutControlResetPCRCommand();
 }
 
 EsOutMetaCommand * CommandsFactory::createEsOutMetaCommand( int group, const vlc_meta_t *p_meta ) const
@@ -221,19 +357,114 @@ EsOutMetaCommand * CommandsFactory::createEsOutMetaCommand( int group, const vlc
     if( p_dup )
     {
         vlc_meta_Merge( p_dup, p_meta );
-        return new (std::nothrow) EsOutMetaCommand( group, p_dup );
+        EsOutMetaCommand *command = new (&pool) EsOutMetaCommand( group, p_dup );
+        if( unlikely(command == nullptr) )
+            vlc_meta_Delete( p_dup );
+        return command;
     }
     return nullptr;
 }
 
+/*
+ * Commands list
+ */
+
+CommandsList::CommandsList()
+{
+    head = tail = nullptr;
+}
+
+bool CommandsList::empty() const
+{
+    return head == nullptr;
+}
+
+AbstractCommand * CommandsList::front() const
+{
+    return head;
+}
+
+AbstractCommand * CommandsList::pop_front()
+{
+    AbstractCommand *command = head;
+    head = command->next;
+    if( head )
+        head->prev = nullptr;
+    else
+        tail = nullptr;
+    command->next = nullptr;
+    return command;
+}
+
+void CommandsList::insertAfter( AbstractCommand *pos, AbstractCommand *command )
+{
+    assert( command->prev == nullptr && command->next == nullptr );
+    command->prev = pos;
+    command->next = pos ? pos->next : head;
+    if( command->next )
+        command->next->prev = command;
+    else
+        tail = command;
+    if( pos )
+        pos->next = command;
+    else
+        head = command;
+}
+
+void CommandsList::push_back( AbstractCommand *command )
+{
+    insertAfter( tail, command );
+}
+
+void CommandsList::insertByTime( AbstractCommand *command )
+{
+    /* Commands are mostly scheduled in order, so look for the insertion
+       point from the end. Commands without time (ES creation or deletion,
+       discontinuities...) act as barriers, so that no dated command is moved
+       before them. */
+    AbstractCommand *pos = tail;
+    const vlc_tick_t time = command->getTime();
+    if( time != VLC_TICK_INVALID )
+    {
+        while( pos )
+        {
+            const vlc_tick_t postime = pos->getTime();
+            if( postime == VLC_TICK_INVALID || postime <= time )
+                break;
+            pos = pos->prev;
+        }
+    }
+    insertAfter( pos, command );
+}
+
+void CommandsList::splice_back( CommandsList &other )
+{
+    if( other.head == nullptr )
+        return;
+    if( tail )
+    {
+        tail->next = other.head;
+        other.head->prev = tail;
+    }
+    else head = other.head;
+    tail = other.tail;
+    other.head = other.tail = nullptr;
+}
+
+void CommandsList::clear()
+{
+    while( !empty() )
+        delete pop_front();
+}
+
 /*
  * Commands Queue management
  */
 #if 0
 /* For queue printing/debugging */
-std::ostream& operator<<(std::ostream& ostr, const std::list<AbstractCommand *>& list)
+std::ostream& operator<<(std::ostream& ostr, const CommandsList& list)
 {
-    for (auto &i : list) {
+    for (const AbstractCommand *i = list.front(); i; i = i->next) {
         ostr << "[" << i->getType() << "]" << SEC_FROM_VLC_TICK(i->getTime()) << " ";
     }
     return ostr;
@@ -256,20 +487,6 @@ CommandsQueue::~CommandsQueue()
     delete commandsFactory;
 }
 
-static bool compareCommands( AbstractCommand *a, AbstractCommand *b )
-{
-    if(a->getTime() == b->getTime())
-    {
-        /* Reorder the initial clock PCR setting PCR0 DTS0 PCR0 DTS1 PCR1
-           so it appears after the block, avoiding it not being output */
-        if(a->getType() == ES_OUT_SET_GROUP_PCR &&
-           b->getType() == ES_OUT_PRIVATE_COMMAND_SEND)
-            return false;
-        return true;
-    }
-    else return (a->getTime() < b->getTime() && a->getTime() != VLC_TICK_INVALID);
-}
-
 void CommandsQueue::Schedule( AbstractCommand *command )
 {
     if( b_drop )
@@ -284,7 +501,7 @@ void CommandsQueue::Schedule( AbstractCommand *command )
     }
     else
     {
-        incoming.push_back( command );
+        incoming.insertByTime( command );
     }
 }
 
@@ -306,11 +523,10 @@ vlc_tick_t CommandsQueue::Process( es_out_t *out, vlc_tick_t barrier )
        ex: for a target time of 2, you must dequeue <= 2 until >= PCR2
        A0,A1,A2,B0,PCR0,B1,B2,PCR2,B3,A3,PCR3
     */
-    std::list<AbstractCommand *> output;
-    std::list<AbstractCommand *> in;
+    CommandsList output;
+    CommandsList in;
 
-
-    in.splice( in.end(), commands );
+    in.splice_back( commands );
 
     while( !in.empty() )
     {
@@ -330,9 +546,9 @@ vlc_tick_t CommandsQueue::Process( es_out_t *out, vlc_tick_t barrier )
 
         if( command->getType() == ES_OUT_PRIVATE_COMMAND_SEND )
         {
-            EsOutSendCommand *sendcommand = dynamic_cast<EsOutSendCommand *>(command);
+            EsOutSendCommand *sendcommand = static_cast<EsOutSendCommand *>(command);
             /* We need a stream identifier to send NON DATED data following DATA for the same ES */
-            const void *id = (sendcommand) ? sendcommand->esIdentifier() : 0;
+            const void *id = sendcommand->esIdentifier();
 
             /* Not for now */
             if( command->getTime() > barrier ) /* Not for now */
@@ -358,7 +574,7 @@ vlc_tick_t CommandsQueue::Process( es_out_t *out, vlc_tick_t barrier )
     }
 
     /* push remaining ones if broke above */
-    commands.splice( commands.end(), in );
+    commands.splice_back( in );
 
     if(commands.empty() && b_draining)
         b_draining = false;
@@ -366,8 +582,7 @@ vlc_tick_t CommandsQueue::Process( es_out_t *out, vlc_tick_t barrier )
     /* Now execute our selected commands */
     while( !output.empty() )
     {
-        AbstractCommand *command = output.front();
-        output.pop_front();
+        AbstractCommand *command = output.pop_front();
 
         if( command->getType() == ES_OUT_PRIVATE_COMMAND_SEND )
         {
@@ -387,9 +602,8 @@ vlc_tick_t CommandsQueue::Process( es_out_t *out, vlc_tick_t barrier )
 
 void CommandsQueue::LockedCommit()
 {
-    /* reorder all blocks by time between 2 PCR and merge with main list */
-    incoming.sort( compareCommands );
-    commands.splice( commands.end(), incoming );
+    /* blocks between 2 PCR are already ordered by time, merge with main list */
+    commands.splice_back( incoming );
 }
 
 void CommandsQueue::Commit()
@@ -399,12 +613,8 @@ void CommandsQueue::Commit()
 
 void CommandsQueue::Abort( bool b_reset )
 {
-    commands.splice( commands.end(), incoming );
-    while( !commands.empty() )
-    {
-        delete commands.front();
-        commands.pop_front();
-    }
+    commands.splice_back( incoming );
+    commands.clear();
 
     if( b_reset )
     {
@@ -471,11 +681,10 @@ vlc_tick_t CommandsQueue::getBufferingLevel() const
 
 vlc_tick_t CommandsQueue::getFirstDTS() const
 {
-    std::list<AbstractCommand *>::const_iterator it;
     vlc_tick_t i_firstdts = pcr;
-    for( it = commands.begin(); it != commands.end(); ++it )
+    for( const AbstractCommand *it = commands.front(); it; it = it->next )
     {
-        const vlc_tick_t i_dts = (*it)->getTime();
+        const vlc_tick_t i_dts = it->getTime();
         if( i_dts != VLC_TICK_INVALID )
         {
             if( i_dts < i_firstdts || i_firstdts == VLC_TICK_INVALID )
@@ -23,26 +23,55 @@
 #include <vlc_common.h>
 #include <vlc_es.h>
 
-#include <atomic>
-#include <list>
-
 namespace adaptive
 {
     class FakeESOut;
     class FakeESOutID;
 
+    /* Allocator for commands, as one is created for every demuxed block.
+       Slots are carved from chunks and recycled through a free list,
+       chunks are only released with the pool. */
+    class CommandsPool
+    {
+        public:
+            CommandsPool();
+            ~CommandsPool();
+            void * allocate( size_t );
+            static void release( void * );
+
+        private:
+            struct Slot;
+            struct Chunk;
+            vlc_mutex_t lock;
+            Slot *freeslots;
+            Chunk *chunks;
+            uint8_t *bump;
+            uint8_t *bumpend;
+            size_t allocated;
+    };
+
     class AbstractCommand
     {
         friend class CommandsFactory;
+        friend class CommandsList;
+        friend class CommandsQueue;
         public:
             virtual ~AbstractCommand();
             virtual void Execute( es_out_t * ) = 0;
             virtual vlc_tick_t getTime() const;
             int getType() const;
 
+            static void * operator new( size_t, CommandsPool * ) noexcept;
+            static void operator delete( void * );
+            static void operator delete( void *, CommandsPool * );
+
         protected:
             AbstractCommand( int );
             int type;
+
+        private:
+            AbstractCommand *prev;
+            AbstractCommand *next;
     };
 
     class AbstractFakeEsCommand : public AbstractCommand
@@ -64,6 +93,7 @@ namespace adaptive
         protected:
             EsOutSendCommand( FakeESOutID *, block_t * );
             block_t *p_block;
+            size_t i_size; /* accounted to the memory usage */
     };
 
     class EsOutDelCommand : public AbstractFakeEsCommand
@@ -145,6 +175,28 @@ namespace adaptive
             virtual EsOutControlResetPCRCommand * creatEsOutControlResetPCRCommand() const;
             virtual EsOutDestroyCommand * createEsOutDestroyCommand() const;
             virtual EsOutMetaCommand * createEsOutMetaCommand( int, const vlc_meta_t * ) const;
+
+        protected:
+            mutable CommandsPool pool;
+    };
+
+    /* Intrusive list of commands, a command can only belong to one list */
+    class CommandsList
+    {
+        public:
+            CommandsList();
+            bool empty() const;
+            AbstractCommand * front() const;
+            AbstractCommand * pop_front();
+            void push_back( AbstractCommand * );
+            void insertByTime( AbstractCommand * );
+            void splice_back( CommandsList & );
+            void clear();
+
+        private:
+            void insertAfter( AbstractCommand *, AbstractCommand * );
+            AbstractCommand *head;
+            AbstractCommand *tail;
     };
 
     /* Queuing for doing all the stuff in order */
@@ -173,8 +225,8 @@ namespace adaptive
             CommandsFactory *commandsFactory;
             void LockedCommit();
             void LockedSetDraining();
-            std::list<AbstractCommand *> incoming;
-            std::list<AbstractCommand *> commands;
+            CommandsList incoming; /* ordered by time on insertion */
+            CommandsList commands;
             vlc_tick_t bufferinglevel;
             vlc_tick_t pcr;
             bool b_draining;
@@ -29,31 +29,75 @@
 
 #include <vector>
 #include <stack>
+#include <new>
 #include <vlc_xml.h>
 
 using namespace adaptive::xml;
 
+#define NODES_PER_BLOCK 256
+
 DOMParser::DOMParser() :
     root( nullptr ),
     stream( nullptr ),
-    vlc_reader( nullptr )
+    vlc_reader( nullptr ),
+    attributes( 0 ),
+    bytes( 0 )
 {
 }
 
 DOMParser::DOMParser    (stream_t *stream) :
     root( nullptr ),
     stream( stream ),
-    vlc_reader( nullptr )
+    vlc_reader( nullptr ),
+    attributes( 0 ),
+    bytes( 0 )
 {
 }
 
 DOMParser::~DOMParser   ()
 {
-    delete this->root;
+    clear();
     if(this->vlc_reader)
         xml_ReaderDelete(this->vlc_reader);
 }
 
+void DOMParser::clear()
+{
+    root = nullptr;
+    nodes.clear();
+    names.clear();
+    attributes = 0;
+    bytes = 0;
+}
+
+Node* DOMParser::newNode()
+{
+    try
+    {
+        if(nodes.empty() || nodes.back().size() == nodes.back().capacity())
+        {
+            nodes.emplace_back();
+            nodes.back().reserve(NODES_PER_BLOCK);
+            bytes += NODES_PER_BLOCK * sizeof(Node);
+        }
+        nodes.back().emplace_back();
+    }
+    catch (const std::bad_alloc &)
+    {
+        return nullptr;
+    }
+    return &nodes.back().back();
+}
+
+const std::string * DOMParser::intern(const char *name)
+{
+    std::pair<std::unordered_set<std::string>::iterator, bool> ret = names.insert(name);
+    if(ret.second)
+        bytes += sizeof(std::string) + ret.first->capacity();
+    /* Elements of unordered containers are never moved */
+    return &(*ret.first);
+}
+
 Node*   DOMParser::getRootNode              ()
 {
     return this->root;
@@ -69,10 +113,20 @@ bool    DOMParser::parse                    (bool b)
     struct vlc_logger *const logger = vlc_reader->obj.logger;
     if(!b)
         vlc_reader->obj.logger = nullptr;
+    clear();
+    vlc_tick_t start = vlc_tick_now();
     root = processNode(b);
     vlc_reader->obj.logger = logger;
     if ( root == nullptr )
+    {
+        clear();
         return false;
+    }
+
+    size_t count = (nodes.size() - 1) * NODES_PER_BLOCK + nodes.back().size();
+    msg_Dbg(stream, "parsed %zu elements, %zu attributes in %" PRId64 " us, "
+            "using %zu KiB", count, attributes,
+            US_FROM_VLC_TICK(vlc_tick_now() - start), bytes / 1024);
 
     return true;
 }
@@ -82,8 +136,7 @@ bool DOMParser::reset(stream_t *s)
     stream = s;
     if(!vlc_reader)
         return true;
-    delete root;
-    root = nullptr;
+    clear();
 
     xml_ReaderDelete(vlc_reader);
     vlc_reader = xml_ReaderCreate(s, s);
@@ -103,14 +156,14 @@ Node* DOMParser::processNode(bool b_strict)
             case XML_READER_STARTELEM:
             {
                 bool empty = xml_ReaderIsEmptyElement(vlc_reader);
-                Node *node = new (std::nothrow) Node();
+                Node *node = newNode();
                 if(node)
                 {
                     if(!lifo.empty())
                         lifo.top()->addSubNode(node);
                     lifo.push(node);
 
-                    node->setName(std::string(data));
+                    node->setName(intern(data));
                     addAttributesToNode(node);
                 }
 
@@ -122,7 +175,10 @@ Node* DOMParser::processNode(bool b_strict)
             case XML_READER_TEXT:
             {
                 if(!lifo.empty())
+                {
                     lifo.top()->setText(std::string(data));
+                    bytes += lifo.top()->getText().capacity();
+                }
                 break;
             }
 
@@ -148,10 +204,7 @@ Node* DOMParser::processNode(bool b_strict)
     Node *node = (!lifo.empty()) ? lifo.top() : nullptr;
 
     if(b_strict && node)
-    {
-        delete node;
         return nullptr;
-    }
 
     return node;
 }
@@ -163,9 +216,10 @@ void    DOMParser::addAttributesToNode      (Node *node)
 
     while((attrName = xml_ReaderNextAttr(this->vlc_reader, &attrValue)) != nullptr)
     {
-        std::string key     = attrName;
         std::string value   = attrValue;
-        node->addAttribute(key, value);
+        node->addAttribute(intern(attrName), value);
+        bytes += sizeof(Node::Attribute) + value.size();
+        attributes++;
     }
 }
 void    DOMParser::print                    (Node *node, int offset)
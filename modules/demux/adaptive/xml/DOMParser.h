@@ -30,6 +30,9 @@
 
 #include "Node.h"
 
+#include <list>
+#include <unordered_set>
+
 namespace adaptive
 {
     namespace xml
@@ -52,7 +55,18 @@ namespace adaptive
 
                 xml_reader_t        *vlc_reader;
 
+                /* Nodes arena: blocks are reserved once and never grow, so
+                 * that node addresses stay valid */
+                std::list<std::vector<Node>>     nodes;
+                /* Element and attribute names, shared by all nodes */
+                std::unordered_set<std::string>  names;
+                size_t              attributes;
+                size_t              bytes;
+
                 Node*   processNode             (bool);
+                Node*   newNode                 ();
+                const std::string * intern      (const char *);
+                void    clear                   ();
                 void    addAttributesToNode     (Node *node);
                 void    print                   (Node *node, int offset);
         };
@@ -36,13 +36,12 @@ using namespace adaptive::xml;
 const std::string   Node::EmptyString = "";
 
 Node::Node() :
+    name( &EmptyString ),
     type( -1 )
 {
 }
 Node::~Node ()
 {
-    for(size_t i = 0; i < this->subNodes.size(); i++)
-        delete(this->subNodes.at(i));
 }
 
 const std::vector<Node*>&           Node::getSubNodes           () const
@@ -55,41 +54,57 @@ void                                Node::addSubNode            (Node *node)
 }
 const std::string&                  Node::getName               () const
 {
-    return this->name;
+    return *this->name;
 }
-void                                Node::setName               (const std::string& name)
+void                                Node::setName               (const std::string *name)
 {
     this->name = name;
 }
 
-bool                                Node::hasAttribute        (const std::string& name) const
+/* Elements have a handful of attributes: a linear search is cheaper than
+ * any lookup structure */
+const Node::Attribute *             Node::findAttribute         (const std::string& key) const
 {
-    if(this->attributes.find(name) != this->attributes.end())
-        return true;
+    std::vector<Attribute>::const_iterator it;
 
-    return false;
+    for(it = this->attributes.begin(); it != this->attributes.end(); ++it)
+    {
+        if(*(*it).name == key)
+            return &(*it);
+    }
+    return nullptr;
+}
+
+bool                                Node::hasAttribute        (const std::string& name) const
+{
+    return findAttribute(name) != nullptr;
 }
 const std::string&                  Node::getAttributeValue     (const std::string& key) const
 {
-    std::map<std::string, std::string>::const_iterator  it = this->attributes.find( key );
+    const Attribute *attr = findAttribute( key );
 
-    if ( it != this->attributes.end() )
-        return it->second;
+    if ( attr != nullptr )
+        return attr->value;
     return EmptyString;
 }
 
-void                                Node::addAttribute          ( const std::string& key, const std::string& value)
+void                                Node::addAttribute          ( const std::string *key, const std::string& value)
 {
-    this->attributes[key] = value;
+    Attribute *attr = const_cast<Attribute *>(findAttribute( *key ));
+
+    if ( attr != nullptr )
+        attr->value = value;
+    else
+        this->attributes.push_back( { key, value } );
 }
 std::vector<std::string>            Node::getAttributeKeys      () const
 {
     std::vector<std::string> keys;
-    std::map<std::string, std::string>::const_iterator it;
+    std::vector<Attribute>::const_iterator it;
 
     for(it = this->attributes.begin(); it != this->attributes.end(); ++it)
     {
-        keys.push_back(it->first);
+        keys.push_back(*(*it).name);
     }
     return keys;
 }
@@ -104,7 +119,7 @@ void Node::setText(const std::string &text)
     this->text = text;
 }
 
-const std::map<std::string,std::string>&   Node::getAttributes         () const
+const std::vector<Node::Attribute>&       Node::getAttributes         () const
 {
     return this->attributes;
 }
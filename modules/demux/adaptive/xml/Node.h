@@ -27,29 +27,37 @@
 
 #include <vector>
 #include <string>
-#include <map>
 
 namespace adaptive
 {
     namespace xml
     {
+        /* Nodes are allocated and owned by the DOMParser that created them,
+         * and their element and attribute names are shared through its
+         * pool: a node is only valid during the lifetime of its parser. */
         class Node
         {
             public:
+                struct Attribute
+                {
+                    const std::string *name;
+                    std::string        value;
+                };
+
                 Node            ();
                 virtual ~Node   ();
 
                 const std::vector<Node *>&          getSubNodes         () const;
                 void                                addSubNode          (Node *node);
                 const std::string&                  getName             () const;
-                void                                setName             (const std::string& name);
+                void                                setName             (const std::string *name);
                 bool                                hasAttribute        (const std::string& name) const;
-                void                                addAttribute        (const std::string& key, const std::string& value);
+                void                                addAttribute        (const std::string *key, const std::string& value);
                 const std::string&                  getAttributeValue   (const std::string& key) const;
                 std::vector<std::string>            getAttributeKeys    () const;
                 const std::string&                  getText             () const;
                 void                                setText( const std::string &text );
-                const std::map<std::string, std::string>& getAttributes () const;
+                const std::vector<Attribute>&       getAttributes       () const;
                 int                                 getType() const;
                 void                                setType( int type );
                 std::vector<std::string>            toString(int) const;
@@ -57,11 +65,12 @@ namespace adaptive
             private:
                 static const std::string            EmptyString;
                 std::vector<Node *>                 subNodes;
-                std::map<std::string, std::string>  attributes;
-                std::string                         name;
+                std::vector<Attribute>              attributes;
+                const std::string                  *name;
                 std::string                         text;
                 int                                 type;
 
+                const Attribute *                   findAttribute       (const std::string& key) const;
         };
     }
 }
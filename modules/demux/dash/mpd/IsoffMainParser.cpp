@@ -107,51 +107,38 @@ MPD * IsoffMainParser::parse()
 
 void    IsoffMainParser::parseMPDAttributes   (MPD *mpd, xml::Node *node)
 {
-    const std::map<std::string, std::string> & attr = node->getAttributes();
+    if(node->hasAttribute("mediaPresentationDuration"))
+        mpd->duration.Set(IsoTime(node->getAttributeValue("mediaPresentationDuration")));
 
-    std::map<std::string, std::string>::const_iterator it;
+    if(node->hasAttribute("minBufferTime"))
+        mpd->setMinBuffering(IsoTime(node->getAttributeValue("minBufferTime")));
 
-    it = attr.find("mediaPresentationDuration");
-    if(it != attr.end())
-        mpd->duration.Set(IsoTime(it->second));
-
-    it = attr.find("minBufferTime");
-    if(it != attr.end())
-        mpd->setMinBuffering(IsoTime(it->second));
-
-    it = attr.find("minimumUpdatePeriod");
-    if(it != attr.end())
+    if(node->hasAttribute("minimumUpdatePeriod"))
     {
         mpd->b_needsUpdates = true;
-        vlc_tick_t minupdate = IsoTime(it->second);
+        vlc_tick_t minupdate = IsoTime(node->getAttributeValue("minimumUpdatePeriod"));
         if(minupdate > 0)
             mpd->minUpdatePeriod.Set(minupdate);
     }
     else mpd->b_needsUpdates = false;
 
-    it = attr.find("maxSegmentDuration");
-    if(it != attr.end())
-        mpd->maxSegmentDuration.Set(IsoTime(it->second));
+    if(node->hasAttribute("maxSegmentDuration"))
+        mpd->maxSegmentDuration.Set(IsoTime(node->getAttributeValue("maxSegmentDuration")));
 
-    it = attr.find("type");
-    if(it != attr.end())
-        mpd->setType(it->second);
+    if(node->hasAttribute("type"))
+        mpd->setType(node->getAttributeValue("type"));
 
-    it = attr.find("availabilityStartTime");
-    if(it != attr.end())
-        mpd->availabilityStartTime.Set(UTCTime(it->second).mtime());
+    if(node->hasAttribute("availabilityStartTime"))
+        mpd->availabilityStartTime.Set(UTCTime(node->getAttributeValue("availabilityStartTime")).mtime());
 
-    it = attr.find("availabilityEndTime");
-    if(it != attr.end())
-        mpd->availabilityEndTime.Set(UTCTime(it->second).mtime());
+    if(node->hasAttribute("availabilityEndTime"))
+        mpd->availabilityEndTime.Set(UTCTime(node->getAttributeValue("availabilityEndTime")).mtime());
 
-    it = attr.find("timeShiftBufferDepth");
-        if(it != attr.end())
-            mpd->timeShiftBufferDepth.Set(IsoTime(it->second));
+    if(node->hasAttribute("timeShiftBufferDepth"))
+        mpd->timeShiftBufferDepth.Set(IsoTime(node->getAttributeValue("timeShiftBufferDepth")));
 
-    it = attr.find("suggestedPresentationDelay");
-    if(it != attr.end())
-        mpd->suggestedPresentationDelay.Set(IsoTime(it->second));
+    if(node->hasAttribute("suggestedPresentationDelay"))
+        mpd->suggestedPresentationDelay.Set(IsoTime(node->getAttributeValue("suggestedPresentationDelay")));
 }
 
 void IsoffMainParser::parsePeriods(MPD *mpd, Node *root)
@@ -0,0 +1,178 @@
+/*****************************************************************************
+ * hls_test.cpp: HLS live playlist refresh test
+ *****************************************************************************
+ * Copyright (C) 2026 VideoLabs, VideoLAN and VLC Authors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#undef NDEBUG
+
+#include "playlist/Parser.hpp"
+#include "playlist/M3U8.hpp"
+#include "playlist/Representation.hpp"
+#include "playlist/HLSSegment.hpp"
+#include "../adaptive/playlist/BasePeriod.h"
+#include "../adaptive/playlist/BaseAdaptationSet.h"
+#include "../adaptive/playlist/SegmentList.h"
+#include "../adaptive/tools/Retrieve.hpp"
+
+#include <vlc_common.h>
+#include <vlc_block.h>
+#include <vlc_stream.h>
+
+#include <cassert>
+#include <cstring>
+#include <string>
+
+using namespace adaptive;
+using namespace hls::playlist;
+
+const char vlc_module_name[] = "hls_test";
+
+#define URL "http://example.com/live/index.m3u8"
+
+/* Playlists served on refresh, with and without a delta update request */
+static std::string full;
+static std::string delta;
+static std::string lasturl;
+static unsigned requests;
+
+block_t * Retrieve::HTTP(SharedResources *, const std::string &uri)
+{
+    const bool b_delta = uri.find("_HLS_skip=YES") != std::string::npos;
+    const std::string &text = b_delta ? delta : full;
+
+    lasturl = uri;
+    requests++;
+
+    block_t *p_block = block_Alloc(text.size());
+    assert(p_block);
+    memcpy(p_block->p_buffer, text.data(), text.size());
+    return p_block;
+}
+
+static std::string segments(uint64_t first, uint64_t last)
+{
+    std::string text;
+    for(uint64_t i = first; i <= last; i++)
+        text += "#EXTINF:4.0,\nseg" + std::to_string(i) + ".ts\n";
+    return text;
+}
+
+static std::string header(uint64_t sequence, bool b_canskip)
+{
+    std::string text = "#EXTM3U\n"
+                       "#EXT-X-VERSION:9\n"
+                       "#EXT-X-TARGETDURATION:4\n";
+    if(b_canskip)
+        text += "#EXT-X-SERVER-CONTROL:CAN-SKIP-UNTIL=24.0\n";
+    return text + "#EXT-X-MEDIA-SEQUENCE:" + std::to_string(sequence) + "\n";
+}
+
+/* Checks that the list holds the given segments, 4s long and contiguous */
+static void check(Representation *rep, uint64_t first, uint64_t last)
+{
+    const std::vector<Segment *> &list = rep->inheritSegmentList()->getSegments();
+    assert(list.size() == last - first + 1);
+
+    const Timescale timescale = rep->inheritTimescale();
+    const HLSSegment *prev = nullptr;
+    for(const Segment *segment : list)
+    {
+        assert(segment->getSequenceNumber() == first);
+        assert(segment->getUrlSegment().toString() ==
+               "http://example.com/live/seg" + std::to_string(first) + ".ts");
+        assert(timescale.ToTime(segment->duration.Get()) == VLC_TICK_FROM_SEC(4));
+        if(prev)
+            assert(segment->startTime.Get() ==
+                   prev->startTime.Get() + prev->duration.Get());
+        prev = static_cast<const HLSSegment *>(segment);
+        first++;
+    }
+}
+
+static void refresh(Representation *rep)
+{
+    assert(rep->runLocalUpdates(nullptr));
+    rep->scheduleNextUpdate(0, true);
+}
+
+int main()
+{
+    vlc_object_t *obj = static_cast<vlc_object_t *>(
+                vlc_object_create(static_cast<vlc_object_t *>(nullptr),
+                                  sizeof(vlc_object_t)));
+    assert(obj);
+
+    std::string text = header(10, true) + segments(10, 13);
+    stream_t *stream = vlc_stream_MemoryNew(obj,
+                            reinterpret_cast<uint8_t *>(&text[0]),
+                            text.size(), true);
+    assert(stream);
+
+    M3U8Parser parser(nullptr);
+    M3U8 *playlist = parser.parse(obj, stream, URL);
+    vlc_stream_Delete(stream);
+    assert(playlist);
+
+    BaseRepresentation *base = playlist->getFirstPeriod()->
+                               getAdaptationSets().front()->
+                               getRepresentations().front();
+    Representation *rep = dynamic_cast<Representation *>(base);
+    assert(rep && rep->isLive());
+    check(rep, 10, 13);
+
+    /* The server supports delta updates: skipped segments are kept, and the
+       new ones are appended after them */
+    delta = header(11, true) + "#EXT-X-SKIP:SKIPPED-SEGMENTS=3\n" +
+            segments(14, 15);
+    refresh(rep);
+    assert(requests == 1 && lasturl == URL "?_HLS_skip=YES");
+    check(rep, 11, 15);
+
+    /* The delta update skips segments we don't have: reloaded in full */
+    delta = header(20, true) + "#EXT-X-SKIP:SKIPPED-SEGMENTS=3\n" +
+            segments(23, 23);
+    full = header(20, false) + segments(20, 23);
+    refresh(rep);
+    assert(requests == 3 && lasturl == URL);
+    check(rep, 20, 23);
+
+    /* Delta updates are no longer advertised: the known segments are skipped
+       by the parser, and the new ones are appended */
+    full = header(21, false) + segments(21, 24);
+    refresh(rep);
+    assert(requests == 4 && lasturl == URL);
+    check(rep, 21, 24);
+
+    /* Advertised again */
+    full = header(22, true) + segments(22, 25);
+    refresh(rep);
+    assert(requests == 5 && lasturl == URL);
+    check(rep, 22, 25);
+    delta = header(23, true) + "#EXT-X-SKIP:SKIPPED-SEGMENTS=3\n" +
+            segments(26, 26);
+    refresh(rep);
+    assert(requests == 6 && lasturl == URL "?_HLS_skip=YES");
+    check(rep, 23, 26);
+
+    delete playlist;
+    vlc_object_delete(obj);
+    return 0;
+}
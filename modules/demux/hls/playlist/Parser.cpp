@@ -152,23 +152,54 @@ void M3U8Parser::createAndFillRepresentation(vlc_object_t *p_obj, BaseAdaptation
 
 bool M3U8Parser::appendSegmentsFromPlaylistURI(vlc_object_t *p_obj, Representation *rep)
 {
-    block_t *p_block = Retrieve::HTTP(resources, rep->getPlaylistUrl().toString());
-    if(p_block)
+    /* On live refreshes, only the segments following the known ones need to
+     * be parsed, and the server can omit the older ones (delta update) */
+    uint64_t firstunknown = 0;
+    bool b_delta = false;
+    const SegmentList *segmentList = rep->b_loaded && rep->isLive()
+                                   ? rep->inheritSegmentList() : nullptr;
+    if(segmentList && !segmentList->getSegments().empty())
     {
+        const Segment *last = segmentList->getSegments().back();
+        firstunknown = last->getSequenceNumber() + 1;
+        /* Keys of the skipped segments would not be known */
+        const HLSSegment *hlsLast = dynamic_cast<const HLSSegment *>(last);
+        b_delta = rep->canSkipUntil > 0 && hlsLast &&
+                  hlsLast->encryption.method == CommonEncryption::Method::None &&
+                  vlc_tick_now() - rep->lastUpdateTime < rep->canSkipUntil / 2;
+    }
+
+    for(;;)
+    {
+        std::string url = rep->getPlaylistUrl().toString();
+        if(b_delta)
+            url.append(url.find('?') == std::string::npos ? "?" : "&")
+               .append("_HLS_skip=YES");
+
+        block_t *p_block = Retrieve::HTTP(resources, url);
+        if(!p_block)
+            return false;
+
+        bool b_merged = true;
         stream_t *substream = vlc_stream_MemoryNew(p_obj, p_block->p_buffer, p_block->i_buffer, true);
         if(substream)
         {
-            std::list<Tag *> tagslist = parseEntries(substream);
+            std::list<Tag *> tagslist = parseEntries(substream, firstunknown);
             vlc_stream_Delete(substream);
 
-            parseSegments(p_obj, rep, tagslist);
+            b_merged = parseSegments(p_obj, rep, tagslist);
 
             releaseTagsList(tagslist);
         }
         block_Release(p_block);
-        return true;
+
+        if(b_merged || !b_delta)
+            return true;
+
+        /* The delta update skipped segments we don't have */
+        msg_Dbg(p_obj, "playlist delta update does not match, reloading");
+        b_delta = false;
     }
-    return false;
 }
 
 static bool parseEncryption(const AttributesTag *keytag, const Url &playlistUrl,
@@ -206,18 +237,23 @@ static bool parseEncryption(const AttributesTag *keytag, const Url &playlistUrl,
     }
 }
 
-void M3U8Parser::parseSegments(vlc_object_t *, Representation *rep, const std::list<Tag *> &tagslist)
+bool M3U8Parser::parseSegments(vlc_object_t *, Representation *rep, const std::list<Tag *> &tagslist)
 {
+    SegmentList *currentList = rep->inheritSegmentList();
     SegmentList *segmentList = new (std::nothrow) SegmentList(rep);
 
     Timescale timescale(100);
     rep->addAttribute(new TimescaleAttr(timescale));
     rep->b_loaded = true;
+    /* Unless still advertised: delta updates carry the server control too */
+    rep->canSkipUntil = 0;
 
     vlc_tick_t totalduration = 0;
     vlc_tick_t nzStartTime = 0;
     vlc_tick_t absReferenceTime = VLC_TICK_INVALID;
     uint64_t sequenceNumber = 0;
+    uint64_t firstSequenceNumber = 0;
+    bool b_incremental = false;
     bool discontinuity = false;
     std::size_t prevbyterangeoffset = 0;
     const SingleValueTag *ctx_byterange = nullptr;
@@ -234,6 +270,48 @@ void M3U8Parser::parseSegments(vlc_object_t *, Representation *rep, const std::l
             case SingleValueTag::EXTXMEDIASEQUENCE:
             {
                 sequenceNumber = (static_cast<const SingleValueTag*>(tag))->getValue().decimal();
+                firstSequenceNumber = sequenceNumber;
+            }
+            break;
+
+            case AttributesTag::EXTXSKIP:
+            {
+                /* Segments replaced by the server (delta update) or skipped as
+                   already known: resume from the last skipped one */
+                const Attribute *countAttr = static_cast<const AttributesTag *>(tag)->
+                                             getAttributeByName("SKIPPED-SEGMENTS");
+                if(!countAttr || countAttr->decimal() == 0)
+                    break;
+                sequenceNumber += countAttr->decimal();
+
+                const HLSSegment *last = nullptr;
+                if(currentList)
+                    last = dynamic_cast<const HLSSegment *>(
+                                currentList->getMediaSegment(sequenceNumber - 1));
+                if(!last)
+                {
+                    delete segmentList;
+                    return false;
+                }
+
+                b_incremental = true;
+                nzStartTime = timescale.ToTime(last->startTime.Get() + last->duration.Get());
+                totalduration = nzStartTime;
+                absReferenceTime = last->utcTime
+                                 ? last->utcTime + timescale.ToTime(last->duration.Get())
+                                 : VLC_TICK_INVALID;
+                prevbyterangeoffset = last->endByte ? last->endByte + 1 : 0;
+                ctx_extinf = nullptr;
+                ctx_byterange = nullptr;
+                discontinuity = false;
+            }
+            break;
+
+            case AttributesTag::EXTXSERVERCONTROL:
+            {
+                const Attribute *skipAttr = static_cast<const AttributesTag *>(tag)->
+                                            getAttributeByName("CAN-SKIP-UNTIL");
+                rep->canSkipUntil = skipAttr ? vlc_tick_from_sec(skipAttr->floatingPoint()) : 0;
             }
             break;
 
@@ -366,7 +444,17 @@ void M3U8Parser::parseSegments(vlc_object_t *, Representation *rep, const std::l
         rep->getPlaylist()->duration.Set(totalduration);
     }
 
-    rep->updateSegmentList(segmentList, true);
+    if(b_incremental)
+    {
+        /* Only new segments were parsed, the window start is given by the
+           media sequence */
+        currentList->mergeSegments(segmentList, true);
+        currentList->pruneBySegmentNumber(firstSequenceNumber);
+        delete segmentList;
+    }
+    else rep->updateSegmentList(segmentList, true);
+
+    return true;
 }
 M3U8 * M3U8Parser::parse(vlc_object_t *p_object, stream_t *p_stream, const std::string &playlisturl)
 {
@@ -585,11 +673,34 @@ M3U8 * M3U8Parser::parse(vlc_object_t *p_object, stream_t *p_stream, const std::
     return playlist;
 }
 
-std::list<Tag *> M3U8Parser::parseEntries(stream_t *stream)
+/* Tags only applying to the next media segment */
+static bool isSegmentTag(const std::string &key)
+{
+    return key == "EXTINF" ||
+           key == "EXT-X-BYTERANGE" ||
+           key == "EXT-X-DISCONTINUITY" ||
+           key == "EXT-X-PROGRAM-DATE-TIME";
+}
+
+/* Segments numbered below firstunknown are replaced with an EXT-X-SKIP tag */
+std::list<Tag *> M3U8Parser::parseEntries(stream_t *stream, uint64_t firstunknown)
 {
     std::list<Tag *> entrieslist;
     Tag *lastTag = nullptr;
     char *psz_line;
+    uint64_t sequence = 0;
+    uint64_t skipped = 0;
+
+    auto flushSkipped = [&]()
+    {
+        if(skipped == 0)
+            return;
+        Tag *tag = TagFactory::createTagByName("EXT-X-SKIP",
+                        "SKIPPED-SEGMENTS=" + std::to_string(skipped));
+        if(tag)
+            entrieslist.push_back(tag);
+        skipped = 0;
+    };
 
     while((psz_line = vlc_stream_ReadLine(stream)))
     {
@@ -612,9 +723,33 @@ std::list<Tag *> M3U8Parser::parseEntries(stream_t *stream)
 
                 if(!key.empty())
                 {
+                    if(sequence < firstunknown && isSegmentTag(key))
+                    {
+                        lastTag = nullptr;
+                        free(psz_line);
+                        continue;
+                    }
+
                     Tag *tag = TagFactory::createTagByName(key, attributes);
                     if(tag)
+                    {
+                        if(tag->getType() == SingleValueTag::EXTXMEDIASEQUENCE)
+                        {
+                            sequence = static_cast<SingleValueTag *>(tag)->getValue().decimal();
+                        }
+                        else if(tag->getType() == AttributesTag::EXTXSKIP)
+                        {
+                            const Attribute *countAttr = static_cast<AttributesTag *>(tag)->
+                                                         getAttributeByName("SKIPPED-SEGMENTS");
+                            if(countAttr)
+                                sequence += countAttr->decimal();
+                        }
+                        else if(sequence >= firstunknown)
+                        {
+                            flushSkipped();
+                        }
                         entrieslist.push_back(tag);
+                    }
                     lastTag = tag;
                 }
             }
@@ -630,11 +765,18 @@ std::list<Tag *> M3U8Parser::parseEntries(stream_t *stream)
                 if(uriAttr)
                     streaminftag->addAttribute(uriAttr);
             }
+            else if(sequence < firstunknown) /* already known segment */
+            {
+                sequence++;
+                skipped++;
+            }
             else /* playlist tag, will take modifiers */
             {
+                flushSkipped();
                 Tag *tag = TagFactory::createTagByName("", std::string(psz_line));
                 if(tag)
                     entrieslist.push_back(tag);
+                sequence++;
             }
             lastTag = nullptr;
         }
@@ -646,5 +788,7 @@ std::list<Tag *> M3U8Parser::parseEntries(stream_t *stream)
         free(psz_line);
     }
 
+    flushSkipped();
+
     return entrieslist;
 }
@@ -65,8 +65,8 @@ namespace hls
                 Representation * createRepresentation(BaseAdaptationSet *, const AttributesTag *);
                 void createAndFillRepresentation(vlc_object_t *, BaseAdaptationSet *,
                                                  const AttributesTag *, const std::list<Tag *>&);
-                void parseSegments(vlc_object_t *, Representation *, const std::list<Tag *>&);
-                std::list<Tag *> parseEntries(stream_t *);
+                bool parseSegments(vlc_object_t *, Representation *, const std::list<Tag *>&);
+                std::list<Tag *> parseEntries(stream_t *, uint64_t = 0);
                 adaptive::SharedResources *resources;
         };
     }
@@ -46,6 +46,7 @@ Representation::Representation  ( BaseAdaptationSet *set ) :
     b_loaded = false;
     b_failed = false;
     lastUpdateTime = 0;
+    canSkipUntil = 0;
     targetDuration = 0;
     streamFormat = StreamFormat::UNKNOWN;
 }
@@ -60,6 +60,7 @@ namespace hls
                 bool b_loaded;
                 bool b_failed;
                 vlc_tick_t lastUpdateTime;
+                vlc_tick_t canSkipUntil; /* delta updates skip boundary, 0 if unsupported */
                 time_t targetDuration;
                 Url playlistUrl;
         };
@@ -99,6 +99,8 @@ namespace hls
                     EXTXSTART,
                     EXTXSTREAMINF,
                     EXTXSESSIONKEY,
+                    EXTXSERVERCONTROL,
+                    EXTXSKIP,
                 };
                 AttributesTag(int, const std::string &);
                 virtual ~AttributesTag();
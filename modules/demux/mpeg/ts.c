@@ -196,6 +196,8 @@ static bool GatherPESData( demux_t *p_demux, ts_pid_t *, block_t *, size_t );
 static void ProgramSetPCR( demux_t *p_demux, ts_pmt_t *p_prg, stime_t i_pcr );
 
 static block_t* ReadTSPacket( demux_t *p_demux );
+static block_t* ReadDescrambledTSPacket( demux_t *p_demux );
+static void FlushDescrambledTSPackets( demux_sys_t *p_sys );
 static int SeekToTime( demux_t *p_demux, const ts_pmt_t *, stime_t time );
 static void ReadyQueuesPostSeek( demux_t *p_demux );
 static void PCRHandle( demux_t *p_demux, ts_pid_t *, stime_t );
@@ -402,6 +404,8 @@ static int Open( vlc_object_t *p_this )
     p_sys->i_packet_header_size = i_packet_header_size;
     p_sys->i_ts_read = 50;
     p_sys->csa = NULL;
+    p_sys->csa_batch.p_head = NULL;
+    p_sys->csa_batch.pp_last = &p_sys->csa_batch.p_head;
     p_sys->b_start_record = false;
 
     vlc_dictionary_init( &p_sys->attachments, 0 );
@@ -574,6 +578,7 @@ static void Close( vlc_object_t *p_this )
         csa_Delete( p_sys->csa );
     }
     vlc_mutex_unlock( &p_sys->csa_lock );
+    FlushDescrambledTSPackets( p_sys );
 
     ARRAY_RESET( p_sys->programs );
 
@@ -641,7 +646,7 @@ static int Demux( demux_t *p_demux )
         bool         b_frame = false;
         int          i_header = 0;
         block_t     *p_pkt;
-        if( !(p_pkt = ReadTSPacket( p_demux )) )
+        if( !(p_pkt = ReadDescrambledTSPacket( p_demux )) )
         {
             return VLC_DEMUXER_EOF;
         }
@@ -1837,6 +1842,60 @@ static block_t* ReadTSPacket( demux_t *p_demux )
     return p_pkt;
 }
 
+/* Same as ReadTSPacket(), but reads ahead to descramble packets by batches */
+static block_t* ReadDescrambledTSPacket( demux_t *p_demux )
+{
+    demux_sys_t *p_sys = p_demux->p_sys;
+
+    if( p_sys->csa == NULL )
+        return ReadTSPacket( p_demux );
+
+    if( p_sys->csa_batch.p_head == NULL )
+    {
+        uint8_t *pkts[CSA_BATCH_PACKETS];
+        size_t i_pkts = 0;
+
+        for( size_t i = 0; i < CSA_BATCH_PACKETS; i++ )
+        {
+            block_t *p_pkt = ReadTSPacket( p_demux );
+            if( p_pkt == NULL )
+                break;
+            block_ChainLastAppend( &p_sys->csa_batch.pp_last, p_pkt );
+
+            /* Same packets as ProcessTSPacket() would descramble */
+            const uint8_t *p = p_pkt->p_buffer;
+            if( p_pkt->i_buffer >= TS_PACKET_SIZE_188 &&
+                (p[1]&0x80) == 0 && (p[3]&0xc0) &&
+                PIDGet( p_pkt ) != 0x1FFF )
+                pkts[i_pkts++] = p_pkt->p_buffer;
+        }
+
+        if( i_pkts > 0 )
+        {
+            vlc_mutex_lock( &p_sys->csa_lock );
+            csa_DecryptBatch( p_sys->csa, pkts, i_pkts, p_sys->i_csa_pkt_size );
+            vlc_mutex_unlock( &p_sys->csa_lock );
+        }
+    }
+
+    block_t *p_pkt = p_sys->csa_batch.p_head;
+    if( p_pkt != NULL )
+    {
+        p_sys->csa_batch.p_head = p_pkt->p_next;
+        if( p_sys->csa_batch.p_head == NULL )
+            p_sys->csa_batch.pp_last = &p_sys->csa_batch.p_head;
+        p_pkt->p_next = NULL;
+    }
+    return p_pkt;
+}
+
+static void FlushDescrambledTSPackets( demux_sys_t *p_sys )
+{
+    block_ChainRelease( p_sys->csa_batch.p_head );
+    p_sys->csa_batch.p_head = NULL;
+    p_sys->csa_batch.pp_last = &p_sys->csa_batch.p_head;
+}
+
 static stime_t GetPCR( const block_t *p_pkt )
 {
     const uint8_t *p = p_pkt->p_buffer;
@@ -1904,6 +1963,8 @@ static void ReadyQueuesPostSeek( demux_t *p_demux )
 {
     demux_sys_t *p_sys = p_demux->p_sys;
 
+    FlushDescrambledTSPackets( p_sys );
+
     ts_pat_t *p_pat = GetPID(p_sys, 0)->u.p_pat;
     for( int i=0; i< p_pat->programs.i_size; i++ )
     {
@@ -101,6 +101,12 @@ struct demux_sys_t
 
     csa_t       *csa;
     int         i_csa_pkt_size;
+    /* Packets read ahead, to be descrambled by batches */
+    struct
+    {
+        block_t *p_head;
+        block_t **pp_last;
+    } csa_batch;
     bool        b_split_es;
     bool        b_valid_scrambling;
 
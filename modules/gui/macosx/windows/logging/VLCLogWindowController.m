@@ -71,7 +71,7 @@ static void MsgCallback(void *data, int type, const vlc_log_t *item, const char
     }
 }
 
-static const struct vlc_logger_operations log_ops = { MsgCallback, NULL };
+static const struct vlc_logger_operations log_ops = { MsgCallback, NULL, NULL };
 
 @implementation VLCLogWindowController
 
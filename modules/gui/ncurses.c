@@ -1643,7 +1643,7 @@ static void MsgCallback(void *data, int type, const vlc_log_t *msg,
     vlc_mutex_unlock(&sys->msg_lock);
 }
 
-static const struct vlc_logger_operations log_ops = { MsgCallback, NULL };
+static const struct vlc_logger_operations log_ops = { MsgCallback, NULL, NULL };
 
 /*****************************************************************************
  * Run: ncurses thread
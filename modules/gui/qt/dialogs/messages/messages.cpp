@@ -135,6 +135,7 @@ MessagesDialog::MessagesDialog( intf_thread_t *_p_intf)
     static const struct vlc_logger_operations log_ops =
     {
         MessagesDialog::MsgCallback,
+        NULL,
         NULL
     };
     libvlc_int_t *vlc = vlc_object_instance(p_intf);
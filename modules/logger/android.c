@@ -68,7 +68,7 @@ static void AndroidPrintMsg(void *opaque, int type, const vlc_log_t *p_item,
     free(format2);
 }
 
-static const struct vlc_logger_operations ops = { AndroidPrintMsg, NULL };
+static const struct vlc_logger_operations ops = { AndroidPrintMsg, NULL, NULL };
 
 static const struct vlc_logger_operations *Open(vlc_object_t *obj, void **sysp)
 {
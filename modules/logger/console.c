@@ -98,6 +98,7 @@ static void LogConsoleColor(void *opaque, int type, const vlc_log_t *meta,
 static const struct vlc_logger_operations color_ops =
 {
     LogConsoleColor,
+    NULL,
     NULL
 };
 #endif /* !_WIN32 */
@@ -128,6 +129,7 @@ static void LogConsoleGray(void *opaque, int type, const vlc_log_t *meta,
 static const struct vlc_logger_operations gray_ops =
 {
     LogConsoleGray,
+    NULL,
     NULL
 };
 
@@ -74,10 +74,18 @@ static void Close(void *opaque)
     free(sys);
 }
 
+static void Flush(void *opaque)
+{
+    vlc_logger_sys_t *sys = opaque;
+
+    fflush(sys->stream);
+}
+
 static const struct vlc_logger_operations text_ops =
 {
     LogText,
-    Close
+    Close,
+    Flush
 };
 
 #define HTML_FILENAME "vlc-log.html"
@@ -123,7 +131,8 @@ static void LogHtml(void *opaque, int type, const vlc_log_t *meta,
 static const struct vlc_logger_operations html_ops =
 {
     LogHtml,
-    Close
+    Close,
+    Flush
 };
 
 static const struct vlc_logger_operations *Open(vlc_object_t *obj,
@@ -195,7 +204,10 @@ static const struct vlc_logger_operations *Open(vlc_object_t *obj,
     }
     free(path);
 
-    setvbuf(sys->stream, NULL, _IOLBF, 0);
+    /* With asynchronous logging, the core flushes the stream whenever all
+     * pending messages are written; there is no need to flush every line. */
+    setvbuf(sys->stream, NULL,
+            var_InheritBool(obj, "log-async") ? _IOFBF : _IOLBF, 0);
     fputs(header, sys->stream);
 
     *sysp = sys;
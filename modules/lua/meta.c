@@ -129,6 +129,8 @@ static int run( vlc_object_t *p_this, const char * psz_filename,
         msg_Warn( p_this, "Error while running script %s, "
                  "function %s(): %s", psz_filename, luafunction,
                  lua_tostring( L, lua_gettop( L ) ) );
+        if( p_context && p_context->pb_incomplete )
+            *p_context->pb_incomplete = true;
         goto error;
     }
     return VLC_SUCCESS;
@@ -257,7 +259,7 @@ int FetchMeta( meta_fetcher_t *p_finder )
     if( lua_Disabled( p_finder ) )
         return VLC_EGENERIC;
 
-    luabatch_context_t context = { p_finder->p_item, p_finder->e_scope, validate_scope };
+    luabatch_context_t context = { p_finder->p_item, p_finder->e_scope, validate_scope, NULL };
 
     return vlclua_scripts_batch_execute( VLC_OBJECT(p_finder), "meta"DIR_SEP"fetcher",
                                          &fetch_meta, (void*)&context );
@@ -272,7 +274,8 @@ int FindArt( meta_fetcher_t *p_finder )
     if( lua_Disabled( p_finder ) )
         return VLC_EGENERIC;
 
-    luabatch_context_t context = { p_finder->p_item, p_finder->e_scope, validate_scope };
+    luabatch_context_t context = { p_finder->p_item, p_finder->e_scope, validate_scope,
+                                   &p_finder->b_incomplete };
 
     return vlclua_scripts_batch_execute( VLC_OBJECT(p_finder), "meta"DIR_SEP"art",
                                          &fetch_art, (void*)&context );
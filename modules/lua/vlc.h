@@ -161,6 +161,7 @@ struct luabatch_context_t
     input_item_t *p_item;
     meta_fetcher_scope_t e_scope;
     bool (*pf_validator)( const luabatch_context_t *, meta_fetcher_scope_t );
+    bool *pb_incomplete; /* set if a script fails while running */
 };
 
 int vlclua_scripts_batch_execute( vlc_object_t *p_this, const char * luadirname,
@@ -42,11 +42,32 @@
 #include <gnutls/gnutls.h>
 #include <gnutls/x509.h>
 
+/** Number of TLS sessions remembered for resumption */
+#define GNUTLS_RESUME_CACHE 16
+
+/**
+ * Client-side TLS credentials private data
+ */
+typedef struct vlc_tls_client_sys
+{
+    gnutls_certificate_credentials_t x509;
+    vlc_mutex_t lock;
+    struct
+    {
+        char *key;
+        gnutls_datum_t data;
+    } resume[GNUTLS_RESUME_CACHE]; /**< Session resumption data per server */
+    unsigned resume_next; /**< Next cache entry to replace */
+} vlc_tls_client_sys_t;
+
 typedef struct vlc_tls_gnutls
 {
     vlc_tls_t tls;
     gnutls_session_t session;
     vlc_object_t *obj;
+    vlc_tls_client_sys_t *client; /**< Client credentials (or NULL) */
+    char *key; /**< Server name and port (client-side only) */
+    bool verified; /**< Whether the server was authenticated */
 } vlc_tls_gnutls_t;
 
 static void gnutls_Banner(vlc_object_t *obj)
@@ -203,11 +224,75 @@ static int gnutls_Shutdown(vlc_tls_t *tls, bool duplex)
     return 0;
 }
 
+/**
+ * Resumes the previous session with the same server and port, if any.
+ */
+static void gnutls_SessionResume(vlc_tls_gnutls_t *priv)
+{
+    vlc_tls_client_sys_t *sys = priv->client;
+
+    vlc_mutex_lock(&sys->lock);
+    for (unsigned i = 0; i < GNUTLS_RESUME_CACHE; i++)
+        if (sys->resume[i].key != NULL
+         && !strcmp(sys->resume[i].key, priv->key))
+        {
+            gnutls_session_set_data(priv->session, sys->resume[i].data.data,
+                                    sys->resume[i].data.size);
+            break;
+        }
+    vlc_mutex_unlock(&sys->lock);
+}
+
+/**
+ * Remembers the parameters of a client session, so that the next session to
+ * the same server and port can be resumed with an abbreviated handshake.
+ */
+static void gnutls_SessionSave(vlc_tls_gnutls_t *priv)
+{
+    vlc_tls_client_sys_t *sys = priv->client;
+    gnutls_datum_t data;
+
+    if (gnutls_session_get_data2(priv->session, &data) != 0)
+        return;
+
+    vlc_mutex_lock(&sys->lock);
+
+    unsigned i;
+    for (i = 0; i < GNUTLS_RESUME_CACHE; i++)
+        if (sys->resume[i].key != NULL
+         && !strcmp(sys->resume[i].key, priv->key))
+            break;
+
+    if (i == GNUTLS_RESUME_CACHE)
+    {   /* Replace the oldest entry */
+        char *key = strdup(priv->key);
+        if (unlikely(key == NULL))
+        {
+            vlc_mutex_unlock(&sys->lock);
+            gnutls_free(data.data);
+            return;
+        }
+
+        i = sys->resume_next;
+        sys->resume_next = (i + 1) % GNUTLS_RESUME_CACHE;
+        free(sys->resume[i].key);
+        sys->resume[i].key = key;
+    }
+
+    gnutls_free(sys->resume[i].data.data);
+    sys->resume[i].data = data;
+    vlc_mutex_unlock(&sys->lock);
+}
+
 static void gnutls_Close (vlc_tls_t *tls)
 {
     vlc_tls_gnutls_t *priv = (vlc_tls_gnutls_t *)tls;
 
+    if (priv->verified)
+        gnutls_SessionSave(priv);
+
     gnutls_deinit(priv->session);
+    free(priv->key);
     free(priv);
 }
 
@@ -295,6 +380,9 @@ static vlc_tls_gnutls_t *gnutls_SessionOpen(vlc_object_t *obj, int type,
 
     priv->session = session;
     priv->obj = obj;
+    priv->client = NULL;
+    priv->key = NULL;
+    priv->verified = false;
 
     vlc_tls_t *tls = &priv->tls;
 
@@ -377,8 +465,9 @@ static vlc_tls_t *gnutls_ClientSessionOpen(vlc_tls_client_t *crd,
                                            vlc_tls_t *sk, const char *hostname,
                                            const char *const *alpn)
 {
+    vlc_tls_client_sys_t *sys = crd->sys;
     vlc_tls_gnutls_t *priv = gnutls_SessionOpen(VLC_OBJECT(crd), GNUTLS_CLIENT,
-                                                crd->sys, sk, alpn);
+                                                sys->x509, sk, alpn);
     if (priv == NULL)
         return NULL;
 
@@ -388,16 +477,21 @@ static vlc_tls_t *gnutls_ClientSessionOpen(vlc_tls_client_t *crd,
     gnutls_dh_set_prime_bits (session, 1024);
 
     if (likely(hostname != NULL))
+    {
         /* fill Server Name Indication */
         gnutls_server_name_set (session, GNUTLS_NAME_DNS,
                                 hostname, strlen (hostname));
 
+        /* the session is resumed on handshake, once the port is known */
+        priv->client = sys;
+    }
+
     return &priv->tls;
 }
 
-static int gnutls_ClientHandshake(vlc_tls_t *tls,
-                                  const char *host, const char *service,
-                                  char **restrict alp)
+static int gnutls_ClientHandshakeVerify(vlc_tls_t *tls,
+                                        const char *host, const char *service,
+                                        char **restrict alp)
 {
     vlc_tls_gnutls_t *priv = (vlc_tls_gnutls_t *)tls;
     vlc_object_t *obj = priv->obj;
@@ -406,6 +500,12 @@ static int gnutls_ClientHandshake(vlc_tls_t *tls,
     if (val)
         return val;
 
+    if (gnutls_session_is_resumed(priv->session))
+    {
+        msg_Dbg(obj, "TLS session resumed");
+        return 0; /* the server was authenticated by the original session */
+    }
+
     /* certificates chain verification */
     gnutls_session_t session = priv->session;
     unsigned status;
@@ -529,11 +629,41 @@ error:
     return -1;
 }
 
+static int gnutls_ClientHandshake(vlc_tls_t *tls,
+                                  const char *host, const char *service,
+                                  char **restrict alp)
+{
+    vlc_tls_gnutls_t *priv = (vlc_tls_gnutls_t *)tls;
+
+    /* First call: resume the previous session with the same server */
+    if (priv->client != NULL && priv->key == NULL && host != NULL)
+    {
+        if (asprintf(&priv->key, "%s:%s", host,
+                     (service != NULL) ? service : "") == -1)
+            priv->key = NULL;
+        else
+            gnutls_SessionResume(priv);
+    }
+
+    int val = gnutls_ClientHandshakeVerify(tls, host, service, alp);
+
+    /* Only sessions with an authenticated server can be resumed */
+    if (val == 0 && priv->key != NULL)
+        priv->verified = true;
+    return val;
+}
+
 static void gnutls_ClientDestroy(vlc_tls_client_t *crd)
 {
-    gnutls_certificate_credentials_t x509 = crd->sys;
+    vlc_tls_client_sys_t *sys = crd->sys;
 
-    gnutls_certificate_free_credentials(x509);
+    for (unsigned i = 0; i < GNUTLS_RESUME_CACHE; i++)
+    {
+        free(sys->resume[i].key);
+        gnutls_free(sys->resume[i].data.data);
+    }
+    gnutls_certificate_free_credentials(sys->x509);
+    free(sys);
 }
 
 static const struct vlc_tls_client_operations gnutls_ClientOps =
@@ -586,8 +716,18 @@ static int OpenClient(vlc_tls_client_t *crd)
     gnutls_certificate_set_verify_flags (x509,
                                          GNUTLS_VERIFY_ALLOW_X509_V1_CA_CRT);
 
+    vlc_tls_client_sys_t *sys = calloc(1, sizeof (*sys));
+    if (unlikely(sys == NULL))
+    {
+        gnutls_certificate_free_credentials(x509);
+        return VLC_ENOMEM;
+    }
+
+    sys->x509 = x509;
+    vlc_mutex_init(&sys->lock);
+
     crd->ops = &gnutls_ClientOps;
-    crd->sys = x509;
+    crd->sys = sys;
     return VLC_SUCCESS;
 }
 
@@ -54,6 +54,12 @@
     "\"Fast Start\" files are optimized for downloads and allow the user " \
     "to start previewing the file while it is downloading.")
 
+#define FRAGDURATION_TEXT N_("Fragment duration (ms)")
+#define FRAGDURATION_LONGTEXT N_(\
+    "Maximum duration of the fragments of the fragmented muxer. " \
+    "Fragments still start on keyframes when possible. Short fragments " \
+    "reduce the latency of live streams (CMAF chunks).")
+
 static int  Open   (vlc_object_t *);
 static void Close  (vlc_object_t *);
 static void CloseFrag  (vlc_object_t *);
@@ -69,6 +75,9 @@ vlc_module_begin ()
     add_bool(SOUT_CFG_PREFIX "faststart", false,
               FASTSTART_TEXT, FASTSTART_LONGTEXT,
               true)
+    add_integer(SOUT_CFG_PREFIX "fragment-duration", 1500,
+                FRAGDURATION_TEXT, FRAGDURATION_LONGTEXT, true)
+        change_integer_range(20, 60000)
     set_capability("sout mux", 5)
     add_shortcut("mp4", "mov", "3gp")
     set_callbacks(Open, Close)
@@ -88,7 +97,7 @@ vlc_module_end ()
  * Exported prototypes
  *****************************************************************************/
 static const char *const ppsz_sout_options[] = {
-    "faststart", NULL
+    "faststart", "fragment-duration", NULL
 };
 
 static int Control(sout_mux_t *, int, va_list);
@@ -173,6 +182,7 @@ typedef struct
 
     /* mp4frag */
     vlc_tick_t     i_written_duration;
+    vlc_tick_t     i_fragment_length;
     uint32_t       i_mfhd_sequence;
 } sout_mux_sys_t;
 
@@ -292,6 +302,8 @@ static int Open(vlc_object_t *p_this)
     p_sys->i_written_duration= 0;
     p_sys->i_start_dts = VLC_TICK_INVALID;
     p_sys->i_mfhd_sequence = 1;
+    p_sys->i_fragment_length = VLC_TICK_FROM_MS(
+                var_GetInteger(p_mux, SOUT_CFG_PREFIX "fragment-duration"));
 
     p_mux->p_sys        = p_sys;
     p_mux->pf_control   = Control;
@@ -901,8 +913,6 @@ static void box_send(sout_mux_t *p_mux,  bo_t *box)
 /***************************************************************************
     MP4 Live submodule
 ****************************************************************************/
-#define FRAGMENT_LENGTH  VLC_TICK_FROM_MS(1500)
-
 #define ENQUEUE_ENTRY(object, entry) \
     do {\
         if (object.p_last)\
@@ -967,6 +977,8 @@ static bo_t *GetMoofBox(sout_mux_t *p_mux, size_t *pi_mdat_total_size,
 
     bo_t            *moof, *mfhd;
     size_t           i_fixupoffset = 0;
+    vlc_tick_t       i_length = 0;
+    bool             b_independent = true;
 
     *pi_mdat_total_size = 0;
 
@@ -1070,7 +1082,11 @@ static bo_t *GetMoofBox(sout_mux_t *p_mux, size_t *pi_mdat_total_size,
             uint32_t i_trun_flags = 0x0;
 
             if (p_stream->b_hasiframes && !(p_stream->read.p_first->p_block->i_flags & BLOCK_FLAG_TYPE_I))
+            {
                 i_trun_flags |= MP4_TRUN_FIRST_FLAGS;
+                if (mp4mux_track_GetFmt(p_stream->tinfo)->i_cat == VIDEO_ES)
+                    b_independent = false;
+            }
 
             if (!b_allsamelength ||
                 ( !(i_tfhd_flags & MP4_TFHD_DFLT_SAMPLE_DURATION) &&
@@ -1108,6 +1124,7 @@ static bo_t *GetMoofBox(sout_mux_t *p_mux, size_t *pi_mdat_total_size,
                 p_entry = p_entry->p_next;
             }
             bo_add_32be(trun, i_entry_count); // sample count
+            i_length = __MAX(i_length, i_run_time - p_stream->i_written_duration);
 
             if (i_trun_flags & MP4_TRUN_DATA_OFFSET)
             {
@@ -1178,8 +1195,13 @@ static bo_t *GetMoofBox(sout_mux_t *p_mux, size_t *pi_mdat_total_size,
         bo_set_32be(moof, i_fixupoffset, bo_size(moof) + 8);
     }
 
-    /* set iframe flag, so the streaming server always starts from moof */
-    moof->b->i_flags |= BLOCK_FLAG_TYPE_I;
+    /* let segmenters know the fragment timing, and whether it can be decoded
+     * on its own (LL-HLS independent parts): the streaming server starts
+     * from an I moof. Only moofs carry a frame type. */
+    moof->b->i_dts = VLC_TICK_0 + p_sys->i_written_duration;
+    moof->b->i_length = i_length;
+    moof->b->i_flags &= ~BLOCK_FLAG_TYPE_MASK;
+    moof->b->i_flags |= b_independent ? BLOCK_FLAG_TYPE_I : BLOCK_FLAG_TYPE_P;
 
     return moof;
 }
@@ -1210,7 +1232,7 @@ static void WriteFragmentMDAT(sout_mux_t *p_mux, size_t i_total_size)
             p_sys->i_pos += p_entry->p_block->i_buffer;
             p_stream->i_written_duration += p_entry->p_block->i_length;
 
-            p_entry->p_block->i_flags &= ~BLOCK_FLAG_TYPE_I; // clear flag for http stream
+            p_entry->p_block->i_flags &= ~BLOCK_FLAG_TYPE_MASK; // clear flag for http stream
             sout_AccessOutWrite(p_mux->p_access, p_entry->p_block);
 
             p_stream->towrite.p_first = p_entry->p_next;
@@ -1288,7 +1310,7 @@ static void WriteFragments(sout_mux_t *p_mux, bool b_flush)
 {
     sout_mux_sys_t *p_sys = (sout_mux_sys_t*) p_mux->p_sys;
     bo_t *moof = NULL;
-    vlc_tick_t i_barrier_time = p_sys->i_written_duration + FRAGMENT_LENGTH;
+    vlc_tick_t i_barrier_time = p_sys->i_written_duration + p_sys->i_fragment_length;
     size_t i_mdat_size = 0;
     bool b_has_samples = false;
 
@@ -1476,7 +1498,7 @@ static int MuxFrag(sout_mux_t *p_mux)
         p_stream->p_held_entry = NULL;
 
         if (p_stream->b_hasiframes && (p_heldblock->i_flags & BLOCK_FLAG_TYPE_I) &&
-            mp4mux_track_GetDuration(p_stream->tinfo) - p_sys->i_written_duration < FRAGMENT_LENGTH)
+            mp4mux_track_GetDuration(p_stream->tinfo) - p_sys->i_written_duration < p_sys->i_fragment_length)
         {
             /* Flag the last iframe time, we'll use it as boundary so it will start
                next fragment */
@@ -1529,7 +1551,7 @@ static int MuxFrag(sout_mux_t *p_mux)
     p_sys->i_written_duration = i_min_written_duration;
 
     /* we have prerolled enough to know all streams, and have enough date to create a fragment */
-    if (p_stream->read.p_first && p_sys->i_read_duration - p_sys->i_written_duration >= FRAGMENT_LENGTH)
+    if (p_stream->read.p_first && p_sys->i_read_duration - p_sys->i_written_duration >= p_sys->i_fragment_length)
         WriteFragments(p_mux, false);
 
     return VLC_SUCCESS;
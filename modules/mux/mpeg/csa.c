@@ -57,6 +57,50 @@ static void csa_StreamCypher( csa_t *c, int b_init, uint8_t *ck, uint8_t *sb, ui
 static void csa_BlockDecypher( uint8_t kk[57], uint8_t ib[8], uint8_t bd[8] );
 static void csa_BlockCypher( uint8_t kk[57], uint8_t bd[8], uint8_t ib[8] );
 
+/* Batch (de)scrambling: the stream cypher is bit-sliced (each bit of a
+ * csa_word belongs to a different packet), and the block cypher is
+ * byte-sliced (each byte of a csa_word belongs to a different block) */
+#if defined __has_attribute
+#  if __has_attribute(__vector_size__)
+#    define CSA_HAS_VECTORSIZE
+#  endif
+#endif
+
+#ifdef CSA_HAS_VECTORSIZE
+/* SSE2/NEON/AltiVec register, or pair of registers without SIMD */
+typedef uint64_t csa_word __attribute__((__vector_size__(16)));
+#  define CSA_WORD(x) ((csa_word){ (x), (x) })
+#else
+typedef uint64_t csa_word;
+#  define CSA_WORD(x) ((csa_word)(x))
+#endif
+#define CSA_BYTES(x) CSA_WORD(UINT64_C(0x0101010101010101) * (x))
+
+#define CSA_LANES   (8 * sizeof (csa_word)) /* packets per stream batch */
+#define CSA_BLOCKS  (sizeof (csa_word))     /* blocks per block batch */
+
+typedef union
+{
+    csa_word w;
+    uint64_t u[sizeof (csa_word) / 8];
+    uint8_t  b[sizeof (csa_word)];
+} csa_slice;
+
+struct csa_lane
+{
+    uint8_t *pkt;
+    int     i_hdr;
+    int     n;          /* number of 8 bytes blocks */
+    int     i_residue;
+};
+
+static void csa_StreamBatch( const uint8_t ck[8], struct csa_lane *, size_t,
+                             int i_pkt_size );
+static void csa_BlockDecryptBatch( const uint8_t kk[57], struct csa_lane *,
+                                   size_t );
+static void csa_BlockEncryptBatch( const uint8_t kk[57], struct csa_lane *,
+                                   size_t );
+
 /*****************************************************************************
  * csa_New:
  *****************************************************************************/
@@ -304,6 +348,129 @@ void csa_Encrypt( csa_t *c, uint8_t *pkt, int i_pkt_size )
     }
 }
 
+/*****************************************************************************
+ * csa_DecryptBatch:
+ *****************************************************************************/
+static void csa_DecryptLanes( const uint8_t ck[8], const uint8_t kk[57],
+                              struct csa_lane *lanes, size_t count,
+                              int i_pkt_size )
+{
+    /* remove the stream layer first: the blocks are then independent */
+    csa_StreamBatch( ck, lanes, count, i_pkt_size );
+    csa_BlockDecryptBatch( kk, lanes, count );
+}
+
+void csa_DecryptBatch( csa_t *c, uint8_t *const *pkts, size_t count,
+                       int i_pkt_size )
+{
+    struct csa_lane odd[CSA_LANES], even[CSA_LANES];
+    size_t i_odd = 0, i_even = 0;
+
+    for( size_t i = 0; i < count; i++ )
+    {
+        uint8_t *pkt = pkts[i];
+
+        /* transport scrambling control */
+        if( (pkt[3]&0x80) == 0 )
+            continue;
+
+        int i_hdr = 4;
+        if( pkt[3]&0x20 )
+            i_hdr += pkt[4] + 1;
+
+        if( i_pkt_size - i_hdr < 8 )
+        {
+            /* no complete block */
+            csa_Decrypt( c, pkt, i_pkt_size );
+            continue;
+        }
+
+        const bool b_odd = pkt[3]&0x40;
+        pkt[3] &= 0x3f;
+        if( 188 - i_hdr < 8 )
+            continue;
+
+        struct csa_lane *lane = b_odd ? &odd[i_odd++] : &even[i_even++];
+        lane->pkt = pkt;
+        lane->i_hdr = i_hdr;
+        lane->n = (i_pkt_size - i_hdr) / 8;
+        lane->i_residue = (i_pkt_size - i_hdr) % 8;
+
+        if( i_odd == CSA_LANES )
+        {
+            csa_DecryptLanes( c->o_ck, c->o_kk, odd, i_odd, i_pkt_size );
+            i_odd = 0;
+        }
+        if( i_even == CSA_LANES )
+        {
+            csa_DecryptLanes( c->e_ck, c->e_kk, even, i_even, i_pkt_size );
+            i_even = 0;
+        }
+    }
+
+    if( i_odd > 0 )
+        csa_DecryptLanes( c->o_ck, c->o_kk, odd, i_odd, i_pkt_size );
+    if( i_even > 0 )
+        csa_DecryptLanes( c->e_ck, c->e_kk, even, i_even, i_pkt_size );
+}
+
+/*****************************************************************************
+ * csa_EncryptBatch:
+ *****************************************************************************/
+static void csa_EncryptLanes( const uint8_t ck[8], const uint8_t kk[57],
+                              struct csa_lane *lanes, size_t count,
+                              int i_pkt_size )
+{
+    /* the block layer chains the blocks of a packet, but the packets are
+     * independent */
+    csa_BlockEncryptBatch( kk, lanes, count );
+    csa_StreamBatch( ck, lanes, count, i_pkt_size );
+}
+
+void csa_EncryptBatch( csa_t *c, uint8_t *const *pkts, size_t count,
+                       int i_pkt_size )
+{
+    const uint8_t *ck = c->use_odd ? c->o_ck : c->e_ck;
+    const uint8_t *kk = c->use_odd ? c->o_kk : c->e_kk;
+    struct csa_lane lanes[CSA_LANES];
+    size_t i_lanes = 0;
+
+    for( size_t i = 0; i < count; i++ )
+    {
+        uint8_t *pkt = pkts[i];
+
+        /* set transport scrambling control */
+        pkt[3] |= 0x80;
+        if( c->use_odd )
+            pkt[3] |= 0x40;
+
+        int i_hdr = 4;
+        if( pkt[3]&0x20 )
+            i_hdr += pkt[4] + 1;
+
+        if( i_pkt_size - i_hdr < 8 )
+        {
+            pkt[3] &= 0x3f;
+            continue;
+        }
+
+        struct csa_lane *lane = &lanes[i_lanes++];
+        lane->pkt = pkt;
+        lane->i_hdr = i_hdr;
+        lane->n = (i_pkt_size - i_hdr) / 8;
+        lane->i_residue = (i_pkt_size - i_hdr) % 8;
+
+        if( i_lanes == CSA_LANES )
+        {
+            csa_EncryptLanes( ck, kk, lanes, i_lanes, i_pkt_size );
+            i_lanes = 0;
+        }
+    }
+
+    if( i_lanes > 0 )
+        csa_EncryptLanes( ck, kk, lanes, i_lanes, i_pkt_size );
+}
+
 /*****************************************************************************
  * Divers
  *****************************************************************************/
@@ -607,3 +774,405 @@ static void csa_BlockCypher( uint8_t kk[57], uint8_t bd[8], uint8_t ib[8] )
     }
 }
 
+
+/*****************************************************************************
+ * Batch stream cypher
+ *****************************************************************************/
+struct csa_stream
+{
+    /* A[1]..A[10] and B[1]..B[10], one word per bit of each nibble */
+    csa_word A[10][4];
+    csa_word B[10][4];
+    csa_word X[4], Y[4], Z[4];
+    csa_word D[4], E[4], F[4];
+    csa_word p, q, r;
+};
+
+/* For each s-box and each of its 2 output bits, and for each value of the 3
+ * high input bits, the 4 output values for the 2 low input bits (bit 0 being
+ * the output for the low bits 0) */
+static const uint8_t sbox_sliced[7][2][8] =
+{
+    { { 0xC, 0x6, 0x1, 0xB, 0x6, 0xC, 0x8, 0x7 }, { 0x1, 0x7, 0x7, 0x8, 0x6, 0x3, 0xB, 0x4 } },
+    { { 0x3, 0x6, 0xB, 0x4, 0xB, 0x1, 0x4, 0xE }, { 0x9, 0x7, 0x6, 0x8, 0x9, 0xB, 0x8, 0x5 } },
+    { { 0x4, 0xE, 0xB, 0x1, 0xB, 0x1, 0x4, 0xE }, { 0x9, 0x7, 0x8, 0x5, 0x2, 0xD, 0x9, 0x6 } },
+    { { 0xB, 0x4, 0x9, 0x9, 0xD, 0xA, 0x2, 0x9 }, { 0xD, 0xA, 0x2, 0x9, 0x4, 0xB, 0x6, 0x6 } },
+    { { 0x8, 0x5, 0xE, 0x9, 0x2, 0xE, 0x5, 0x3 }, { 0x1, 0xF, 0xC, 0x4, 0x7, 0x2, 0xC, 0x9 } },
+    { { 0xA, 0x1, 0x6, 0xE, 0x2, 0xD, 0x6, 0x6 }, { 0xC, 0x6, 0x4, 0xB, 0xB, 0x1, 0x9, 0x6 } },
+    { { 0x2, 0x9, 0xD, 0x9, 0xD, 0x6, 0x6, 0x2 }, { 0xE, 0x1, 0x9, 0x6, 0xC, 0x8, 0x3, 0xB } },
+};
+
+/* Selects b where s is set, a elsewhere */
+static inline csa_word csa_Select( csa_word s, csa_word a, csa_word b )
+{
+    return a ^ ((a ^ b) & s);
+}
+
+static inline void csa_SboxSliced( const uint8_t fn[2][8],
+                                   csa_word x0, csa_word x1, csa_word x2,
+                                   csa_word x3, csa_word x4, csa_word out[2] )
+{
+    /* the 4 functions of x0 */
+    const csa_word f[4] = { CSA_WORD(0), ~x0, x0, CSA_WORD(UINT64_MAX) };
+
+    for( int o = 0; o < 2; o++ )
+    {
+        csa_word m[8];
+
+        for( int k = 0; k < 8; k++ )
+            m[k] = csa_Select( x1, f[fn[o][k] & 3], f[fn[o][k] >> 2] );
+        for( int k = 0; k < 4; k++ )
+            m[k] = csa_Select( x2, m[2*k], m[2*k+1] );
+        for( int k = 0; k < 2; k++ )
+            m[k] = csa_Select( x3, m[2*k], m[2*k+1] );
+        out[o] = csa_Select( x4, m[0], m[1] );
+    }
+}
+
+/* Same as csa_StreamCypher() for CSA_LANES packets: initializes the state
+ * from ck and sb if ck is not NULL, generates 8 bytes in cb otherwise */
+static void csa_StreamCypherSliced( struct csa_stream *c, const uint8_t *ck,
+                                    const csa_slice sb[8][8],
+                                    csa_slice cb[8][8] )
+{
+    /* the registers are shifted by moving down their base: at the step i,
+     * A[1] is A[32-i] */
+    csa_word A[32+10][4], B[32+10][4];
+    const bool b_init = ck != NULL;
+
+    if( b_init )
+    {
+        memset( c, 0, sizeof (*c) );
+        for( int i = 0; i < 8; i++ )
+        {
+            const int i_shift = (i & 1) ? 0 : 4;
+            for( int k = 0; k < 4; k++ )
+            {
+                if( (ck[i/2] >> (i_shift + k)) & 1 )
+                    c->A[i][k] = CSA_WORD(UINT64_MAX);
+                if( (ck[4+i/2] >> (i_shift + k)) & 1 )
+                    c->B[i][k] = CSA_WORD(UINT64_MAX);
+            }
+        }
+    }
+    memcpy( A[32], c->A, sizeof (c->A) );
+    memcpy( B[32], c->B, sizeof (c->B) );
+
+    for( int i = 0; i < 8; i++ )
+    {
+        for( int j = 0; j < 4; j++ )
+        {
+            /* a[k] is A[k], a[0] is the next A[1] */
+            csa_word (*a)[4] = &A[31 - 4*i - j];
+            csa_word (*b)[4] = &B[31 - 4*i - j];
+            csa_word s[7][2], extra_B[4], next_B1[4];
+
+            csa_SboxSliced( sbox_sliced[0], a[9][0], a[7][3], a[6][1], a[1][2], a[4][0], s[0] );
+            csa_SboxSliced( sbox_sliced[1], a[9][1], a[7][0], a[6][3], a[3][2], a[2][1], s[1] );
+            csa_SboxSliced( sbox_sliced[2], a[6][2], a[5][3], a[5][1], a[2][0], a[1][3], s[2] );
+            csa_SboxSliced( sbox_sliced[3], a[8][0], a[4][2], a[2][3], a[1][1], a[3][3], s[3] );
+            csa_SboxSliced( sbox_sliced[4], a[9][2], a[8][1], a[6][0], a[4][3], a[5][2], s[4] );
+            csa_SboxSliced( sbox_sliced[5], a[9][3], a[7][2], a[5][0], a[4][1], a[3][1], s[5] );
+            csa_SboxSliced( sbox_sliced[6], a[8][3], a[8][2], a[7][1], a[3][0], a[2][2], s[6] );
+
+            extra_B[3] = b[3][0] ^ b[6][1] ^ b[7][2] ^ b[9][3];
+            extra_B[2] = b[6][0] ^ b[8][1] ^ b[3][3] ^ b[4][2];
+            extra_B[1] = b[5][3] ^ b[8][2] ^ b[4][0] ^ b[5][1];
+            extra_B[0] = b[9][2] ^ b[6][3] ^ b[3][1] ^ b[8][0];
+
+            for( int k = 0; k < 4; k++ )
+            {
+                a[0][k] = a[10][k] ^ c->X[k];
+                next_B1[k] = b[7][k] ^ b[10][k] ^ c->Y[k];
+                if( b_init )
+                {
+                    /* in1 is the high nibble, in2 the low one */
+                    a[0][k] ^= c->D[k] ^ sb[i][((j % 2) ? 0 : 4) + k].w;
+                    next_B1[k] ^= sb[i][((j % 2) ? 4 : 0) + k].w;
+                }
+            }
+            /* if p=1, rotate left */
+            for( int k = 0; k < 4; k++ )
+                b[0][k] = csa_Select( c->p, next_B1[k], next_B1[(k + 3) % 4] );
+
+            for( int k = 0; k < 4; k++ )
+                c->D[k] = c->E[k] ^ c->Z[k] ^ extra_B[k];
+
+            /* if q=1, F = Z + E + r, r being the carry */
+            csa_word carry = c->r;
+            for( int k = 0; k < 4; k++ )
+            {
+                const csa_word ze = c->Z[k] ^ c->E[k];
+                const csa_word next_E = c->F[k];
+
+                c->F[k] = csa_Select( c->q, c->E[k], ze ^ carry );
+                carry = (c->Z[k] & c->E[k]) | (carry & ze);
+                c->E[k] = next_E;
+            }
+            c->r = csa_Select( c->q, c->r, carry );
+
+            c->X[3] = s[3][0]; c->X[2] = s[2][0]; c->X[1] = s[1][1]; c->X[0] = s[0][1];
+            c->Y[3] = s[5][0]; c->Y[2] = s[4][0]; c->Y[1] = s[3][1]; c->Y[0] = s[2][1];
+            c->Z[3] = s[1][0]; c->Z[2] = s[0][0]; c->Z[1] = s[5][1]; c->Z[0] = s[4][1];
+            c->p = s[6][1];
+            c->q = s[6][0];
+
+            if( !b_init )
+            {
+                cb[i][7 - 2*j].w = c->D[2] ^ c->D[3];
+                cb[i][6 - 2*j].w = c->D[0] ^ c->D[1];
+            }
+        }
+    }
+
+    memcpy( c->A, A[0], sizeof (c->A) );
+    memcpy( c->B, B[0], sizeof (c->B) );
+}
+
+/* Transposes a 8x8 bits matrix, each byte being a row */
+static inline uint64_t csa_Transpose8x8( uint64_t x )
+{
+    uint64_t t;
+
+    t = (x ^ (x >> 7)) & UINT64_C(0x00AA00AA00AA00AA);
+    x ^= t ^ (t << 7);
+    t = (x ^ (x >> 14)) & UINT64_C(0x0000CCCC0000CCCC);
+    x ^= t ^ (t << 14);
+    t = (x ^ (x >> 28)) & UINT64_C(0x00000000F0F0F0F0);
+    x ^= t ^ (t << 28);
+    return x;
+}
+
+static void csa_StreamBatch( const uint8_t ck[8], struct csa_lane *lanes,
+                             size_t count, int i_pkt_size )
+{
+    struct csa_stream c;
+    csa_slice slices[8][8];
+    int i_blocks = 0;
+
+    assert( count <= CSA_LANES );
+
+    /* the first block initializes the cypher, the following ones and the
+     * residue are xored with the stream */
+    memset( slices, 0, sizeof (slices) );
+    for( size_t g = 0; g < count; g += 8 )
+    {
+        for( int i = 0; i < 8; i++ )
+        {
+            uint64_t x = 0;
+            for( size_t l = 0; l < 8 && g + l < count; l++ )
+                x |= (uint64_t)lanes[g+l].pkt[lanes[g+l].i_hdr + i] << (8 * l);
+            x = csa_Transpose8x8( x );
+            for( int k = 0; k < 8; k++ )
+                slices[i][k].u[g / 64] |= ((x >> (8 * k)) & 0xff) << (g % 64);
+        }
+    }
+    for( size_t l = 0; l < count; l++ )
+    {
+        const int n = lanes[l].n - 1 + (lanes[l].i_residue > 0);
+        if( n > i_blocks )
+            i_blocks = n;
+    }
+
+    csa_StreamCypherSliced( &c, ck, slices, NULL );
+
+    for( int n = 1; n <= i_blocks; n++ )
+    {
+        csa_StreamCypherSliced( &c, NULL, NULL, slices );
+
+        for( size_t g = 0; g < count; g += 8 )
+        {
+            uint8_t stream[8][8];
+
+            for( int i = 0; i < 8; i++ )
+            {
+                uint64_t x = 0;
+                for( int k = 0; k < 8; k++ )
+                    x |= ((slices[i][k].u[g / 64] >> (g % 64)) & 0xff) << (8 * k);
+                x = csa_Transpose8x8( x );
+                for( int l = 0; l < 8; l++ )
+                    stream[l][i] = x >> (8 * l);
+            }
+
+            for( size_t l = 0; l < 8 && g + l < count; l++ )
+            {
+                const struct csa_lane *lane = &lanes[g+l];
+                uint8_t *p;
+                int i_size;
+
+                if( n < lane->n )
+                {
+                    p = &lane->pkt[lane->i_hdr + 8*n];
+                    i_size = 8;
+                }
+                else if( n == lane->n && lane->i_residue > 0 )
+                {
+                    p = &lane->pkt[i_pkt_size - lane->i_residue];
+                    i_size = lane->i_residue;
+                }
+                else
+                    continue;
+
+                for( int j = 0; j < i_size; j++ )
+                    p[j] ^= stream[l][j];
+            }
+        }
+    }
+}
+
+/*****************************************************************************
+ * Batch block cypher
+ *****************************************************************************/
+static inline csa_word csa_BlockSboxSliced( csa_word x )
+{
+    csa_slice s = { .w = x };
+
+    for( size_t i = 0; i < sizeof (s.b); i++ )
+        s.b[i] = block_sbox[s.b[i]];
+    return s.w;
+}
+
+/* block_perm[] is a bit permutation */
+static inline csa_word csa_BlockPermSliced( csa_word x )
+{
+    return ((x & CSA_BYTES(0x29)) << 1) | ((x & CSA_BYTES(0x02)) << 6) |
+           ((x & CSA_BYTES(0x04)) << 3) | ((x & CSA_BYTES(0x10)) >> 2) |
+           ((x & CSA_BYTES(0x40)) >> 6) | ((x & CSA_BYTES(0x80)) >> 4);
+}
+
+static void csa_BlockDecypherSliced( const uint8_t kk[57], csa_word R[9] )
+{
+    for( int i = 56; i > 0; i-- )
+    {
+        const csa_word sbox_out = csa_BlockSboxSliced( CSA_BYTES(kk[i]) ^ R[7] );
+        const csa_word perm_out = csa_BlockPermSliced( sbox_out );
+        const csa_word R8 = R[8] ^ sbox_out;
+
+        R[8] = R[7];
+        R[7] = R[6] ^ perm_out;
+        R[6] = R[5];
+        R[5] = R[4] ^ R8;
+        R[4] = R[3] ^ R8;
+        R[3] = R[2] ^ R8;
+        R[2] = R[1];
+        R[1] = R8;
+    }
+}
+
+static void csa_BlockCypherSliced( const uint8_t kk[57], csa_word R[9] )
+{
+    for( int i = 1; i <= 56; i++ )
+    {
+        const csa_word sbox_out = csa_BlockSboxSliced( CSA_BYTES(kk[i]) ^ R[8] );
+        const csa_word perm_out = csa_BlockPermSliced( sbox_out );
+        const csa_word R1 = R[1];
+
+        R[1] = R[2];
+        R[2] = R[3] ^ R1;
+        R[3] = R[4] ^ R1;
+        R[4] = R[5] ^ R1;
+        R[5] = R[6];
+        R[6] = R[7] ^ perm_out;
+        R[7] = R[8];
+        R[8] = R1 ^ sbox_out;
+    }
+}
+
+static void csa_BlockDecryptSlice( const uint8_t kk[57], uint8_t **blocks,
+                                   uint8_t **next, size_t count )
+{
+    csa_slice s[8];
+    csa_word R[9];
+
+    memset( s, 0, sizeof (s) );
+    for( size_t i = 0; i < count; i++ )
+        for( int k = 0; k < 8; k++ )
+            s[k].b[i] = blocks[i][k];
+    for( int k = 0; k < 8; k++ )
+        R[k+1] = s[k].w;
+
+    csa_BlockDecypherSliced( kk, R );
+
+    for( int k = 0; k < 8; k++ )
+        s[k].w = R[k+1];
+    /* in order, so that the next blocks are still to be decrypted */
+    for( size_t i = 0; i < count; i++ )
+        for( int k = 0; k < 8; k++ )
+            blocks[i][k] = s[k].b[i] ^ (next[i] ? next[i][k] : 0);
+}
+
+static void csa_BlockDecryptBatch( const uint8_t kk[57],
+                                   struct csa_lane *lanes, size_t count )
+{
+    uint8_t *blocks[CSA_BLOCKS], *next[CSA_BLOCKS];
+    size_t i_blocks = 0;
+
+    for( size_t l = 0; l < count; l++ )
+    {
+        for( int i = 0; i < lanes[l].n; i++ )
+        {
+            uint8_t *p = &lanes[l].pkt[lanes[l].i_hdr + 8*i];
+
+            blocks[i_blocks] = p;
+            next[i_blocks] = i + 1 < lanes[l].n ? p + 8 : NULL;
+            if( ++i_blocks == CSA_BLOCKS )
+            {
+                csa_BlockDecryptSlice( kk, blocks, next, i_blocks );
+                i_blocks = 0;
+            }
+        }
+    }
+    if( i_blocks > 0 )
+        csa_BlockDecryptSlice( kk, blocks, next, i_blocks );
+}
+
+static void csa_BlockEncryptBatch( const uint8_t kk[57],
+                                   struct csa_lane *lanes, size_t count )
+{
+    for( size_t g = 0; g < count; g += CSA_BLOCKS )
+    {
+        const size_t i_lanes = __MIN( count - g, CSA_BLOCKS );
+        int i_max = 0;
+
+        for( size_t l = 0; l < i_lanes; l++ )
+            if( lanes[g+l].n > i_max )
+                i_max = lanes[g+l].n;
+
+        /* the blocks are chained from the last one: the packets with less
+         * blocks are left idle until they reach their last block */
+        for( int n = i_max; n > 0; n-- )
+        {
+            csa_slice s[8];
+            csa_word R[9];
+
+            memset( s, 0, sizeof (s) );
+            for( size_t l = 0; l < i_lanes; l++ )
+            {
+                const struct csa_lane *lane = &lanes[g+l];
+                if( n > lane->n )
+                    continue;
+
+                const uint8_t *p = &lane->pkt[lane->i_hdr + 8*(n-1)];
+                for( int k = 0; k < 8; k++ )
+                    s[k].b[l] = p[k] ^ (n < lane->n ? p[8+k] : 0);
+            }
+            for( int k = 0; k < 8; k++ )
+                R[k+1] = s[k].w;
+
+            csa_BlockCypherSliced( kk, R );
+
+            for( int k = 0; k < 8; k++ )
+                s[k].w = R[k+1];
+            for( size_t l = 0; l < i_lanes; l++ )
+            {
+                const struct csa_lane *lane = &lanes[g+l];
+                if( n > lane->n )
+                    continue;
+
+                uint8_t *p = &lane->pkt[lane->i_hdr + 8*(n-1)];
+                for( int k = 0; k < 8; k++ )
+                    p[k] = s[k].b[l];
+            }
+        }
+    }
+}
@@ -30,6 +30,12 @@ typedef struct csa_t csa_t;
 #define csa_UseKey  __csa_UseKey
 #define csa_Decrypt __csa_decrypt
 #define csa_Encrypt __csa_encrypt
+#define csa_DecryptBatch __csa_DecryptBatch
+#define csa_EncryptBatch __csa_EncryptBatch
+
+/* Number of packets to provide to the batch functions at once, for them to
+ * (de)scramble as many packets as possible in parallel */
+#define CSA_BATCH_PACKETS 128
 
 csa_t *csa_New( void );
 void   csa_Delete( csa_t * );
@@ -40,4 +46,10 @@ void   csa_UseKey( vlc_object_t *p_caller, csa_t *, bool use_odd );
 void   csa_Decrypt( csa_t *, uint8_t *pkt, int i_pkt_size );
 void   csa_Encrypt( csa_t *, uint8_t *pkt, int i_pkt_size );
 
+/* Same as csa_Decrypt()/csa_Encrypt() on each packet, but faster */
+void   csa_DecryptBatch( csa_t *, uint8_t *const *pkts, size_t count,
+                         int i_pkt_size );
+void   csa_EncryptBatch( csa_t *, uint8_t *const *pkts, size_t count,
+                         int i_pkt_size );
+
 #endif /* _CSA_H */
@@ -31,6 +31,7 @@
 # include "config.h"
 #endif
 
+#include <assert.h>
 #include <limits.h>
 
 #include <vlc_common.h>
@@ -153,6 +154,12 @@ static const char *const ts_standards_list_text[] =
   "PCRs (Program Clock Reference) will be sent (in milliseconds). " \
   "This value should be below 100ms. (default is 70ms).")
 
+#define MUXRATE_TEXT N_("Mux rate (bits/s)")
+#define MUXRATE_LONGTEXT N_("Output a constant bitrate transport stream " \
+  "at the given rate, by inserting null packets (and PCR only packets when " \
+  "needed). The PCRs are computed from the position of the packets in the " \
+  "stream. 0 means variable bitrate.")
+
 #define BMIN_TEXT N_( "Minimum B (deprecated)")
 #define BMIN_LONGTEXT N_( "This setting is deprecated and not used anymore" )
 
@@ -196,6 +203,10 @@ static const char *const ts_standards_list_text[] =
 
 #define BLOCK_FLAG_NO_KEYFRAME (1 << BLOCK_FLAG_PRIVATE_SHIFT) /* This is not a key frame for bitrate shaping */
 
+#define TS_PACKET_SIZE 188
+#define TS_PACKET_BITS (TS_PACKET_SIZE * 8)
+#define TS_PACKET_POOL_MAX 8192 /* recycled TS packets kept for TSNew() */
+
 vlc_module_begin ()
     set_description( N_("TS muxer (libdvbpsi)") )
     set_shortname( "MPEG-TS")
@@ -226,6 +237,9 @@ vlc_module_begin ()
     add_bool(SOUT_CFG_PREFIX "use-key-frames", false, KEYF_TEXT, KEYF_LONGTEXT, true)
 
     add_integer( SOUT_CFG_PREFIX "pcr", 70, PCR_TEXT, PCR_LONGTEXT, true)
+    add_integer( SOUT_CFG_PREFIX "mux-rate", 0, MUXRATE_TEXT, MUXRATE_LONGTEXT,
+                 true)
+        change_integer_range( 0, INT64_MAX )
     add_integer( SOUT_CFG_PREFIX "bmin", 0, BMIN_TEXT, BMIN_LONGTEXT, true)
     add_integer( SOUT_CFG_PREFIX "bmax", 0, BMAX_TEXT, BMAX_LONGTEXT, true)
     add_integer( SOUT_CFG_PREFIX "dts-delay", 400, DTS_TEXT, DTS_LONGTEXT, true)
@@ -247,7 +261,7 @@ static const char *const ppsz_sout_options[] = {
     "standard",
     "pid-video", "pid-audio", "pid-spu", "pid-pmt", "tsid",
     "netid", "sdtdesc",
-    "es-id-pid", "shaping", "pcr", "bmin", "bmax", "use-key-frames",
+    "es-id-pid", "shaping", "pcr", "mux-rate", "bmin", "bmax", "use-key-frames",
     "dts-delay", "csa-ck", "csa2-ck", "csa-use", "csa-pkt", "crypt-audio", "crypt-video",
     "muxpmt", "program-pmt", "alignment",
     NULL
@@ -381,8 +395,27 @@ typedef struct
 
     vlc_tick_t      i_pcr;  /* last PCR emited */
 
+    /* TS packets are built in recycled blocks, then copied in output blocks
+     * of i_out_packets packets (fitting in the MTU) */
+    sout_buffer_chain_t packet_pool;
+    block_t         *p_out;
+    unsigned        i_out_packets;
+
+    /* Constant bitrate: the date of the next packet is
+     * i_cbr_date + i_cbr_frac / i_mux_rate */
+    uint64_t        i_mux_rate; /* 0 for VBR */
+    bool            b_cbr_started;
+    vlc_tick_t      i_cbr_date;
+    uint64_t        i_cbr_frac;
+    vlc_tick_t      i_cbr_last_pcr;
+    uint8_t         i_cbr_pcr_cc; /* last continuity counter of the PCR PID */
+
     csa_t           *csa;
     int             i_csa_pkt_size;
+    /* Output blocks are held until their packets are scrambled by batches */
+    sout_buffer_chain_t csa_out;
+    uint8_t         *csa_pkts[CSA_BATCH_PACKETS];
+    size_t          i_csa_pkts;
     bool            b_crypt_audio;
     bool            b_crypt_video;
 } sout_mux_sys_t;
@@ -477,11 +510,21 @@ static void TSSchedule  ( sout_mux_t *p_mux, sout_buffer_chain_t *p_chain_ts,
                           vlc_tick_t i_pcr_length, vlc_tick_t i_pcr_dts );
 static void TSDate      ( sout_mux_t *p_mux, sout_buffer_chain_t *p_chain_ts,
                           vlc_tick_t i_pcr_length, vlc_tick_t i_pcr_dts );
+static void TSDateCBR   ( sout_mux_t *p_mux, sout_buffer_chain_t *p_chain_ts,
+                          vlc_tick_t i_pcr_length, vlc_tick_t i_pcr_dts );
+static void TSOutput    ( sout_mux_t *p_mux, block_t *p_ts, vlc_tick_t i_dts,
+                          vlc_tick_t i_length );
+static uint8_t *TSOutputPacket( sout_mux_t *p_mux, vlc_tick_t i_dts,
+                                vlc_tick_t i_length, uint32_t i_flags );
+static void TSOutputCommit( sout_mux_t *p_mux, bool b_force );
+static void TSOutputFlush( sout_mux_t *p_mux );
+static void TSScramble  ( sout_mux_t *p_mux );
+static void TSRecycle   ( sout_mux_t *p_mux, block_t *p_ts );
 static void GetPAT( sout_mux_t *p_mux, sout_buffer_chain_t *c );
 static void GetPMT( sout_mux_t *p_mux, sout_buffer_chain_t *c );
 
 static block_t *TSNew( sout_mux_t *p_mux, sout_input_sys_t *p_stream, bool b_pcr );
-static void TSSetPCR( block_t *p_ts, vlc_tick_t i_dts );
+static void TSSetPCR( uint8_t *p_ts, vlc_tick_t i_dts );
 
 static csa_t *csaSetup( vlc_object_t *p_this )
 {
@@ -743,6 +786,26 @@ static int Open( vlc_object_t *p_this )
 
     p_sys->b_use_key_frames = var_GetBool( p_mux, SOUT_CFG_PREFIX "use-key-frames" );
 
+    p_sys->i_mux_rate = var_GetInteger( p_mux, SOUT_CFG_PREFIX "mux-rate" );
+    if( p_sys->i_mux_rate > 0 && p_sys->i_mux_rate < 10 * TS_PACKET_BITS )
+    {
+        msg_Err( p_mux, "invalid mux rate (%"PRIu64" bits/s), disabling "
+                 "constant bitrate", p_sys->i_mux_rate );
+        p_sys->i_mux_rate = 0;
+    }
+    if( p_sys->i_mux_rate > 0 )
+        msg_Dbg( p_mux, "constant bitrate: %"PRIu64" bits/s",
+                 p_sys->i_mux_rate );
+
+    /* Group as many packets as the MTU allows, so that UDP datagrams remain
+     * aligned on TS packets */
+    int64_t i_mtu = var_InheritInteger( p_mux, "mtu" );
+    p_sys->i_out_packets = i_mtu >= TS_PACKET_SIZE ? i_mtu / TS_PACKET_SIZE : 1;
+    BufferChainInit( &p_sys->packet_pool );
+    p_sys->p_out = NULL;
+    BufferChainInit( &p_sys->csa_out );
+    p_sys->i_csa_pkts = 0;
+
     p_mux->p_sys        = p_sys;
 
     p_sys->csa = csaSetup(p_this);
@@ -763,6 +826,10 @@ static void Close( vlc_object_t * p_this )
     sout_mux_t          *p_mux = (sout_mux_t*)p_this;
     sout_mux_sys_t      *p_sys = p_mux->p_sys;
 
+    TSOutputFlush( p_mux );
+    TSScramble( p_mux );
+    BufferChainClean( &p_sys->packet_pool );
+
     if( p_sys->p_dvbpsi )
         dvbpsi_delete( p_sys->p_dvbpsi );
 
@@ -1573,7 +1640,13 @@ static bool MuxStreams(sout_mux_t *p_mux )
     }
 
     /* 4: date and send */
-    TSSchedule( p_mux, &chain_ts, i_pcr_length, i_pcr_dts );
+    if( p_sys->i_mux_rate > 0 )
+        TSDateCBR( p_mux, &chain_ts, i_pcr_length, i_pcr_dts );
+    else
+        TSSchedule( p_mux, &chain_ts, i_pcr_length, i_pcr_dts );
+    /* Do not hold the end of the slice until the next one, which may come
+     * much later */
+    TSOutputCommit( p_mux, true );
     return false;
 }
 
@@ -1598,6 +1671,9 @@ static int Mux( sout_mux_t *p_mux )
 
     while (!MuxStreams(p_mux))
         ;
+    /* Do not delay the output blocks held for scrambling until the next
+     * call */
+    TSScramble( p_mux );
     return VLC_SUCCESS;
 }
 
@@ -1792,32 +1868,263 @@ static void TSDate( sout_mux_t *p_mux, sout_buffer_chain_t *p_chain_ts,
         block_t *p_ts = BufferChainGet( p_chain_ts );
         vlc_tick_t i_new_dts = i_pcr_dts + i_pcr_length * i / i_packet_count;
 
-        p_ts->i_dts    = i_new_dts;
-        p_ts->i_length = i_pcr_length / i_packet_count;
+        TSOutput( p_mux, p_ts, i_new_dts, i_pcr_length / i_packet_count );
+    }
+}
+
+/* Output a TS packet at the given date (the position in the stream), and
+ * recycle its block */
+static void TSOutput( sout_mux_t *p_mux, block_t *p_ts, vlc_tick_t i_dts,
+                      vlc_tick_t i_length )
+{
+    sout_mux_sys_t  *p_sys = p_mux->p_sys;
+
+    /* Access outputs split the stream on headers and keyframes: start a new
+     * output block, and keep headers on their own */
+    uint32_t i_flags = p_ts->i_flags & (BLOCK_FLAG_HEADER|BLOCK_FLAG_TYPE_I);
+    if( i_flags )
+        TSOutputFlush( p_mux );
+
+    uint8_t *p_packet = TSOutputPacket( p_mux, i_dts, i_length, i_flags );
+    if( likely(p_packet != NULL) )
+    {
+        memcpy( p_packet, p_ts->p_buffer, TS_PACKET_SIZE );
 
         if( p_ts->i_flags & BLOCK_FLAG_CLOCK )
         {
-            /* msg_Dbg( p_mux, "pcr=%lld ms", p_ts->i_dts / 1000 ); */
-            TSSetPCR( p_ts, p_ts->i_dts - p_sys->first_dts );
+            /* msg_Dbg( p_mux, "pcr=%lld ms", i_dts / 1000 ); */
+            TSSetPCR( p_packet, i_dts - p_sys->first_dts );
+            p_sys->p_out->i_flags |= BLOCK_FLAG_CLOCK;
         }
         if( p_ts->i_flags & BLOCK_FLAG_SCRAMBLED )
-        {
-            vlc_mutex_lock( &p_sys->csa_lock );
-            csa_Encrypt( p_sys->csa, p_ts->p_buffer, p_sys->i_csa_pkt_size );
-            vlc_mutex_unlock( &p_sys->csa_lock );
-        }
+            p_sys->csa_pkts[p_sys->i_csa_pkts++] = p_packet;
+
+        TSOutputCommit( p_mux, (i_flags & BLOCK_FLAG_HEADER) ||
+                               p_sys->i_csa_pkts == CSA_BATCH_PACKETS );
+    }
+
+    TSRecycle( p_mux, p_ts );
+}
+
+/* Reserve a TS packet in the pending output block (to be written before
+ * TSOutputCommit()) */
+static uint8_t *TSOutputPacket( sout_mux_t *p_mux, vlc_tick_t i_dts,
+                                vlc_tick_t i_length, uint32_t i_flags )
+{
+    sout_mux_sys_t  *p_sys = p_mux->p_sys;
+    block_t *p_out = p_sys->p_out;
 
+    if( p_out == NULL )
+    {
+        p_out = block_Alloc( p_sys->i_out_packets * TS_PACKET_SIZE );
+        if( unlikely(p_out == NULL) )
+            return NULL;
+        p_out->i_buffer = 0;
         /* latency */
-        p_ts->i_dts += p_sys->i_shaping_delay * 3 / 2;
+        p_out->i_dts = i_dts + p_sys->i_shaping_delay * 3 / 2;
+        p_out->i_length = 0;
+        p_out->i_flags = i_flags;
+        p_sys->p_out = p_out;
+    }
+
+    uint8_t *p_packet = &p_out->p_buffer[p_out->i_buffer];
+    p_out->i_buffer += TS_PACKET_SIZE;
+    p_out->i_length += i_length;
+    return p_packet;
+}
+
+/* Send the pending output block if it is full (or if forced) */
+static void TSOutputCommit( sout_mux_t *p_mux, bool b_force )
+{
+    sout_mux_sys_t  *p_sys = p_mux->p_sys;
+    block_t *p_out = p_sys->p_out;
+
+    if( p_out != NULL &&
+        ( b_force || p_out->i_buffer >= p_sys->i_out_packets * TS_PACKET_SIZE ) )
+        TSOutputFlush( p_mux );
+}
+
+static void TSOutputFlush( sout_mux_t *p_mux )
+{
+    sout_mux_sys_t  *p_sys = p_mux->p_sys;
+    block_t *p_out = p_sys->p_out;
+
+    if( p_out != NULL )
+    {
+        p_sys->p_out = NULL;
+        if( p_sys->i_csa_pkts > 0 )
+            BufferChainAppend( &p_sys->csa_out, p_out );
+        else
+            sout_AccessOutWrite( p_mux->p_access, p_out );
+    }
+
+    if( p_sys->i_csa_pkts == CSA_BATCH_PACKETS )
+        TSScramble( p_mux );
+}
+
+/* Scramble the pending packets, and send the output blocks held for them */
+static void TSScramble( sout_mux_t *p_mux )
+{
+    sout_mux_sys_t  *p_sys = p_mux->p_sys;
+    block_t *p_out;
+
+    if( p_sys->i_csa_pkts > 0 )
+    {
+        vlc_mutex_lock( &p_sys->csa_lock );
+        csa_EncryptBatch( p_sys->csa, p_sys->csa_pkts, p_sys->i_csa_pkts,
+                          p_sys->i_csa_pkt_size );
+        vlc_mutex_unlock( &p_sys->csa_lock );
+        p_sys->i_csa_pkts = 0;
+    }
+
+    while( ( p_out = BufferChainGet( &p_sys->csa_out ) ) != NULL )
+        sout_AccessOutWrite( p_mux->p_access, p_out );
+}
+
+static void TSRecycle( sout_mux_t *p_mux, block_t *p_ts )
+{
+    sout_mux_sys_t  *p_sys = p_mux->p_sys;
+
+    if( p_ts->i_buffer != TS_PACKET_SIZE ||
+        p_sys->packet_pool.i_depth >= TS_PACKET_POOL_MAX )
+    {
+        block_Release( p_ts );
+        return;
+    }
+    BufferChainAppend( &p_sys->packet_pool, p_ts );
+}
+
+/* Insert a null packet, or a PCR only packet if the last PCR is too old */
+static void TSStuffing( sout_mux_t *p_mux, vlc_tick_t i_dts,
+                        vlc_tick_t i_length )
+{
+    sout_mux_sys_t  *p_sys = p_mux->p_sys;
+    bool b_pcr = p_sys->i_cbr_last_pcr == VLC_TICK_INVALID ||
+                 i_dts - p_sys->i_cbr_last_pcr >= p_sys->i_pcr_delay;
+
+    uint8_t *p = TSOutputPacket( p_mux, i_dts, i_length, 0 );
+    if( unlikely(p == NULL) )
+        return;
+
+    if( b_pcr )
+    {
+        const sout_input_sys_t *p_pcr_stream = p_sys->p_pcr_input->p_sys;
+        int i_pid = p_pcr_stream->ts.i_pid;
+
+        /* Adaptation field only: the continuity counter is not incremented */
+        p[0] = 0x47;
+        p[1] = ( i_pid >> 8 ) & 0x1f;
+        p[2] = i_pid & 0xff;
+        p[3] = 0x20 | p_sys->i_cbr_pcr_cc;
+        p[4] = 183;
+        p[5] = 1 << 4; /* PCR_flag */
+        TSSetPCR( p, i_dts - p_sys->first_dts );
+        memset( &p[12], 0xff, TS_PACKET_SIZE - 12 );
+
+        p_sys->p_out->i_flags |= BLOCK_FLAG_CLOCK;
+        p_sys->i_cbr_last_pcr = i_dts;
+    }
+    else
+    {
+        p[0] = 0x47;
+        p[1] = 0x1f; /* PID 0x1fff */
+        p[2] = 0xff;
+        p[3] = 0x10;
+        memset( &p[4], 0xff, TS_PACKET_SIZE - 4 );
+    }
+
+    TSOutputCommit( p_mux, false );
+}
+
+/* Date of the next packet of the constant bitrate stream */
+static inline vlc_tick_t TSCBRDate( const sout_mux_sys_t *p_sys )
+{
+    return p_sys->i_cbr_date + p_sys->i_cbr_frac / p_sys->i_mux_rate;
+}
+
+static inline void TSCBRNext( sout_mux_sys_t *p_sys )
+{
+    p_sys->i_cbr_frac += (uint64_t)TS_PACKET_BITS * CLOCK_FREQ;
+    p_sys->i_cbr_date += p_sys->i_cbr_frac / p_sys->i_mux_rate;
+    p_sys->i_cbr_frac %= p_sys->i_mux_rate;
+}
+
+/* Date the packets on the constant bitrate timeline, and fill the slots left
+ * up to the end of the slice with stuffing */
+static void TSDateCBR( sout_mux_t *p_mux, sout_buffer_chain_t *p_chain_ts,
+                       vlc_tick_t i_pcr_length, vlc_tick_t i_pcr_dts )
+{
+    sout_mux_sys_t  *p_sys = p_mux->p_sys;
+    const vlc_tick_t i_end = i_pcr_dts + __MAX(i_pcr_length, 0);
+
+    /* Restart the timeline after a gap in the input (it is never moved
+     * backwards, that would break the PCR continuity) */
+    if( !p_sys->b_cbr_started ||
+        TSCBRDate( p_sys ) + p_sys->i_shaping_delay < i_pcr_dts )
+    {
+        if( p_sys->b_cbr_started )
+            msg_Warn( p_mux, "resetting the constant bitrate timeline "
+                      "(%"PRId64" us late)", i_pcr_dts - TSCBRDate( p_sys ) );
+        p_sys->b_cbr_started = true;
+        p_sys->i_cbr_date = i_pcr_dts;
+        p_sys->i_cbr_frac = 0;
+        p_sys->i_cbr_last_pcr = VLC_TICK_INVALID;
+    }
+
+    /* number of packets dated before the end of the slice */
+    uint64_t i_slots = 0;
+    vlc_tick_t i_date = TSCBRDate( p_sys );
+    if( i_date < i_end )
+    {
+        const uint64_t i_packet_scaled = (uint64_t)TS_PACKET_BITS * CLOCK_FREQ;
+        uint64_t i_avail = (uint64_t)(i_end - p_sys->i_cbr_date)
+                         * p_sys->i_mux_rate - p_sys->i_cbr_frac;
+        i_slots = ( i_avail + i_packet_scaled - 1 ) / i_packet_scaled;
+    }
+
+    const uint64_t i_packets = p_chain_ts->i_depth;
+    if( i_slots < i_packets )
+    {
+        msg_Warn( p_mux, "mux rate exceeded (%"PRIu64" packets for %"PRIu64
+                  " slots at %"PRId64")", i_packets, i_slots, i_pcr_dts );
+        i_slots = i_packets;
+    }
+
+    const vlc_tick_t i_length =
+        (uint64_t)TS_PACKET_BITS * CLOCK_FREQ / p_sys->i_mux_rate;
+    const sout_input_sys_t *p_pcr_stream = p_sys->p_pcr_input->p_sys;
+    uint64_t i_sent = 0;
+
+    for( uint64_t i = 0; i < i_slots; i++ )
+    {
+        i_date = TSCBRDate( p_sys );
+
+        /* spread the packets evenly among the slots */
+        if( i_sent < ( i + 1 ) * i_packets / i_slots )
+        {
+            block_t *p_ts = BufferChainGet( p_chain_ts );
+            int i_pid = ( ( p_ts->p_buffer[1] & 0x1f ) << 8 ) | p_ts->p_buffer[2];
+
+            if( i_pid == p_pcr_stream->ts.i_pid )
+                p_sys->i_cbr_pcr_cc = p_ts->p_buffer[3] & 0x0f;
+            if( p_ts->i_flags & BLOCK_FLAG_CLOCK )
+                p_sys->i_cbr_last_pcr = i_date;
 
-        sout_AccessOutWrite( p_mux->p_access, p_ts );
+            TSOutput( p_mux, p_ts, i_date, i_length );
+            i_sent++;
+        }
+        else
+            TSStuffing( p_mux, i_date, i_length );
+
+        TSCBRNext( p_sys );
     }
+    assert( p_chain_ts->i_depth == 0 );
 }
 
 static block_t *TSNew( sout_mux_t *p_mux, sout_input_sys_t *p_stream,
                        bool b_pcr )
 {
-    VLC_UNUSED(p_mux);
+    sout_mux_sys_t *p_sys = p_mux->p_sys;
     block_t *p_pes = p_stream->state.chain_pes.p_first;
 
     bool b_new_pes = false;
@@ -1837,7 +2144,11 @@ static block_t *TSNew( sout_mux_t *p_mux, sout_input_sys_t *p_stream,
         b_adaptation_field = true;
     }
 
-    block_t *p_ts = block_Alloc( 188 );
+    block_t *p_ts = BufferChainGet( &p_sys->packet_pool );
+    if( p_ts != NULL )
+        p_ts->i_flags = 0;
+    else
+        p_ts = block_Alloc( TS_PACKET_SIZE );
 
     if (b_new_pes && !(p_pes->i_flags & BLOCK_FLAG_NO_KEYFRAME) && p_pes->i_flags & BLOCK_FLAG_TYPE_I)
     {
@@ -1917,17 +2228,17 @@ static block_t *TSNew( sout_mux_t *p_mux, sout_input_sys_t *p_stream,
     return p_ts;
 }
 
-static void TSSetPCR( block_t *p_ts, vlc_tick_t i_dts )
+static void TSSetPCR( uint8_t *p_ts, vlc_tick_t i_dts )
 {
     int64_t i_pcr = TO_SCALE_NZ(i_dts);
 
-    p_ts->p_buffer[6]  = ( i_pcr >> 25 )&0xff;
-    p_ts->p_buffer[7]  = ( i_pcr >> 17 )&0xff;
-    p_ts->p_buffer[8]  = ( i_pcr >> 9  )&0xff;
-    p_ts->p_buffer[9]  = ( i_pcr >> 1  )&0xff;
-    p_ts->p_buffer[10] = ( i_pcr << 7  )&0x80;
-    p_ts->p_buffer[10] |= 0x7e;
-    p_ts->p_buffer[11] = 0; /* we don't set PCR extension */
+    p_ts[6]  = ( i_pcr >> 25 )&0xff;
+    p_ts[7]  = ( i_pcr >> 17 )&0xff;
+    p_ts[8]  = ( i_pcr >> 9  )&0xff;
+    p_ts[9]  = ( i_pcr >> 1  )&0xff;
+    p_ts[10] = ( i_pcr << 7  )&0x80;
+    p_ts[10] |= 0x7e;
+    p_ts[11] = 0; /* we don't set PCR extension */
 }
 
 void GetPAT( sout_mux_t *p_mux, sout_buffer_chain_t *c )
@@ -896,7 +896,7 @@ static block_t *OutputPicture( decoder_t *p_dec )
     p_sys->leading.p_head = NULL;
     p_sys->leading.pp_append = &p_sys->leading.p_head;
 
-    p_pic = block_ChainGather( p_pic );
+    p_pic = packetizer_ChainGather( p_pic );
 
     if( !p_pic )
     {
@@ -1089,6 +1089,14 @@ static void PutSPS( decoder_t *p_dec, block_t *p_frag )
     if( !p_sys->sps[p_sps->i_id].p_sps )
         msg_Dbg( p_dec, "found NAL_SPS (sps_id=%d)", p_sps->i_id );
 
+    /* Stored until replaced: do not keep the input block */
+    p_frag = packetizer_Detach( p_frag );
+    if( unlikely(p_frag == NULL) )
+    {
+        h264_release_sps( p_sps );
+        return;
+    }
+
     StoreSPS( p_sys, p_sps->i_id, p_frag, p_sps );
 }
 
@@ -1116,6 +1124,14 @@ static void PutPPS( decoder_t *p_dec, block_t *p_frag )
     if( !p_sys->pps[p_pps->i_id].p_pps )
         msg_Dbg( p_dec, "found NAL_PPS (pps_id=%d sps_id=%d)", p_pps->i_id, p_pps->i_sps_id );
 
+    /* Stored until replaced: do not keep the input block */
+    p_frag = packetizer_Detach( p_frag );
+    if( unlikely(p_frag == NULL) )
+    {
+        h264_release_pps( p_pps );
+        return;
+    }
+
     StorePPS( p_sys, p_pps->i_id, p_frag, p_pps );
 }
 
@@ -27,7 +27,6 @@
 #include "h264_nal.h"
 #include "h264_slice.h"
 #include "hxxx_nal.h"
-#include "hxxx_ep3b.h"
 
 bool h264_decode_slice( const uint8_t *p_buffer, size_t i_buffer,
                         void (* get_sps_pps)(uint8_t, void *,
@@ -37,28 +36,26 @@ bool h264_decode_slice( const uint8_t *p_buffer, size_t i_buffer,
 {
     int i_slice_type;
     h264_slice_init( p_slice );
-    bs_t s;
-    struct hxxx_bsfw_ep3b_ctx_s bsctx;
-    hxxx_bsfw_ep3b_ctx_init( &bsctx );
-    bs_init_custom( &s, p_buffer, i_buffer, &hxxx_bsfw_ep3b_callbacks, &bsctx );
+    bs_fast_t s;
+    bs_fast_init_ep3b( &s, p_buffer, i_buffer );
 
     /* nal unit header */
-    bs_skip( &s, 1 );
-    const uint8_t i_nal_ref_idc = bs_read( &s, 2 );
-    const uint8_t i_nal_type = bs_read( &s, 5 );
+    bs_fast_skip( &s, 1 );
+    const uint8_t i_nal_ref_idc = bs_fast_read( &s, 2 );
+    const uint8_t i_nal_type = bs_fast_read( &s, 5 );
 
     /* first_mb_in_slice */
-    /* int i_first_mb = */ bs_read_ue( &s );
+    /* int i_first_mb = */ bs_fast_read_ue( &s );
 
     /* slice_type */
-    i_slice_type = bs_read_ue( &s );
+    i_slice_type = bs_fast_read_ue( &s );
     p_slice->type = i_slice_type % 5;
 
     /* */
     p_slice->i_nal_type = i_nal_type;
     p_slice->i_nal_ref_idc = i_nal_ref_idc;
 
-    p_slice->i_pic_parameter_set_id = bs_read_ue( &s );
+    p_slice->i_pic_parameter_set_id = bs_fast_read_ue( &s );
     if( p_slice->i_pic_parameter_set_id > H264_PPS_ID_MAX )
         return false;
 
@@ -70,50 +67,50 @@ bool h264_decode_slice( const uint8_t *p_buffer, size_t i_buffer,
     if( !p_sps || !p_pps )
         return false;
 
-    p_slice->i_frame_num = bs_read( &s, p_sps->i_log2_max_frame_num + 4 );
+    p_slice->i_frame_num = bs_fast_read( &s, p_sps->i_log2_max_frame_num + 4 );
 
     if( !p_sps->frame_mbs_only_flag )
     {
         /* field_pic_flag */
-        p_slice->i_field_pic_flag = bs_read( &s, 1 );
+        p_slice->i_field_pic_flag = bs_fast_read( &s, 1 );
         if( p_slice->i_field_pic_flag )
-            p_slice->i_bottom_field_flag = bs_read( &s, 1 );
+            p_slice->i_bottom_field_flag = bs_fast_read( &s, 1 );
     }
 
     if( p_slice->i_nal_type == H264_NAL_SLICE_IDR )
-        p_slice->i_idr_pic_id = bs_read_ue( &s );
+        p_slice->i_idr_pic_id = bs_fast_read_ue( &s );
 
     p_slice->i_pic_order_cnt_type = p_sps->i_pic_order_cnt_type;
     if( p_sps->i_pic_order_cnt_type == 0 )
     {
-        p_slice->i_pic_order_cnt_lsb = bs_read( &s, p_sps->i_log2_max_pic_order_cnt_lsb + 4 );
+        p_slice->i_pic_order_cnt_lsb = bs_fast_read( &s, p_sps->i_log2_max_pic_order_cnt_lsb + 4 );
         if( p_pps->i_pic_order_present_flag && !p_slice->i_field_pic_flag )
-            p_slice->i_delta_pic_order_cnt_bottom = bs_read_se( &s );
+            p_slice->i_delta_pic_order_cnt_bottom = bs_fast_read_se( &s );
     }
     else if( (p_sps->i_pic_order_cnt_type == 1) &&
              (!p_sps->i_delta_pic_order_always_zero_flag) )
     {
-        p_slice->i_delta_pic_order_cnt0 = bs_read_se( &s );
+        p_slice->i_delta_pic_order_cnt0 = bs_fast_read_se( &s );
         if( p_pps->i_pic_order_present_flag && !p_slice->i_field_pic_flag )
-            p_slice->i_delta_pic_order_cnt1 = bs_read_se( &s );
+            p_slice->i_delta_pic_order_cnt1 = bs_fast_read_se( &s );
     }
 
     if( p_pps->i_redundant_pic_present_flag )
-        bs_read_ue( &s ); /* redudant_pic_count */
+        bs_fast_read_ue( &s ); /* redudant_pic_count */
 
     unsigned num_ref_idx_l01_active_minus1[2] = {0 , 0};
 
     if( i_slice_type == 1 || i_slice_type == 6 ) /* B slices */
-        bs_read1( &s ); /* direct_spatial_mv_pred_flag */
+        bs_fast_read1( &s ); /* direct_spatial_mv_pred_flag */
     if( i_slice_type == 0 || i_slice_type == 5 ||
         i_slice_type == 3 || i_slice_type == 8 ||
         i_slice_type == 1 || i_slice_type == 6 ) /* P SP B slices */
     {
-        if( bs_read1( &s ) ) /* num_ref_idx_active_override_flag */
+        if( bs_fast_read1( &s ) ) /* num_ref_idx_active_override_flag */
         {
-            num_ref_idx_l01_active_minus1[0] = bs_read_ue( &s );
+            num_ref_idx_l01_active_minus1[0] = bs_fast_read_ue( &s );
             if( i_slice_type == 1 || i_slice_type == 6 ) /* B slices */
-                num_ref_idx_l01_active_minus1[1] = bs_read_ue( &s );
+                num_ref_idx_l01_active_minus1[1] = bs_fast_read_ue( &s );
         }
     }
 
@@ -135,20 +132,20 @@ bool h264_decode_slice( const uint8_t *p_buffer, size_t i_buffer,
 
     for( ; i>0; i-- )
     {
-        if( bs_read1( &s ) ) /* ref_pic_list_modification_flag_l{0,1} */
+        if( bs_fast_read1( &s ) ) /* ref_pic_list_modification_flag_l{0,1} */
         {
             uint32_t mod;
             do
             {
-                mod = bs_read_ue( &s );
+                mod = bs_fast_read_ue( &s );
                 if( mod < 3 || ( b_mvc && (mod == 4 || mod == 5) ) )
-                    bs_read_ue( &s ); /* abs_diff_pic_num_minus1, long_term_pic_num, abs_diff_view_idx_min1 */
+                    bs_fast_read_ue( &s ); /* abs_diff_pic_num_minus1, long_term_pic_num, abs_diff_view_idx_min1 */
             }
-            while( mod != 3 && !bs_eof( &s ) );
+            while( mod != 3 && !bs_fast_eof( &s ) );
         }
     }
 
-    if( bs_error( &s ) )
+    if( bs_fast_error( &s ) )
         return false;
 
     /* pred_weight_table() */
@@ -156,28 +153,28 @@ bool h264_decode_slice( const uint8_t *p_buffer, size_t i_buffer,
                                          i_slice_type == 3 || i_slice_type == 8 ) ) ||
         ( p_pps->weighted_bipred_idc == 1 && ( i_slice_type == 1 || i_slice_type == 6 ) /* B */ ) )
     {
-        bs_read_ue( &s ); /* luma_log2_weight_denom */
+        bs_fast_read_ue( &s ); /* luma_log2_weight_denom */
         if( !p_sps->b_separate_colour_planes_flag ) /* ChromaArrayType != 0 */
-            bs_read_ue( &s ); /* chroma_log2_weight_denom */
+            bs_fast_read_ue( &s ); /* chroma_log2_weight_denom */
 
         const unsigned i_num_layers = ( i_slice_type % 5 == 1 ) ? 2 : 1;
         for( unsigned j=0; j < i_num_layers; j++ )
         {
             for( unsigned k=0; k<=num_ref_idx_l01_active_minus1[j]; k++ )
             {
-                if( bs_read1( &s ) ) /* luma_weight_l{0,1}_flag */
+                if( bs_fast_read1( &s ) ) /* luma_weight_l{0,1}_flag */
                 {
-                    bs_read_se( &s );
-                    bs_read_se( &s );
+                    bs_fast_read_se( &s );
+                    bs_fast_read_se( &s );
                 }
                 if( !p_sps->b_separate_colour_planes_flag ) /* ChromaArrayType != 0 */
                 {
-                    if( bs_read1( &s ) ) /* chroma_weight_l{0,1}_flag */
+                    if( bs_fast_read1( &s ) ) /* chroma_weight_l{0,1}_flag */
                     {
-                        bs_read_se( &s );
-                        bs_read_se( &s );
-                        bs_read_se( &s );
-                        bs_read_se( &s );
+                        bs_fast_read_se( &s );
+                        bs_fast_read_se( &s );
+                        bs_fast_read_se( &s );
+                        bs_fast_read_se( &s );
                     }
                 }
             }
@@ -187,20 +184,20 @@ bool h264_decode_slice( const uint8_t *p_buffer, size_t i_buffer,
     /* dec_ref_pic_marking() */
     if( p_slice->i_nal_type != 5 ) /* IdrFlag */
     {
-        if( bs_read1( &s ) ) /* adaptive_ref_pic_marking_mode_flag */
+        if( bs_fast_read1( &s ) ) /* adaptive_ref_pic_marking_mode_flag */
         {
             uint32_t mmco;
             do
             {
-                mmco = bs_read_ue( &s );
+                mmco = bs_fast_read_ue( &s );
                 if( mmco == 1 || mmco == 3 )
-                    bs_read_ue( &s ); /* diff_pics_minus1 */
+                    bs_fast_read_ue( &s ); /* diff_pics_minus1 */
                 if( mmco == 2 )
-                    bs_read_ue( &s ); /* long_term_pic_num */
+                    bs_fast_read_ue( &s ); /* long_term_pic_num */
                 if( mmco == 3 || mmco == 6 )
-                    bs_read_ue( &s ); /* long_term_frame_idx */
+                    bs_fast_read_ue( &s ); /* long_term_frame_idx */
                 if( mmco == 4 )
-                    bs_read_ue( &s ); /* max_long_term_frame_idx_plus1 */
+                    bs_fast_read_ue( &s ); /* max_long_term_frame_idx_plus1 */
                 if( mmco == 5 )
                 {
                     p_slice->has_mmco5 = true;
@@ -213,7 +210,7 @@ bool h264_decode_slice( const uint8_t *p_buffer, size_t i_buffer,
 
     /* If you need to store anything else than MMCO presence above, care of "Early END" cases */
 
-    return !bs_error( &s );
+    return !bs_fast_error( &s );
 }
 
 
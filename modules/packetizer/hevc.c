@@ -885,7 +885,7 @@ static block_t *GatherAndValidateChain(block_t *p_outputchain)
         if(p_outputchain->i_flags & BLOCK_FLAG_DROP)
             p_output = p_outputchain; /* Avoid useless gather */
         else
-            p_output = block_ChainGather(p_outputchain);
+            p_output = packetizer_ChainGather(p_outputchain);
     }
 
     if(p_output && (p_output->i_flags & BLOCK_FLAG_DROP))
@@ -1199,7 +1199,7 @@ bool hevc_get_colorimetry( const hevc_sequence_parameter_set_t *p_sps,
     return true;
 }
 
-static bool hevc_parse_slice_segment_header_rbsp( bs_t *p_bs,
+static bool hevc_parse_slice_segment_header_rbsp( bs_fast_t *p_bs,
                                                   pf_get_matchedxps get_matchedxps,
                                                   void *priv,
                                                   hevc_slice_segment_header_t *p_sl )
@@ -1208,17 +1208,17 @@ static bool hevc_parse_slice_segment_header_rbsp( bs_t *p_bs,
     hevc_picture_parameter_set_t *p_pps;
     hevc_video_parameter_set_t *p_vps;
 
-    if( bs_eof( p_bs ) )
+    if( bs_fast_eof( p_bs ) )
         return false;
 
-    p_sl->first_slice_segment_in_pic_flag = bs_read1( p_bs );
+    p_sl->first_slice_segment_in_pic_flag = bs_fast_read1( p_bs );
     if( p_sl->nal_type >= HEVC_NAL_BLA_W_LP && p_sl->nal_type <= HEVC_NAL_IRAP_VCL23 )
-        p_sl->no_output_of_prior_pics_flag = bs_read1( p_bs );
-    p_sl->slice_pic_parameter_set_id = bs_read_ue( p_bs );
+        p_sl->no_output_of_prior_pics_flag = bs_fast_read1( p_bs );
+    p_sl->slice_pic_parameter_set_id = bs_fast_read_ue( p_bs );
     if( p_sl->slice_pic_parameter_set_id > HEVC_PPS_ID_MAX )
         return false;
 
-    if( bs_error( p_bs ) )
+    if( bs_fast_error( p_bs ) )
         return false;
 
     get_matchedxps( p_sl->slice_pic_parameter_set_id, priv, &p_pps, &p_sps, &p_vps );
@@ -1228,13 +1228,13 @@ static bool hevc_parse_slice_segment_header_rbsp( bs_t *p_bs,
     if( !p_sl->first_slice_segment_in_pic_flag )
     {
         if( p_pps->dependent_slice_segments_enabled_flag )
-            p_sl->dependent_slice_segment_flag = bs_read1( p_bs );
+            p_sl->dependent_slice_segment_flag = bs_fast_read1( p_bs );
 
         unsigned w, h;
         if( !hevc_get_picture_CtbsYsize( p_sps, &w, &h ) )
             return false;
 
-        (void) bs_read( p_bs, vlc_ceil_log2( w * h ) ); /* slice_segment_address */
+        (void) bs_fast_read( p_bs, vlc_ceil_log2( w * h ) ); /* slice_segment_address */
     }
 
     if( !p_sl->dependent_slice_segment_flag )
@@ -1243,37 +1243,37 @@ static bool hevc_parse_slice_segment_header_rbsp( bs_t *p_bs,
         if( p_pps->num_extra_slice_header_bits > i )
         {
             i++;
-            bs_skip( p_bs, 1 ); /* discardable_flag */
+            bs_fast_skip( p_bs, 1 ); /* discardable_flag */
         }
 
         if( p_pps->num_extra_slice_header_bits > i )
         {
             i++;
-            bs_skip( p_bs, 1 ); /* cross_layer_bla_flag */
+            bs_fast_skip( p_bs, 1 ); /* cross_layer_bla_flag */
         }
 
         if( i < p_pps->num_extra_slice_header_bits )
-           bs_skip( p_bs, p_pps->num_extra_slice_header_bits - i );
+           bs_fast_skip( p_bs, p_pps->num_extra_slice_header_bits - i );
 
-        p_sl->slice_type = bs_read_ue( p_bs );
+        p_sl->slice_type = bs_fast_read_ue( p_bs );
         if( p_sl->slice_type > HEVC_SLICE_TYPE_I )
             return false;
 
         if( p_pps->output_flag_present_flag )
-            p_sl->pic_output_flag = bs_read1( p_bs );
+            p_sl->pic_output_flag = bs_fast_read1( p_bs );
         else
             p_sl->pic_output_flag = 1;
     }
 
     if( p_sps->separate_colour_plane_flag )
-        bs_skip( p_bs, 2 ); /* colour_plane_id */
+        bs_fast_skip( p_bs, 2 ); /* colour_plane_id */
 
     if( p_sl->nal_type != HEVC_NAL_IDR_W_RADL && p_sl->nal_type != HEVC_NAL_IDR_N_LP )
-        p_sl->pic_order_cnt_lsb = bs_read( p_bs, p_sps->log2_max_pic_order_cnt_lsb_minus4 + 4 );
+        p_sl->pic_order_cnt_lsb = bs_fast_read( p_bs, p_sps->log2_max_pic_order_cnt_lsb_minus4 + 4 );
     else
         p_sl->pic_order_cnt_lsb = 0;
 
-    return !bs_error( p_bs );
+    return !bs_fast_error( p_bs );
 }
 
 void hevc_rbsp_release_slice_header( hevc_slice_segment_header_t *p_sh )
@@ -1287,18 +1287,15 @@ hevc_slice_segment_header_t * hevc_decode_slice_header( const uint8_t *p_buf, si
     hevc_slice_segment_header_t *p_sh = calloc(1, sizeof(hevc_slice_segment_header_t));
     if(likely(p_sh))
     {
-        bs_t bs;
-        struct hxxx_bsfw_ep3b_ctx_s bsctx;
+        bs_fast_t bs;
         if( b_escaped )
-        {
-            hxxx_bsfw_ep3b_ctx_init( &bsctx );
-            bs_init_custom( &bs, p_buf, i_buf, &hxxx_bsfw_ep3b_callbacks, &bsctx );
-        }
-        else bs_init( &bs, p_buf, i_buf );
-        bs_skip( &bs, 1 );
-        p_sh->nal_type = bs_read( &bs, 6 );
-        p_sh->nuh_layer_id = bs_read( &bs, 6 );
-        p_sh->temporal_id_plus1 = bs_read( &bs, 3 );
+            bs_fast_init_ep3b( &bs, p_buf, i_buf );
+        else
+            bs_fast_init( &bs, p_buf, i_buf );
+        bs_fast_skip( &bs, 1 );
+        p_sh->nal_type = bs_fast_read( &bs, 6 );
+        p_sh->nuh_layer_id = bs_fast_read( &bs, 6 );
+        p_sh->temporal_id_plus1 = bs_fast_read( &bs, 3 );
         if( p_sh->nuh_layer_id > 62 || p_sh->temporal_id_plus1 == 0 ||
            !hevc_parse_slice_segment_header_rbsp( &bs, get_matchedxps, priv, p_sh ) )
         {
@@ -448,7 +448,7 @@ static block_t *OutputFrame( decoder_t *p_dec )
 
     ProcessSequenceParameters( p_dec );
 
-    p_pic = block_ChainGather( p_sys->p_frame );
+    p_pic = packetizer_ChainGather( p_sys->p_frame );
     if( p_pic == NULL )
     {
         p_sys->p_frame = NULL;
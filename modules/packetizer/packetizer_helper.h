@@ -24,6 +24,7 @@
 #define VLC_PACKETIZER_HELPER_H_
 
 #include <vlc_block.h>
+#include <vlc_atomic.h>
 
 enum
 {
@@ -36,6 +37,137 @@ enum
     STATE_CUSTOM_FIRST,
 };
 
+/*****************************************************************************
+ * Fragment views
+ *****************************************************************************
+ * When a fragment lies entirely within one input block, the packetizer hands
+ * out a view on that block instead of a copy. Views on the same input share
+ * a reference to it, and contiguous views can be gathered without copying.
+ *****************************************************************************/
+typedef struct
+{
+    vlc_atomic_rc_t rc;
+    block_t *p_block;
+} packetizer_shared_t;
+
+typedef struct
+{
+    block_t self;
+    packetizer_shared_t *p_shared;
+} packetizer_view_t;
+
+static void packetizer_ViewRelease( block_t *p_block )
+{
+    packetizer_view_t *p_view = container_of( p_block, packetizer_view_t, self );
+
+    if( vlc_atomic_rc_dec( &p_view->p_shared->rc ) )
+    {
+        block_Release( p_view->p_shared->p_block );
+        free( p_view->p_shared );
+    }
+    free( p_view );
+}
+
+static const struct vlc_block_callbacks packetizer_view_cbs =
+{
+    packetizer_ViewRelease,
+};
+
+static inline bool packetizer_IsView( const block_t *p_block )
+{
+    return p_block->cbs == &packetizer_view_cbs;
+}
+
+/* Takes ownership of p_frag and returns a copy if it is a view, so that a
+ * fragment kept for long, such as a parameter set, does not keep the whole
+ * input block alive. Returns NULL on allocation failure. */
+static inline block_t *packetizer_Detach( block_t *p_frag )
+{
+    if( !packetizer_IsView( p_frag ) )
+        return p_frag;
+
+    block_t *p_copy = block_Duplicate( p_frag );
+    block_Release( p_frag );
+    return p_copy;
+}
+
+static inline packetizer_shared_t *packetizer_ViewShared( block_t *p_block )
+{
+    return container_of( p_block, packetizer_view_t, self )->p_shared;
+}
+
+static inline block_t *packetizer_ViewNew( packetizer_shared_t *p_shared,
+                                           uint8_t *p_data, size_t i_data )
+{
+    packetizer_view_t *p_view = malloc( sizeof(*p_view) );
+    if( unlikely(p_view == NULL) )
+        return NULL;
+
+    vlc_atomic_rc_inc( &p_shared->rc );
+    p_view->p_shared = p_shared;
+    return block_Init( &p_view->self, &packetizer_view_cbs, p_data, i_data );
+}
+
+/* Takes ownership of p_block and returns a view spanning all of it */
+static inline block_t *packetizer_ViewWrap( block_t *p_block )
+{
+    packetizer_shared_t *p_shared = malloc( sizeof(*p_shared) );
+    if( unlikely(p_shared == NULL) )
+        return NULL;
+    vlc_atomic_rc_init( &p_shared->rc );
+    p_shared->p_block = p_block;
+
+    packetizer_view_t *p_view = malloc( sizeof(*p_view) );
+    if( unlikely(p_view == NULL) )
+    {
+        free( p_shared );
+        return NULL;
+    }
+    p_view->p_shared = p_shared;
+    block_Init( &p_view->self, &packetizer_view_cbs,
+                p_block->p_buffer, p_block->i_buffer );
+    block_CopyProperties( &p_view->self, p_block );
+    return &p_view->self;
+}
+
+/**
+ * Gathers a chain of fragments into a single block.
+ *
+ * Same as block_ChainGather(), but contiguous views on the same input block
+ * are merged into a single view without copying the payload.
+ */
+static inline block_t *packetizer_ChainGather( block_t *p_list )
+{
+    if( p_list->p_next == NULL || !packetizer_IsView( p_list ) )
+        return block_ChainGather( p_list );
+
+    packetizer_shared_t *p_shared = packetizer_ViewShared( p_list );
+    size_t i_total = p_list->i_buffer;
+    vlc_tick_t i_length = p_list->i_length;
+
+    for( block_t *p_prev = p_list, *p = p_list->p_next;
+         p != NULL; p_prev = p, p = p->p_next )
+    {
+        if( !packetizer_IsView( p ) || packetizer_ViewShared( p ) != p_shared ||
+            &p_prev->p_buffer[p_prev->i_buffer] != p->p_buffer )
+            return block_ChainGather( p_list );
+        i_total += p->i_buffer;
+        i_length += p->i_length;
+    }
+
+    block_t *p_gather = packetizer_ViewNew( p_shared, p_list->p_buffer, i_total );
+    if( unlikely(p_gather == NULL) )
+        return block_ChainGather( p_list );
+
+    p_gather->i_flags = p_list->i_flags;
+    p_gather->i_pts = p_list->i_pts;
+    p_gather->i_dts = p_list->i_dts;
+    p_gather->i_length = i_length;
+
+    block_ChainRelease( p_list );
+    return p_gather;
+}
+
 typedef void (*packetizer_reset_t)( void *p_private, bool b_flush );
 typedef block_t *(*packetizer_parse_t)( void *p_private, bool *pb_ts_used, block_t * );
 typedef block_t *(*packetizer_drain_t)( void *p_private );
@@ -106,6 +238,43 @@ static inline void packetizer_Flush( packetizer_t *p_pack )
     p_pack->pf_reset( p_pack->p_private, true );
 }
 
+/* Returns a view on the next i_offset bytes of the bytestream, or NULL if
+ * the fragment (with its prepend) is not contained within a single block */
+static inline block_t *packetizer_ReferenceFragment( packetizer_t *p_pack )
+{
+    block_bytestream_t *p_bs = &p_pack->bytestream;
+    block_t *p_head = p_bs->p_block;
+    const size_t i_prepend = p_pack->i_au_prepend;
+
+    if( p_pack->i_offset > p_head->i_buffer - p_bs->i_block_offset )
+        return NULL;
+
+    /* The prepend must already precede the fragment in memory. For views,
+     * bytes already popped before p_buffer are still part of the input */
+    uint8_t *p_frag = &p_head->p_buffer[p_bs->i_block_offset];
+    const uint8_t *p_low = packetizer_IsView( p_head ) ? p_head->p_start
+                                                       : p_head->p_buffer;
+    if( i_prepend > 0 &&
+        ( (size_t)(p_frag - p_low) < i_prepend ||
+          memcmp( p_frag - i_prepend, p_pack->p_au_prepend, i_prepend ) ) )
+        return NULL;
+
+    if( !packetizer_IsView( p_head ) )
+    {
+        block_t *p_wrap = packetizer_ViewWrap( p_head );
+        if( unlikely(p_wrap == NULL) )
+            return NULL;
+        p_wrap->p_next = p_head->p_next;
+        p_head->p_next = NULL;
+        if( p_bs->pp_last == &p_head->p_next )
+            p_bs->pp_last = &p_wrap->p_next;
+        p_bs->p_chain = p_bs->p_block = p_head = p_wrap;
+    }
+
+    return packetizer_ViewNew( packetizer_ViewShared( p_head ), p_frag - i_prepend,
+                               p_pack->i_offset + i_prepend );
+}
+
 static block_t *packetizer_PacketizeBlock( packetizer_t *p_pack, block_t **pp_block )
 {
     block_t *p_block = ( pp_block ) ? *pp_block : NULL;
@@ -178,9 +347,20 @@ static block_t *packetizer_PacketizeBlock( packetizer_t *p_pack, block_t **pp_bl
             block_BytestreamFlush( &p_pack->bytestream );
 
             /* Get the new fragment and set the pts/dts */
+            p_pic = packetizer_ReferenceFragment( p_pack );
             block_t *p_block_bytestream = p_pack->bytestream.p_block;
 
-            p_pic = block_Alloc( p_pack->i_offset + p_pack->i_au_prepend );
+            if( p_pic != NULL )
+                block_SkipBytes( &p_pack->bytestream, p_pack->i_offset );
+            else
+            {
+                p_pic = block_Alloc( p_pack->i_offset + p_pack->i_au_prepend );
+                block_GetBytes( &p_pack->bytestream, &p_pic->p_buffer[p_pack->i_au_prepend],
+                                p_pic->i_buffer - p_pack->i_au_prepend );
+                if( p_pack->i_au_prepend > 0 )
+                    memcpy( p_pic->p_buffer, p_pack->p_au_prepend, p_pack->i_au_prepend );
+            }
+
             p_pic->i_pts = p_block_bytestream->i_pts;
             p_pic->i_dts = p_block_bytestream->i_dts;
 
@@ -191,11 +371,6 @@ static block_t *packetizer_PacketizeBlock( packetizer_t *p_pack, block_t **pp_bl
                 p_pic->i_flags |= BLOCK_FLAG_AU_END;
             }
 
-            block_GetBytes( &p_pack->bytestream, &p_pic->p_buffer[p_pack->i_au_prepend],
-                            p_pic->i_buffer - p_pack->i_au_prepend );
-            if( p_pack->i_au_prepend > 0 )
-                memcpy( p_pic->p_buffer, p_pack->p_au_prepend, p_pack->i_au_prepend );
-
             p_pack->i_offset = 0;
 
             /* Parse the NAL */
@@ -368,7 +368,7 @@ static block_t *OutputFrame( decoder_t *p_dec )
     vlc_tick_t i_pts = p_sys->i_frame_pts;
 
     /* */
-    block_t *p_pic = block_ChainGather( p_sys->p_frame );
+    block_t *p_pic = packetizer_ChainGather( p_sys->p_frame );
     if( p_pic )
     {
         p_pic->i_dts = p_sys->i_frame_dts;
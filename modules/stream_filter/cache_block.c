@@ -33,6 +33,7 @@
 #include <vlc_stream.h>
 #include <vlc_interrupt.h>
 #include <vlc_block_helper.h>
+#include <vlc_memusage.h>
 
 /* TODO:
  *  - tune the 2 methods (block/stream)
@@ -67,6 +68,7 @@
 typedef struct
 {
     block_bytestream_t cache; /* bytestream chain for storing cache */
+    size_t accounted; /* cache size reported to the memory usage */
 
     struct
     {
@@ -76,6 +78,19 @@ typedef struct
     } stat;
 } stream_sys_t;
 
+static void AStreamAccount(stream_t *s)
+{
+    stream_sys_t *sys = s->p_sys;
+
+    if (sys->cache.i_total > sys->accounted)
+        vlc_memusage_Add(VLC_MEMUSAGE_STREAM,
+                         sys->cache.i_total - sys->accounted);
+    else
+        vlc_memusage_Sub(VLC_MEMUSAGE_STREAM,
+                         sys->accounted - sys->cache.i_total);
+    sys->accounted = sys->cache.i_total;
+}
+
 static int AStreamRefillBlock(stream_t *s)
 {
     stream_sys_t *sys = s->p_sys;
@@ -85,6 +100,7 @@ static int AStreamRefillBlock(stream_t *s)
     if (cache_size >= STREAM_CACHE_SIZE)
     {
         block_BytestreamFlush( &sys->cache );
+        AStreamAccount(s);
         cache_size = sys->cache.i_total;
     }
     if (cache_size >= STREAM_CACHE_SIZE &&
@@ -115,6 +131,7 @@ static int AStreamRefillBlock(stream_t *s)
     sys->stat.read_bytes += added_bytes;
 
     block_BytestreamPush( &sys->cache, b );
+    AStreamAccount(s);
     return VLC_SUCCESS;
 }
 
@@ -156,6 +173,7 @@ static void AStreamPrebufferBlock(stream_t *s)
         }
 
         block_BytestreamPush( &sys->cache, b);
+        AStreamAccount(s);
 
         if (first)
         {
@@ -174,6 +192,7 @@ static void AStreamControlReset(stream_t *s)
     stream_sys_t *sys = s->p_sys;
 
     block_BytestreamEmpty( &sys->cache );
+    AStreamAccount(s);
 
     /* Do the prebuffering */
     AStreamPrebufferBlock(s);
@@ -191,6 +210,7 @@ static int AStreamSeekBlock(stream_t *s, uint64_t i_pos)
     if (vlc_stream_Seek(s->s, i_pos)) return VLC_EGENERIC;
 
     block_BytestreamEmpty( &sys->cache );
+    AStreamAccount(s);
 
     /* Refill a block */
     if (AStreamRefillBlock(s))
@@ -289,6 +309,7 @@ static int Open(vlc_object_t *obj)
 
     /* Init all fields of sys->block */
     block_BytestreamInit( &sys->cache );
+    sys->accounted = 0;
 
     s->p_sys = sys;
     /* Do the prebuffering */
@@ -297,6 +318,8 @@ static int Open(vlc_object_t *obj)
     if (block_BytestreamRemaining( &sys->cache ) <= 0)
     {
         msg_Err(s, "cannot pre fill buffer");
+        block_BytestreamEmpty( &sys->cache );
+        AStreamAccount(s);
         free(sys);
         return VLC_EGENERIC;
     }
@@ -316,6 +339,7 @@ static void Close(vlc_object_t *obj)
     stream_sys_t *sys = s->p_sys;
 
     block_BytestreamEmpty( &sys->cache );
+    AStreamAccount(s);
     free(sys);
 }
 
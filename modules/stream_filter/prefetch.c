@@ -34,6 +34,7 @@
 #include <vlc_stream.h>
 #include <vlc_fs.h>
 #include <vlc_interrupt.h>
+#include <vlc_memusage.h>
 
 struct stream_ctrl
 {
@@ -73,11 +74,24 @@ typedef struct
     size_t       buffer_length;
     size_t       buffer_size;
     char        *buffer;
+    size_t       buffer_max;
     size_t       seek_threshold;
 
+    /* Adaptation of the buffer size */
+    vlc_tick_t   read_delay; /**< average duration of upstream reads */
+    vlc_tick_t   rate_start; /**< start of the consumption measurement */
+    uint64_t     rate_bytes; /**< bytes consumed since rate_start */
+    size_t       rate; /**< average consumption rate (bytes per second) */
+    unsigned     underruns; /**< reads that found the buffer drained */
+    unsigned     partial_reads; /**< upstream reads shorter than requested */
+    unsigned     underruns_total;
+
     struct stream_ctrl *controls;
 } stream_sys_t;
 
+/* Period of the consumption rate measurement */
+#define RATE_PERIOD VLC_TICK_FROM_MS(500)
+
 static ssize_t ThreadRead(stream_t *stream, void *buf, size_t length)
 {
     stream_sys_t *sys = stream->p_sys;
@@ -85,12 +99,95 @@ static ssize_t ThreadRead(stream_t *stream, void *buf, size_t length)
     vlc_mutex_unlock(&sys->lock);
     assert(length > 0);
 
+    vlc_tick_t start = vlc_tick_now();
     ssize_t val = vlc_stream_ReadPartial(stream->s, buf, length);
+    vlc_tick_t delay = vlc_tick_now() - start;
 
     vlc_mutex_lock(&sys->lock);
+    if (val > 0)
+    {
+        sys->read_delay = sys->read_delay ? (7 * sys->read_delay + delay) / 8
+                                          : delay;
+        if ((size_t)val < length)
+            sys->partial_reads++;
+    }
     return val;
 }
 
+/**
+ * Grows the buffer if it cannot cover the consumption during one upstream
+ * read, i.e. if it is smaller than the bandwidth-delay product.
+ *
+ * Called with the lock held, from the prefetch thread only, as it is the only
+ * one modifying the buffer, its size and the buffered range.
+ */
+static void ThreadAdapt(stream_t *stream)
+{
+    stream_sys_t *sys = stream->p_sys;
+
+    /* Only grow if the consumer had to wait, and with a valid measurement:
+     * otherwise the buffer is big enough, whatever the bitrate. */
+    if (sys->underruns == 0 || sys->rate == 0
+     || sys->buffer_size >= sys->buffer_max)
+        return;
+    sys->underruns = 0;
+
+    /* Half of the buffer is consumed while the other half is refilled */
+    uint64_t target = 2 * (uint64_t)sys->rate * sys->read_delay / CLOCK_FREQ;
+    bool partial = sys->partial_reads > 0;
+
+    sys->partial_reads = 0;
+    /* While the consumer waits, the measured rate is capped by what the reads
+     * return. If they returned all the requested data, larger reads would
+     * return more: the buffer is too small, whatever the rate. */
+    if (target <= sys->buffer_size && partial)
+        return; /* Not a matter of buffer size, but of upstream bandwidth */
+
+    size_t old_size = sys->buffer_size;
+    size_t new_size = old_size * 2;
+
+    if (new_size > sys->buffer_max)
+        new_size = sys->buffer_max;
+    if (sys->size != (uint64_t)-1 && new_size > sys->size)
+        new_size = sys->size;
+    if (new_size <= old_size)
+        return;
+
+    vlc_mutex_unlock(&sys->lock);
+    char *buffer = malloc(new_size);
+    vlc_mutex_lock(&sys->lock);
+    if (unlikely(buffer == NULL))
+        return;
+
+    /* Move the buffered data to their offsets in the new ring */
+    uint64_t offset = sys->buffer_offset;
+    size_t length = sys->buffer_length;
+
+    while (length > 0)
+    {
+        size_t from = offset % old_size, to = offset % new_size;
+        size_t copy = length;
+
+        if (copy > old_size - from)
+            copy = old_size - from;
+        if (copy > new_size - to)
+            copy = new_size - to;
+        memcpy(buffer + to, sys->buffer + from, copy);
+        offset += copy;
+        length -= copy;
+    }
+
+    free(sys->buffer);
+    sys->buffer = buffer;
+    sys->buffer_size = new_size;
+    vlc_memusage_Add(VLC_MEMUSAGE_STREAM, new_size);
+    vlc_memusage_Sub(VLC_MEMUSAGE_STREAM, old_size);
+
+    msg_Dbg(stream, "growing buffer to %zu bytes (%zu bytes/s, "
+            "%"PRId64" us per read)", new_size, sys->rate,
+            US_FROM_VLC_TICK(sys->read_delay));
+}
+
 static int ThreadSeek(stream_t *stream, uint64_t seek_offset)
 {
     stream_sys_t *sys = stream->p_sys;
@@ -258,6 +355,7 @@ static void *Thread(void *data)
         //msg_Dbg(stream, "buffer: %zu/%zu", sys->buffer_length,
         //        sys->buffer_size);
         vlc_cond_signal(&sys->wait_data);
+        ThreadAdapt(stream);
     }
 
     sys->error = true;
@@ -273,6 +371,7 @@ static int Seek(stream_t *stream, uint64_t offset)
     vlc_mutex_lock(&sys->lock);
     sys->stream_offset = offset;
     sys->error = false;
+    sys->rate_start = VLC_TICK_INVALID;
     vlc_cond_signal(&sys->wait_space);
     vlc_mutex_unlock(&sys->lock);
     return 0;
@@ -294,6 +393,29 @@ static size_t BufferLevel(const stream_t *stream, bool *eof)
     return sys->buffer_offset + sys->buffer_length - sys->stream_offset;
 }
 
+static void UpdateRate(stream_t *stream, size_t consumed)
+{
+    stream_sys_t *sys = stream->p_sys;
+    vlc_tick_t now = vlc_tick_now();
+
+    if (sys->rate_start == VLC_TICK_INVALID)
+    {   /* (Re)start measuring, e.g. after seeking or pausing */
+        sys->rate_start = now;
+        sys->rate_bytes = 0;
+        return;
+    }
+
+    sys->rate_bytes += consumed;
+    if (now - sys->rate_start < RATE_PERIOD)
+        return;
+
+    size_t rate = sys->rate_bytes * CLOCK_FREQ / (now - sys->rate_start);
+
+    sys->rate = sys->rate ? (3 * sys->rate + rate) / 4 : rate;
+    sys->rate_start = now;
+    sys->rate_bytes = 0;
+}
+
 static ssize_t Read(stream_t *stream, void *buf, size_t buflen)
 {
     stream_sys_t *sys = stream->p_sys;
@@ -311,6 +433,13 @@ static ssize_t Read(stream_t *stream, void *buf, size_t buflen)
         vlc_cond_signal(&sys->wait_space);
     }
 
+    if ((copy = BufferLevel(stream, &eof)) == 0 && !eof && !sys->error
+     && sys->stream_offset == sys->buffer_offset + sys->buffer_length)
+    {   /* The consumer caught up with the prefetch thread (not seeking) */
+        sys->underruns++;
+        sys->underruns_total++;
+    }
+
     while ((copy = BufferLevel(stream, &eof)) == 0 && !eof)
     {
         void *data[2];
@@ -335,6 +464,7 @@ static ssize_t Read(stream_t *stream, void *buf, size_t buflen)
 
     memcpy(buf, sys->buffer + offset, copy);
     sys->stream_offset += copy;
+    UpdateRate(stream, copy);
     vlc_cond_signal(&sys->wait_space);
     vlc_mutex_unlock(&sys->lock);
     return copy;
@@ -380,12 +510,25 @@ static int Control(stream_t *stream, int query, va_list args)
         case STREAM_GET_TAGS:
         case STREAM_GET_TYPE:
             return VLC_EGENERIC;
+        case STREAM_GET_BUFFER_LEVEL:
+        {
+            size_t *level = va_arg(args, size_t *);
+            size_t *size = va_arg(args, size_t *);
+            bool eof;
+
+            vlc_mutex_lock(&sys->lock);
+            *level = BufferLevel(stream, &eof);
+            *size = sys->buffer_size;
+            vlc_mutex_unlock(&sys->lock);
+            break;
+        }
         case STREAM_SET_PAUSE_STATE:
         {
             bool paused = va_arg(args, unsigned);
 
             vlc_mutex_lock(&sys->lock);
             sys->paused = paused;
+            sys->rate_start = VLC_TICK_INVALID;
             vlc_cond_signal(&sys->wait_space);
             vlc_mutex_unlock (&sys->lock);
             break;
@@ -464,7 +607,15 @@ static int Open(vlc_object_t *obj)
     sys->stream_offset = 0;
     sys->buffer_length = 0;
     sys->buffer_size = var_InheritInteger(obj, "prefetch-buffer-size") << 10u;
+    sys->buffer_max = var_InheritInteger(obj, "prefetch-buffer-max") << 10u;
     sys->seek_threshold = var_InheritInteger(obj, "prefetch-seek-threshold");
+    sys->read_delay = 0;
+    sys->rate_start = VLC_TICK_INVALID;
+    sys->rate_bytes = 0;
+    sys->rate = 0;
+    sys->underruns = 0;
+    sys->partial_reads = 0;
+    sys->underruns_total = 0;
     sys->controls = NULL;
 
     uint64_t size = stream_Size(stream->s);
@@ -473,6 +624,8 @@ static int Open(vlc_object_t *obj)
         if (sys->buffer_size > size)
             sys->buffer_size = size;
     }
+    if (sys->buffer_max < sys->buffer_size)
+        sys->buffer_max = sys->buffer_size;
 
     sys->buffer = malloc(sys->buffer_size);
     if (sys->buffer == NULL)
@@ -495,6 +648,7 @@ static int Open(vlc_object_t *obj)
     }
 
     msg_Dbg(stream, "using %zu bytes buffer", sys->buffer_size);
+    vlc_memusage_Add(VLC_MEMUSAGE_STREAM, sys->buffer_size);
     stream->pf_read = Read;
     stream->pf_seek = Seek;
     stream->pf_control = Control;
@@ -530,6 +684,10 @@ static void Close (vlc_object_t *obj)
         sys->controls = ctrl->next;
         free(ctrl);
     }
+    msg_Dbg(stream, "%zu bytes buffer, %u underruns, %zu bytes/s, "
+            "%"PRId64" us per read", sys->buffer_size, sys->underruns_total,
+            sys->rate, US_FROM_VLC_TICK(sys->read_delay));
+    vlc_memusage_Sub(VLC_MEMUSAGE_STREAM, sys->buffer_size);
     free(sys->buffer);
     free(sys->content_type);
     free(sys);
@@ -546,6 +704,11 @@ vlc_module_begin()
     add_integer("prefetch-buffer-size", 1 << 14, N_("Buffer size"),
                 N_("Prefetch buffer size (KiB)"), false)
         change_integer_range(4, 1 << 20)
+    add_integer("prefetch-buffer-max", 1 << 16, N_("Maximum buffer size"),
+                N_("The prefetch buffer grows up to this size (KiB) when it "
+                   "cannot cover the reading rate over the access latency."),
+                true)
+        change_integer_range(4, 1 << 20)
     add_obsolete_integer("prefetch-read-size") /* since 4.0.0 */
     add_integer("prefetch-seek-threshold", 1 << 14, N_("Seek threshold"),
                 N_("Prefetch forward seek threshold (bytes)"), true)
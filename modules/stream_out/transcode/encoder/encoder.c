@@ -50,6 +50,7 @@ void transcode_encoder_delete( transcode_encoder_t *p_enc )
         {
             block_ChainRelease( p_enc->p_buffers );
             picture_fifo_Delete( p_enc->pp_pics );
+            es_format_Clean( &p_enc->conv_fmt_in );
         }
         es_format_Clean( &p_enc->p_encoder->fmt_in );
         es_format_Clean( &p_enc->p_encoder->fmt_out );
@@ -106,6 +107,7 @@ transcode_encoder_t * transcode_encoder_new( encoder_t *p_encoder,
                 return NULL;
             }
             vlc_mutex_init( &p_enc->lock_out );
+            es_format_Init( &p_enc->conv_fmt_in, VIDEO_ES, 0 );
             break;
         default:
             break;
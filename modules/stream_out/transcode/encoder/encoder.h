@@ -94,6 +94,7 @@ void transcode_encoder_video_configure( vlc_object_t *p_obj,
 
 void transcode_encoder_video_set_src( encoder_t *, const video_format_t *,
                                       const transcode_encoder_config_t * );
+void transcode_encoder_video_enable_conversion( transcode_encoder_t * );
 
 void transcode_video_framerate_apply( const video_format_t *p_src,
                                             video_format_t *p_dst );
@@ -17,6 +17,7 @@
  * along with this program; if not, If not, see https://www.gnu.org/licenses/
  *****************************************************************************/
 #include <vlc_picture_fifo.h>
+#include <vlc_filter.h>
 
 struct transcode_encoder_t
 {
@@ -31,6 +32,12 @@ struct transcode_encoder_t
     /* output buffers */
     block_t         *p_buffers;
     bool b_threaded;
+
+    /* Conversion from the pushed pictures to fmt_in, owned by the
+     * encoding thread (ladder renditions) */
+    bool            b_convert;
+    filter_chain_t *p_conv;
+    es_format_t     conv_fmt_in;
 };
 
 int transcode_encoder_audio_open( transcode_encoder_t *p_enc,
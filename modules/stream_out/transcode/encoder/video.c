@@ -355,6 +355,75 @@ int transcode_encoder_video_test( encoder_t *p_encoder,
     return p_module != NULL ? VLC_SUCCESS : VLC_EGENERIC;
 }
 
+void transcode_encoder_video_enable_conversion( transcode_encoder_t *p_enc )
+{
+    p_enc->b_convert = true;
+}
+
+/* Takes ownership of p_pic and returns it converted to the encoder input
+ * format. The converter is (re)built whenever the source format changes, so
+ * that the thread owning the encoder never shares it with the stream thread. */
+static picture_t * transcode_encoder_video_convert( transcode_encoder_t *p_enc,
+                                                    picture_t *p_pic )
+{
+    const es_format_t *p_dst = &p_enc->p_encoder->fmt_in;
+
+    if( p_pic->format.i_chroma == p_dst->video.i_chroma &&
+        p_pic->format.i_width == p_dst->video.i_width &&
+        p_pic->format.i_height == p_dst->video.i_height &&
+        p_pic->format.i_visible_width == p_dst->video.i_visible_width &&
+        p_pic->format.i_visible_height == p_dst->video.i_visible_height )
+        return p_pic;
+
+    if( !p_enc->p_conv ||
+        !video_format_IsSimilar( &p_enc->conv_fmt_in.video, &p_pic->format ) )
+    {
+        if( !p_enc->p_conv )
+            p_enc->p_conv = filter_chain_NewVideo( p_enc->p_encoder, false, NULL );
+        if( !p_enc->p_conv )
+        {
+            picture_Release( p_pic );
+            return NULL;
+        }
+
+        es_format_Clean( &p_enc->conv_fmt_in );
+        es_format_InitFromVideo( &p_enc->conv_fmt_in, &p_pic->format );
+        filter_chain_Reset( p_enc->p_conv, &p_enc->conv_fmt_in,
+                            picture_GetVideoContext( p_pic ), p_dst );
+        if( filter_chain_AppendConverter( p_enc->p_conv, NULL ) != VLC_SUCCESS )
+        {
+            msg_Err( p_enc->p_encoder, "cannot convert %4.4s %ux%u to %4.4s %ux%u",
+                     (const char *)&p_pic->format.i_chroma,
+                     p_pic->format.i_visible_width, p_pic->format.i_visible_height,
+                     (const char *)&p_dst->video.i_chroma,
+                     p_dst->video.i_visible_width, p_dst->video.i_visible_height );
+            filter_chain_Delete( p_enc->p_conv );
+            p_enc->p_conv = NULL;
+            picture_Release( p_pic );
+            return NULL;
+        }
+    }
+
+    return filter_chain_VideoFilter( p_enc->p_conv, p_pic );
+}
+
+static block_t * transcode_encoder_video_encode_pic( transcode_encoder_t *p_enc,
+                                                     picture_t *p_pic )
+{
+    if( !p_enc->b_convert || !p_pic )
+        return p_enc->p_encoder->pf_encode_video( p_enc->p_encoder, p_pic );
+
+    block_t *p_block = NULL;
+    picture_Hold( p_pic );
+    p_pic = transcode_encoder_video_convert( p_enc, p_pic );
+    if( p_pic )
+    {
+        p_block = p_enc->p_encoder->pf_encode_video( p_enc->p_encoder, p_pic );
+        picture_Release( p_pic );
+    }
+    return p_block;
+}
+
 static void* EncoderThread( void *obj )
 {
     transcode_encoder_t *p_enc = obj;
@@ -375,7 +444,7 @@ static void* EncoderThread( void *obj )
         {
             /* release lock while encoding */
             vlc_mutex_unlock( &p_enc->lock_out );
-            p_block = p_enc->p_encoder->pf_encode_video( p_enc->p_encoder, p_pic );
+            p_block = transcode_encoder_video_encode_pic( p_enc, p_pic );
             picture_Release( p_pic );
             vlc_mutex_lock( &p_enc->lock_out );
 
@@ -390,7 +459,7 @@ static void* EncoderThread( void *obj )
     while( (p_pic = picture_fifo_Pop( p_enc->pp_pics )) != NULL )
     {
         vlc_sem_post( &p_enc->picture_pool_has_room );
-        p_block = p_enc->p_encoder->pf_encode_video( p_enc->p_encoder, p_pic );
+        p_block = transcode_encoder_video_encode_pic( p_enc, p_pic );
         picture_Release( p_pic );
         block_ChainAppend( &p_enc->p_buffers, p_block );
     }
@@ -444,6 +513,12 @@ void transcode_encoder_video_close( transcode_encoder_t *p_enc )
         vlc_join( p_enc->thread, NULL );
     }
 
+    if( p_enc->p_conv )
+    {
+        filter_chain_Delete( p_enc->p_conv );
+        p_enc->p_conv = NULL;
+    }
+
     /* Close encoder */
     module_unneed( p_enc->p_encoder, p_enc->p_encoder->p_module );
     p_enc->p_encoder->p_module = NULL;
@@ -471,7 +546,9 @@ int transcode_encoder_video_open( transcode_encoder_t *p_enc,
     p_enc->p_buffers = NULL;
     p_enc->b_abort = false;
 
-    if( p_cfg->video.threads.i_count > 0 )
+    /* Converting encoders (ladder renditions) always get their own thread so
+     * that scaling and encoding of all renditions run in parallel */
+    if( p_cfg->video.threads.i_count > 0 || p_enc->b_convert )
     {
         if( vlc_clone( &p_enc->thread, EncoderThread, p_enc, p_cfg->video.threads.i_priority ) )
         {
@@ -489,7 +566,7 @@ block_t * transcode_encoder_video_encode( transcode_encoder_t *p_enc, picture_t
 {
     if( !p_enc->b_threaded )
     {
-        return p_enc->p_encoder->pf_encode_video( p_enc->p_encoder, p_pic );
+        return transcode_encoder_video_encode_pic( p_enc, p_pic );
     }
 
     vlc_sem_wait( &p_enc->picture_pool_has_room );
@@ -75,6 +75,12 @@
 #define MAXHEIGHT_TEXT N_("Maximum video height")
 #define MAXHEIGHT_LONGTEXT N_( \
     "Maximum output video height." )
+#define LADDER_TEXT N_("Video renditions ladder")
+#define LADDER_LONGTEXT N_( \
+    "Comma-separated list of extra video renditions (WIDTHxHEIGHT[@KBPS]) " \
+    "encoded from the same decoded and deinterlaced pictures, each one in " \
+    "its own thread. They use the main video encoder and codec settings, " \
+    "which should enforce a fixed GOP for the keyframes to stay aligned." )
 #define VFILTER_TEXT N_("Video filter")
 #define VFILTER_LONGTEXT N_( \
     "Video filters will be applied to the video streams (after overlays " \
@@ -177,6 +183,8 @@ vlc_module_begin ()
                  MAXHEIGHT_LONGTEXT, true )
     add_module_list(SOUT_CFG_PREFIX "vfilter", "video filter", NULL,
                     VFILTER_TEXT, VFILTER_LONGTEXT)
+    add_string( SOUT_CFG_PREFIX "ladder", NULL, LADDER_TEXT,
+                LADDER_LONGTEXT, true )
 
     set_section( N_("Audio"), NULL )
     add_module(SOUT_CFG_PREFIX "aenc", "encoder", NULL,
@@ -224,7 +232,7 @@ static const char *const ppsz_sout_options[] = {
     "deinterlace-module", "threads", "aenc", "acodec", "ab", "alang",
     "afilter", "samplerate", "channels", "senc", "scodec", "soverlay",
     "sfilter", "high-priority", "maxwidth", "maxheight", "pool-size",
-    NULL
+    "ladder", NULL
 };
 
 /*****************************************************************************
@@ -334,6 +342,52 @@ static void SetVideoEncoderConfig( sout_stream_t *p_stream, transcode_encoder_co
         p_cfg->video.threads.i_priority = VLC_THREAD_PRIORITY_VIDEO;
 }
 
+static void SetVideoLadderConfig( sout_stream_t *p_stream, sout_stream_sys_t *p_sys )
+{
+    char *psz_string = var_GetNonEmptyString( p_stream, SOUT_CFG_PREFIX "ladder" );
+    if( !psz_string || !p_sys->venc_cfg.i_codec )
+    {
+        free( psz_string );
+        return;
+    }
+
+    char *psz_save;
+    for( const char *psz_rung = strtok_r( psz_string, ",", &psz_save );
+         psz_rung; psz_rung = strtok_r( NULL, ",", &psz_save ) )
+    {
+        unsigned i_width, i_height, i_bitrate = 0;
+        if( sscanf( psz_rung, "%ux%u@%u", &i_width, &i_height, &i_bitrate ) < 2 ||
+            !i_width || !i_height )
+        {
+            msg_Warn( p_stream, "ignoring invalid rendition `%s'", psz_rung );
+            continue;
+        }
+
+        transcode_encoder_config_t *p_cfgs =
+            realloc( p_sys->p_ladder_cfg, (p_sys->i_ladder + 1) * sizeof(*p_cfgs) );
+        if( !p_cfgs )
+            break;
+        p_sys->p_ladder_cfg = p_cfgs;
+
+        /* Inherit everything but the size and bitrate from the main video */
+        transcode_encoder_config_t *p_cfg = &p_cfgs[p_sys->i_ladder++];
+        *p_cfg = p_sys->venc_cfg;
+        p_cfg->psz_name = p_sys->venc_cfg.psz_name ? strdup( p_sys->venc_cfg.psz_name ) : NULL;
+        p_cfg->psz_lang = p_sys->venc_cfg.psz_lang ? strdup( p_sys->venc_cfg.psz_lang ) : NULL;
+        p_cfg->p_config_chain = config_ChainDuplicate( p_sys->venc_cfg.p_config_chain );
+        p_cfg->video.f_scale = 0;
+        p_cfg->video.i_width = i_width;
+        p_cfg->video.i_height = i_height;
+        p_cfg->video.i_maxwidth = p_cfg->video.i_maxheight = 0;
+        if( i_bitrate )
+            p_cfg->video.i_bitrate = i_bitrate * 1000;
+
+        msg_Dbg( p_stream, "rendition %zu: %ux%u %ukb/s", p_sys->i_ladder,
+                 i_width, i_height, p_cfg->video.i_bitrate / 1000 );
+    }
+    free( psz_string );
+}
+
 static void SetSPUEncoderConfig( sout_stream_t *p_stream, transcode_encoder_config_t *p_cfg )
 {
     char *psz_string = var_GetString( p_stream, SOUT_CFG_PREFIX "senc" );
@@ -423,6 +477,8 @@ static int Open( vlc_object_t *p_this )
                  p_sys->venc_cfg.video.i_bitrate / 1000 );
     }
 
+    SetVideoLadderConfig( p_stream, p_sys );
+
     /* Video Filter Parameters */
     sout_filters_config_init( &p_sys->vfilters_cfg );
 
@@ -481,6 +537,9 @@ static void Close( vlc_object_t * p_this )
 
     transcode_encoder_config_clean( &p_sys->venc_cfg );
     sout_filters_config_clean( &p_sys->vfilters_cfg );
+    for( size_t i = 0; i < p_sys->i_ladder; i++ )
+        transcode_encoder_config_clean( &p_sys->p_ladder_cfg[i] );
+    free( p_sys->p_ladder_cfg );
 
     transcode_encoder_config_clean( &p_sys->aenc_cfg );
     sout_filters_config_clean( &p_sys->afilters_cfg );
@@ -692,7 +751,7 @@ static void Del( sout_stream_t *p_stream, void *_id )
             if( id == p_sys->id_video )
                 p_sys->id_video = NULL;
             vlc_mutex_unlock( &p_sys->lock );
-            transcode_video_clean( id );
+            transcode_video_clean( p_stream, id );
             break;
         case SPU_ES:
             decoder_Destroy( id->p_decoder );
@@ -1,4 +1,5 @@
 #include <vlc_picture_fifo.h>
+#include <vlc_picture_pool.h>
 #include <vlc_filter.h>
 #include <vlc_codec.h>
 #include "encoder/encoder.h"
@@ -52,6 +53,9 @@ typedef struct
     /* Video */
     transcode_encoder_config_t venc_cfg;
     sout_filters_config_t vfilters_cfg;
+    /* Extra video renditions sharing the decoder and filters of venc_cfg */
+    transcode_encoder_config_t *p_ladder_cfg;
+    size_t                     i_ladder;
 
     /* SPU */
     transcode_encoder_config_t senc_cfg;
@@ -68,6 +72,13 @@ typedef struct
 
 struct aout_filters;
 
+typedef struct
+{
+    const transcode_encoder_config_t *p_enccfg;
+    transcode_encoder_t *encoder;
+    void *downstream_id;
+} transcode_rendition_t;
+
 struct sout_stream_id_sys_t
 {
     bool            b_transcode;
@@ -122,9 +133,13 @@ struct sout_stream_id_sys_t
              filter_chain_t  *p_uf_chain; /**< User-specified video filters */
              filter_chain_t  *p_final_conv_static; /**< converter to adapt filtered pics to the encoder */
              vlc_blender_t   *p_spu_blender;
+             picture_pool_t  *p_blend_pool; /**< copies to blend spu into */
+             video_format_t  blend_pool_fmt;
              spu_t           *p_spu;
              vlc_decoder_device *dec_dev;
              vlc_video_context *enc_vctx_in;
+             transcode_rendition_t *p_renditions; /**< ladder encoders */
+             size_t          i_renditions;
          };
          struct
          {
@@ -201,7 +216,7 @@ int  transcode_audio_init   ( sout_stream_t *, const es_format_t *,
 
 /* VIDEO */
 
-void transcode_video_clean  ( sout_stream_id_sys_t * );
+void transcode_video_clean  ( sout_stream_t *, sout_stream_id_sys_t * );
 int  transcode_video_process( sout_stream_t *, sout_stream_id_sys_t *,
                                      block_t *, block_t ** );
 int transcode_video_get_output_dimensions( sout_stream_id_sys_t *,
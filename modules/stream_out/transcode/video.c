@@ -136,15 +136,30 @@ static int video_update_format_decoder( decoder_t *p_dec, vlc_video_context *vct
     return chain_works;
 }
 
-static picture_t *video_new_buffer_encoder( transcode_encoder_t *p_enc )
+/* Gets a picture to blend subpictures in from a pool matching fmt */
+static picture_t *transcode_video_blend_buffer_new( sout_stream_id_sys_t *id,
+                                                    const video_format_t *fmt )
 {
-    return picture_NewFromFormat( &transcode_encoder_format_in( p_enc )->video );
-}
+    if( id->p_blend_pool && !video_format_IsSimilar( &id->blend_pool_fmt, fmt ) )
+    {
+        picture_pool_Release( id->p_blend_pool );
+        id->p_blend_pool = NULL;
+        video_format_Clean( &id->blend_pool_fmt );
+    }
 
-static picture_t *transcode_video_filter_buffer_new( filter_t *p_filter )
-{
-    assert(p_filter->fmt_out.video.i_chroma == p_filter->fmt_out.i_codec);
-    return picture_NewFromFormat( &p_filter->fmt_out.video );
+    if( !id->p_blend_pool )
+    {
+        /* the blended pictures are held by the encoder (thread) fifo */
+        unsigned i_count = id->p_enccfg->video.threads.i_count > 0 ||
+                           id->i_renditions
+                         ? id->p_enccfg->video.threads.pool_size + 1 : 2;
+        id->p_blend_pool = picture_pool_NewFromFormat( fmt, __MIN(i_count, 32) );
+        if( id->p_blend_pool )
+            video_format_Copy( &id->blend_pool_fmt, fmt );
+    }
+
+    picture_t *p_pic = id->p_blend_pool ? picture_pool_Get( id->p_blend_pool ) : NULL;
+    return p_pic ? p_pic : picture_NewFromFormat( fmt );
 }
 
 static void decoder_queue_video( decoder_t *p_dec, picture_t *p_pic )
@@ -168,6 +183,47 @@ static vlc_picture_chain_t transcode_dequeue_all_pics( sout_stream_id_sys_t *id
     return p_pics;
 }
 
+static transcode_encoder_t *transcode_video_encoder_new( sout_stream_t *p_stream,
+                                                        sout_stream_id_sys_t *id,
+                                                        const transcode_encoder_config_t *p_cfg )
+{
+    /* Should be the same format until encoder loads */
+    es_format_t encoder_tested_fmt_in;
+    es_format_Init( &encoder_tested_fmt_in, id->decoder_out.i_cat, 0 );
+
+    struct encoder_owner *p_enc_owner = (struct encoder_owner*)sout_EncoderCreate(p_stream, sizeof(struct encoder_owner));
+    if ( unlikely(p_enc_owner == NULL))
+       return NULL;
+
+    p_enc_owner->id = id;
+    p_enc_owner->enc.cbs = &encoder_video_transcode_cbs;
+
+    if( transcode_encoder_test( &p_enc_owner->enc,
+                                p_cfg,
+                                &id->p_decoder->fmt_in,
+                                id->p_decoder->fmt_out.i_codec,
+                                &encoder_tested_fmt_in ) )
+    {
+        es_format_Clean( &encoder_tested_fmt_in );
+        return NULL;
+    }
+
+    transcode_encoder_t *p_encoder = NULL;
+    p_enc_owner = (struct encoder_owner *)sout_EncoderCreate(p_stream, sizeof(struct encoder_owner));
+    if ( likely(p_enc_owner != NULL) )
+    {
+        p_encoder = transcode_encoder_new( &p_enc_owner->enc, &encoder_tested_fmt_in );
+        if( p_encoder )
+        {
+            p_enc_owner->id = id;
+            p_enc_owner->enc.cbs = &encoder_video_transcode_cbs;
+        }
+    }
+
+    es_format_Clean( &encoder_tested_fmt_in );
+    return p_encoder;
+}
+
 int transcode_video_init( sout_stream_t *p_stream, const es_format_t *p_fmt,
                           sout_stream_id_sys_t *id )
 {
@@ -217,51 +273,51 @@ int transcode_video_init( sout_stream_t *p_stream, const es_format_t *p_fmt,
      * once the first frame is decoded, we actually only test the availability
      * of the encoder here.
      */
-
-    /* Should be the same format until encoder loads */
-    es_format_t encoder_tested_fmt_in;
-    es_format_Init( &encoder_tested_fmt_in, id->decoder_out.i_cat, 0 );
-
-    struct encoder_owner *p_enc_owner = (struct encoder_owner*)sout_EncoderCreate(p_stream, sizeof(struct encoder_owner));
-    if ( unlikely(p_enc_owner == NULL))
-       goto error;
-
-    p_enc_owner->id = id;
-    p_enc_owner->enc.cbs = &encoder_video_transcode_cbs;
-
-    if( transcode_encoder_test( &p_enc_owner->enc,
-                                id->p_enccfg,
-                                &id->p_decoder->fmt_in,
-                                id->p_decoder->fmt_out.i_codec,
-                                &encoder_tested_fmt_in ) )
-       goto error;
-
-    p_enc_owner = (struct encoder_owner *)sout_EncoderCreate(p_stream, sizeof(struct encoder_owner));
-    if ( unlikely(p_enc_owner == NULL))
-       goto error;
-
-    id->encoder = transcode_encoder_new( &p_enc_owner->enc, &encoder_tested_fmt_in );
+    id->encoder = transcode_video_encoder_new( p_stream, id, id->p_enccfg );
     if( !id->encoder )
-       goto error;
-
-    p_enc_owner->id = id;
-    p_enc_owner->enc.cbs = &encoder_video_transcode_cbs;
+        goto error;
 
-    es_format_Clean( &encoder_tested_fmt_in );
+    sout_stream_sys_t *p_sys = p_stream->p_sys;
+    if( p_sys->i_ladder )
+    {
+        id->p_renditions = vlc_alloc( p_sys->i_ladder, sizeof(*id->p_renditions) );
+        if( !id->p_renditions )
+            goto error;
+        for( ; id->i_renditions < p_sys->i_ladder; id->i_renditions++ )
+        {
+            transcode_rendition_t *r = &id->p_renditions[id->i_renditions];
+            r->p_enccfg = &p_sys->p_ladder_cfg[id->i_renditions];
+            r->downstream_id = NULL;
+            r->encoder = transcode_video_encoder_new( p_stream, id, r->p_enccfg );
+            if( !r->encoder )
+                goto error;
+            transcode_encoder_video_enable_conversion( r->encoder );
+        }
+    }
 
     return VLC_SUCCESS;
 
 error:
+    for( size_t i = 0; i < id->i_renditions; i++ )
+        transcode_encoder_delete( id->p_renditions[i].encoder );
+    free( id->p_renditions );
+    id->p_renditions = NULL;
+    id->i_renditions = 0;
+    if( id->encoder )
+    {
+        transcode_encoder_delete( id->encoder );
+        id->encoder = NULL;
+    }
     module_unneed( id->p_decoder, id->p_decoder->p_module );
     id->p_decoder->p_module = NULL;
-    es_format_Clean( &encoder_tested_fmt_in );
     es_format_Clean( &id->decoder_out );
     return VLC_EGENERIC;
 }
 
+/* Filtered pictures are allocated from the pools of the filter chains */
 static const struct filter_video_callbacks transcode_filter_video_cbs =
 {
-    transcode_video_filter_buffer_new, transcode_video_filter_hold_device,
+    NULL, transcode_video_filter_hold_device,
 };
 
 static inline bool transcode_video_filters_configured( const sout_stream_id_sys_t *id )
@@ -331,12 +387,22 @@ static int transcode_video_filters_init( sout_stream_t *p_stream,
     return VLC_SUCCESS;
 }
 
-void transcode_video_clean( sout_stream_id_sys_t *id )
+void transcode_video_clean( sout_stream_t *p_stream, sout_stream_id_sys_t *id )
 {
     /* Close encoder */
     transcode_encoder_close( id->encoder );
     transcode_encoder_delete( id->encoder );
 
+    for( size_t i = 0; i < id->i_renditions; i++ )
+    {
+        transcode_rendition_t *r = &id->p_renditions[i];
+        transcode_encoder_close( r->encoder );
+        transcode_encoder_delete( r->encoder );
+        if( r->downstream_id )
+            sout_StreamIdDel( p_stream->p_next, r->downstream_id );
+    }
+    free( id->p_renditions );
+
     es_format_Clean( &id->decoder_out );
 
     /* Close filters */
@@ -347,6 +413,11 @@ void transcode_video_clean( sout_stream_id_sys_t *id )
         filter_DeleteBlend( id->p_spu_blender );
     if( id->p_spu )
         spu_Destroy( id->p_spu );
+    if( id->p_blend_pool )
+    {
+        picture_pool_Release( id->p_blend_pool );
+        video_format_Clean( &id->blend_pool_fmt );
+    }
     if ( id->dec_dev )
         vlc_decoder_device_Release( id->dec_dev );
 }
@@ -400,9 +471,8 @@ static picture_t * RenderSubpictures( sout_stream_id_sys_t *id, picture_t *p_pic
     {
         if( filter_chain_IsEmpty( id->p_f_chain ) )
         {
-            /* We can't modify the picture, we need to duplicate it,
-                 * in this point the picture is already p_encoder->fmt.in format*/
-            picture_t *p_tmp = video_new_buffer_encoder( id->encoder );
+            /* We can't modify the picture, we need to duplicate it */
+            picture_t *p_tmp = transcode_video_blend_buffer_new( id, &p_pic->format );
             if( likely( p_tmp ) )
             {
                 picture_Copy( p_tmp, p_pic );
@@ -433,6 +503,100 @@ static void tag_last_block_with_flag( block_t **out, int i_flag )
     }
 }
 
+static int transcode_video_ladder_open( sout_stream_t *p_stream,
+                                        sout_stream_id_sys_t *id,
+                                        picture_t *p_pic )
+{
+    /* All renditions are fed with the filtered pictures */
+    const es_format_t *p_filtered = id->p_uf_chain
+                                  ? filter_chain_GetFmtOut( id->p_uf_chain )
+                                  : filter_chain_GetFmtOut( id->p_f_chain );
+
+    for( size_t i = 0; i < id->i_renditions; i++ )
+    {
+        transcode_rendition_t *r = &id->p_renditions[i];
+
+        if( !transcode_encoder_opened( r->encoder ) )
+        {
+            transcode_encoder_video_configure( VLC_OBJECT(p_stream),
+                                               &id->p_decoder->fmt_out.video,
+                                               r->p_enccfg,
+                                               &p_pic->format,
+                                               picture_GetVideoContext(p_pic),
+                                               r->encoder );
+            transcode_encoder_update_format_in( r->encoder, p_filtered, r->p_enccfg );
+            if( transcode_encoder_open( r->encoder, r->p_enccfg ) != VLC_SUCCESS )
+            {
+                msg_Err( p_stream, "cannot open encoder for rendition %zu", i + 1 );
+                return VLC_EGENERIC;
+            }
+        }
+
+        if( !r->downstream_id )
+        {
+            /* Let the next stream pick its own id for the extra ES */
+            es_format_t fmt_orig = id->p_decoder->fmt_in;
+            fmt_orig.i_id = -1;
+            r->downstream_id =
+                id->pf_transcode_downstream_add( p_stream, &fmt_orig,
+                                                 transcode_encoder_format_out( r->encoder ) );
+            if( !r->downstream_id )
+            {
+                msg_Err( p_stream, "cannot output rendition %zu", i + 1 );
+                return VLC_EGENERIC;
+            }
+        }
+    }
+    return VLC_SUCCESS;
+}
+
+static void transcode_video_ladder_push( sout_stream_id_sys_t *id, picture_t *p_pic )
+{
+    /* Each rendition scales and encodes the shared picture in its own thread.
+     * The pixels are shared, but each encoder queues its own clone, as a
+     * picture is linked in one FIFO at a time. */
+    for( size_t i = 0; i < id->i_renditions; i++ )
+    {
+        transcode_rendition_t *r = &id->p_renditions[i];
+        if( !transcode_encoder_opened( r->encoder ) )
+            continue;
+
+        picture_t *p_clone = picture_Clone( p_pic );
+        if( unlikely(p_clone == NULL) )
+            continue;
+        picture_CopyProperties( p_clone, p_pic );
+        transcode_encoder_encode( r->encoder, p_clone );
+        picture_Release( p_clone );
+    }
+}
+
+static void transcode_video_ladder_output( sout_stream_t *p_stream,
+                                           sout_stream_id_sys_t *id,
+                                           bool b_drain, bool b_close )
+{
+    for( size_t i = 0; i < id->i_renditions; i++ )
+    {
+        transcode_rendition_t *r = &id->p_renditions[i];
+        block_t *p_out = NULL;
+
+        if( b_drain && transcode_encoder_opened( r->encoder ) )
+            transcode_encoder_drain( r->encoder, &p_out );
+        else
+            p_out = transcode_encoder_get_output_async( r->encoder );
+
+        if( b_close )
+        {
+            transcode_encoder_close( r->encoder );
+            tag_last_block_with_flag( &p_out, BLOCK_FLAG_END_OF_SEQUENCE );
+        }
+
+        if( p_out && r->downstream_id )
+            sout_StreamIdSend( p_stream->p_next, r->downstream_id, p_out );
+        else if( p_out )
+            block_ChainRelease( p_out );
+    }
+}
+
 int transcode_video_process( sout_stream_t *p_stream, sout_stream_id_sys_t *id,
                                     block_t *in, block_t **out )
 {
@@ -568,6 +732,9 @@ int transcode_video_process( sout_stream_t *p_stream, sout_stream_id_sys_t *id,
                                    (char *) &id->p_enccfg->i_codec );
                 goto error;
             }
+
+            if( transcode_video_ladder_open( p_stream, id, p_pic ) != VLC_SUCCESS )
+                goto error;
         }
 
         /* Run the filter and output chains; first with the picture,
@@ -586,20 +753,25 @@ int transcode_video_process( sout_stream_t *p_stream, sout_stream_id_sys_t *id,
             for ( ;; p_in = NULL /* drain second time */ )
             {
                 /* Run user specified filter chain */
-                filter_chain_t * secondary_chains[] = { id->p_uf_chain,
-                                                        id->p_final_conv_static };
-                for( size_t i=0; p_in && i<ARRAY_SIZE(secondary_chains); i++ )
+                if( p_in && id->p_uf_chain )
+                    p_in = filter_chain_VideoFilter( id->p_uf_chain, p_in );
+
+                if( p_in && id->i_renditions )
                 {
-                    if( !secondary_chains[i] )
-                        continue;
-                    p_in = filter_chain_VideoFilter( secondary_chains[i], p_in );
+                    /* Blend subpictures once for all the renditions */
+                    p_in = RenderSubpictures( id, p_in );
+                    transcode_video_ladder_push( id, p_in );
                 }
 
+                if( p_in && id->p_final_conv_static )
+                    p_in = filter_chain_VideoFilter( id->p_final_conv_static, p_in );
+
                 if( !p_in )
                     break;
 
                 /* Blend subpictures */
-                p_in = RenderSubpictures( id, p_in );
+                if( !id->i_renditions )
+                    p_in = RenderSubpictures( id, p_in );
 
                 if( p_in )
                 {
@@ -617,6 +789,7 @@ int transcode_video_process( sout_stream_t *p_stream, sout_stream_id_sys_t *id,
             if( transcode_encoder_drain( id->encoder, out ) != VLC_SUCCESS )
                 goto error;
             transcode_encoder_close( id->encoder );
+            transcode_video_ladder_output( p_stream, id, true, true );
             /* Close filters */
             transcode_remove_filters( &id->p_f_chain );
             transcode_remove_filters( &id->p_uf_chain );
@@ -648,6 +821,9 @@ error:
             msg_Warn( p_stream, "Flushing failed");
     }
 
+    /* Forward what the rendition threads have encoded so far */
+    transcode_video_ladder_output( p_stream, id, !id->b_error && in == NULL, false );
+
     if( b_eos )
         tag_last_block_with_flag( out, BLOCK_FLAG_END_OF_SEQUENCE );
 
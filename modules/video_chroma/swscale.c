@@ -37,6 +37,13 @@
 
 #include <libswscale/swscale.h>
 #include <libswscale/version.h>
+#include <libavutil/opt.h>
+
+/* Slice threading, through the frame API */
+#if LIBSWSCALE_VERSION_INT >= AV_VERSION_INT( 6, 4, 100 )
+# define SWSCALE_THREADS 1
+# include <libavutil/frame.h>
+#endif
 
 #ifdef __APPLE__
 # include <TargetConditionals.h>
@@ -64,6 +71,11 @@ static const char *const ppsz_mode_descriptions[] =
   N_("Area"), N_("Luma bicubic / chroma bilinear"), N_("Gauss"),
   N_("SincR"), N_("Lanczos"), N_("Bicubic spline") };
 
+#define THREADS_TEXT N_("Threads")
+#define THREADS_LONGTEXT N_("Number of threads used by libswscale to " \
+    "convert each picture (0 = automatic for large pictures, " \
+    "1 = disabled).")
+
 vlc_module_begin ()
     set_description( N_("Video scaling filter") )
     set_shortname( N_("Swscale" ) )
@@ -72,6 +84,8 @@ vlc_module_begin ()
     set_callback_video_converter( OpenScaler, 150 )
     add_integer( "swscale-mode", 2, SCALEMODE_TEXT, SCALEMODE_LONGTEXT, true )
         change_integer_list( pi_mode_values, ppsz_mode_descriptions )
+    add_integer( "swscale-threads", 0, THREADS_TEXT, THREADS_LONGTEXT, true )
+        change_integer_range( 0, 16 )
 vlc_module_end ()
 
 /* Version checking */
@@ -86,6 +100,7 @@ typedef struct
 {
     SwsFilter *p_filter;
     int i_cpu_mask, i_sws_flags;
+    unsigned i_threads;
 
     video_format_t fmt_in;
     video_format_t fmt_out;
@@ -134,6 +149,11 @@ static int GetSwsCpuMask(void);
 /* SwScaler does not like too small picture */
 #define MINIMUM_WIDTH (32)
 
+/* Automatic threading is enabled from this number of pixels (input or
+ * output) */
+#define THREADS_MIN_PIXELS (1920 * 1080)
+#define THREADS_MAX (16)
+
 /* XXX is it always 3 even for BIG_ENDIAN (blend.c seems to think so) ? */
 #define OFFSET_A (3)
 
@@ -180,6 +200,9 @@ static int OpenScaler( filter_t *p_filter )
     default: p_sys->i_sws_flags = SWS_BICUBIC; i_sws_mode = 2; break;
     }
 
+    int i_threads = var_CreateGetInteger( p_filter, "swscale-threads" );
+    p_sys->i_threads = VLC_CLIP( i_threads, 0, THREADS_MAX );
+
     /* Misc init */
     memset( &p_sys->fmt_in,  0, sizeof(p_sys->fmt_in) );
     memset( &p_sys->fmt_out, 0, sizeof(p_sys->fmt_out) );
@@ -347,6 +370,56 @@ static int GetParameters( ScalerConfiguration *p_cfg,
     return VLC_SUCCESS;
 }
 
+/* Creates a context, using the slice threading of libswscale for large
+ * pictures. The output is the same as without threads. */
+static struct SwsContext *GetContext( filter_t *p_filter,
+                                      int i_src_width, int i_src_height,
+                                      int i_fmti,
+                                      int i_dst_width, int i_dst_height,
+                                      int i_fmto, int i_flags )
+{
+    filter_sys_t *p_sys = p_filter->p_sys;
+    unsigned i_threads = p_sys->i_threads;
+
+    if( i_threads == 0 )
+    {
+        uint64_t i_pixels = __MAX(
+            (uint64_t) i_src_width * i_src_height,
+            (uint64_t) i_dst_width * i_dst_height );
+        i_threads = i_pixels >= THREADS_MIN_PIXELS ?
+                    __MIN( vlc_GetCPUCount(), THREADS_MAX ) : 1;
+    }
+
+#ifdef SWSCALE_THREADS
+    if( i_threads > 1 && p_filter->fmt_in.video.i_chroma != VLC_CODEC_RGBP )
+    {
+        struct SwsContext *ctx = sws_alloc_context();
+        if( ctx == NULL )
+            return NULL;
+
+        av_opt_set_int( ctx, "srcw", i_src_width, 0 );
+        av_opt_set_int( ctx, "srch", i_src_height, 0 );
+        av_opt_set_int( ctx, "src_format", i_fmti, 0 );
+        av_opt_set_int( ctx, "dstw", i_dst_width, 0 );
+        av_opt_set_int( ctx, "dsth", i_dst_height, 0 );
+        av_opt_set_int( ctx, "dst_format", i_fmto, 0 );
+        av_opt_set_int( ctx, "sws_flags", i_flags, 0 );
+        if( av_opt_set_int( ctx, "threads", i_threads, 0 ) >= 0 &&
+            sws_init_context( ctx, p_sys->p_filter, NULL ) >= 0 )
+        {
+            msg_Dbg( p_filter, "converting with %u threads", i_threads );
+            return ctx;
+        }
+        sws_freeContext( ctx );
+        msg_Warn( p_filter, "could not init threaded conversion" );
+    }
+#endif
+
+    return sws_getContext( i_src_width, i_src_height, i_fmti,
+                           i_dst_width, i_dst_height, i_fmto,
+                           i_flags, p_sys->p_filter, NULL, 0 );
+}
+
 static int Init( filter_t *p_filter )
 {
     filter_sys_t *p_sys = p_filter->p_sys;
@@ -401,10 +474,10 @@ static int Init( filter_t *p_filter )
         const int i_fmto = n == 0 ? cfg.i_fmto : AV_PIX_FMT_GRAY8;
         struct SwsContext *ctx;
 
-        ctx = sws_getContext( i_fmti_visible_width, p_fmti->i_visible_height, i_fmti,
-                              i_fmto_visible_width, p_fmto->i_visible_height, i_fmto,
-                              cfg.i_sws_flags | p_sys->i_cpu_mask,
-                              p_sys->p_filter, NULL, 0 );
+        ctx = GetContext( p_filter,
+                          i_fmti_visible_width, p_fmti->i_visible_height, i_fmti,
+                          i_fmto_visible_width, p_fmto->i_visible_height, i_fmto,
+                          cfg.i_sws_flags | p_sys->i_cpu_mask );
         if( n == 0 )
             p_sys->ctx = ctx;
         else
@@ -581,6 +654,75 @@ static void SwapUV( picture_t *p_dst, const picture_t *p_src )
     picture_CopyPixels( p_dst, &tmp );
 }
 
+#ifdef SWSCALE_THREADS
+static void ReleaseFrameBuffer( void *opaque, uint8_t *data )
+{
+    VLC_UNUSED(opaque); VLC_UNUSED(data);
+}
+
+/* Wraps planes in a frame without copying them. The pixels are owned by the
+ * filter: the buffer reference only lets libswscale reference them. */
+static AVFrame *WrapFrame( struct SwsContext *ctx, const char *psz_prefix,
+                           uint8_t *const pp_pixel[4], const int pi_pitch[4] )
+{
+    AVFrame *frame = av_frame_alloc();
+    if( frame == NULL )
+        return NULL;
+
+    frame->buf[0] = av_buffer_create( pp_pixel[0], 1, ReleaseFrameBuffer,
+                                      NULL, 0 );
+    if( frame->buf[0] == NULL )
+    {
+        av_frame_free( &frame );
+        return NULL;
+    }
+
+    for( int i = 0; i < 4; i++ )
+    {
+        frame->data[i] = pp_pixel[i];
+        frame->linesize[i] = pi_pitch[i];
+    }
+
+    char psz_opt[16];
+    int64_t i_val;
+
+    snprintf( psz_opt, sizeof(psz_opt), "%sw", psz_prefix );
+    av_opt_get_int( ctx, psz_opt, 0, &i_val );
+    frame->width = i_val;
+    snprintf( psz_opt, sizeof(psz_opt), "%sh", psz_prefix );
+    av_opt_get_int( ctx, psz_opt, 0, &i_val );
+    frame->height = i_val;
+    snprintf( psz_opt, sizeof(psz_opt), "%s_format", psz_prefix );
+    av_opt_get_int( ctx, psz_opt, 0, &i_val );
+    frame->format = i_val;
+    return frame;
+}
+
+/* Converts with the threads of a threaded context. Only the frame API
+ * uses them: sws_scale() does not. */
+static int ConvertFrame( struct SwsContext *ctx,
+                         uint8_t *const src[4], const int src_stride[4],
+                         uint8_t *const dst[4], const int dst_stride[4] )
+{
+    int64_t i_threads;
+
+    if( av_opt_get_int( ctx, "threads", 0, &i_threads ) < 0 ||
+        i_threads <= 1 )
+        return -1;
+
+    AVFrame *src_frame = WrapFrame( ctx, "src", src, src_stride );
+    AVFrame *dst_frame = WrapFrame( ctx, "dst", dst, dst_stride );
+    int ret = -1;
+
+    if( src_frame != NULL && dst_frame != NULL )
+        ret = sws_scale_frame( ctx, dst_frame, src_frame );
+
+    av_frame_free( &dst_frame );
+    av_frame_free( &src_frame );
+    return ret;
+}
+#endif
+
 static void Convert( filter_t *p_filter, struct SwsContext *ctx,
                      picture_t *p_dst, picture_t *p_src, int i_height,
                      int i_plane_count, bool b_swap_uvi, bool b_swap_uvo )
@@ -606,6 +748,11 @@ static void Convert( filter_t *p_filter, struct SwsContext *ctx,
     GetPixels( dst, dst_stride, p_sys->desc_out, &p_filter->fmt_out.video,
                p_dst, i_plane_count, b_swap_uvo );
 
+#ifdef SWSCALE_THREADS
+    if( ConvertFrame( ctx, src, src_stride, dst, dst_stride ) >= 0 )
+        return;
+#endif
+
     for (size_t i = 0; i < ARRAY_SIZE(src); i++)
         csrc[i] = src[i];
 
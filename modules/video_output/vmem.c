@@ -34,6 +34,8 @@
 #include <vlc_common.h>
 #include <vlc_plugin.h>
 #include <vlc_vout_display.h>
+#include <vlc_picture_pool.h>
+#include <vlc_atomic.h>
 
 /*****************************************************************************
  * Module descriptor
@@ -51,6 +53,9 @@
 #define LT_CHROMA N_("Output chroma for the memory image as a 4-character " \
                       "string, eg. \"RV32\".")
 
+#define T_DIRECT N_("Direct rendering")
+#define LT_DIRECT N_("Decode directly into the memory buffers.")
+
 static int Open(vout_display_t *vd, const vout_display_cfg_t *cfg,
                 video_format_t *fmtp, vlc_video_context *context);
 static void Close(vout_display_t *vd);
@@ -70,6 +75,8 @@ vlc_module_begin()
         change_private()
     add_string("vmem-chroma", "RV16", T_CHROMA, LT_CHROMA, true)
         change_private()
+    add_bool("vmem-direct", false, T_DIRECT, LT_DIRECT, true)
+        change_private()
     add_obsolete_string("vmem-lock") /* obsoleted since 1.1.1 */
     add_obsolete_string("vmem-unlock") /* obsoleted since 1.1.1 */
     add_obsolete_string("vmem-data") /* obsoleted since 1.1.1 */
@@ -80,11 +87,31 @@ vlc_module_end()
 /*****************************************************************************
  * Local prototypes
  *****************************************************************************/
+/* Maximum number of pictures in a picture pool */
+#define VMEM_MAX_BUFFERS 64
+
+struct vmem_buffers;
+
 typedef struct
 {
+    struct vmem_buffers *owner;
     void *id;
 } picture_sys_t;
 
+/* Application buffers for direct rendering: they are released when the
+ * decoder and the display do not use any of them anymore. The display cannot
+ * wait for that when closing, as the decoder only releases its pool after
+ * the display is stopped. So the cleanup callback is invoked from the thread
+ * releasing the last picture, possibly after the setup of the next display. */
+struct vmem_buffers
+{
+    vlc_atomic_rc_t rc;
+    void *opaque;
+    void (*cleanup)(void *sys);
+    unsigned count;
+    picture_sys_t sys[];
+};
+
 /* NOTE: the callback prototypes must match those of LibVLC */
 struct vout_display_sys_t {
     void *opaque;
@@ -96,6 +123,11 @@ struct vout_display_sys_t {
 
     unsigned pitches[PICTURE_PLANE_MAX];
     unsigned lines[PICTURE_PLANE_MAX];
+
+    struct vmem_buffers *buffers; /* direct rendering, or NULL */
+    picture_t **pictures; /* not given to the decoder yet */
+    picture_t *displayed; /* last displayed direct rendering picture */
+    bool direct;
 };
 
 typedef unsigned (*vlc_format_cb)(void **, char *, unsigned *, unsigned *,
@@ -104,11 +136,86 @@ typedef unsigned (*vlc_format_cb)(void **, char *, unsigned *, unsigned *,
 static void           Prepare(vout_display_t *, picture_t *, subpicture_t *, vlc_tick_t);
 static void           Display(vout_display_t *, picture_t *);
 static int            Control(vout_display_t *, int);
+static picture_pool_t *Pool(vout_display_t *, unsigned);
 
 static const struct vlc_display_operations ops = {
-    Close, Prepare, Display, Control, NULL, NULL,
+    Close, Prepare, Display, Control, NULL, NULL, Pool,
 };
 
+static void ReleaseBuffers(struct vmem_buffers *buffers)
+{
+    if (!vlc_atomic_rc_dec(&buffers->rc))
+        return;
+
+    if (buffers->cleanup != NULL)
+        buffers->cleanup(buffers->opaque);
+    free(buffers);
+}
+
+static void DestroyBuffer(picture_t *pic)
+{
+    picture_sys_t *picsys = pic->p_sys;
+
+    ReleaseBuffers(picsys->owner);
+}
+
+/**
+ * Gets the application buffers, and wraps them into pictures for the decoder.
+ */
+static int CreateBuffers(vout_display_t *vd, vout_display_sys_t *sys,
+                         const video_format_t *fmt, unsigned count)
+{
+    struct vmem_buffers *buffers;
+
+    count = __MIN(count, VMEM_MAX_BUFFERS);
+    buffers = malloc(sizeof (*buffers) + count * sizeof (buffers->sys[0]));
+    sys->pictures = vlc_alloc(count, sizeof (*sys->pictures));
+    if (unlikely(buffers == NULL || sys->pictures == NULL)) {
+        free(buffers);
+        free(sys->pictures);
+        sys->pictures = NULL;
+        return VLC_ENOMEM;
+    }
+
+    vlc_atomic_rc_init(&buffers->rc);
+    buffers->opaque = sys->opaque;
+    buffers->cleanup = sys->cleanup;
+    buffers->count = 0;
+
+    for (unsigned i = 0; i < count; i++) {
+        picture_sys_t *picsys = &buffers->sys[i];
+        picture_resource_t rsc = {
+            .p_sys = picsys, .pf_destroy = DestroyBuffer,
+        };
+        void *planes[PICTURE_PLANE_MAX] = { NULL };
+
+        picsys->owner = buffers;
+        picsys->id = sys->lock(sys->opaque, planes);
+        for (unsigned j = 0; j < PICTURE_PLANE_MAX; j++) {
+            rsc.p[j].p_pixels = planes[j];
+            rsc.p[j].i_lines  = sys->lines[j];
+            rsc.p[j].i_pitch  = sys->pitches[j];
+        }
+
+        picture_t *pic = picture_NewFromResource(fmt, &rsc);
+        if (unlikely(pic == NULL)) {
+            while (i > 0)
+                picture_Release(sys->pictures[--i]);
+            free(sys->pictures);
+            sys->pictures = NULL;
+            ReleaseBuffers(buffers);
+            return VLC_ENOMEM;
+        }
+        vlc_atomic_rc_inc(&buffers->rc);
+        buffers->count++;
+        sys->pictures[i] = pic;
+    }
+
+    sys->buffers = buffers;
+    msg_Dbg(vd, "direct rendering into %u buffers", count);
+    return VLC_SUCCESS;
+}
+
 /*****************************************************************************
  * Open: allocates video thread
  *****************************************************************************
@@ -135,9 +242,15 @@ static int Open(vout_display_t *vd, const vout_display_cfg_t *cfg,
     sys->cleanup = var_InheritAddress(vd, "vmem-cleanup");
     sys->opaque = var_InheritAddress(vd, "vmem-data");
 
+    sys->buffers = NULL;
+    sys->pictures = NULL;
+    sys->displayed = NULL;
+    sys->direct = false;
+
     /* Define the video format */
     video_format_t fmt;
     video_format_ApplyRotation(&fmt, vd->source);
+    unsigned count = 0;
 
     if (setup != NULL) {
         char chroma[5];
@@ -154,8 +267,9 @@ static int Open(vout_display_t *vd, const vout_display_cfg_t *cfg,
         heights[0] = fmt.i_height;
         heights[1] = fmt.i_visible_height;
 
-        if (setup(&sys->opaque, chroma, widths, heights,
-                           sys->pitches, sys->lines) == 0) {
+        count = setup(&sys->opaque, chroma, widths, heights,
+                      sys->pitches, sys->lines);
+        if (count == 0) {
             msg_Err(vd, "video format setup failure (no pictures)");
             free(sys);
             return VLC_EGENERIC;
@@ -216,6 +330,24 @@ static int Open(vout_display_t *vd, const vout_display_cfg_t *cfg,
         break;
     }
 
+    /* The decoder can only render into the application buffers if they
+     * match its own format */
+    if (count > 0 && var_InheritBool(vd, "vmem-direct")) {
+        if (fmt.i_chroma == vd->source->i_chroma
+         && fmt.i_width == vd->source->i_width
+         && fmt.i_height == vd->source->i_height
+         && fmt.orientation == vd->source->orientation) {
+            video_format_t pic_fmt = *vd->source;
+
+            pic_fmt.p_palette = NULL;
+            if (CreateBuffers(vd, sys, &pic_fmt, count)) {
+                free(sys);
+                return VLC_ENOMEM;
+            }
+        } else
+            msg_Dbg(vd, "video format converted, no direct rendering");
+    }
+
     /* */
     *fmtp = fmt;
 
@@ -230,11 +362,56 @@ static void Close(vout_display_t *vd)
 {
     vout_display_sys_t *sys = vd->sys;
 
-    if (sys->cleanup)
+    if (sys->displayed != NULL)
+        picture_Release(sys->displayed);
+
+    if (sys->buffers != NULL) {
+        if (sys->pictures != NULL) {
+            for (unsigned i = 0; i < sys->buffers->count; i++)
+                picture_Release(sys->pictures[i]);
+            free(sys->pictures);
+        }
+        /* the cleanup is done once the decoder released the pictures */
+        ReleaseBuffers(sys->buffers);
+    } else if (sys->cleanup)
         sys->cleanup(sys->opaque);
     free(sys);
 }
 
+static picture_pool_t *Pool(vout_display_t *vd, unsigned count)
+{
+    vout_display_sys_t *sys = vd->sys;
+
+    /* the buffers can only be used by one decoder */
+    if (sys->pictures == NULL)
+        return NULL;
+
+    if (sys->buffers->count < count) {
+        msg_Warn(vd, "not enough buffers for direct rendering (%u/%u)",
+                 sys->buffers->count, count);
+        return NULL;
+    }
+
+    picture_pool_t *pool = picture_pool_New(sys->buffers->count,
+                                            sys->pictures);
+    if (pool != NULL) {
+        free(sys->pictures);
+        sys->pictures = NULL;
+    }
+    return pool;
+}
+
+static picture_sys_t *GetBuffer(vout_display_sys_t *sys, picture_t *pic)
+{
+    if (sys->buffers == NULL)
+        return NULL;
+
+    for (unsigned i = 0; i < sys->buffers->count; i++)
+        if (pic->p_sys == &sys->buffers->sys[i])
+            return pic->p_sys;
+    return NULL;
+}
+
 static void Prepare(vout_display_t *vd, picture_t *pic, subpicture_t *subpic,
                     vlc_tick_t date)
 {
@@ -242,6 +419,20 @@ static void Prepare(vout_display_t *vd, picture_t *pic, subpicture_t *subpic,
     vout_display_sys_t *sys = vd->sys;
     picture_resource_t rsc = { .p_sys = NULL };
     void *planes[PICTURE_PLANE_MAX];
+    picture_sys_t *picsys = GetBuffer(sys, pic);
+
+    sys->direct = picsys != NULL;
+    if (sys->direct) {
+        /* the decoder rendered into the application buffer */
+        for (unsigned i = 0; i < PICTURE_PLANE_MAX; i++)
+            planes[i] = i < (unsigned)pic->i_planes ? pic->p[i].p_pixels
+                                                    : NULL;
+        sys->pic_opaque = picsys->id;
+        if (sys->unlock != NULL)
+            sys->unlock(sys->opaque, sys->pic_opaque, planes);
+        (void) subpic;
+        return;
+    }
 
     sys->pic_opaque = sys->lock(sys->opaque, planes);
 
@@ -266,10 +457,14 @@ static void Prepare(vout_display_t *vd, picture_t *pic, subpicture_t *subpic,
 static void Display(vout_display_t *vd, picture_t *pic)
 {
     vout_display_sys_t *sys = vd->sys;
-    VLC_UNUSED(pic);
 
     if (sys->display != NULL)
         sys->display(sys->opaque, sys->pic_opaque);
+
+    /* keep the displayed buffer from being reused until the next one */
+    if (sys->displayed != NULL)
+        picture_Release(sys->displayed);
+    sys->displayed = sys->direct ? picture_Hold(pic) : NULL;
 }
 
 static int Control(vout_display_t *vd, int query)
@@ -30,6 +30,7 @@
 # include <vlc_list.h>
 # include <vlc_viewpoint.h>
 # include "../clock/clock.h"
+# include "../input/input_internal.h"
 
 /* Max input rate factor (1/4 -> 4) */
 # define AOUT_MAX_INPUT_RATE (4)
@@ -99,6 +100,8 @@ typedef struct
 
     atomic_uint buffers_lost;
     atomic_uint buffers_played;
+    input_latency_t filter_latency;
+    input_latency_t output_latency;
     atomic_uchar restart;
 
     vlc_atomic_rc_t rc;
@@ -160,6 +163,7 @@ int aout_DecNew(audio_output_t *, const audio_sample_format_t *, int profile,
 void aout_DecDelete(audio_output_t *);
 int aout_DecPlay(audio_output_t *aout, block_t *block);
 void aout_DecGetResetStats(audio_output_t *, unsigned *, unsigned *);
+void aout_DecGetResetLatency(audio_output_t *, struct input_es_latency *);
 void aout_DecChangePause(audio_output_t *, bool b_paused, vlc_tick_t i_date);
 void aout_DecChangeRate(audio_output_t *aout, float rate);
 void aout_DecChangeDelay(audio_output_t *aout, vlc_tick_t delay);
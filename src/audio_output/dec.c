@@ -133,6 +133,8 @@ error:
 
     atomic_init (&owner->buffers_lost, 0);
     atomic_init (&owner->buffers_played, 0);
+    input_latency_Init (&owner->filter_latency);
+    input_latency_Init (&owner->output_latency);
     atomic_store_explicit(&owner->vp.update, true, memory_order_relaxed);
     return 0;
 }
@@ -464,7 +466,9 @@ int aout_DecPlay(audio_output_t *aout, block_t *block)
             vlc_mutex_unlock (&owner->vp.lock);
         }
 
+        vlc_tick_t start = vlc_tick_now();
         block = aout_FiltersPlay(owner->filters, block, owner->sync.rate);
+        input_latency_Add(&owner->filter_latency, vlc_tick_now() - start);
         if (block == NULL)
             return ret;
     }
@@ -501,6 +505,7 @@ int aout_DecPlay(audio_output_t *aout, block_t *block)
 
     }
 
+    input_latency_Add(&owner->output_latency, play_date - system_now);
     vlc_audio_meter_Process(&owner->meter, block, play_date);
 
     /* Output */
@@ -528,6 +533,17 @@ void aout_DecGetResetStats(audio_output_t *aout, unsigned *restrict lost,
                                        memory_order_relaxed);
 }
 
+void aout_DecGetResetLatency(audio_output_t *aout,
+                             struct input_es_latency *latency)
+{
+    aout_owner_t *owner = aout_owner (aout);
+
+    input_latency_Merge(&latency->stages[VLC_LATENCY_FILTER],
+                        &owner->filter_latency);
+    input_latency_Merge(&latency->stages[VLC_LATENCY_OUTPUT],
+                        &owner->output_latency);
+}
+
 void aout_DecChangePause (audio_output_t *aout, bool paused, vlc_tick_t date)
 {
     aout_owner_t *owner = aout_owner (aout);
@@ -49,6 +49,7 @@
 #include "../clock/clock.h"
 #include "decoder.h"
 #include "resource.h"
+#include "input_internal.h"
 #include "libvlc.h"
 
 #include "../video_output/vout_internal.h"
@@ -96,6 +97,16 @@ struct vlc_input_decoder_t
     /* fifo */
     block_fifo_t *p_fifo;
 
+    /* Latency instrumentation (NULL if disabled) */
+    struct input_es_latency *latency;
+#define DECODER_FIFO_DATES 64
+#define DECODER_FIFO_DATES_MAX 65536
+    vlc_tick_t *fifo_dates; /* enqueue dates ring, protected by the fifo lock */
+    size_t fifo_dates_size; /* ring size, a power of two */
+    uint64_t fifo_in; /* number of blocks queued, protected by the fifo lock */
+    uint64_t fifo_out; /* number of blocks dequeued, ditto */
+    size_t fifo_limit; /* bytes above which the input is slowed down, or 0 */
+
     /* Lock for communication with decoder thread */
     vlc_mutex_t lock;
     vlc_cond_t  wait_request;
@@ -147,6 +158,7 @@ struct vlc_input_decoder_t
     bool paused;
 
     bool error;
+    bool b_thumbnailing;
 
     /* Waiting */
     bool b_waiting;
@@ -426,6 +438,20 @@ static int ModuleThread_UpdateVideoFormat( decoder_t *p_dec, vlc_video_context *
 
     // configure the new vout
 
+    vout_configuration_t cfg = {
+        .vout = p_owner->p_vout, .clock = p_owner->p_clock, .fmt = &p_dec->fmt_out.video,
+        .mouse_event = MouseEvent, .mouse_opaque = p_dec,
+    };
+    bool has_started;
+    vout_thread_t *p_vout =
+        input_resource_RequestVout(p_owner->p_resource, vctx, &cfg, NULL,
+                                   &has_started);
+    if (p_vout == NULL)
+        goto error;
+
+    if (has_started)
+        decoder_Notify(p_owner, on_vout_started, p_vout, p_owner->vout_order);
+
     if ( p_owner->out_pool == NULL )
     {
         unsigned dpb_size;
@@ -450,14 +476,34 @@ static int ModuleThread_UpdateVideoFormat( decoder_t *p_dec, vlc_video_context *
             dpb_size = 2;
             break;
         }
-        picture_pool_t *pool = picture_pool_NewFromFormat( &p_dec->fmt_out.video,
-                            dpb_size + p_dec->i_extra_picture_buffers + 1 );
+        const unsigned count = dpb_size + p_dec->i_extra_picture_buffers + 1;
+
+        /* decode directly into the display buffers if possible */
+        picture_pool_t *pool = NULL;
+        if( vctx == NULL )
+            pool = vout_GetDecoderPool( p_vout, &p_dec->fmt_out.video, count );
+        if( pool != NULL )
+            msg_Dbg( p_dec, "rendering directly into the display pictures" );
+        else
+            pool = picture_pool_NewFromFormat( &p_dec->fmt_out.video, count );
 
         if( pool == NULL)
         {
             msg_Err(p_dec, "Failed to create a pool of %d %4.4s pictures",
-                           dpb_size + p_dec->i_extra_picture_buffers + 1,
-                           (char*)&p_dec->fmt_out.video.i_chroma);
+                           count, (char*)&p_dec->fmt_out.video.i_chroma);
+
+            /* Give the vout back, it is not usable without pictures. Hold it
+             * since PutVout may release it and the notification needs it. */
+            vout_Hold(p_vout);
+            vlc_mutex_lock( &p_owner->lock );
+            p_owner->p_vout = NULL;
+            vlc_mutex_unlock( &p_owner->lock );
+
+            bool has_stopped;
+            input_resource_PutVout(p_owner->p_resource, p_vout, &has_stopped);
+            if (has_stopped)
+                decoder_Notify(p_owner, on_vout_stopped, p_vout);
+            vout_Release(p_vout);
             goto error;
         }
 
@@ -467,28 +513,14 @@ static int ModuleThread_UpdateVideoFormat( decoder_t *p_dec, vlc_video_context *
 
     }
 
-    vout_configuration_t cfg = {
-        .vout = p_owner->p_vout, .clock = p_owner->p_clock, .fmt = &p_dec->fmt_out.video,
-        .mouse_event = MouseEvent, .mouse_opaque = p_dec,
-    };
-    bool has_started;
-    vout_thread_t *p_vout =
-        input_resource_RequestVout(p_owner->p_resource, vctx, &cfg, NULL,
-                                   &has_started);
-    if (p_vout != NULL)
-    {
-        vlc_mutex_lock( &p_owner->lock );
-        p_owner->vout_started = true;
-        vlc_mutex_unlock( &p_owner->lock );
-
-        vlc_fifo_Lock( p_owner->p_fifo );
-        p_owner->reset_out_state = true;
-        vlc_fifo_Unlock( p_owner->p_fifo );
+    vlc_mutex_lock( &p_owner->lock );
+    p_owner->vout_started = true;
+    vlc_mutex_unlock( &p_owner->lock );
 
-        if (has_started)
-            decoder_Notify(p_owner, on_vout_started, p_vout, p_owner->vout_order);
-        return 0;
-    }
+    vlc_fifo_Lock( p_owner->p_fifo );
+    p_owner->reset_out_state = true;
+    vlc_fifo_Unlock( p_owner->p_fifo );
+    return 0;
 
 error:
     /* Clean fmt and vctx to trigger a new vout creation on the next update
@@ -1109,6 +1141,9 @@ static void ModuleThread_UpdateStatVideo( vlc_input_decoder_t *p_owner,
     }
     if (lost) vout_lost++;
 
+    if( p_owner->latency != NULL && p_owner->p_vout != NULL )
+        vout_GetResetLatency( p_owner->p_vout, p_owner->latency );
+
     decoder_Notify(p_owner, on_new_video_stats, 1, vout_lost, displayed, vout_late);
 }
 
@@ -1244,6 +1279,9 @@ static void ModuleThread_UpdateStatAudio( vlc_input_decoder_t *p_owner,
     }
     if (lost) aout_lost++;
 
+    if( p_owner->latency != NULL && p_owner->p_aout != NULL )
+        aout_DecGetResetLatency( p_owner->p_aout, p_owner->latency );
+
     decoder_Notify(p_owner, on_new_audio_stats, 1, aout_lost, played);
 }
 
@@ -1318,8 +1356,16 @@ static void DecoderThread_ProcessInput( vlc_input_decoder_t *p_owner, block_t *p
 static void DecoderThread_DecodeBlock( vlc_input_decoder_t *p_owner, block_t *p_block )
 {
     decoder_t *p_dec = &p_owner->dec;
+    vlc_tick_t start = VLC_TICK_INVALID;
+
+    if( p_owner->latency != NULL && p_block != NULL )
+        start = vlc_tick_now();
 
     int ret = p_dec->pf_decode( p_dec, p_block );
+
+    if( start != VLC_TICK_INVALID )
+        input_latency_Add( &p_owner->latency->stages[VLC_LATENCY_DECODE],
+                           vlc_tick_now() - start );
     switch( ret )
     {
         case VLCDEC_SUCCESS:
@@ -1495,6 +1541,11 @@ static void DecoderThread_Flush( vlc_input_decoder_t *p_owner )
          * vlc_input_decoder_Flush() */
         if( p_owner->out_pool != NULL )
             picture_pool_Cancel( p_owner->out_pool, false );
+
+        /* Output a new thumbnail after a seek, even if the es_out did not
+         * call vlc_input_decoder_StartWait() because it is still buffering */
+        if( p_owner->b_thumbnailing )
+            p_owner->b_first = true;
     }
     else if( p_dec->fmt_out.i_cat == SPU_ES )
     {
@@ -1601,6 +1652,47 @@ static void DecoderThread_ChangeDelay( vlc_input_decoder_t *p_owner, vlc_tick_t
     }
 }
 
+/**
+ * Doubles the ring of enqueue dates once it is full, so that the dates of the
+ * queued blocks are kept (called with the fifo locked)
+ */
+static void DecoderGrowFifoDates( vlc_input_decoder_t *p_owner )
+{
+    size_t size = p_owner->fifo_dates_size;
+
+    if( size >= DECODER_FIFO_DATES_MAX )
+        return; /* the oldest dates will be overwritten */
+
+    vlc_tick_t *dates = vlc_alloc( 2 * size, sizeof( *dates ) );
+    if( unlikely(dates == NULL) )
+        return;
+
+    for( uint64_t seq = p_owner->fifo_out; seq < p_owner->fifo_in; seq++ )
+        dates[seq % (2 * size)] = p_owner->fifo_dates[seq % size];
+
+    free( p_owner->fifo_dates );
+    p_owner->fifo_dates = dates;
+    p_owner->fifo_dates_size = 2 * size;
+}
+
+/**
+ * Accounts for a block dequeued from the fifo (called with the fifo locked)
+ */
+static void DecoderThread_UpdateFifoLatency( vlc_input_decoder_t *p_owner )
+{
+    struct input_es_latency *latency = p_owner->latency;
+    uint64_t seq = p_owner->fifo_out++;
+
+    /* The enqueue date is lost if the ring could not grow */
+    if( p_owner->fifo_in - seq <= p_owner->fifo_dates_size )
+        input_latency_Add( &latency->stages[VLC_LATENCY_FIFO_WAIT],
+                           vlc_tick_now()
+                           - p_owner->fifo_dates[seq % p_owner->fifo_dates_size] );
+
+    input_es_latency_UpdateFifo( latency,
+                                 vlc_fifo_GetCount( p_owner->p_fifo ) );
+}
+
 /**
  * The decoding main loop
  *
@@ -1707,6 +1799,8 @@ static void *DecoderThread( void *p_data )
             /* We have emptied the FIFO and there is a pending request to
              * drain. Pass p_block = NULL to decoder just once. */
         }
+        else if( p_owner->latency != NULL )
+            DecoderThread_UpdateFifoLatency( p_owner );
 
         vlc_fifo_Unlock( p_owner->p_fifo );
 
@@ -1828,6 +1922,7 @@ CreateDecoder( vlc_object_t *p_parent,
     p_owner->b_has_data = false;
 
     p_owner->error = false;
+    p_owner->b_thumbnailing = b_thumbnailing;
 
     p_owner->flushing = false;
     p_owner->b_draining = false;
@@ -1847,6 +1942,33 @@ CreateDecoder( vlc_object_t *p_parent,
         vlc_object_delete(p_dec);
         return NULL;
     }
+    vlc_fifo_SetMemUsage( p_owner->p_fifo, VLC_MEMUSAGE_DECODER );
+
+    uint64_t fifo_limit = var_InheritInteger( p_parent, "input-fifo-limit" );
+    p_owner->fifo_limit = __MIN( fifo_limit, SIZE_MAX / 1024 ) * 1024;
+
+    p_owner->latency = NULL;
+    p_owner->fifo_dates = NULL;
+    p_owner->fifo_dates_size = 0;
+    p_owner->fifo_in = p_owner->fifo_out = 0;
+    if( cbs != NULL && !b_thumbnailing && var_InheritBool( p_parent, "stats" ) )
+    {
+        p_owner->latency = malloc( sizeof( *p_owner->latency ) );
+        p_owner->fifo_dates = vlc_alloc( DECODER_FIFO_DATES,
+                                         sizeof( *p_owner->fifo_dates ) );
+        if( likely(p_owner->latency != NULL && p_owner->fifo_dates != NULL) )
+        {
+            input_es_latency_Init( p_owner->latency, fmt );
+            p_owner->fifo_dates_size = DECODER_FIFO_DATES;
+        }
+        else
+        {
+            free( p_owner->latency );
+            free( p_owner->fifo_dates );
+            p_owner->latency = NULL;
+            p_owner->fifo_dates = NULL;
+        }
+    }
 
     vlc_mutex_init( &p_owner->lock );
     vlc_mutex_init( &p_owner->mouse_lock );
@@ -1954,6 +2076,8 @@ static void DeleteDecoder( vlc_input_decoder_t *p_owner )
 
     /* Free all packets still in the decoder fifo. */
     block_FifoRelease( p_owner->p_fifo );
+    free( p_owner->latency );
+    free( p_owner->fifo_dates );
 
     /* Cleanup */
 #ifdef ENABLE_SOUT
@@ -2216,6 +2340,14 @@ void vlc_input_decoder_Decode( vlc_input_decoder_t *p_owner, block_t *p_block,
     vlc_fifo_Lock( p_owner->p_fifo );
     if( !b_do_pace )
     {
+        if( p_owner->fifo_limit > 0 && !p_owner->b_waiting )
+        {   /* Slow the input down rather than buffering without bounds. The
+             * FIFO is not consumed while waiting or paused (see below). */
+            while( vlc_fifo_GetBytes( p_owner->p_fifo ) > p_owner->fifo_limit
+                && !p_owner->paused )
+                vlc_fifo_WaitCond( p_owner->p_fifo, &p_owner->wait_fifo );
+        }
+
         /* FIXME: ideally we would check the time amount of data
          * in the FIFO instead of its size. */
         /* 400 MiB, i.e. ~ 50mb/s for 60s */
@@ -2224,6 +2356,7 @@ void vlc_input_decoder_Decode( vlc_input_decoder_t *p_owner, block_t *p_block,
             msg_Warn( &p_owner->dec, "decoder/packetizer fifo full (data not "
                       "consumed quickly enough), resetting fifo!" );
             block_ChainRelease( vlc_fifo_DequeueAllUnlocked( p_owner->p_fifo ) );
+            p_owner->fifo_out = p_owner->fifo_in;
             p_block->i_flags |= BLOCK_FLAG_DISCONTINUITY;
         }
     }
@@ -2236,10 +2369,33 @@ void vlc_input_decoder_Decode( vlc_input_decoder_t *p_owner, block_t *p_block,
             vlc_fifo_WaitCond( p_owner->p_fifo, &p_owner->wait_fifo );
     }
 
+    if( p_owner->latency != NULL )
+    {
+        const vlc_tick_t now = vlc_tick_now();
+
+        for( block_t *p = p_block; p != NULL; p = p->p_next )
+        {
+            if( p_owner->fifo_in - p_owner->fifo_out
+                                            == p_owner->fifo_dates_size )
+                DecoderGrowFifoDates( p_owner );
+            p_owner->fifo_dates[p_owner->fifo_in++
+                                % p_owner->fifo_dates_size] = now;
+        }
+    }
+
     vlc_fifo_QueueUnlocked( p_owner->p_fifo, p_block );
+
+    if( p_owner->latency != NULL )
+        input_es_latency_UpdateFifo( p_owner->latency,
+                                     vlc_fifo_GetCount( p_owner->p_fifo ) );
     vlc_fifo_Unlock( p_owner->p_fifo );
 }
 
+struct input_es_latency *vlc_input_decoder_GetLatency( vlc_input_decoder_t *p_owner )
+{
+    return p_owner->latency;
+}
+
 bool vlc_input_decoder_IsEmpty( vlc_input_decoder_t * p_owner )
 {
     assert( !p_owner->b_waiting );
@@ -2297,6 +2453,7 @@ void vlc_input_decoder_Flush( vlc_input_decoder_t *p_owner )
 
     /* Empty the fifo */
     block_ChainRelease( vlc_fifo_DequeueAllUnlocked( p_owner->p_fifo ) );
+    p_owner->fifo_out = p_owner->fifo_in;
 
     /* Don't need to wait for the DecoderThread to flush. Indeed, if called a
      * second time, this function will clear the FIFO again before anything was
@@ -97,6 +97,12 @@ void vlc_input_decoder_StopWait( vlc_input_decoder_t * );
  */
 bool vlc_input_decoder_IsEmpty( vlc_input_decoder_t * );
 
+/**
+ * This function returns the latency instrumentation of the decoder, or NULL
+ * if statistics are disabled. It remains valid until the decoder is deleted.
+ */
+struct input_es_latency *vlc_input_decoder_GetLatency( vlc_input_decoder_t * );
+
 /**
  * This function activates the request closed caption channel.
  */
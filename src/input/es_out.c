@@ -2194,6 +2194,10 @@ static void EsOutCreateDecoder( es_out_t *out, es_out_id_t *p_es )
                                  priv->b_thumbnailing, &decoder_cbs, p_es );
     if( dec != NULL )
     {
+        struct input_es_latency *latency = vlc_input_decoder_GetLatency( dec );
+        if( priv->stats != NULL && latency != NULL )
+            input_stats_AddEsLatency( priv->stats, latency );
+
         vlc_input_decoder_ChangeRate( dec, p_sys->rate );
 
         if( p_sys->b_buffering )
@@ -2224,13 +2228,18 @@ static void EsOutCreateDecoder( es_out_t *out, es_out_id_t *p_es )
 }
 static void EsOutDestroyDecoder( es_out_t *out, es_out_id_t *p_es )
 {
-    VLC_UNUSED(out);
+    es_out_sys_t *p_sys = container_of(out, es_out_sys_t, out);
 
     if( !p_es->p_dec )
         return;
 
     assert( p_es->p_pgrm );
 
+    struct input_stats *stats = input_priv(p_sys->p_input)->stats;
+    struct input_es_latency *latency = vlc_input_decoder_GetLatency( p_es->p_dec );
+    if( stats != NULL && latency != NULL )
+        input_stats_RemoveEsLatency( stats, latency );
+
     vlc_input_decoder_Delete( p_es->p_dec );
     p_es->p_dec = NULL;
     if( p_es->p_pgrm->p_master_clock == p_es->p_clock )
@@ -45,6 +45,7 @@
 #endif
 #include <vlc_es_out.h>
 #include <vlc_block.h>
+#include <vlc_memusage.h>
 #include "input_internal.h"
 #include "es_out.h"
 
@@ -1263,6 +1264,7 @@ static ts_storage_t *TsStorageNew( const char *psz_tmp_path, int64_t i_tmp_size_
         TsStorageDelete( p_storage );
         return NULL;
     }
+    vlc_memusage_Add( VLC_MEMUSAGE_TIMESHIFT, p_storage->i_cmd_buf );
     return p_storage;
 error:
     free( psz_file );
@@ -1280,6 +1282,8 @@ static void TsStorageDelete( ts_storage_t *p_storage )
 
         CmdClean( &cmd );
     }
+    if( p_storage->p_cmd_buf )
+        vlc_memusage_Sub( VLC_MEMUSAGE_TIMESHIFT, p_storage->i_cmd_buf );
     free( p_storage->p_cmd_buf );
 
     fclose( p_storage->p_filer );
@@ -1301,6 +1305,8 @@ static void TsStoragePack( ts_storage_t *p_storage )
     uint8_t *p_realloc = realloc( p_storage->p_cmd_buf, i_realloc );
     if( p_realloc )
     {
+        vlc_memusage_Sub( VLC_MEMUSAGE_TIMESHIFT,
+                          p_storage->i_cmd_buf - i_realloc );
         p_storage->p_cmd_r = p_realloc + (p_storage->p_cmd_r - p_storage->p_cmd_buf);
         p_storage->p_cmd_w = p_realloc + i_realloc;
         p_storage->i_cmd_buf = i_realloc;
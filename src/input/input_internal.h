@@ -719,6 +719,26 @@ typedef struct input_rate_t
     } samples[2];
 } input_rate_t;
 
+/** Lock-free latency histogram */
+typedef struct input_latency_t
+{
+    atomic_uintmax_t count;
+    atomic_uintmax_t total;
+    atomic_uintmax_t max;
+    atomic_uintmax_t buckets[VLC_LATENCY_BUCKETS];
+} input_latency_t;
+
+/** Latency instrumentation of an elementary stream, owned by its decoder */
+struct input_es_latency
+{
+    int es_id;
+    enum es_format_category_e cat;
+    input_latency_t stages[VLC_LATENCY_STAGE_COUNT];
+    atomic_size_t fifo_depth;
+    atomic_size_t fifo_depth_max;
+    struct vlc_list node;
+};
+
 struct input_stats {
     input_rate_t input_bitrate;
     input_rate_t demux_bitrate;
@@ -731,6 +751,9 @@ struct input_stats {
     atomic_uintmax_t displayed_pictures;
     atomic_uintmax_t late_pictures;
     atomic_uintmax_t lost_pictures;
+
+    vlc_mutex_t latency_lock;
+    struct vlc_list latencies; /**< list of struct input_es_latency */
 };
 
 struct input_stats *input_stats_Create(void);
@@ -738,4 +761,16 @@ void input_stats_Destroy(struct input_stats *);
 void input_rate_Add(input_rate_t *, uintmax_t);
 void input_stats_Compute(struct input_stats *, input_stats_t*);
 
+void input_latency_Init(input_latency_t *);
+void input_latency_Add(input_latency_t *, vlc_tick_t);
+void input_latency_Merge(input_latency_t *dst, input_latency_t *src);
+
+void input_es_latency_Init(struct input_es_latency *, const es_format_t *);
+void input_es_latency_UpdateFifo(struct input_es_latency *, size_t depth);
+void input_stats_AddEsLatency(struct input_stats *, struct input_es_latency *);
+void input_stats_RemoveEsLatency(struct input_stats *,
+                                 struct input_es_latency *);
+struct vlc_es_latency *input_stats_GetLatency(struct input_stats *,
+                                              size_t *count);
+
 #endif
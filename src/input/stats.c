@@ -26,6 +26,7 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <assert.h>
 
 #include <vlc_common.h>
 #include "input/input_internal.h"
@@ -68,11 +69,14 @@ struct input_stats *input_stats_Create(void)
     atomic_init(&stats->displayed_pictures, 0);
     atomic_init(&stats->late_pictures, 0);
     atomic_init(&stats->lost_pictures, 0);
+    vlc_mutex_init(&stats->latency_lock);
+    vlc_list_init(&stats->latencies);
     return stats;
 }
 
 void input_stats_Destroy(struct input_stats *stats)
 {
+    assert(vlc_list_is_empty(&stats->latencies));
     free(stats);
 }
 
@@ -140,3 +144,168 @@ void input_rate_Add(input_rate_t *counter, uintmax_t val)
     counter->samples[0].date = now;
     vlc_mutex_unlock(&counter->lock);
 }
+
+void input_latency_Init(input_latency_t *latency)
+{
+    atomic_init(&latency->count, 0);
+    atomic_init(&latency->total, 0);
+    atomic_init(&latency->max, 0);
+    for (size_t i = 0; i < VLC_LATENCY_BUCKETS; i++)
+        atomic_init(&latency->buckets[i], 0);
+}
+
+static void input_latency_AddMax(input_latency_t *latency, uintmax_t value)
+{
+    uintmax_t max = atomic_load_explicit(&latency->max, memory_order_relaxed);
+
+    while (value > max
+        && !atomic_compare_exchange_weak_explicit(&latency->max, &max, value,
+                                                  memory_order_relaxed,
+                                                  memory_order_relaxed));
+}
+
+/**
+ * Adds a sample to a latency histogram
+ *
+ * This is lock-free and can be called from any thread.
+ */
+void input_latency_Add(input_latency_t *latency, vlc_tick_t value)
+{
+    if (value < 0)
+        value = 0;
+
+    unsigned bucket = 0;
+    uintmax_t us = US_FROM_VLC_TICK(value);
+    if (us > 1)
+    {
+        bucket = 63 - vlc_clzll(us);
+        if (bucket >= VLC_LATENCY_BUCKETS)
+            bucket = VLC_LATENCY_BUCKETS - 1;
+    }
+
+    atomic_fetch_add_explicit(&latency->buckets[bucket], 1,
+                              memory_order_relaxed);
+    atomic_fetch_add_explicit(&latency->count, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&latency->total, value, memory_order_relaxed);
+    input_latency_AddMax(latency, value);
+}
+
+/**
+ * Moves the samples of a histogram to another one
+ *
+ * The source histogram is reset.
+ */
+void input_latency_Merge(input_latency_t *dst, input_latency_t *src)
+{
+    uintmax_t count = atomic_exchange_explicit(&src->count, 0,
+                                               memory_order_relaxed);
+    if (count == 0)
+        return;
+
+    atomic_fetch_add_explicit(&dst->count, count, memory_order_relaxed);
+    atomic_fetch_add_explicit(&dst->total,
+                              atomic_exchange_explicit(&src->total, 0,
+                                                       memory_order_relaxed),
+                              memory_order_relaxed);
+    input_latency_AddMax(dst, atomic_exchange_explicit(&src->max, 0,
+                                                       memory_order_relaxed));
+    for (size_t i = 0; i < VLC_LATENCY_BUCKETS; i++)
+        atomic_fetch_add_explicit(&dst->buckets[i],
+                                  atomic_exchange_explicit(&src->buckets[i], 0,
+                                                      memory_order_relaxed),
+                                  memory_order_relaxed);
+}
+
+static void input_latency_Get(input_latency_t *latency,
+                              struct vlc_latency_histogram *h)
+{
+    h->count = atomic_load_explicit(&latency->count, memory_order_relaxed);
+    h->total = atomic_load_explicit(&latency->total, memory_order_relaxed);
+    h->max = atomic_load_explicit(&latency->max, memory_order_relaxed);
+    for (size_t i = 0; i < VLC_LATENCY_BUCKETS; i++)
+        h->buckets[i] = atomic_load_explicit(&latency->buckets[i],
+                                             memory_order_relaxed);
+}
+
+void input_es_latency_Init(struct input_es_latency *latency,
+                           const es_format_t *fmt)
+{
+    latency->es_id = fmt->i_id;
+    latency->cat = fmt->i_cat;
+    for (size_t i = 0; i < VLC_LATENCY_STAGE_COUNT; i++)
+        input_latency_Init(&latency->stages[i]);
+    atomic_init(&latency->fifo_depth, 0);
+    atomic_init(&latency->fifo_depth_max, 0);
+}
+
+void input_es_latency_UpdateFifo(struct input_es_latency *latency,
+                                 size_t depth)
+{
+    atomic_store_explicit(&latency->fifo_depth, depth, memory_order_relaxed);
+
+    size_t max = atomic_load_explicit(&latency->fifo_depth_max,
+                                      memory_order_relaxed);
+    while (depth > max
+        && !atomic_compare_exchange_weak_explicit(&latency->fifo_depth_max,
+                                                  &max, depth,
+                                                  memory_order_relaxed,
+                                                  memory_order_relaxed));
+}
+
+void input_stats_AddEsLatency(struct input_stats *stats,
+                              struct input_es_latency *latency)
+{
+    vlc_mutex_lock(&stats->latency_lock);
+    vlc_list_append(&latency->node, &stats->latencies);
+    vlc_mutex_unlock(&stats->latency_lock);
+}
+
+void input_stats_RemoveEsLatency(struct input_stats *stats,
+                                 struct input_es_latency *latency)
+{
+    vlc_mutex_lock(&stats->latency_lock);
+    vlc_list_remove(&latency->node);
+    vlc_mutex_unlock(&stats->latency_lock);
+}
+
+/**
+ * Gets a snapshot of the latency statistics of all active ES
+ *
+ * \param count pointer to the number of returned elements [OUT]
+ * \return an array of statistics (to be released with free()), or NULL
+ */
+struct vlc_es_latency *input_stats_GetLatency(struct input_stats *stats,
+                                              size_t *count)
+{
+    struct input_es_latency *latency;
+    struct vlc_es_latency *array = NULL;
+    size_t n = 0;
+
+    vlc_mutex_lock(&stats->latency_lock);
+    vlc_list_foreach(latency, &stats->latencies, node)
+        n++;
+
+    if (n > 0)
+        array = vlc_alloc(n, sizeof (*array));
+    if (array != NULL)
+    {
+        struct vlc_es_latency *es = array;
+
+        vlc_list_foreach(latency, &stats->latencies, node)
+        {
+            es->i_id = latency->es_id;
+            es->i_cat = latency->cat;
+            es->fifo_depth = atomic_load_explicit(&latency->fifo_depth,
+                                                  memory_order_relaxed);
+            es->fifo_depth_max = atomic_load_explicit(&latency->fifo_depth_max,
+                                                      memory_order_relaxed);
+            for (size_t i = 0; i < VLC_LATENCY_STAGE_COUNT; i++)
+                input_latency_Get(&latency->stages[i], &es->stages[i]);
+            es++;
+        }
+    }
+    vlc_mutex_unlock(&stats->latency_lock);
+
+    *count = (array != NULL) ? n : 0;
+    return array;
+}
@@ -26,6 +26,8 @@
 
 #include <vlc_thumbnailer.h>
 #include <vlc_executor.h>
+#include <vlc_image.h>
+#include <vlc_sort.h>
 #include "input_internal.h"
 
 struct vlc_thumbnailer_t
@@ -51,6 +53,33 @@ struct seek_target
     };
 };
 
+struct batch_entry
+{
+    vlc_tick_t time;
+    size_t index; /**< index in the times array provided by the user */
+    picture_t *pic;
+};
+
+/**
+ * Thumbnails requested by vlc_thumbnailer_RequestBatch(), taken from a single
+ * input, by increasing time
+ */
+struct thumbnailer_batch
+{
+    vlc_thumbnailer_batch_cb cb;
+    unsigned width;
+    unsigned height;
+
+    size_t current; /**< entry waiting for its thumbnail (protected by the
+                         task lock) */
+    /** Input the events are expected from (protected by the task lock): a
+     * thumbnail timing out is given up with its input, and the late events
+     * of that input must not be taken for the next thumbnails */
+    input_thread_t *input;
+    size_t count;
+    struct batch_entry entries[];
+};
+
 /* We may not rename vlc_thumbnailer_request_t because it is exposed in the
  * public API */
 typedef struct vlc_thumbnailer_request_t task_t;
@@ -69,10 +98,13 @@ struct vlc_thumbnailer_request_t
     vlc_tick_t timeout;
     vlc_thumbnailer_cb cb;
     void* userdata;
+    /** NULL for single thumbnail requests */
+    struct thumbnailer_batch *batch;
 
     vlc_mutex_t lock;
     vlc_cond_t cond_ended;
     bool ended;
+    bool canceled;
 
     struct vlc_runnable runnable; /**< to be passed to the executor */
 
@@ -97,10 +129,12 @@ TaskNew(vlc_thumbnailer_t *thumbnailer, input_item_t *item,
     task->cb = cb;
     task->userdata = userdata;
     task->timeout = timeout;
+    task->batch = NULL;
 
     vlc_mutex_init(&task->lock);
     vlc_cond_init(&task->cond_ended);
     task->ended = false;
+    task->canceled = false;
 
     task->runnable.run = RunnableRun;
     task->runnable.userdata = task;
@@ -113,6 +147,14 @@ TaskNew(vlc_thumbnailer_t *thumbnailer, input_item_t *item,
 static void
 TaskDelete(task_t *task)
 {
+    struct thumbnailer_batch *batch = task->batch;
+    if (batch)
+    {
+        for (size_t i = 0; i < batch->count; ++i)
+            if (batch->entries[i].pic)
+                picture_Release(batch->entries[i].pic);
+        free(batch);
+    }
     input_item_Release(task->item);
     free(task);
 }
@@ -139,11 +181,66 @@ static void NotifyThumbnail(task_t *task, picture_t *pic)
     task->cb(task->userdata, pic);
 }
 
+static void NotifyBatchThumbnail(task_t *task, const struct batch_entry *entry,
+                                 picture_t *pic)
+{
+    assert(task->batch->cb);
+    task->batch->cb(task->userdata, entry->index, pic);
+}
+
+static void NotifyFailure(task_t *task)
+{
+    struct thumbnailer_batch *batch = task->batch;
+    if (!batch)
+    {
+        NotifyThumbnail(task, NULL);
+        return;
+    }
+
+    for (size_t i = 0; i < batch->count; ++i)
+        NotifyBatchThumbnail(task, &batch->entries[i], NULL);
+}
+
+static void
+on_batch_input_event(input_thread_t *input,
+                     const struct vlc_input_event *event, task_t *task)
+{
+    struct thumbnailer_batch *batch = task->batch;
+
+    vlc_mutex_lock(&task->lock);
+    if (task->ended || input != batch->input)
+    {
+        vlc_mutex_unlock(&task->lock);
+        return;
+    }
+
+    if (event->type == INPUT_EVENT_THUMBNAIL_READY)
+    {
+        assert(batch->current < batch->count);
+        struct batch_entry *entry = &batch->entries[batch->current++];
+        assert(entry->pic == NULL);
+        entry->pic = picture_Hold(event->thumbnail);
+
+        /* Seek right away (from the decoder thread), so that the input does
+         * not reach the end of the stream in the meantime. The next decoded
+         * picture after the seek is the next thumbnail. */
+        if (batch->current < batch->count)
+            input_SetTime(input, batch->entries[batch->current].time,
+                          task->fast_seek);
+        else
+            task->ended = true;
+    }
+    else
+        task->ended = true;
+
+    vlc_mutex_unlock(&task->lock);
+    vlc_cond_signal(&task->cond_ended);
+}
+
 static void
 on_thumbnailer_input_event( input_thread_t *input,
                             const struct vlc_input_event *event, void *userdata )
 {
-    VLC_UNUSED(input);
     if ( event->type != INPUT_EVENT_THUMBNAIL_READY &&
          ( event->type != INPUT_EVENT_STATE || ( event->state.value != ERROR_S &&
                                                  event->state.value != END_S ) ) )
@@ -151,6 +248,12 @@ on_thumbnailer_input_event( input_thread_t *input,
 
     task_t *task = userdata;
 
+    if (task->batch)
+    {
+        on_batch_input_event(input, event, task);
+        return;
+    }
+
     vlc_mutex_lock(&task->lock);
     if (task->ended)
     {
@@ -172,19 +275,183 @@ on_thumbnailer_input_event( input_thread_t *input,
     vlc_cond_signal(&task->cond_ended);
 }
 
+static picture_t *
+ScaleThumbnail(image_handler_t **handler, vlc_object_t *parent,
+               const struct thumbnailer_batch *batch, picture_t *pic)
+{
+    if (!batch->width && !batch->height)
+        return picture_Hold(pic);
+
+    video_format_t fmt_in = pic->format;
+    if (!fmt_in.i_visible_width || !fmt_in.i_visible_height)
+        return NULL;
+
+    unsigned sar_num = fmt_in.i_sar_num ? fmt_in.i_sar_num : 1;
+    unsigned sar_den = fmt_in.i_sar_den ? fmt_in.i_sar_den : 1;
+    uint64_t display_width = (uint64_t) fmt_in.i_visible_width * sar_num;
+    uint64_t display_height = (uint64_t) fmt_in.i_visible_height * sar_den;
+
+    unsigned width = batch->width;
+    unsigned height = batch->height;
+    if (!width)
+        width = __MAX(1, (height * display_width + display_height / 2)
+                         / display_height);
+    else if (!height)
+        height = __MAX(1, (width * display_height + display_width / 2)
+                          / display_width);
+
+    if (width == fmt_in.i_visible_width && height == fmt_in.i_visible_height)
+        return picture_Hold(pic);
+
+    if (!*handler)
+    {
+        *handler = image_HandlerCreate(parent);
+        if (!*handler)
+            return NULL;
+    }
+
+    video_format_t fmt_out = fmt_in;
+    fmt_out.i_width = fmt_out.i_visible_width = width;
+    fmt_out.i_height = fmt_out.i_visible_height = height;
+    fmt_out.i_x_offset = fmt_out.i_y_offset = 0;
+    fmt_out.i_sar_num = fmt_out.i_sar_den = 1;
+
+    image_handler_t *image = *handler;
+    return image_Convert(image, pic, &fmt_in, &fmt_out);
+}
+
+static input_thread_t *
+BatchStart(task_t *task, vlc_tick_t time)
+{
+    input_thread_t *input =
+        input_CreateThumbnailer(task->thumbnailer->parent,
+                                on_thumbnailer_input_event, task, task->item);
+    if (!input)
+        return NULL;
+
+    vlc_mutex_lock(&task->lock);
+    task->batch->input = input;
+    vlc_mutex_unlock(&task->lock);
+
+    input_SetTime(input, time, task->fast_seek);
+    if (input_Start(input) != VLC_SUCCESS)
+    {
+        input_Close(input);
+        return NULL;
+    }
+    return input;
+}
+
+/* Returns the input to stop and close, if any */
+static input_thread_t *
+BatchRun(task_t *task, input_thread_t *input)
+{
+    struct thumbnailer_batch *batch = task->batch;
+    image_handler_t *handler = NULL;
+    size_t notified = 0;
+
+    vlc_mutex_lock(&task->lock);
+    while (notified < batch->count)
+    {
+        if (task->canceled)
+            break;
+
+        if (notified == batch->current && !task->ended)
+        {
+            /* Wait for the next thumbnail */
+            if (task->timeout == VLC_TICK_INVALID)
+                vlc_cond_wait(&task->cond_ended, &task->lock);
+            else
+            {
+                vlc_tick_t deadline = vlc_tick_now() + task->timeout;
+                bool timeout = false;
+                while (notified == batch->current && !task->ended && !timeout)
+                    timeout = vlc_cond_timedwait(&task->cond_ended,
+                                                 &task->lock, deadline);
+                if (timeout && notified == batch->current && !task->ended)
+                {
+                    /* Give up this thumbnail, and move to the next one from a
+                     * new input: the current one may still output the
+                     * thumbnail given up */
+                    batch->input = NULL;
+                    if (++batch->current == batch->count)
+                    {
+                        task->ended = true;
+                        continue;
+                    }
+                    vlc_tick_t time = batch->entries[batch->current].time;
+                    vlc_mutex_unlock(&task->lock);
+
+                    input_Stop(input);
+                    input_Close(input);
+                    input = BatchStart(task, time);
+
+                    vlc_mutex_lock(&task->lock);
+                    if (!input)
+                        task->ended = true;
+                }
+            }
+            continue;
+        }
+
+        /* Notify the available thumbnails (and all the remaining ones on end
+         * of stream), without blocking the input */
+        size_t available = task->ended ? batch->count : batch->current;
+        vlc_mutex_unlock(&task->lock);
+
+        for (; notified < available; ++notified)
+        {
+            struct batch_entry *entry = &batch->entries[notified];
+            picture_t *pic = NULL;
+            if (entry->pic)
+            {
+                pic = ScaleThumbnail(&handler, task->thumbnailer->parent,
+                                     batch, entry->pic);
+                picture_Release(entry->pic);
+                entry->pic = NULL;
+            }
+            NotifyBatchThumbnail(task, entry, pic);
+            if (pic)
+                picture_Release(pic);
+        }
+
+        vlc_mutex_lock(&task->lock);
+    }
+    vlc_mutex_unlock(&task->lock);
+
+    if (handler)
+        image_HandlerDelete(handler);
+    return input;
+}
+
 static void
 RunnableRun(void *userdata)
 {
     task_t *task = userdata;
     vlc_thumbnailer_t *thumbnailer = task->thumbnailer;
 
+    if (task->batch)
+    {
+        input_thread_t *input = BatchStart(task, task->batch->entries[0].time);
+        if (!input)
+            goto error;
+
+        input = BatchRun(task, input);
+        if (input)
+        {
+            input_Stop(input);
+            input_Close(input);
+        }
+        goto end;
+    }
+
     vlc_tick_t now = vlc_tick_now();
 
     input_thread_t* input =
         input_CreateThumbnailer(thumbnailer->parent, on_thumbnailer_input_event,
                                 task, task->item);
     if (!input)
-        goto end;
+        goto error;
 
     if (task->seek_target.type == VLC_THUMBNAILER_SEEK_TIME)
         input_SetTime(input, task->seek_target.time, task->fast_seek);
@@ -198,7 +465,7 @@ RunnableRun(void *userdata)
     if (ret != VLC_SUCCESS)
     {
         input_Close(input);
-        goto end;
+        goto error;
     }
 
     vlc_mutex_lock(&task->lock);
@@ -219,7 +486,13 @@ RunnableRun(void *userdata)
 
     input_Stop(input);
     input_Close(input);
+    goto end;
 
+error:
+    /* The single thumbnail request callback is not called on error, for
+     * compatibility, but each thumbnail of a batch must be notified */
+    if (task->batch)
+        NotifyFailure(task);
 end:
     ThumbnailerRemoveTask(thumbnailer, task);
     TaskDelete(task);
@@ -231,6 +504,7 @@ Interrupt(task_t *task)
     /* Wake up RunnableRun() which will call input_Stop() */
     vlc_mutex_lock(&task->lock);
     task->ended = true;
+    task->canceled = true;
     vlc_mutex_unlock(&task->lock);
     vlc_cond_signal(&task->cond_ended);
 }
@@ -286,6 +560,72 @@ vlc_thumbnailer_RequestByPos( vlc_thumbnailer_t *thumbnailer,
                          userdata);
 }
 
+static int
+CompareBatchEntries(const void *a, const void *b, void *userdata)
+{
+    const struct batch_entry *ea = a;
+    const struct batch_entry *eb = b;
+    VLC_UNUSED(userdata);
+
+    if (ea->time != eb->time)
+        return ea->time < eb->time ? -1 : 1;
+    /* keep the user order for equal times */
+    return ea->index < eb->index ? -1 : 1;
+}
+
+task_t *
+vlc_thumbnailer_RequestBatch( vlc_thumbnailer_t *thumbnailer,
+                              const vlc_tick_t *times, size_t count,
+                              enum vlc_thumbnailer_seek_speed speed,
+                              unsigned width, unsigned height,
+                              input_item_t *item, vlc_tick_t timeout,
+                              vlc_thumbnailer_batch_cb cb, void* userdata )
+{
+    assert(count > 0);
+
+    struct thumbnailer_batch *batch;
+    if (count > (SIZE_MAX - sizeof(*batch)) / sizeof(*batch->entries))
+        return NULL;
+    batch = malloc(sizeof(*batch) + count * sizeof(*batch->entries));
+    if (!batch)
+        return NULL;
+
+    batch->cb = cb;
+    batch->width = width;
+    batch->height = height;
+    batch->current = 0;
+    batch->input = NULL;
+    batch->count = count;
+    for (size_t i = 0; i < count; ++i)
+    {
+        batch->entries[i].time = times[i];
+        batch->entries[i].index = i;
+        batch->entries[i].pic = NULL;
+    }
+    vlc_qsort(batch->entries, count, sizeof(*batch->entries),
+              CompareBatchEntries, NULL);
+
+    struct seek_target seek_target = {
+        .type = VLC_THUMBNAILER_SEEK_TIME,
+        .time = batch->entries[0].time,
+    };
+    bool fast_seek = speed == VLC_THUMBNAILER_SEEK_FAST;
+    task_t *task = TaskNew(thumbnailer, item, seek_target, fast_seek, NULL,
+                           userdata, timeout);
+    if (!task)
+    {
+        free(batch);
+        return NULL;
+    }
+    task->batch = batch;
+
+    ThumbnailerAddTask(thumbnailer, task);
+
+    vlc_executor_Submit(thumbnailer->executor, &task->runnable);
+
+    return task;
+}
+
 void vlc_thumbnailer_Cancel( vlc_thumbnailer_t* thumbnailer, task_t* task )
 {
     (void) thumbnailer;
@@ -325,7 +665,7 @@ CancelAllTasks(vlc_thumbnailer_t *thumbnailer)
                                             &task->runnable);
         if (canceled)
         {
-            NotifyThumbnail(task, NULL);
+            NotifyFailure(task);
             vlc_list_remove(&task->node);
             TaskDelete(task);
         }
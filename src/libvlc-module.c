@@ -98,6 +98,12 @@ static const char *const ppsz_snap_formats[] =
     "This enables colorization of the messages sent to the console. " \
     "Your terminal needs Linux color support for this to work.")
 
+#define LOG_ASYNC_TEXT N_("Asynchronous logging")
+#define LOG_ASYNC_LONGTEXT N_( \
+    "Write log messages from a dedicated thread, so that logging does not " \
+    "slow down the playback threads. Messages may be dropped if they are " \
+    "emitted faster than they can be written.")
+
 #define INTERACTION_TEXT N_("Interface interaction")
 #define INTERACTION_LONGTEXT N_( \
     "When this is enabled, the interface will show a dialog box each time " \
@@ -717,6 +723,12 @@ static const char *const ppsz_prefres[] = {
     "This is the maximum size in bytes of the temporary files " \
     "that will be used to store the timeshifted streams." )
 
+#define INPUT_FIFO_LIMIT_TEXT N_("Decoder input limit (KiB)")
+#define INPUT_FIFO_LIMIT_LONGTEXT N_( \
+    "Maximum amount of demuxed data waiting to be decoded, for each " \
+    "elementary stream. Once it is reached, live inputs are slowed down " \
+    "instead of buffering more data. 0 means no limit." )
+
 #define INPUT_TITLE_FORMAT_TEXT N_( "Change title according to current media" )
 #define INPUT_TITLE_FORMAT_LONGTEXT N_( "This option allows you to set the title according to what's being played<br>"  \
     "$a: Artist<br>$b: Album<br>$c: Copyright<br>$t: Title<br>$g: Genre<br>"  \
@@ -1158,6 +1170,17 @@ static const char *const clock_sources_text[] = {
 #define PREPARSE_THREADS_LONGTEXT N_( \
     "Maximum number of threads used to preparse items" )
 
+#define PREPARSE_CACHE_TEXT N_( "Preparsing cache" )
+#define PREPARSE_CACHE_LONGTEXT N_( \
+    "Remember the meta data and duration of local files preparsed in " \
+    "batches (e.g. when adding many items to the playlist), so that they " \
+    "are not read again until they are modified." )
+
+#define PREPARSE_CACHE_SIZE_TEXT N_( "Preparsing cache size" )
+#define PREPARSE_CACHE_SIZE_LONGTEXT N_( \
+    "Maximum number of items remembered by the preparsing cache. The least " \
+    "recently used ones are forgotten first." )
+
 #define FETCH_ART_THREADS_TEXT N_( "Fetch-art threads" )
 #define FETCH_ART_THREADS_LONGTEXT N_( \
     "Maximum number of threads used to fetch art" )
@@ -1991,6 +2014,11 @@ vlc_module_begin ()
     add_integer( "input-timeshift-granularity", -1, INPUT_TIMESHIFT_GRANULARITY_TEXT,
                  INPUT_TIMESHIFT_GRANULARITY_LONGTEXT, true )
 
+    add_integer( "input-fifo-limit", 0, INPUT_FIFO_LIMIT_TEXT,
+                 INPUT_FIFO_LIMIT_LONGTEXT, true )
+        change_integer_range( 0, INT_MAX )
+        change_safe()
+
     add_string( "input-title-format", "$Z", INPUT_TITLE_FORMAT_TEXT, INPUT_TITLE_FORMAT_LONGTEXT, false );
 
 /* Decoder options */
@@ -2176,6 +2204,12 @@ vlc_module_begin ()
     add_integer( "preparse-threads", 1, PREPARSE_THREADS_TEXT,
                  PREPARSE_THREADS_LONGTEXT, false )
 
+    add_bool( "preparse-cache", false, PREPARSE_CACHE_TEXT,
+              PREPARSE_CACHE_LONGTEXT, true )
+    add_integer_with_range( "preparse-cache-size", 10000, 1, INT_MAX,
+                            PREPARSE_CACHE_SIZE_TEXT,
+                            PREPARSE_CACHE_SIZE_LONGTEXT, true )
+
     add_integer( "fetch-art-threads", 1, FETCH_ART_THREADS_TEXT,
                  FETCH_ART_THREADS_LONGTEXT, false )
 
@@ -2220,6 +2254,7 @@ vlc_module_begin ()
 
     add_bool( "color", true, COLOR_TEXT, COLOR_LONGTEXT, true )
         change_volatile ()
+    add_bool( "log-async", false, LOG_ASYNC_TEXT, LOG_ASYNC_LONGTEXT, true )
     add_obsolete_bool( "advanced" ) /* since 4.0.0 */
     add_bool( "interact", true, INTERACTION_TEXT,
               INTERACTION_LONGTEXT, false )
@@ -95,6 +95,7 @@ libvlc_int_t * libvlc_InternalCreate( void )
     priv->main_playlist = NULL;
     priv->p_vlm = NULL;
     priv->media_source_provider = NULL;
+    priv->cleanups = NULL;
 
     vlc_ExitInit( &priv->exit );
 
@@ -329,6 +330,30 @@ error:
     return i_ret;
 }
 
+struct libvlc_cleanup
+{
+    struct libvlc_cleanup *next;
+    void (*cb)(void *);
+    void *opaque;
+};
+
+int libvlc_AddCleanup(libvlc_int_t *libvlc, void (*cb)(void *), void *opaque)
+{
+    libvlc_priv_t *priv = libvlc_priv(libvlc);
+    struct libvlc_cleanup *c = malloc(sizeof (*c));
+
+    if (unlikely(c == NULL))
+        return VLC_ENOMEM;
+
+    c->cb = cb;
+    c->opaque = opaque;
+    vlc_mutex_lock(&priv->lock);
+    c->next = priv->cleanups;
+    priv->cleanups = c;
+    vlc_mutex_unlock(&priv->lock);
+    return VLC_SUCCESS;
+}
+
 /**
  * Cleanup a libvlc instance. The instance is not completely deallocated
  * \param p_libvlc the instance to clean
@@ -384,6 +409,15 @@ void libvlc_InternalCleanup( libvlc_int_t *p_libvlc )
 
     libvlc_InternalActionsClean( p_libvlc );
 
+    /* Clean-up callbacks registered by the plug-ins */
+    for (struct libvlc_cleanup *c = priv->cleanups, *next; c != NULL; c = next)
+    {
+        next = c->next;
+        c->cb(c->opaque);
+        free(c);
+    }
+    priv->cleanups = NULL;
+
     /* Save the configuration */
     if( !var_InheritBool( p_libvlc, "ignore-config" ) )
         config_AutoSaveConfigFile( VLC_OBJECT(p_libvlc) );
@@ -462,6 +496,22 @@ int vlc_MetadataRequest(libvlc_int_t *libvlc, input_item_t *item,
                                  cbs_userdata, timeout, id );
 }
 
+int vlc_MetadataRequestBatch(libvlc_int_t *libvlc, input_item_t **items,
+                             size_t count,
+                             input_item_meta_request_option_t i_options,
+                             const input_preparser_callbacks_t *cbs,
+                             void *cbs_userdata,
+                             int timeout, void *id)
+{
+    libvlc_priv_t *priv = libvlc_priv(libvlc);
+
+    if (unlikely(priv->parser == NULL))
+        return VLC_ENOMEM;
+
+    return input_preparser_PushBatch( priv->parser, items, count, i_options,
+                                      cbs, cbs_userdata, timeout, id );
+}
+
 /**
  * Requests extraction of the meta data for an input item (a.k.a. preparsing).
  * The actual extraction is asynchronous. It can be cancelled with
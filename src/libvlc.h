@@ -194,6 +194,8 @@ typedef struct libvlc_priv_t
 
     /* Exit callback */
     vlc_exit_t       exit;
+
+    struct libvlc_cleanup *cleanups; ///< Clean-up callbacks (LIFO)
 } libvlc_priv_t;
 
 static inline libvlc_priv_t *libvlc_priv (libvlc_int_t *libvlc)
@@ -211,6 +213,13 @@ int vlc_MetadataRequest(libvlc_int_t *libvlc, input_item_t *item,
                         void *cbs_userdata,
                         int timeout, void *id);
 
+int vlc_MetadataRequestBatch(libvlc_int_t *libvlc, input_item_t **items,
+                             size_t count,
+                             input_item_meta_request_option_t i_options,
+                             const input_preparser_callbacks_t *cbs,
+                             void *cbs_userdata,
+                             int timeout, void *id);
+
 /*
  * Variables stuff
  */
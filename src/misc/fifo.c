@@ -40,6 +40,7 @@ struct block_fifo_t
     vlc_queue_t         q;
     size_t              i_depth;
     size_t              i_size;
+    int                 i_tag; /* enum vlc_memusage_tag, or -1 */
 };
 
 static_assert (offsetof (block_fifo_t, q) == 0, "Problems in <vlc_block.h>");
@@ -56,12 +57,23 @@ size_t vlc_fifo_GetBytes(const vlc_fifo_t *fifo)
     return fifo->i_size;
 }
 
+void vlc_fifo_SetMemUsage(block_fifo_t *fifo, enum vlc_memusage_tag tag)
+{
+    assert(fifo->i_size == 0);
+    fifo->i_tag = tag;
+}
+
 void vlc_fifo_QueueUnlocked(block_fifo_t *fifo, block_t *block)
 {
+    size_t size = 0;
+
     for (block_t *b = block; b != NULL; b = b->p_next) {
         fifo->i_depth++;
-        fifo->i_size += b->i_buffer;
+        size += b->i_buffer;
     }
+    fifo->i_size += size;
+    if (fifo->i_tag >= 0)
+        vlc_memusage_Add(fifo->i_tag, size);
 
     vlc_queue_EnqueueUnlocked(&fifo->q, block);
 }
@@ -75,6 +87,8 @@ block_t *vlc_fifo_DequeueUnlocked(block_fifo_t *fifo)
         assert(fifo->i_size >= block->i_buffer);
         fifo->i_depth--;
         fifo->i_size -= block->i_buffer;
+        if (fifo->i_tag >= 0)
+            vlc_memusage_Sub(fifo->i_tag, block->i_buffer);
     }
 
     return block;
@@ -82,6 +96,8 @@ block_t *vlc_fifo_DequeueUnlocked(block_fifo_t *fifo)
 
 block_t *vlc_fifo_DequeueAllUnlocked(block_fifo_t *fifo)
 {
+    if (fifo->i_tag >= 0)
+        vlc_memusage_Sub(fifo->i_tag, fifo->i_size);
     fifo->i_depth = 0;
     fifo->i_size = 0;
     return vlc_queue_DequeueAllUnlocked(&fifo->q);
@@ -95,6 +111,7 @@ block_fifo_t *block_FifoNew( void )
         vlc_queue_Init(&p_fifo->q, offsetof (block_t, p_next));
         p_fifo->i_depth = 0;
         p_fifo->i_size = 0;
+        p_fifo->i_tag = -1;
     }
 
     return p_fifo;
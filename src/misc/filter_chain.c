@@ -29,6 +29,7 @@
 #include <vlc_modules.h>
 #include <vlc_mouse.h>
 #include <vlc_spu.h>
+#include <vlc_picture_pool.h>
 #include <libvlc.h>
 #include <assert.h>
 
@@ -40,8 +41,16 @@ typedef struct chained_filter_t
     struct chained_filter_t *prev, *next;
     vlc_mouse_t mouse;
     vlc_picture_chain_t pending;
+    /* Recycled output pictures, matching pool_fmt */
+    picture_pool_t *pool;
+    video_format_t pool_fmt;
 } chained_filter_t;
 
+/* Output pictures may still be referenced by the following filters (e.g.
+ * deinterlacers keep past pictures) and by the owner of the chain */
+#define FILTER_POOL_MARGIN 3
+#define FILTER_POOL_MAX    32
+
 /* */
 struct filter_chain_t
 {
@@ -95,13 +104,86 @@ filter_chain_t *filter_chain_NewSPU( vlc_object_t *obj, const char *cap )
     return filter_chain_NewInner( obj, cap, NULL, false, SPU_ES );
 }
 
+static bool filter_chain_PoolFormatMatches( const video_format_t *a,
+                                             const video_format_t *b )
+{
+    return video_format_IsSimilar( a, b ) &&
+           a->primaries == b->primaries && a->transfer == b->transfer &&
+           a->space == b->space && a->color_range == b->color_range &&
+           a->chroma_location == b->chroma_location;
+}
+
+static void filter_chain_PoolRelease( chained_filter_t *chained )
+{
+    if( chained->pool != NULL )
+    {
+        /* Pictures still in use remain valid until they are released */
+        picture_pool_Release( chained->pool );
+        chained->pool = NULL;
+        video_format_Clean( &chained->pool_fmt );
+    }
+}
+
+/**
+ * Gets an output picture from the pool of the filter. The pool is created
+ * from the depth of the chain after the filter, recreated whenever the
+ * output format changes and grown when all its pictures are in use.
+ */
+static picture_t *filter_chain_PoolGet( chained_filter_t *chained )
+{
+    filter_t *filter = &chained->filter;
+    const video_format_t *fmt = &filter->fmt_out.video;
+    unsigned count = 0;
+
+    /* Opaque pictures are allocated by the video context */
+    if( filter->vctx_out != NULL || fmt->i_chroma == 0 )
+        return NULL;
+
+    if( chained->pool != NULL )
+    {
+        if( filter_chain_PoolFormatMatches( &chained->pool_fmt, fmt ) )
+        {
+            picture_t *pic = picture_pool_Get( chained->pool );
+            if( pic != NULL )
+                return pic;
+
+            count = 2 * picture_pool_GetSize( chained->pool );
+            if( count > FILTER_POOL_MAX )
+                return NULL;
+        }
+        filter_chain_PoolRelease( chained );
+    }
+
+    if( count == 0 )
+    {
+        count = FILTER_POOL_MARGIN;
+        for( const chained_filter_t *f = chained->next; f != NULL; f = f->next )
+            count++;
+    }
+
+    chained->pool = picture_pool_NewFromFormat( fmt, __MIN(count, FILTER_POOL_MAX) );
+    if( chained->pool == NULL )
+        return NULL;
+    video_format_Copy( &chained->pool_fmt, fmt );
+
+    return picture_pool_Get( chained->pool );
+}
+
 /** Chained filter picture allocator function */
 static picture_t *filter_chain_VideoBufferNew( filter_t *filter )
 {
     picture_t *pic;
     chained_filter_t *chained = container_of(filter, chained_filter_t, filter);
-    if( chained->next != NULL )
+    filter_chain_t *chain = filter->owner.sys;
+
+    if( chained->next != NULL ||
+        chain->parent_video_owner.video == NULL ||
+        chain->parent_video_owner.video->buffer_new == NULL )
     {
+        pic = filter_chain_PoolGet( chained );
+        if( pic != NULL )
+            return pic;
+
         // HACK as intermediate filters may not have the same video format as
         // the last one handled by the owner
         filter_owner_t saved_owner = filter->owner;
@@ -113,8 +195,6 @@ static picture_t *filter_chain_VideoBufferNew( filter_t *filter )
     }
     else
     {
-        filter_chain_t *chain = filter->owner.sys;
-
         // the owner of the chain requires pictures from the last filter to be grabbed from its callback
         /* XXX ugly */
         filter_owner_t saved_owner = filter->owner;
@@ -153,8 +233,8 @@ filter_chain_t *filter_chain_NewVideo( vlc_object_t *obj, bool allow_change,
 
     if( owner != NULL && owner->video != NULL )
     {
-        // keep this to get pictures for the last filter in the chain
-        assert( owner->video->buffer_new != NULL );
+        // keep this to get pictures for the last filter in the chain,
+        // otherwise they come from the pool of the last filter
         chain->parent_video_owner = *owner;
     }
     else
@@ -213,6 +293,8 @@ static filter_t *filter_chain_AppendInner( filter_chain_t *chain,
         return NULL;
 
     filter_t *filter = &chained->filter;
+    chained->pool = NULL;
+    video_format_Init( &chained->pool_fmt, 0 );
 
     const es_format_t *fmt_in;
     vlc_video_context *vctx_in;
@@ -333,6 +415,7 @@ void filter_chain_DeleteFilter( filter_chain_t *chain, filter_t *filter )
 
     msg_Dbg( chain->obj, "Filter %p removed from chain", (void *)filter );
     FilterDeletePictures( &chained->pending );
+    filter_chain_PoolRelease( chained );
 
     es_format_Clean( &filter->fmt_out );
     es_format_Clean( &filter->fmt_in );
@@ -0,0 +1,72 @@
+/*****************************************************************************
+ * memusage.c: memory usage accounting
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <assert.h>
+#include <stdatomic.h>
+
+#include <vlc_common.h>
+#include <vlc_memusage.h>
+
+/* Process-wide, as the buffers of all the instances share the same memory */
+static struct
+{
+    atomic_size_t current;
+    atomic_size_t peak;
+} usage[VLC_MEMUSAGE_MAX];
+
+void vlc_memusage_Add(enum vlc_memusage_tag tag, size_t size)
+{
+    assert((unsigned)tag < VLC_MEMUSAGE_MAX);
+
+    size_t current = atomic_fetch_add_explicit(&usage[tag].current, size,
+                                               memory_order_relaxed) + size;
+    size_t peak = atomic_load_explicit(&usage[tag].peak,
+                                       memory_order_relaxed);
+
+    while (current > peak
+        && !atomic_compare_exchange_weak_explicit(&usage[tag].peak, &peak,
+                                                  current,
+                                                  memory_order_relaxed,
+                                                  memory_order_relaxed));
+}
+
+void vlc_memusage_Sub(enum vlc_memusage_tag tag, size_t size)
+{
+    assert((unsigned)tag < VLC_MEMUSAGE_MAX);
+
+    size_t old = atomic_fetch_sub_explicit(&usage[tag].current, size,
+                                           memory_order_relaxed);
+    assert(old >= size);
+    (void) old;
+}
+
+void vlc_memusage_Get(enum vlc_memusage_tag tag, size_t *current,
+                      size_t *peak)
+{
+    assert((unsigned)tag < VLC_MEMUSAGE_MAX);
+
+    *current = atomic_load_explicit(&usage[tag].current,
+                                    memory_order_relaxed);
+    *peak = atomic_load_explicit(&usage[tag].peak, memory_order_relaxed);
+}
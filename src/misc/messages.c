@@ -35,6 +35,7 @@
 #include <stdarg.h>                                       /* va_list for BSD */
 #include <unistd.h>
 #include <assert.h>
+#include <stdatomic.h>
 
 #include <vlc_common.h>
 #include <vlc_interface.h>
@@ -263,6 +264,7 @@ static void vlc_LogEarlyClose(void *d)
 static const struct vlc_logger_operations early_ops = {
     vlc_vaLogEarly,
     vlc_LogEarlyClose,
+    NULL,
 };
 
 static struct vlc_logger *vlc_LogEarlyOpen(struct vlc_logger *logger)
@@ -293,6 +295,7 @@ static void vlc_LogDiscardClose(void *d)
 static const struct vlc_logger_operations discard_ops = {
     vlc_vaLogDiscard,
     vlc_LogDiscardClose,
+    NULL,
 };
 
 static struct vlc_logger discard_log = { &discard_ops };
@@ -338,6 +341,7 @@ static void vlc_LogSwitchClose(void *d)
 static const struct vlc_logger_operations switch_ops = {
     vlc_vaLogSwitch,
     vlc_LogSwitchClose,
+    NULL,
 };
 
 static void vlc_LogSwitch(vlc_logger_t *logger, vlc_logger_t *new_logger)
@@ -414,9 +418,20 @@ static void vlc_LogModuleClose(void *d)
     vlc_object_delete(VLC_OBJECT(module));
 }
 
+static void vlc_LogModuleFlush(void *d)
+{
+    struct vlc_logger *logger = d;
+    struct vlc_logger_module *module =
+        container_of(logger, struct vlc_logger_module, frontend);
+
+    if (module->ops->flush != NULL)
+        module->ops->flush(module->opaque);
+}
+
 static const struct vlc_logger_operations module_ops = {
     vlc_vaLogModule,
     vlc_LogModuleClose,
+    vlc_LogModuleFlush,
 };
 
 static struct vlc_logger *vlc_LogModuleCreate(vlc_object_t *parent)
@@ -438,6 +453,262 @@ static struct vlc_logger *vlc_LogModuleCreate(vlc_object_t *parent)
     return &module->frontend;
 }
 
+/**
+ * Asynchronous message log.
+ *
+ * The emitting thread only formats the message into a slot of a bounded
+ * lock-free ring. A dedicated low-priority thread writes the messages to the
+ * backend log, so that logger I/O never blocks the emitting threads.
+ *
+ * There is one ring per group of threads (selected from the thread ID) to
+ * reduce contention between producers. The writer thread merges the rings
+ * back in emission order. When a ring is full, the message is dropped and
+ * accounted for; the number of dropped messages is reported later on.
+ */
+#define LOG_ASYNC_RINGS 8
+#define LOG_ASYNC_SLOTS 256 /* per ring, must be a power of two */
+
+struct vlc_log_record {
+    atomic_size_t seq; /**< slot sequence number */
+    uint64_t order; /**< emission order across all rings */
+    int type;
+    vlc_log_t meta;
+    char *longmsg; /**< heap-allocated text if it does not fit in msg */
+    char module[32];
+    char header[64];
+    char msg[256];
+};
+
+struct vlc_log_ring {
+    atomic_size_t tail; /**< next slot to write (producers) */
+    size_t head; /**< next slot to read (writer thread) */
+    atomic_ulong dropped; /**< messages dropped since last report */
+    struct vlc_log_record slots[LOG_ASYNC_SLOTS];
+};
+
+struct vlc_logger_async {
+    struct vlc_logger frontend;
+    struct vlc_logger *backend;
+    vlc_thread_t thread;
+    atomic_uint sleeping;
+    atomic_bool stop;
+    atomic_uint_fast64_t order;
+    struct vlc_log_ring rings[LOG_ASYNC_RINGS];
+};
+
+static void vlc_vaLogAsync(void *d, int type, const vlc_log_t *item,
+                           const char *format, va_list ap)
+{
+    struct vlc_logger *logger = d;
+    struct vlc_logger_async *async =
+        container_of(logger, struct vlc_logger_async, frontend);
+    struct vlc_log_ring *ring = &async->rings[item->tid % LOG_ASYNC_RINGS];
+    struct vlc_log_record *rec;
+    size_t pos = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+
+    /* Reserve a slot */
+    for (;;) {
+        rec = &ring->slots[pos % LOG_ASYNC_SLOTS];
+
+        size_t seq = atomic_load_explicit(&rec->seq, memory_order_acquire);
+        if (seq == pos) {
+            if (atomic_compare_exchange_weak_explicit(&ring->tail, &pos,
+                                                      pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed))
+                break;
+        } else if ((ssize_t)(seq - pos) < 0) {
+            /* Ring full: drop the message */
+            atomic_fetch_add_explicit(&ring->dropped, 1,
+                                      memory_order_relaxed);
+            return;
+        } else
+            pos = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    }
+
+    rec->order = atomic_fetch_add_explicit(&async->order, 1,
+                                           memory_order_relaxed);
+    rec->type = type;
+    rec->meta = *item;
+    /* NOTE: The module name and header may not outlive the call. */
+    strlcpy(rec->module, item->psz_module, sizeof (rec->module));
+    rec->meta.psz_module = rec->module;
+    if (item->psz_header != NULL) {
+        strlcpy(rec->header, item->psz_header, sizeof (rec->header));
+        rec->meta.psz_header = rec->header;
+    }
+
+    va_list aq;
+    va_copy(aq, ap);
+    int len = vsnprintf(rec->msg, sizeof (rec->msg), format, aq);
+    va_end(aq);
+
+    rec->longmsg = NULL;
+    if (unlikely(len >= (int)sizeof (rec->msg))
+     && vasprintf(&rec->longmsg, format, ap) == -1)
+        rec->longmsg = NULL; /* keep the truncated message */
+
+    atomic_store_explicit(&rec->seq, pos + 1, memory_order_release);
+
+    /* Wake the writer thread up, only if it is sleeping */
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&async->sleeping, memory_order_relaxed)
+     && atomic_exchange(&async->sleeping, 0))
+        vlc_atomic_notify_one(&async->sleeping);
+}
+
+static struct vlc_log_record *vlc_LogAsyncPeek(struct vlc_log_ring *ring)
+{
+    struct vlc_log_record *rec = &ring->slots[ring->head % LOG_ASYNC_SLOTS];
+    size_t seq = atomic_load_explicit(&rec->seq, memory_order_acquire);
+
+    return (seq == ring->head + 1) ? rec : NULL;
+}
+
+static bool vlc_LogAsyncDrain(struct vlc_logger_async *async)
+{
+    struct vlc_logger *backend = async->backend;
+    bool written = false;
+
+    for (;;) {
+        /* Pick the oldest pending message from all rings */
+        struct vlc_log_ring *ring = NULL;
+        struct vlc_log_record *rec = NULL;
+
+        for (size_t i = 0; i < LOG_ASYNC_RINGS; i++) {
+            struct vlc_log_record *r = vlc_LogAsyncPeek(&async->rings[i]);
+
+            if (r != NULL && (rec == NULL || r->order < rec->order)) {
+                ring = &async->rings[i];
+                rec = r;
+            }
+        }
+
+        if (rec == NULL)
+            break;
+
+        vlc_LogCallback(backend, rec->type, &rec->meta, "%s",
+                        (rec->longmsg != NULL) ? rec->longmsg : rec->msg);
+        free(rec->longmsg);
+
+        /* Release the slot to the producers */
+        atomic_store_explicit(&rec->seq, ring->head + LOG_ASYNC_SLOTS,
+                              memory_order_release);
+        ring->head++;
+        written = true;
+    }
+
+    unsigned long dropped = 0;
+
+    for (size_t i = 0; i < LOG_ASYNC_RINGS; i++)
+        dropped += atomic_exchange_explicit(&async->rings[i].dropped, 0,
+                                            memory_order_relaxed);
+
+    if (dropped > 0) {
+        vlc_log_t meta = {
+            .i_object_id = (uintptr_t)(void *)async,
+            .psz_object_type = "logger",
+            .psz_module = "core",
+            .file = __FILE__,
+            .line = __LINE__,
+            .func = __func__,
+            .tid = vlc_thread_id(),
+        };
+
+        vlc_LogCallback(backend, VLC_MSG_WARN, &meta,
+                        "%lu message(s) dropped (log queue full)", dropped);
+        written = true;
+    }
+
+    if (written && backend->ops->flush != NULL)
+        backend->ops->flush(backend);
+    return written;
+}
+
+static bool vlc_LogAsyncPending(struct vlc_logger_async *async)
+{
+    for (size_t i = 0; i < LOG_ASYNC_RINGS; i++)
+        if (vlc_LogAsyncPeek(&async->rings[i]) != NULL
+         || atomic_load_explicit(&async->rings[i].dropped,
+                                 memory_order_relaxed) > 0)
+            return true;
+    return false;
+}
+
+static void *vlc_LogAsyncThread(void *data)
+{
+    struct vlc_logger_async *async = data;
+
+    for (;;) {
+        bool stop = atomic_load(&async->stop);
+
+        if (vlc_LogAsyncDrain(async))
+            continue;
+        if (stop)
+            break;
+
+        atomic_store(&async->sleeping, 1);
+        atomic_thread_fence(memory_order_seq_cst);
+        if (!vlc_LogAsyncPending(async) && !atomic_load(&async->stop))
+            vlc_atomic_wait(&async->sleeping, 1);
+        atomic_store(&async->sleeping, 0);
+    }
+    return NULL;
+}
+
+static void vlc_LogAsyncClose(void *d)
+{
+    struct vlc_logger *logger = d;
+    struct vlc_logger_async *async =
+        container_of(logger, struct vlc_logger_async, frontend);
+    struct vlc_logger *backend = async->backend;
+
+    /* The writer thread drains all pending messages before exiting */
+    atomic_store(&async->stop, true);
+    atomic_store(&async->sleeping, 0);
+    vlc_atomic_notify_one(&async->sleeping);
+    vlc_join(async->thread, NULL);
+
+    backend->ops->destroy(backend);
+    free(async);
+}
+
+static const struct vlc_logger_operations async_ops = {
+    vlc_vaLogAsync,
+    vlc_LogAsyncClose,
+    NULL,
+};
+
+static struct vlc_logger *vlc_LogAsyncCreate(struct vlc_logger *backend)
+{
+    struct vlc_logger_async *async = malloc(sizeof (*async));
+    if (unlikely(async == NULL))
+        return NULL;
+
+    async->frontend.ops = &async_ops;
+    async->backend = backend;
+    atomic_init(&async->sleeping, 0);
+    atomic_init(&async->stop, false);
+    atomic_init(&async->order, 0);
+
+    for (size_t i = 0; i < LOG_ASYNC_RINGS; i++) {
+        struct vlc_log_ring *ring = &async->rings[i];
+
+        atomic_init(&ring->tail, 0);
+        ring->head = 0;
+        atomic_init(&ring->dropped, 0);
+        for (size_t j = 0; j < LOG_ASYNC_SLOTS; j++)
+            atomic_init(&ring->slots[j].seq, j);
+    }
+
+    if (vlc_clone(&async->thread, vlc_LogAsyncThread, async,
+                  VLC_THREAD_PRIORITY_LOW)) {
+        free(async);
+        return NULL;
+    }
+    return &async->frontend;
+}
+
 /**
  * Initializes the messages logging subsystem and drain the early messages to
  * the configured log.
@@ -447,6 +718,11 @@ void vlc_LogInit(libvlc_int_t *vlc)
     struct vlc_logger *logger = vlc_LogModuleCreate(VLC_OBJECT(vlc));
     if (logger == NULL)
         logger = &discard_log;
+    else if (var_InheritBool(vlc, "log-async")) {
+        struct vlc_logger *async = vlc_LogAsyncCreate(logger);
+        if (async != NULL)
+            logger = async;
+    }
 
     vlc_LogSwitch(vlc->obj.logger, logger);
 }
@@ -500,6 +776,7 @@ static void vlc_vaLogHeader(void *d, int type, const vlc_log_t *item,
 static const struct vlc_logger_operations header_ops = {
     vlc_vaLogHeader,
     free,
+    NULL,
 };
 
 struct vlc_logger *vlc_LogHeaderCreate(struct vlc_logger *parent,
@@ -545,6 +822,7 @@ static void vlc_LogExternalClose(void *d)
 static const struct vlc_logger_operations external_ops = {
     vlc_vaLogExternal,
     vlc_LogExternalClose,
+    NULL,
 };
 
 static struct vlc_logger *
@@ -37,6 +37,7 @@
 #include "picture.h"
 #include <vlc_image.h>
 #include <vlc_block.h>
+#include <vlc_memusage.h>
 
 static void PictureDestroyContext( picture_t *p_picture )
 {
@@ -68,7 +69,10 @@ static void picture_DestroyFromFormat(picture_t *pic)
     picture_buffer_t *res = pic->p_sys;
 
     if (res != NULL)
+    {
+        vlc_memusage_Sub(VLC_MEMUSAGE_PICTURE, res->size);
         picture_Deallocate(res->fd, res->base, res->size);
+    }
 }
 
 VLC_WEAK void *picture_Allocate(int *restrict fdp, size_t size)
@@ -306,6 +310,7 @@ picture_t *picture_NewFromFormat(const video_format_t *restrict fmt)
     res->base = buf;
     res->size = pic_size;
     res->offset = 0;
+    vlc_memusage_Add(VLC_MEMUSAGE_PICTURE, pic_size);
 
     /* Fill the p_pixels field for each plane */
     for (int i = 0; i < pic->i_planes; i++)
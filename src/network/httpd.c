@@ -145,6 +145,7 @@ struct httpd_client_t
     struct vlc_list node;
 
     bool    b_stream_mode;
+    bool    b_deferred;
     uint8_t i_state;
 
     vlc_tick_t i_timeout_date;
@@ -1240,6 +1241,7 @@ static httpd_client_t *httpd_ClientNew(vlc_tls_t *sock)
     cl->p_buffer = xmalloc(cl->i_buffer_size);
     cl->i_keyframe_wait_to_pass = -1;
     cl->b_stream_mode = false;
+    cl->b_deferred = false;
 
     httpd_MsgInit(&cl->query);
     httpd_MsgInit(&cl->answer);
@@ -1866,6 +1868,14 @@ static void httpdLoop(httpd_host_t *host)
                             if (url->catch[i_msg].cb(url->catch[i_msg].p_sys, cl, answer, query))
                                 continue;
 
+                            if (answer->i_type == HTTPD_MSG_NONE) {
+                                /* answer deferred, poll the callback again */
+                                cl->b_deferred = true;
+                                cl->url = url;
+                                answer = NULL;
+                                break;
+                            }
+
                             if (answer->i_proto == HTTPD_PROTO_NONE)
                                 cl->i_buffer = cl->i_buffer_size; /* Raw answer from a CGI */
                             else
@@ -1901,7 +1911,8 @@ static void httpdLoop(httpd_host_t *host)
                                 httpd_MsgAdd(answer, "Connection", "close");
                         }
 
-                        cl->i_state = HTTPD_CLIENT_SENDING;
+                        cl->i_state = cl->b_deferred ? HTTPD_CLIENT_WAITING
+                                                     : HTTPD_CLIENT_SENDING;
                     }
                 }
                 break;
@@ -1960,7 +1971,12 @@ static void httpdLoop(httpd_host_t *host)
 
                 cl->url->catch[i_msg].cb(cl->url->catch[i_msg].p_sys, cl,
                         &cl->answer, &cl->query);
-                if (cl->answer.i_type != HTTPD_MSG_NONE) {
+                if (cl->answer.i_type != HTTPD_MSG_NONE && cl->b_deferred) {
+                    /* the deferred answer is ready */
+                    cl->b_deferred = false;
+                    cl->i_buffer = -1;
+                    cl->i_state = HTTPD_CLIENT_SENDING;
+                } else if (cl->answer.i_type != HTTPD_MSG_NONE) {
                     /* we have new data, so re-enter send mode */
                     cl->i_buffer      = 0;
                     cl->p_buffer      = cl->answer.p_body;
@@ -1806,6 +1806,19 @@ vlc_player_GetStatistics(vlc_player_t *player)
     return input ? &input->stats : NULL;
 }
 
+struct vlc_es_latency *
+vlc_player_GetLatencyStats(vlc_player_t *player, size_t *count)
+{
+    struct vlc_player_input *input = vlc_player_get_input_locked(player);
+
+    *count = 0;
+    if (input == NULL)
+        return NULL;
+
+    struct input_stats *stats = input_priv(input->thread)->stats;
+    return stats != NULL ? input_stats_GetLatency(stats, count) : NULL;
+}
+
 void
 vlc_player_SetPauseOnCork(vlc_player_t *player, bool enabled)
 {
@@ -37,6 +37,7 @@ vlc_playlist_ClearItems(vlc_playlist_t *playlist)
     vlc_vector_foreach(item, &playlist->items)
         vlc_playlist_item_Release(item);
     vlc_vector_clear(&playlist->items);
+    playlist_lookup_Clear(&playlist->lookup);
 }
 
 static void
@@ -60,6 +61,10 @@ vlc_playlist_ItemsReset(vlc_playlist_t *playlist)
 static void
 vlc_playlist_ItemsInserted(vlc_playlist_t *playlist, size_t index, size_t count)
 {
+    /* space has been reserved by the caller */
+    playlist_lookup_Add(&playlist->lookup, &playlist->items.data[index], count);
+    playlist_lookup_Invalidate(&playlist->lookup, index);
+
     if (playlist->order == VLC_PLAYLIST_PLAYBACK_ORDER_RANDOM)
         randomizer_Add(&playlist->randomizer,
                        &playlist->items.data[index], count);
@@ -76,17 +81,16 @@ vlc_playlist_ItemsInserted(vlc_playlist_t *playlist, size_t index, size_t count)
     vlc_playlist_Notify(playlist, on_items_added, index, items, count);
     vlc_playlist_state_NotifyChanges(playlist, &state);
 
-    for (size_t i = index; i < index + count; ++i)
-    {
-        vlc_playlist_item_t *item = playlist->items.data[i];
-        vlc_playlist_AutoPreparse(playlist, item->media);
-    }
+    vlc_playlist_AutoPreparseItems(playlist, items, count);
 }
 
 static void
 vlc_playlist_ItemsMoved(vlc_playlist_t *playlist, size_t index, size_t count,
                         size_t target)
 {
+    playlist_lookup_Invalidate(&playlist->lookup, index < target ? index
+                                                                 : target);
+
     struct vlc_playlist_state state;
     vlc_playlist_state_Save(playlist, &state);
 
@@ -127,6 +131,10 @@ vlc_playlist_ItemsRemoving(vlc_playlist_t *playlist, size_t index, size_t count)
     if (playlist->order == VLC_PLAYLIST_PLAYBACK_ORDER_RANDOM)
         randomizer_Remove(&playlist->randomizer,
                           &playlist->items.data[index], count);
+
+    playlist_lookup_Remove(&playlist->lookup, &playlist->items.data[index],
+                           count);
+    playlist_lookup_Invalidate(&playlist->lookup, index);
 }
 
 /* return whether the current media has changed */
@@ -197,9 +205,8 @@ vlc_playlist_IndexOf(vlc_playlist_t *playlist, const vlc_playlist_item_t *item)
 {
     vlc_playlist_AssertLocked(playlist);
 
-    ssize_t index;
-    vlc_vector_index_of(&playlist->items, item, &index);
-    return index;
+    return playlist_lookup_IndexOf(&playlist->lookup, playlist->items.data,
+                                   playlist->items.size, item);
 }
 
 ssize_t
@@ -207,11 +214,9 @@ vlc_playlist_IndexOfMedia(vlc_playlist_t *playlist, const input_item_t *media)
 {
     vlc_playlist_AssertLocked(playlist);
 
-    playlist_item_vector_t *items = &playlist->items;
-    for (size_t i = 0; i < items->size; ++i)
-        if (items->data[i]->media == media)
-            return i;
-    return -1;
+    return playlist_lookup_IndexOfMedia(&playlist->lookup,
+                                        playlist->items.data,
+                                        playlist->items.size, media);
 }
 
 ssize_t
@@ -219,11 +224,12 @@ vlc_playlist_IndexOfId(vlc_playlist_t *playlist, uint64_t id)
 {
     vlc_playlist_AssertLocked(playlist);
 
-    playlist_item_vector_t *items = &playlist->items;
-    for (size_t i = 0; i < items->size; ++i)
-        if (items->data[i]->id == id)
-            return i;
-    return -1;
+    vlc_playlist_item_t *item = playlist_lookup_GetById(&playlist->lookup, id);
+    if (!item)
+        return -1;
+
+    return playlist_lookup_IndexOf(&playlist->lookup, playlist->items.data,
+                                   playlist->items.size, item);
 }
 
 void
@@ -268,6 +274,10 @@ vlc_playlist_Insert(vlc_playlist_t *playlist, size_t index,
     vlc_playlist_AssertLocked(playlist);
     assert(index <= playlist->items.size);
 
+    /* make space in the lookup tables */
+    if (!playlist_lookup_Reserve(&playlist->lookup, count))
+        return VLC_ENOMEM;
+
     /* make space in the vector */
     if (!vlc_vector_insert_hole(&playlist->items, index, count))
         return VLC_ENOMEM;
@@ -323,6 +333,133 @@ vlc_playlist_Remove(vlc_playlist_t *playlist, size_t index, size_t count)
         vlc_player_InvalidateNextMedia(playlist->player);
 }
 
+void
+vlc_playlist_RemoveIndices(vlc_playlist_t *playlist, const size_t indices[],
+                           size_t count)
+{
+    vlc_playlist_AssertLocked(playlist);
+    assert(count > 0);
+
+    playlist_item_vector_t *items = &playlist->items;
+    size_t first = indices[0];
+    assert(first < items->size);
+
+    struct vlc_playlist_state state;
+    vlc_playlist_state_Save(playlist, &state);
+
+    /* compact the vector in a single pass */
+    ssize_t current = playlist->current;
+    bool current_media_changed = false;
+    size_t removed = 0;
+    size_t j = first;
+    size_t k = 0;
+    for (size_t i = first; i < items->size; ++i)
+    {
+        vlc_playlist_item_t *item = items->data[i];
+        if ((ssize_t) i == playlist->current)
+        {
+            /* if removed, select the first item after it */
+            current = j;
+            current_media_changed = k < count && indices[k] == i;
+        }
+
+        if (k < count && indices[k] == i)
+        {
+            /* skip duplicates */
+            do
+                ++k;
+            while (k < count && indices[k] == i);
+
+            if (playlist->order == VLC_PLAYLIST_PLAYBACK_ORDER_RANDOM)
+                randomizer_Remove(&playlist->randomizer, &item, 1);
+            playlist_lookup_Remove(&playlist->lookup, &item, 1);
+            vlc_playlist_item_Release(item);
+            ++removed;
+        }
+        else
+            items->data[j++] = item;
+    }
+    assert(k == count);
+
+    /* the tail now contains stale pointers */
+    vlc_vector_remove_slice(items, j, removed);
+    playlist_lookup_Invalidate(&playlist->lookup, first);
+
+    if (current >= (ssize_t) items->size)
+        /* no more items after the removed current item */
+        current = -1;
+    playlist->current = current;
+    playlist->has_prev = vlc_playlist_ComputeHasPrev(playlist);
+    playlist->has_next = vlc_playlist_ComputeHasNext(playlist);
+
+    vlc_playlist_Notify(playlist, on_items_reset, items->data, items->size);
+    vlc_playlist_state_NotifyChanges(playlist, &state);
+
+    if (current_media_changed)
+        vlc_playlist_SetCurrentMedia(playlist, playlist->current);
+    else
+        vlc_player_InvalidateNextMedia(playlist->player);
+}
+
+int
+vlc_playlist_MoveIndices(vlc_playlist_t *playlist, const size_t indices[],
+                         size_t count, size_t target)
+{
+    vlc_playlist_AssertLocked(playlist);
+    assert(count > 0);
+
+    playlist_item_vector_t *items = &playlist->items;
+    assert(target + count <= items->size);
+
+    vlc_playlist_item_t **moved = vlc_alloc(count, sizeof(*moved));
+    if (unlikely(!moved))
+        return VLC_ENOMEM;
+
+    vlc_playlist_item_t *current = playlist->current != -1
+                                 ? items->data[playlist->current]
+                                 : NULL;
+
+    /* extract the moved items, in the requested order */
+    size_t first = target;
+    for (size_t i = 0; i < count; ++i)
+    {
+        size_t index = indices[i];
+        assert(items->data[index]); /* indices must be unique */
+        moved[i] = items->data[index];
+        items->data[index] = NULL;
+        if (index < first)
+            first = index;
+    }
+
+    /* compact the remaining items, then open the hole at target */
+    size_t j = first;
+    for (size_t i = first; i < items->size; ++i)
+        if (items->data[i])
+            items->data[j++] = items->data[i];
+    assert(j + count == items->size);
+
+    memmove(&items->data[target + count], &items->data[target],
+            (j - target) * sizeof(*items->data));
+    memcpy(&items->data[target], moved, count * sizeof(*moved));
+    free(moved);
+
+    playlist_lookup_Invalidate(&playlist->lookup, first);
+
+    struct vlc_playlist_state state;
+    vlc_playlist_state_Save(playlist, &state);
+
+    if (current)
+        playlist->current = vlc_playlist_IndexOf(playlist, current);
+    playlist->has_prev = vlc_playlist_ComputeHasPrev(playlist);
+    playlist->has_next = vlc_playlist_ComputeHasNext(playlist);
+
+    vlc_playlist_Notify(playlist, on_items_reset, items->data, items->size);
+    vlc_playlist_state_NotifyChanges(playlist, &state);
+
+    vlc_player_InvalidateNextMedia(playlist->player);
+    return VLC_SUCCESS;
+}
+
 static int
 vlc_playlist_Replace(vlc_playlist_t *playlist, size_t index,
                      input_item_t *media)
@@ -342,8 +479,12 @@ vlc_playlist_Replace(vlc_playlist_t *playlist, size_t index,
         randomizer_Add(&playlist->randomizer, &item, 1);
     }
 
+    playlist_lookup_Remove(&playlist->lookup, &playlist->items.data[index], 1);
     vlc_playlist_item_Release(playlist->items.data[index]);
     playlist->items.data[index] = item;
+    /* the position of the other items is unchanged */
+    item->index = index;
+    playlist_lookup_Add(&playlist->lookup, &item, 1);
 
     vlc_playlist_ItemReplaced(playlist, index);
     return VLC_SUCCESS;
@@ -366,6 +507,10 @@ vlc_playlist_Expand(vlc_playlist_t *playlist, size_t index,
 
         if (count > 1)
         {
+            /* make space in the lookup tables */
+            if (!playlist_lookup_Reserve(&playlist->lookup, count - 1))
+                return VLC_ENOMEM;
+
             /* make space in the vector */
             if (!vlc_vector_insert_hole(&playlist->items, index + 1, count - 1))
                 return VLC_ENOMEM;
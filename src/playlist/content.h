@@ -28,6 +28,17 @@ typedef struct input_item_t input_item_t;
 void
 vlc_playlist_ClearItems(vlc_playlist_t *playlist);
 
+/* remove the items at the given sorted indices at once, notify a reset */
+void
+vlc_playlist_RemoveIndices(vlc_playlist_t *playlist, const size_t indices[],
+                           size_t count);
+
+/* move the items at the given indices (in this order) at once, so that they
+ * form a slice starting at target, notify a reset */
+int
+vlc_playlist_MoveIndices(vlc_playlist_t *playlist, const size_t indices[],
+                         size_t count, size_t target);
+
 /* expand an item (replace it by the given media array) */
 int
 vlc_playlist_Expand(vlc_playlist_t *playlist, size_t index,
@@ -31,6 +31,10 @@ struct vlc_playlist_item
     input_item_t *media;
     uint64_t id;
     vlc_atomic_rc_t rc;
+    /* private to the lookup helper, protected by the playlist lock */
+    size_t index; /* cached position in the playlist */
+    vlc_playlist_item_t *next_by_id;
+    vlc_playlist_item_t *next_by_media;
 };
 
 /* _New() is private, it is called when inserting new media in the playlist */
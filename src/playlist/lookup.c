@@ -0,0 +1,287 @@
+/*****************************************************************************
+ * playlist/lookup.c
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <assert.h>
+
+#include <vlc_common.h>
+#include "item.h"
+#include "lookup.h"
+
+/**
+ * \addtogroup playlist_lookup Playlist lookup helper
+ * \ingroup playlist
+ *
+ * The items are chained (using pointers stored in the items themselves) in two
+ * hash tables, so that adding or removing an item never allocates, except
+ * when the tables need to grow.
+ *
+ * Several items may reference the same media, so the media table may contain
+ * several entries for the same key.
+ *
+ * Retrieving the index of an item requires its position in the playlist
+ * vector. Each item caches its own position, which is valid for all items
+ * before lookup->valid. Inserting, removing or moving items only lowers this
+ * limit; positions are recomputed on demand, only up to the requested item.
+ *
+ * As a consequence, a sequence of lookups between two modifications costs at
+ * most O(n) in total, instead of O(n) for each lookup.
+ *
+ * @{
+ */
+
+#define LOOKUP_MIN_BITS 6
+
+static inline size_t
+HashKey(uint64_t key, unsigned bits)
+{
+    /* Fibonacci hashing */
+    return (key * UINT64_C(0x9E3779B97F4A7C15)) >> (64 - bits);
+}
+
+static inline size_t
+HashId(const struct playlist_lookup *lookup, uint64_t id)
+{
+    return HashKey(id, lookup->bits);
+}
+
+static inline size_t
+HashMedia(const struct playlist_lookup *lookup, const input_item_t *media)
+{
+    return HashKey((uintptr_t) media, lookup->bits);
+}
+
+static void
+Insert(struct playlist_lookup *lookup, vlc_playlist_item_t *item)
+{
+    size_t h = HashId(lookup, item->id);
+    item->next_by_id = lookup->by_id[h];
+    lookup->by_id[h] = item;
+
+    h = HashMedia(lookup, item->media);
+    item->next_by_media = lookup->by_media[h];
+    lookup->by_media[h] = item;
+}
+
+void
+playlist_lookup_Init(struct playlist_lookup *lookup)
+{
+    lookup->by_id = NULL;
+    lookup->by_media = NULL;
+    lookup->bits = 0;
+    lookup->count = 0;
+    lookup->valid = 0;
+}
+
+void
+playlist_lookup_Destroy(struct playlist_lookup *lookup)
+{
+    free(lookup->by_id);
+    free(lookup->by_media);
+}
+
+bool
+playlist_lookup_Reserve(struct playlist_lookup *lookup, size_t count)
+{
+    size_t needed = lookup->count + count;
+    if (needed < lookup->count)
+        return false; /* overflow */
+
+    /* keep the load factor below 1 */
+    unsigned bits = lookup->bits ? lookup->bits : LOOKUP_MIN_BITS;
+    while (((size_t) 1 << bits) < needed)
+    {
+        if (bits >= sizeof(size_t) * 8 - 4)
+            return false;
+        bits++;
+    }
+
+    if (bits == lookup->bits)
+        return true;
+
+    size_t size = (size_t) 1 << bits;
+    vlc_playlist_item_t **by_id = calloc(size, sizeof(*by_id));
+    vlc_playlist_item_t **by_media = calloc(size, sizeof(*by_media));
+    if (unlikely(!by_id || !by_media))
+    {
+        free(by_id);
+        free(by_media);
+        return false;
+    }
+
+    vlc_playlist_item_t **old_by_id = lookup->by_id;
+    size_t old_size = lookup->bits ? (size_t) 1 << lookup->bits : 0;
+
+    lookup->by_id = by_id;
+    free(lookup->by_media);
+    lookup->by_media = by_media;
+    lookup->bits = bits;
+
+    /* rehash (every item is in both tables, iterate over one of them) */
+    for (size_t i = 0; i < old_size; ++i)
+    {
+        vlc_playlist_item_t *item = old_by_id[i];
+        while (item)
+        {
+            vlc_playlist_item_t *next = item->next_by_id;
+            Insert(lookup, item);
+            item = next;
+        }
+    }
+    free(old_by_id);
+
+    return true;
+}
+
+void
+playlist_lookup_Add(struct playlist_lookup *lookup,
+                    vlc_playlist_item_t *const items[], size_t count)
+{
+    assert(lookup->count + count <= ((size_t) 1 << lookup->bits));
+
+    for (size_t i = 0; i < count; ++i)
+        Insert(lookup, items[i]);
+    lookup->count += count;
+}
+
+static void
+RemoveOne(struct playlist_lookup *lookup, vlc_playlist_item_t *item)
+{
+    vlc_playlist_item_t **pp = &lookup->by_id[HashId(lookup, item->id)];
+    while (*pp != item)
+    {
+        assert(*pp);
+        pp = &(*pp)->next_by_id;
+    }
+    *pp = item->next_by_id;
+    item->next_by_id = NULL;
+
+    pp = &lookup->by_media[HashMedia(lookup, item->media)];
+    while (*pp != item)
+    {
+        assert(*pp);
+        pp = &(*pp)->next_by_media;
+    }
+    *pp = item->next_by_media;
+    item->next_by_media = NULL;
+}
+
+void
+playlist_lookup_Remove(struct playlist_lookup *lookup,
+                       vlc_playlist_item_t *const items[], size_t count)
+{
+    assert(count <= lookup->count);
+
+    for (size_t i = 0; i < count; ++i)
+        RemoveOne(lookup, items[i]);
+    lookup->count -= count;
+}
+
+void
+playlist_lookup_Clear(struct playlist_lookup *lookup)
+{
+    if (lookup->bits)
+    {
+        size_t size = (size_t) 1 << lookup->bits;
+        memset(lookup->by_id, 0, size * sizeof(*lookup->by_id));
+        memset(lookup->by_media, 0, size * sizeof(*lookup->by_media));
+    }
+    lookup->count = 0;
+    lookup->valid = 0;
+}
+
+vlc_playlist_item_t *
+playlist_lookup_GetById(struct playlist_lookup *lookup, uint64_t id)
+{
+    if (!lookup->count)
+        return NULL;
+
+    vlc_playlist_item_t *item = lookup->by_id[HashId(lookup, id)];
+    while (item && item->id != id)
+        item = item->next_by_id;
+    return item;
+}
+
+static size_t
+GetPosition(struct playlist_lookup *lookup, vlc_playlist_item_t *const items[],
+            size_t size, const vlc_playlist_item_t *item)
+{
+    /* all the items before lookup->valid have a correct cached position, but
+     * an item located after may have a stale one (pointing before) */
+    if (item->index < lookup->valid && items[item->index] == item)
+        return item->index;
+
+    /* the item is after lookup->valid, refresh the cached positions up to the
+     * requested item */
+    for (size_t i = lookup->valid; i < size; ++i)
+    {
+        items[i]->index = i;
+        lookup->valid = i + 1;
+        if (items[i] == item)
+            return i;
+    }
+
+    vlc_assert_unreachable(); /* the item is in the tables */
+}
+
+ssize_t
+playlist_lookup_IndexOf(struct playlist_lookup *lookup,
+                        vlc_playlist_item_t *const items[], size_t size,
+                        const vlc_playlist_item_t *item)
+{
+    assert(lookup->count == size);
+
+    /* the item belongs to the playlist if it is the one registered for its
+     * id */
+    if (playlist_lookup_GetById(lookup, item->id) != item)
+        return -1;
+
+    return GetPosition(lookup, items, size, item);
+}
+
+ssize_t
+playlist_lookup_IndexOfMedia(struct playlist_lookup *lookup,
+                             vlc_playlist_item_t *const items[], size_t size,
+                             const input_item_t *media)
+{
+    assert(lookup->count == size);
+
+    if (!lookup->count)
+        return -1;
+
+    ssize_t index = -1;
+    vlc_playlist_item_t *item = lookup->by_media[HashMedia(lookup, media)];
+    for (; item; item = item->next_by_media)
+    {
+        if (item->media != media)
+            continue;
+
+        /* the same media may be referenced several times, keep the first */
+        size_t pos = GetPosition(lookup, items, size, item);
+        if (index == -1 || pos < (size_t) index)
+            index = pos;
+    }
+    return index;
+}
+
+/** @} */
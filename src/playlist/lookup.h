@@ -0,0 +1,135 @@
+/*****************************************************************************
+ * playlist/lookup.h
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef VLC_PLAYLIST_LOOKUP_H
+#define VLC_PLAYLIST_LOOKUP_H
+
+#include <vlc_common.h>
+
+typedef struct vlc_playlist_item vlc_playlist_item_t;
+typedef struct input_item_t input_item_t;
+
+/**
+ * \defgroup playlist_lookup Playlist lookup helper
+ * \ingroup playlist
+ *  @{ */
+
+/**
+ * Playlist helper to find items by id or by media in constant time.
+ *
+ * Items are chained in two hash tables (by id and by media). The position of
+ * each item in the playlist is cached in the item itself, and is refreshed
+ * lazily: any change to the playlist content only invalidates the cached
+ * positions from the first modified index.
+ *
+ * See lookup.c for implementation details.
+ */
+struct playlist_lookup {
+    vlc_playlist_item_t **by_id;
+    vlc_playlist_item_t **by_media;
+    unsigned bits; /* log2 of the number of buckets (0 if not allocated) */
+    size_t count; /* number of items in the tables */
+    size_t valid; /* cached positions are up-to-date before this index */
+};
+
+/**
+ * Initialize an empty lookup helper.
+ */
+void
+playlist_lookup_Init(struct playlist_lookup *lookup);
+
+/**
+ * Destroy a lookup helper.
+ */
+void
+playlist_lookup_Destroy(struct playlist_lookup *lookup);
+
+/**
+ * Make sure that count items can be added without failure.
+ */
+bool
+playlist_lookup_Reserve(struct playlist_lookup *lookup, size_t count);
+
+/**
+ * Add items (space must have been reserved).
+ */
+void
+playlist_lookup_Add(struct playlist_lookup *lookup,
+                    vlc_playlist_item_t *const items[], size_t count);
+
+/**
+ * Remove items.
+ */
+void
+playlist_lookup_Remove(struct playlist_lookup *lookup,
+                       vlc_playlist_item_t *const items[], size_t count);
+
+/**
+ * Remove all items.
+ */
+void
+playlist_lookup_Clear(struct playlist_lookup *lookup);
+
+/**
+ * Notify that the playlist content changed from the given index.
+ *
+ * The cached positions of items at or after this index are not trusted
+ * anymore.
+ */
+static inline void
+playlist_lookup_Invalidate(struct playlist_lookup *lookup, size_t index)
+{
+    if (index < lookup->valid)
+        lookup->valid = index;
+}
+
+/**
+ * Return the item having the given id, or NULL if not found.
+ */
+vlc_playlist_item_t *
+playlist_lookup_GetById(struct playlist_lookup *lookup, uint64_t id);
+
+/**
+ * Return the index of the given item in the playlist, or -1 if it does not
+ * belong to the playlist.
+ *
+ * \param items the playlist items
+ * \param size  the number of playlist items
+ */
+ssize_t
+playlist_lookup_IndexOf(struct playlist_lookup *lookup,
+                        vlc_playlist_item_t *const items[], size_t size,
+                        const vlc_playlist_item_t *item);
+
+/**
+ * Return the index of the first item referencing the given media, or -1 if
+ * not found.
+ *
+ * \param items the playlist items
+ * \param size  the number of playlist items
+ */
+ssize_t
+playlist_lookup_IndexOfMedia(struct playlist_lookup *lookup,
+                             vlc_playlist_item_t *const items[], size_t size,
+                             const input_item_t *media);
+
+/** @} */
+
+#endif
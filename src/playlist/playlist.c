@@ -46,6 +46,7 @@ vlc_playlist_New(vlc_object_t *parent)
 
     vlc_vector_init(&playlist->items);
     randomizer_Init(&playlist->randomizer);
+    playlist_lookup_Init(&playlist->lookup);
     playlist->current = -1;
     playlist->has_prev = false;
     playlist->has_next = false;
@@ -73,6 +74,7 @@ vlc_playlist_Delete(vlc_playlist_t *playlist)
     vlc_playlist_PlayerDestroy(playlist);
     randomizer_Destroy(&playlist->randomizer);
     vlc_playlist_ClearItems(playlist);
+    playlist_lookup_Destroy(&playlist->lookup);
     free(playlist);
 }
 
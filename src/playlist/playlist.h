@@ -25,6 +25,7 @@
 #include <vlc_playlist.h>
 #include <vlc_vector.h>
 #include "../player/player.h"
+#include "lookup.h"
 #include "randomizer.h"
 
 typedef struct input_item_t input_item_t;
@@ -54,6 +55,7 @@ struct vlc_playlist
     struct vlc_player_listener_id *player_listener;
     playlist_item_vector_t items;
     struct randomizer randomizer;
+    struct playlist_lookup lookup;
     ssize_t current;
     bool has_prev;
     bool has_next;
@@ -30,6 +30,9 @@
 #include "notify.h"
 #include "libvlc.h" /* for vlc_MetadataRequest() */
 
+/* Number of items preparsed in a row by a preparser worker */
+#define PREPARSE_BATCH_SIZE 64
+
 typedef struct VLC_VECTOR(input_item_t *) media_vector_t;
 
 static void
@@ -133,3 +136,53 @@ vlc_playlist_AutoPreparse(vlc_playlist_t *playlist, input_item_t *input)
     if (playlist->auto_preparse && !input_item_IsPreparsed(input))
         vlc_playlist_Preparse(playlist, input);
 }
+
+static void
+vlc_playlist_PreparseBatch(vlc_playlist_t *playlist, input_item_t **media,
+                           size_t count)
+{
+#ifdef TEST_PLAYLIST
+    VLC_UNUSED(playlist);
+    VLC_UNUSED(media);
+    VLC_UNUSED(count);
+#else
+    vlc_MetadataRequestBatch(playlist->libvlc, media, count,
+                             META_REQUEST_OPTION_SCOPE_LOCAL |
+                             META_REQUEST_OPTION_FETCH_LOCAL,
+                             &input_preparser_callbacks, playlist, -1, NULL);
+#endif
+}
+
+void
+vlc_playlist_AutoPreparseItems(vlc_playlist_t *playlist,
+                               vlc_playlist_item_t *const items[],
+                               size_t count)
+{
+    if (!playlist->auto_preparse)
+        return;
+
+    if (count == 1)
+    {
+        /* a single item gets a regular (full) preparse */
+        vlc_playlist_AutoPreparse(playlist, items[0]->media);
+        return;
+    }
+
+    input_item_t *batch[PREPARSE_BATCH_SIZE];
+    size_t size = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        input_item_t *media = items[i]->media;
+        if (input_item_IsPreparsed(media))
+            continue;
+
+        batch[size++] = media;
+        if (size == PREPARSE_BATCH_SIZE)
+        {
+            vlc_playlist_PreparseBatch(playlist, batch, size);
+            size = 0;
+        }
+    }
+    if (size > 0)
+        vlc_playlist_PreparseBatch(playlist, batch, size);
+}
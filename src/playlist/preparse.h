@@ -25,10 +25,16 @@
 
 typedef struct vlc_playlist vlc_playlist_t;
 typedef struct input_item_node_t input_item_node_t;
+typedef struct vlc_playlist_item vlc_playlist_item_t;
 
 void
 vlc_playlist_AutoPreparse(vlc_playlist_t *playlist, input_item_t *input);
 
+void
+vlc_playlist_AutoPreparseItems(vlc_playlist_t *playlist,
+                               vlc_playlist_item_t *const items[],
+                               size_t count);
+
 int
 vlc_playlist_ExpandItem(vlc_playlist_t *playlist, size_t index,
                         input_item_node_t *node);
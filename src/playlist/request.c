@@ -22,6 +22,7 @@
 # include "config.h"
 #endif
 
+#include "content.h"
 #include "item.h"
 #include "playlist.h"
 
@@ -57,6 +58,20 @@ vlc_playlist_FindRealIndex(vlc_playlist_t *playlist, vlc_playlist_item_t *item,
 
 struct size_vector VLC_VECTOR(size_t);
 
+/* Above this number of slices, a request is applied at once and notified as a
+ * reset: listeners would be flooded by individual slice notifications */
+#define BATCH_MAX_SLICES 16
+
+static size_t
+CountSlices(const size_t indices[], size_t count)
+{
+    size_t slices = count > 0;
+    for (size_t i = 1; i < count; ++i)
+        if (indices[i] != indices[i - 1] + 1)
+            slices++;
+    return slices;
+}
+
 static void
 vlc_playlist_FindIndices(vlc_playlist_t *playlist,
                          vlc_playlist_item_t *const items[], size_t count,
@@ -224,7 +239,11 @@ vlc_playlist_RequestMove(vlc_playlist_t *playlist,
             target = size - move_count;
 
         /* keep the items in the same order as the request (do not sort them) */
-        vlc_playlist_MoveBySlices(playlist, vector.data, vector.size, target);
+        if (CountSlices(vector.data, vector.size) <= BATCH_MAX_SLICES
+         || vlc_playlist_MoveIndices(playlist, vector.data, vector.size,
+                                     target) != VLC_SUCCESS)
+            vlc_playlist_MoveBySlices(playlist, vector.data, vector.size,
+                                      target);
     }
 
     vlc_vector_destroy(&vector);
@@ -249,7 +268,10 @@ vlc_playlist_RequestRemove(vlc_playlist_t *playlist,
         /* sort so that removing an item does not shift the other indices */
         qsort(vector.data, vector.size, sizeof(vector.data[0]), cmp_size);
 
-        vlc_playlist_RemoveBySlices(playlist, vector.data, vector.size);
+        if (CountSlices(vector.data, vector.size) <= BATCH_MAX_SLICES)
+            vlc_playlist_RemoveBySlices(playlist, vector.data, vector.size);
+        else
+            vlc_playlist_RemoveIndices(playlist, vector.data, vector.size);
     }
 
     vlc_vector_destroy(&vector);
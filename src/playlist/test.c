@@ -1065,6 +1065,58 @@ test_index_of(void)
     vlc_playlist_Delete(playlist);
 }
 
+static void
+test_index_of_after_changes(void)
+{
+    vlc_playlist_t *playlist = vlc_playlist_New(NULL);
+    assert(playlist);
+
+    input_item_t *media[100];
+    CreateDummyMediaArray(media, 100);
+
+    int ret = vlc_playlist_Append(playlist, media, 100);
+    assert(ret == VLC_SUCCESS);
+
+    /* the same media may be added several times */
+    ret = vlc_playlist_Insert(playlist, 10, &media[50], 1);
+    assert(ret == VLC_SUCCESS);
+    assert(vlc_playlist_IndexOfMedia(playlist, media[50]) == 10);
+
+    vlc_playlist_RemoveOne(playlist, 10);
+    assert(vlc_playlist_IndexOfMedia(playlist, media[50]) == 50);
+
+    vlc_playlist_Move(playlist, 80, 10, 5);
+    vlc_playlist_Remove(playlist, 0, 3);
+
+    /* 3..4, 80..89, 5..79, 90..99 */
+    for (size_t i = 0; i < 97; ++i)
+    {
+        vlc_playlist_item_t *item = vlc_playlist_Get(playlist, i);
+        assert(vlc_playlist_IndexOf(playlist, item) == (ssize_t) i);
+        assert(vlc_playlist_IndexOfMedia(playlist, item->media) == (ssize_t) i);
+        assert(vlc_playlist_IndexOfId(playlist, item->id) == (ssize_t) i);
+    }
+    assert(vlc_playlist_IndexOfMedia(playlist, media[0]) == -1);
+    assert(vlc_playlist_IndexOfMedia(playlist, media[3]) == 0);
+    assert(vlc_playlist_IndexOfMedia(playlist, media[80]) == 2);
+    assert(vlc_playlist_IndexOfMedia(playlist, media[5]) == 12);
+    assert(vlc_playlist_IndexOfMedia(playlist, media[99]) == 96);
+
+    /* lookup in reverse order after a change at the beginning */
+    vlc_playlist_RemoveOne(playlist, 0);
+    for (size_t i = 96; i != 0; --i)
+    {
+        vlc_playlist_item_t *item = vlc_playlist_Get(playlist, i - 1);
+        assert(vlc_playlist_IndexOfId(playlist, item->id) == (ssize_t) i - 1);
+    }
+
+    vlc_playlist_Clear(playlist);
+    assert(vlc_playlist_IndexOfMedia(playlist, media[50]) == -1);
+
+    DestroyMediaArray(media, 100);
+    vlc_playlist_Delete(playlist);
+}
+
 static void
 test_prev(void)
 {
@@ -1883,6 +1935,143 @@ test_request_move_to_end_adapt(void)
     vlc_playlist_Delete(playlist);
 }
 
+static void
+test_request_remove_batch(void)
+{
+    vlc_playlist_t *playlist = vlc_playlist_New(NULL);
+    assert(playlist);
+
+    input_item_t *media[100];
+    CreateDummyMediaArray(media, 100);
+
+    /* initial playlist with 100 items */
+    int ret = vlc_playlist_Append(playlist, media, 100);
+    assert(ret == VLC_SUCCESS);
+
+    /* last item removed is the current one */
+    playlist->current = 61;
+
+    struct vlc_playlist_callbacks cbs = {
+        .on_items_reset = callback_on_items_reset,
+        .on_items_removed = callback_on_items_removed,
+        .on_current_index_changed = callback_on_current_index_changed,
+    };
+
+    struct callback_ctx ctx = CALLBACK_CTX_INITIALIZER;
+    vlc_playlist_listener_id *listener =
+            vlc_playlist_AddListener(playlist, &cbs, &ctx, false);
+    assert(listener);
+
+    /* remove 31 items forming 31 slices: 1, 3, 5, ..., 61 */
+    vlc_playlist_item_t *items_to_remove[31];
+    for (size_t i = 0; i < 31; ++i)
+        items_to_remove[i] = vlc_playlist_Get(playlist, 2 * i + 1);
+
+    ret = vlc_playlist_RequestRemove(playlist, items_to_remove, 31, -1);
+    assert(ret == VLC_SUCCESS);
+
+    assert(vlc_playlist_Count(playlist) == 69);
+
+    for (size_t i = 0; i < 31; ++i)
+        EXPECT_AT(i, 2 * i);
+    for (size_t i = 31; i < 69; ++i)
+        EXPECT_AT(i, i + 31);
+
+    /* the item following the current one becomes the current one */
+    assert(playlist->current == 31);
+
+    /* a single notification for the whole request */
+    assert(ctx.vec_items_removed.size == 0);
+    assert(ctx.vec_items_reset.size == 1);
+    assert(ctx.vec_items_reset.data[0].count == 69);
+    assert(ctx.vec_items_reset.data[0].state.playlist_size == 69);
+    assert(ctx.vec_items_reset.data[0].state.current == 31);
+
+    assert(ctx.vec_current_index_changed.size == 1);
+    assert(ctx.vec_current_index_changed.data[0].current == 31);
+
+    for (size_t i = 0; i < 69; ++i)
+    {
+        vlc_playlist_item_t *item = vlc_playlist_Get(playlist, i);
+        assert(vlc_playlist_IndexOf(playlist, item) == (ssize_t) i);
+    }
+    assert(vlc_playlist_IndexOfMedia(playlist, media[61]) == -1);
+
+    callback_ctx_destroy(&ctx);
+    vlc_playlist_RemoveListener(playlist, listener);
+    DestroyMediaArray(media, 100);
+    vlc_playlist_Delete(playlist);
+}
+
+static void
+test_request_move_batch(void)
+{
+    vlc_playlist_t *playlist = vlc_playlist_New(NULL);
+    assert(playlist);
+
+    input_item_t *media[100];
+    CreateDummyMediaArray(media, 100);
+
+    /* initial playlist with 100 items */
+    int ret = vlc_playlist_Append(playlist, media, 100);
+    assert(ret == VLC_SUCCESS);
+
+    playlist->current = 50;
+
+    struct vlc_playlist_callbacks cbs = {
+        .on_items_reset = callback_on_items_reset,
+        .on_items_moved = callback_on_items_moved,
+        .on_current_index_changed = callback_on_current_index_changed,
+    };
+
+    struct callback_ctx ctx = CALLBACK_CTX_INITIALIZER;
+    vlc_playlist_listener_id *listener =
+            vlc_playlist_AddListener(playlist, &cbs, &ctx, false);
+    assert(listener);
+
+    /* move 20 items (in reverse order) forming 20 slices: 98, 93, ..., 3 */
+    vlc_playlist_item_t *items_to_move[20];
+    for (size_t i = 0; i < 20; ++i)
+        items_to_move[i] = vlc_playlist_Get(playlist, 98 - 5 * i);
+
+    ret = vlc_playlist_RequestMove(playlist, items_to_move, 20, 10, -1);
+    assert(ret == VLC_SUCCESS);
+
+    assert(vlc_playlist_Count(playlist) == 100);
+
+    /* the first 10 remaining items: 0, 1, 2, 4, 5, 6, 7, 9, 10, 11 */
+    EXPECT_AT(0, 0);
+    EXPECT_AT(3, 4);
+    EXPECT_AT(9, 11);
+    for (size_t i = 0; i < 20; ++i)
+        EXPECT_AT(10 + i, 98 - 5 * i);
+    EXPECT_AT(30, 12);
+    EXPECT_AT(99, 99);
+
+    /* 10 moved items were before 50 (3, 8, ..., 48) */
+    EXPECT_AT(60, 50);
+    assert(playlist->current == 60);
+
+    assert(ctx.vec_items_moved.size == 0);
+    assert(ctx.vec_items_reset.size == 1);
+    assert(ctx.vec_items_reset.data[0].count == 100);
+    assert(ctx.vec_items_reset.data[0].state.current == 60);
+
+    assert(ctx.vec_current_index_changed.size == 1);
+    assert(ctx.vec_current_index_changed.data[0].current == 60);
+
+    for (size_t i = 0; i < 100; ++i)
+    {
+        vlc_playlist_item_t *item = vlc_playlist_Get(playlist, i);
+        assert(vlc_playlist_IndexOf(playlist, item) == (ssize_t) i);
+    }
+
+    callback_ctx_destroy(&ctx);
+    vlc_playlist_RemoveListener(playlist, listener);
+    DestroyMediaArray(media, 100);
+    vlc_playlist_Delete(playlist);
+}
+
 static void
 test_request_goto_with_matching_hint(void)
 {
@@ -2367,6 +2556,7 @@ int main(void)
     test_playback_order_changed_callbacks();
     test_callbacks_on_add_listener();
     test_index_of();
+    test_index_of_after_changes();
     test_prev();
     test_next();
     test_goto();
@@ -2378,6 +2568,8 @@ int main(void)
     test_request_move_without_hint();
     test_request_move_adapt();
     test_request_move_to_end_adapt();
+    test_request_remove_batch();
+    test_request_move_batch();
     test_request_goto_with_matching_hint();
     test_request_goto_without_hint();
     test_request_goto_adapt();
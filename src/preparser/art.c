@@ -246,6 +246,74 @@ static char * GetFileByItemUID( char *psz_dir, const char *psz_type )
     return psz_file;
 }
 
+static char * GetDirByArtURL( const char *psz_arturl )
+{
+    char psz_hash[VLC_HASH_MD5_DIGEST_HEX_SIZE];
+    vlc_hash_md5_t md5;
+    vlc_hash_md5_Init( &md5 );
+    vlc_hash_md5_Update( &md5, psz_arturl, strlen( psz_arturl ) );
+    vlc_hash_FinishHex( &md5, psz_hash );
+
+    char *psz_cachedir = config_GetUserDir(VLC_CACHE_DIR);
+    char *psz_dir;
+    if( asprintf( &psz_dir, "%s" DIR_SEP
+                  "by-arturl" DIR_SEP
+                  "%s",
+                  psz_cachedir, psz_hash ) == -1 )
+    {
+        psz_dir = NULL;
+    }
+    free( psz_cachedir );
+    return psz_dir;
+}
+
+/* Only remote art is indexed by URL */
+static bool IsRemoteArtURL( const char *psz_arturl )
+{
+    return psz_arturl != NULL &&
+           strncasecmp( psz_arturl, "file://", 7 ) &&
+           strncasecmp( psz_arturl, "attachment://", 13 );
+}
+
+int input_FindArtInCacheUsingArtURL( input_item_t *p_item )
+{
+    char *psz_arturl = input_item_GetArtURL( p_item );
+    if( !IsRemoteArtURL( psz_arturl ) )
+    {
+        free( psz_arturl );
+        return VLC_EGENERIC;
+    }
+
+    bool b_done = false;
+    char *psz_dir = GetDirByArtURL( psz_arturl );
+    char *psz_file = psz_dir ? GetFileByItemUID( psz_dir, "arturl" ) : NULL;
+    free( psz_dir );
+    free( psz_arturl );
+    if( psz_file )
+    {
+        FILE *fd = vlc_fopen( psz_file, "rb" );
+        if( fd )
+        {
+            char sz_cachefile[2049];
+            /* the art may have been removed from the cache since */
+            if( fgets( sz_cachefile, 2048, fd ) != NULL )
+            {
+                char *psz_path = vlc_uri2path( sz_cachefile );
+                struct stat st;
+                if( psz_path && !vlc_stat( psz_path, &st ) )
+                {
+                    input_item_SetArtURL( p_item, sz_cachefile );
+                    b_done = true;
+                }
+                free( psz_path );
+            }
+            fclose( fd );
+        }
+        free( psz_file );
+    }
+    return b_done ? VLC_SUCCESS : VLC_EGENERIC;
+}
+
 int input_FindArtInCacheUsingItemUID( input_item_t *p_item )
 {
     char *uid = input_item_GetInfo( p_item, "uid", "md5" );
@@ -282,6 +350,41 @@ int input_FindArtInCacheUsingItemUID( input_item_t *p_item )
     return VLC_EGENERIC;
 }
 
+/* Remember where the art downloaded from the item art URL was saved, so that
+ * it is not downloaded again for other items */
+static void SaveArtURLInfo( vlc_object_t *obj, input_item_t *p_item,
+                            const char *psz_uri )
+{
+    char *psz_arturl = input_item_GetArtURL( p_item );
+    if( !IsRemoteArtURL( psz_arturl ) )
+    {
+        free( psz_arturl );
+        return;
+    }
+
+    char *psz_dir = GetDirByArtURL( psz_arturl );
+    free( psz_arturl );
+    if( !psz_dir )
+        return;
+
+    char *psz_file = GetFileByItemUID( psz_dir, "arturl" );
+    ArtCacheCreateDir( psz_dir );
+    free( psz_dir );
+
+    if( psz_file )
+    {
+        FILE *f = vlc_fopen( psz_file, "wb" );
+        if( f )
+        {
+            if( fputs( psz_uri, f ) < 0 )
+                msg_Err( obj, "Error writing %s: %s", psz_file,
+                         vlc_strerror_c(errno) );
+            fclose( f );
+        }
+        free( psz_file );
+    }
+}
+
 /* */
 int input_SaveArt( vlc_object_t *obj, input_item_t *p_item,
                    const void *data, size_t length, const char *psz_type )
@@ -319,6 +422,7 @@ int input_SaveArt( vlc_object_t *obj, input_item_t *p_item,
         else
         {
             msg_Dbg( obj, "album art saved to %s", psz_filename );
+            SaveArtURLInfo( obj, p_item, psz_uri );
             input_item_SetArtURL( p_item, psz_uri );
         }
         fclose( f );
@@ -26,6 +26,7 @@
 
 int input_FindArtInCache( input_item_t * );
 int input_FindArtInCacheUsingItemUID( input_item_t * );
+int input_FindArtInCacheUsingArtURL( input_item_t * );
 
 int input_SaveArt( vlc_object_t *, input_item_t *,
                    const void *, size_t, const char *psz_type );
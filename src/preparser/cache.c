@@ -0,0 +1,403 @@
+/*****************************************************************************
+ * cache.c: persistent preparse results cache
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <sys/stat.h>
+#include <errno.h>
+
+#include <vlc_common.h>
+#include <vlc_arrays.h>
+#include <vlc_fs.h>
+#include <vlc_list.h>
+#include <vlc_meta.h>
+#include <vlc_url.h>
+
+#include "cache.h"
+
+#define CACHE_FILENAME "preparse.cache"
+#define CACHE_HEADER   "vlc-preparse-cache 1"
+
+struct cache_entry
+{
+    int64_t mtime;
+    vlc_tick_t duration;
+    vlc_meta_t *meta;
+    char *uri;
+    struct vlc_list node; /**< in preparse_cache_t.lru */
+};
+
+struct preparse_cache_t
+{
+    vlc_object_t *obj;
+    char *path;
+
+    vlc_mutex_t lock;
+    vlc_dictionary_t entries; /**< URI -> struct cache_entry */
+    struct vlc_list lru; /**< most recently used first */
+    size_t count;
+    size_t max_count;
+    bool dirty;
+};
+
+static void EntryDelete( void *entry_, void *opaque )
+{
+    struct cache_entry *entry = entry_;
+    preparse_cache_t *cache = opaque;
+
+    vlc_list_remove( &entry->node );
+    cache->count--;
+    vlc_meta_Delete( entry->meta );
+    free( entry->uri );
+    free( entry );
+}
+
+static struct cache_entry *EntryNew( int64_t mtime, vlc_tick_t duration )
+{
+    struct cache_entry *entry = malloc( sizeof(*entry) );
+    if( unlikely(entry == NULL) )
+        return NULL;
+
+    entry->meta = vlc_meta_New();
+    if( unlikely(entry->meta == NULL) )
+    {
+        free( entry );
+        return NULL;
+    }
+    entry->mtime = mtime;
+    entry->duration = duration;
+    entry->uri = NULL;
+    return entry;
+}
+
+/* Only for entries not inserted yet */
+static void EntryFree( struct cache_entry *entry )
+{
+    vlc_meta_Delete( entry->meta );
+    free( entry );
+}
+
+static void CacheInsert( preparse_cache_t *cache, const char *uri,
+                         struct cache_entry *entry )
+{
+    entry->uri = strdup( uri );
+    if( unlikely(entry->uri == NULL) )
+    {
+        EntryFree( entry );
+        return;
+    }
+
+    if( vlc_dictionary_has_key( &cache->entries, uri ) )
+        vlc_dictionary_remove_value_for_key( &cache->entries, uri,
+                                             EntryDelete, cache );
+    vlc_dictionary_insert( &cache->entries, uri, entry );
+    vlc_list_prepend( &entry->node, &cache->lru );
+    cache->count++;
+
+    /* Evict the least recently used entries */
+    while( cache->count > cache->max_count )
+    {
+        struct cache_entry *last =
+            vlc_list_last_entry_or_null( &cache->lru, struct cache_entry, node );
+        vlc_dictionary_remove_value_for_key( &cache->entries, last->uri,
+                                             EntryDelete, cache );
+    }
+}
+
+/* Returns the modification time of a local regular file */
+static int GetModificationTime( const char *uri, int64_t *mtime )
+{
+    if( strncmp( uri, "file://", 7 ) )
+        return VLC_EGENERIC;
+
+    char *path = vlc_uri2path( uri );
+    if( path == NULL )
+        return VLC_EGENERIC;
+
+    struct stat st;
+    int ret = vlc_stat( path, &st );
+    free( path );
+    if( ret || !S_ISREG( st.st_mode ) )
+        return VLC_EGENERIC;
+
+    *mtime = st.st_mtime;
+    return VLC_SUCCESS;
+}
+
+static void CacheParseLine( preparse_cache_t *cache, char *line )
+{
+    char *saveptr;
+    char *uri = strtok_r( line, " ", &saveptr );
+    char *mtime = strtok_r( NULL, " ", &saveptr );
+    char *duration = strtok_r( NULL, " ", &saveptr );
+    if( uri == NULL || mtime == NULL || duration == NULL )
+        return;
+
+    struct cache_entry *entry = EntryNew( strtoll( mtime, NULL, 10 ),
+                                          strtoll( duration, NULL, 10 ) );
+    if( unlikely(entry == NULL) )
+        return;
+
+    char *field;
+    while( (field = strtok_r( NULL, " ", &saveptr )) != NULL )
+    {
+        char *value = strchr( field, '=' );
+        if( value == NULL )
+            continue;
+        *value++ = '\0';
+
+        unsigned type = strtoul( field, NULL, 10 );
+        if( type < VLC_META_TYPE_COUNT && vlc_uri_decode( value ) != NULL )
+            vlc_meta_Set( entry->meta, type, value );
+    }
+
+    if( vlc_uri_decode( uri ) == NULL )
+    {
+        EntryFree( entry );
+        return;
+    }
+    CacheInsert( cache, uri, entry );
+}
+
+static void CacheLoad( preparse_cache_t *cache )
+{
+    FILE *file = vlc_fopen( cache->path, "r" );
+    if( file == NULL )
+        return;
+
+    char *line = NULL;
+    size_t size = 0;
+    ssize_t len = getline( &line, &size, file );
+    if( len > 0 && !strncmp( line, CACHE_HEADER, strlen(CACHE_HEADER) ) )
+    {
+        while( (len = getline( &line, &size, file )) > 0 )
+        {
+            if( line[len - 1] == '\n' )
+                line[len - 1] = '\0';
+            CacheParseLine( cache, line );
+        }
+    }
+    free( line );
+    fclose( file );
+
+    msg_Dbg( cache->obj, "loaded %d preparse cache entries",
+             vlc_dictionary_keys_count( &cache->entries ) );
+}
+
+static int CacheWriteEntry( FILE *file, const char *uri,
+                            const struct cache_entry *entry )
+{
+    char *encoded = vlc_uri_encode( uri );
+    if( encoded == NULL )
+        return VLC_ENOMEM;
+    int ret = fprintf( file, "%s %"PRId64" %"PRId64, encoded,
+                       entry->mtime, entry->duration );
+    free( encoded );
+
+    for( unsigned type = 0; ret >= 0 && type < VLC_META_TYPE_COUNT; type++ )
+    {
+        const char *value = vlc_meta_Get( entry->meta, type );
+        if( value == NULL )
+            continue;
+        encoded = vlc_uri_encode( value );
+        if( encoded == NULL )
+            return VLC_ENOMEM;
+        ret = fprintf( file, " %u=%s", type, encoded );
+        free( encoded );
+    }
+    if( ret < 0 || fputc( '\n', file ) == EOF )
+        return VLC_EGENERIC;
+    return VLC_SUCCESS;
+}
+
+static void CacheCreateDir( char *dir )
+{
+    for( char *psz = dir; (psz = strchr( psz + 1, DIR_SEP_CHAR )) != NULL; )
+    {
+        *psz = '\0';
+        vlc_mkdir( dir, 0700 );
+        *psz = DIR_SEP_CHAR;
+    }
+    vlc_mkdir( dir, 0700 );
+}
+
+static void CacheSave( preparse_cache_t *cache )
+{
+    char *tmp;
+    if( asprintf( &tmp, "%s.tmp", cache->path ) == -1 )
+        return;
+
+    FILE *file = vlc_fopen( tmp, "w" );
+    if( file == NULL )
+    {
+        msg_Warn( cache->obj, "cannot write %s: %s", tmp, vlc_strerror_c(errno) );
+        free( tmp );
+        return;
+    }
+
+    bool error = fputs( CACHE_HEADER "\n", file ) == EOF;
+
+    /* Least recently used first, as each loaded entry becomes the most
+     * recently used one */
+    for( struct cache_entry *entry =
+             vlc_list_last_entry_or_null( &cache->lru, struct cache_entry, node );
+         !error && entry != NULL;
+         entry = vlc_list_prev_entry_or_null( &cache->lru, entry,
+                                              struct cache_entry, node ) )
+        error = CacheWriteEntry( file, entry->uri, entry ) != VLC_SUCCESS;
+
+    if( fclose( file ) )
+        error = true;
+
+    if( error || vlc_rename( tmp, cache->path ) )
+    {
+        msg_Warn( cache->obj, "cannot save preparse cache" );
+        vlc_unlink( tmp );
+    }
+    free( tmp );
+}
+
+preparse_cache_t *preparse_cache_New( vlc_object_t *obj, size_t max_count )
+{
+    char *dir = config_GetUserDir( VLC_CACHE_DIR );
+    if( dir == NULL )
+        return NULL;
+
+    preparse_cache_t *cache = malloc( sizeof(*cache) );
+    if( unlikely(cache == NULL) )
+    {
+        free( dir );
+        return NULL;
+    }
+
+    CacheCreateDir( dir );
+    if( asprintf( &cache->path, "%s"DIR_SEP CACHE_FILENAME, dir ) == -1 )
+    {
+        free( dir );
+        free( cache );
+        return NULL;
+    }
+    free( dir );
+
+    cache->obj = obj;
+    vlc_mutex_init( &cache->lock );
+    vlc_dictionary_init( &cache->entries, 4096 );
+    vlc_list_init( &cache->lru );
+    cache->count = 0;
+    cache->max_count = max_count ? max_count : 1;
+    cache->dirty = false;
+
+    CacheLoad( cache );
+    return cache;
+}
+
+void preparse_cache_Delete( preparse_cache_t *cache )
+{
+    if( cache->dirty )
+        CacheSave( cache );
+
+    vlc_dictionary_clear( &cache->entries, EntryDelete, cache );
+    free( cache->path );
+    free( cache );
+}
+
+bool preparse_cache_Apply( preparse_cache_t *cache, input_item_t *item )
+{
+    char *uri = input_item_GetURI( item );
+    if( uri == NULL )
+        return false;
+
+    int64_t mtime;
+    if( GetModificationTime( uri, &mtime ) )
+    {
+        free( uri );
+        return false;
+    }
+
+    vlc_meta_t *meta = NULL;
+    vlc_tick_t duration = VLC_TICK_INVALID;
+
+    vlc_mutex_lock( &cache->lock );
+    struct cache_entry *entry =
+        vlc_dictionary_value_for_key( &cache->entries, uri );
+    if( entry != NULL && entry->mtime == mtime )
+    {
+        vlc_list_remove( &entry->node );
+        vlc_list_prepend( &entry->node, &cache->lru );
+
+        meta = vlc_meta_New();
+        if( likely(meta != NULL) )
+            vlc_meta_Merge( meta, entry->meta );
+        duration = entry->duration;
+    }
+    vlc_mutex_unlock( &cache->lock );
+    free( uri );
+
+    if( meta == NULL )
+        return false;
+
+    for( unsigned type = 0; type < VLC_META_TYPE_COUNT; type++ )
+    {
+        const char *value = vlc_meta_Get( meta, type );
+        if( value != NULL )
+            input_item_SetMeta( item, type, value );
+    }
+    if( vlc_meta_Get( meta, vlc_meta_Title ) != NULL )
+        input_item_SetName( item, vlc_meta_Get( meta, vlc_meta_Title ) );
+    if( duration != VLC_TICK_INVALID )
+        input_item_SetDuration( item, duration );
+
+    vlc_meta_Delete( meta );
+    return true;
+}
+
+void preparse_cache_Store( preparse_cache_t *cache, input_item_t *item )
+{
+    char *uri = input_item_GetURI( item );
+    if( uri == NULL )
+        return;
+
+    int64_t mtime;
+    if( GetModificationTime( uri, &mtime ) )
+    {
+        free( uri );
+        return;
+    }
+
+    vlc_mutex_lock( &item->lock );
+    struct cache_entry *entry = EntryNew( mtime, item->i_duration );
+    if( likely(entry != NULL) )
+        for( unsigned type = 0; type < VLC_META_TYPE_COUNT; type++ )
+            if( type != vlc_meta_ArtworkURL )
+                vlc_meta_Set( entry->meta, type,
+                              vlc_meta_Get( item->p_meta, type ) );
+    vlc_mutex_unlock( &item->lock );
+
+    if( likely(entry != NULL) )
+    {
+        vlc_mutex_lock( &cache->lock );
+        CacheInsert( cache, uri, entry );
+        cache->dirty = true;
+        vlc_mutex_unlock( &cache->lock );
+    }
+    free( uri );
+}
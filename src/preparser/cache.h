@@ -0,0 +1,52 @@
+/*****************************************************************************
+ * cache.h: persistent preparse results cache
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef VLC_PREPARSER_CACHE_H
+#define VLC_PREPARSER_CACHE_H 1
+
+#include <vlc_input_item.h>
+
+/**
+ * Preparse results cache.
+ *
+ * Remembers the meta data and duration of local files, keyed by URI and
+ * modification time, so that a file is not probed again until it changes.
+ * The cache is loaded from the user cache directory on creation and written
+ * back on deletion. Beyond max_count entries, the least recently used ones
+ * are evicted.
+ */
+typedef struct preparse_cache_t preparse_cache_t;
+
+preparse_cache_t *preparse_cache_New( vlc_object_t *, size_t max_count );
+void preparse_cache_Delete( preparse_cache_t * );
+
+/**
+ * Applies a cached result to an item.
+ *
+ * @return true if the item is a local file whose cached entry is still valid
+ */
+bool preparse_cache_Apply( preparse_cache_t *, input_item_t * );
+
+/**
+ * Stores the current meta data and duration of a preparsed item.
+ */
+void preparse_cache_Store( preparse_cache_t *, input_item_t * );
+
+#endif
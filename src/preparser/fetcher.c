@@ -22,6 +22,8 @@
 # include "config.h"
 #endif
 
+#include <assert.h>
+
 #include <vlc_common.h>
 #include <vlc_atomic.h>
 #include <vlc_stream.h>
@@ -39,16 +41,51 @@
 #include "input/input_interface.h"
 #include "misc/interrupt.h"
 
+#define FETCHER_CACHE_SIZE 1024
+
+/**
+ * In-memory cache of fetcher results, bounded to FETCHER_CACHE_SIZE entries
+ * (the least recently used ones are evicted).
+ */
+struct fetcher_cache {
+    vlc_dictionary_t entries; /**< key -> struct fetcher_cache_entry */
+    struct vlc_list lru; /**< list of struct fetcher_cache_entry, most
+                              recently used first */
+    size_t count;
+};
+
+struct fetcher_cache_entry {
+    char *value;
+    struct vlc_list node; /**< node of fetcher_cache.lru */
+    char key[];
+};
+
+/**
+ * Work in progress for a given key (album or art URL), so that concurrent
+ * tasks for the same key wait for the first one instead of repeating it.
+ */
+struct fetcher_inflight {
+    struct vlc_list node; /**< node of input_fetcher_t.inflight */
+    char key[];
+};
+
 struct input_fetcher_t {
     vlc_executor_t *executor_local;
     vlc_executor_t *executor_network;
     vlc_executor_t *executor_downloader;
 
-    vlc_dictionary_t album_cache;
+    struct fetcher_cache album_cache; /**< album key -> art URL */
+    struct fetcher_cache url_cache; /**< remote art URL -> local art URL */
+    struct fetcher_cache notfound_cache; /**< albums without network art */
     vlc_object_t* owner;
 
     vlc_mutex_t lock;
     struct vlc_list submitted_tasks; /**< list of struct task */
+
+    /* Not protected by lock, which is held while interrupting the tasks */
+    vlc_mutex_t inflight_lock;
+    vlc_cond_t inflight_wait;
+    struct vlc_list inflight; /**< list of struct fetcher_inflight */
 };
 
 struct task {
@@ -144,6 +181,166 @@ Submit(input_fetcher_t *fetcher, vlc_executor_t *executor, input_item_t *item,
     return VLC_SUCCESS;
 }
 
+static void CacheInit( struct fetcher_cache *cache )
+{
+    vlc_dictionary_init( &cache->entries, FETCHER_CACHE_SIZE );
+    vlc_list_init( &cache->lru );
+    cache->count = 0;
+}
+
+static void CacheEntryDelete( void *data, void *obj )
+{
+    struct fetcher_cache_entry *entry = data;
+    VLC_UNUSED( obj );
+
+    free( entry->value );
+    free( entry );
+}
+
+static void CacheClear( struct fetcher_cache *cache )
+{
+    vlc_dictionary_clear( &cache->entries, CacheEntryDelete, NULL );
+}
+
+/* The fetcher lock must be held, the value is valid until it is released */
+static const char *CacheGet( struct fetcher_cache *cache, const char *key )
+{
+    struct fetcher_cache_entry *entry =
+        vlc_dictionary_value_for_key( &cache->entries, key );
+    if( !entry )
+        return NULL;
+
+    vlc_list_remove( &entry->node );
+    vlc_list_prepend( &entry->node, &cache->lru );
+    return entry->value;
+}
+
+/* The fetcher lock must be held, the value is consumed */
+static void CachePut( struct fetcher_cache *cache, const char *key,
+                      char *value, bool overwrite )
+{
+    struct fetcher_cache_entry *entry =
+        vlc_dictionary_value_for_key( &cache->entries, key );
+    if( entry )
+    {
+        if( overwrite )
+        {
+            free( entry->value );
+            entry->value = value;
+        }
+        else
+            free( value );
+
+        vlc_list_remove( &entry->node );
+        vlc_list_prepend( &entry->node, &cache->lru );
+        return;
+    }
+
+    size_t keylen = strlen( key ) + 1;
+    entry = malloc( sizeof( *entry ) + keylen );
+    if( unlikely( !entry ) )
+    {
+        free( value );
+        return;
+    }
+    memcpy( entry->key, key, keylen );
+    entry->value = value;
+
+    if( cache->count == FETCHER_CACHE_SIZE )
+    {
+        struct fetcher_cache_entry *oldest =
+            vlc_list_last_entry_or_null( &cache->lru,
+                                         struct fetcher_cache_entry, node );
+        vlc_list_remove( &oldest->node );
+        vlc_dictionary_remove_value_for_key( &cache->entries, oldest->key,
+                                             CacheEntryDelete, NULL );
+        cache->count--;
+    }
+
+    vlc_dictionary_insert( &cache->entries, key, entry );
+    vlc_list_prepend( &entry->node, &cache->lru );
+    cache->count++;
+}
+
+static void FetcherWakeUp( void *data )
+{
+    input_fetcher_t *fetcher = data;
+
+    vlc_mutex_lock( &fetcher->inflight_lock );
+    vlc_cond_broadcast( &fetcher->inflight_wait );
+    vlc_mutex_unlock( &fetcher->inflight_lock );
+}
+
+/**
+ * Waits until no other task works on the key, and marks it as in progress.
+ *
+ * \param inflightp set to the entry to pass to FetcherEnd(), or to NULL if
+ * it could not be allocated (the task proceeds anyway)
+ * \return VLC_SUCCESS, or VLC_EGENERIC if the task was killed while waiting
+ */
+static int
+FetcherBegin( input_fetcher_t *fetcher, const char *type, const char *key,
+              struct fetcher_inflight **inflightp )
+{
+    struct fetcher_inflight *inflight;
+    size_t len = strlen( type ) + 1 + strlen( key ) + 1;
+
+    *inflightp = NULL;
+    inflight = malloc( sizeof( *inflight ) + len );
+    if( unlikely( !inflight ) )
+        return VLC_SUCCESS;
+    snprintf( inflight->key, len, "%s:%s", type, key );
+
+    bool killed = false;
+
+    vlc_interrupt_register( FetcherWakeUp, fetcher );
+    vlc_mutex_lock( &fetcher->inflight_lock );
+    for( ;; )
+    {
+        bool busy = false;
+        struct fetcher_inflight *other;
+        vlc_list_foreach( other, &fetcher->inflight, node )
+            if( !strcmp( other->key, inflight->key ) )
+            {
+                busy = true;
+                break;
+            }
+        if( !busy )
+            break;
+        killed = vlc_killed();
+        if( killed )
+            break;
+        vlc_cond_wait( &fetcher->inflight_wait, &fetcher->inflight_lock );
+    }
+    if( !killed )
+        vlc_list_append( &inflight->node, &fetcher->inflight );
+    vlc_mutex_unlock( &fetcher->inflight_lock );
+    vlc_interrupt_unregister();
+
+    if( killed )
+    {
+        free( inflight );
+        return VLC_EGENERIC;
+    }
+
+    *inflightp = inflight;
+    return VLC_SUCCESS;
+}
+
+static void
+FetcherEnd( input_fetcher_t *fetcher, struct fetcher_inflight *inflight )
+{
+    if( !inflight )
+        return;
+
+    vlc_mutex_lock( &fetcher->inflight_lock );
+    vlc_list_remove( &inflight->node );
+    vlc_cond_broadcast( &fetcher->inflight_wait );
+    vlc_mutex_unlock( &fetcher->inflight_lock );
+
+    free( inflight );
+}
+
 static char* CreateCacheKey( input_item_t* item )
 {
     vlc_mutex_lock( &item->lock );
@@ -174,12 +371,6 @@ static char* CreateCacheKey( input_item_t* item )
     return key;
 }
 
-static void FreeCacheEntry( void* data, void* obj )
-{
-    free( data );
-    VLC_UNUSED( obj );
-}
-
 static int ReadAlbumCache( input_fetcher_t* fetcher, input_item_t* item )
 {
     char* key = CreateCacheKey( item );
@@ -188,8 +379,7 @@ static int ReadAlbumCache( input_fetcher_t* fetcher, input_item_t* item )
         return VLC_EGENERIC;
 
     vlc_mutex_lock( &fetcher->lock );
-    char const* art = vlc_dictionary_value_for_key( &fetcher->album_cache,
-                                                    key );
+    char const* art = CacheGet( &fetcher->album_cache, key );
     if( art )
         input_item_SetArtURL( item, art );
     vlc_mutex_unlock( &fetcher->lock );
@@ -207,20 +397,60 @@ static void AddAlbumCache( input_fetcher_t* fetcher, input_item_t* item,
     if( key && art && strncasecmp( art, "attachment://", 13 ) )
     {
         vlc_mutex_lock( &fetcher->lock );
-        if( overwrite || !vlc_dictionary_has_key( &fetcher->album_cache, key ) )
-        {
-            vlc_dictionary_insert( &fetcher->album_cache, key, art );
-            art = NULL;
-        }
+        CachePut( &fetcher->album_cache, key, art, overwrite );
         vlc_mutex_unlock( &fetcher->lock );
+        art = NULL;
     }
 
     free( art );
     free( key );
 }
 
+static int ReadArtURLCache( input_fetcher_t* fetcher, input_item_t* item,
+                            const char *arturl )
+{
+    vlc_mutex_lock( &fetcher->lock );
+    char const* art = CacheGet( &fetcher->url_cache, arturl );
+    if( art )
+        input_item_SetArtURL( item, art );
+    vlc_mutex_unlock( &fetcher->lock );
+
+    return art ? VLC_SUCCESS : VLC_EGENERIC;
+}
+
+static void AddArtURLCache( input_fetcher_t* fetcher, input_item_t* item,
+                            const char *arturl )
+{
+    char* art = input_item_GetArtURL( item );
+
+    if( art && !strncasecmp( art, "file://", 7 ) )
+    {
+        vlc_mutex_lock( &fetcher->lock );
+        CachePut( &fetcher->url_cache, arturl, art, true );
+        vlc_mutex_unlock( &fetcher->lock );
+        art = NULL;
+    }
+
+    free( art );
+}
+
+static bool IsAlbumNotFound( input_fetcher_t* fetcher, const char *key )
+{
+    vlc_mutex_lock( &fetcher->lock );
+    bool notfound = CacheGet( &fetcher->notfound_cache, key ) != NULL;
+    vlc_mutex_unlock( &fetcher->lock );
+    return notfound;
+}
+
+static void AddAlbumNotFound( input_fetcher_t* fetcher, const char *key )
+{
+    vlc_mutex_lock( &fetcher->lock );
+    CachePut( &fetcher->notfound_cache, key, strdup( "" ), false );
+    vlc_mutex_unlock( &fetcher->lock );
+}
+
 static int InvokeModule( input_fetcher_t* fetcher, input_item_t* item,
-                         int scope, char const* type )
+                         int scope, char const* type, bool *incomplete )
 {
     meta_fetcher_t* mf = vlc_custom_create( fetcher->owner,
                                             sizeof( *mf ), type );
@@ -229,12 +459,15 @@ static int InvokeModule( input_fetcher_t* fetcher, input_item_t* item,
 
     mf->e_scope = scope;
     mf->p_item = item;
+    mf->b_incomplete = false;
 
     module_t* mf_module = module_need( mf, type, NULL, false );
 
     if( mf_module )
         module_unneed( mf, mf_module );
 
+    if( incomplete )
+        *incomplete = mf->b_incomplete;
     vlc_object_delete(mf);
 
     return VLC_SUCCESS;
@@ -260,9 +493,15 @@ static int CheckArt( input_item_t* item )
     return error;
 }
 
-static int SearchArt( input_fetcher_t* fetcher, input_item_t* item, int scope)
+/* definitive is set if the art finders did not fail to complete the search,
+ * i.e. if the result would be the same if searched again */
+static int SearchArt( input_fetcher_t* fetcher, input_item_t* item, int scope,
+                      bool *definitive )
 {
-    InvokeModule( fetcher, item, scope, "art finder" );
+    bool incomplete = true;
+
+    InvokeModule( fetcher, item, scope, "art finder", &incomplete );
+    *definitive = !incomplete && !vlc_killed();
     return CheckArt( item );
 }
 
@@ -272,25 +511,44 @@ static int SearchByScope(struct task *task, int scope)
     input_item_t* item = task->item;
 
     if( CheckMeta( item ) &&
-        InvokeModule( fetcher, item, scope, "meta fetcher" ) )
+        InvokeModule( fetcher, item, scope, "meta fetcher", NULL ) )
     {
         return VLC_EGENERIC;
     }
 
+    /* The items of an album are searched once: concurrent searches wait for
+     * the first one, and then find its result in the album cache */
+    char *key = CreateCacheKey( item );
+    struct fetcher_inflight *inflight = NULL;
+    if( key && FetcherBegin( fetcher, "album", key, &inflight ) )
+    {
+        free( key );
+        return VLC_EGENERIC;
+    }
+    /* do not query the network again for albums known to have no art */
+    bool network = scope == FETCHER_SCOPE_NETWORK && key &&
+                   !IsAlbumNotFound( fetcher, key );
+    bool definitive = false;
+    int ret = VLC_EGENERIC;
+
     if( ! CheckArt( item )                         ||
         ! ReadAlbumCache( fetcher, item )          ||
         ! input_FindArtInCacheUsingItemUID( item ) ||
         ! input_FindArtInCache( item )             ||
-        ! SearchArt( fetcher, item, scope ) )
+        ( ( scope != FETCHER_SCOPE_NETWORK || network ) &&
+          ! SearchArt( fetcher, item, scope, &definitive ) ) )
     {
         AddAlbumCache( fetcher, task->item, false );
-        int ret = Submit(fetcher, fetcher->executor_downloader, item,
-                         task->options, task->cbs, task->userdata);
-        if (ret == VLC_SUCCESS)
-            return VLC_SUCCESS;
+        ret = Submit(fetcher, fetcher->executor_downloader, item,
+                     task->options, task->cbs, task->userdata);
     }
+    else if( network && definitive )
+        AddAlbumNotFound( fetcher, key );
 
-    return VLC_EGENERIC;
+    FetcherEnd( fetcher, inflight );
+    free( key );
+
+    return ret;
 }
 
 static void NotifyArtFetchEnded(struct task *task, bool fetched)
@@ -299,27 +557,13 @@ static void NotifyArtFetchEnded(struct task *task, bool fetched)
         task->cbs->on_art_fetch_ended(task->item, fetched, task->userdata);
 }
 
-static void RunDownloader(void *userdata)
+static int Download( input_fetcher_t *fetcher, input_item_t *item,
+                     const char *psz_arturl )
 {
-    struct task *task = userdata;
-    input_fetcher_t *fetcher = task->fetcher;
-
-    vlc_interrupt_set(&task->interrupt);
-
-    ReadAlbumCache( fetcher, task->item );
-
-    char *psz_arturl = input_item_GetArtURL( task->item );
-    if( !psz_arturl )
-        goto error;
-
-    if( !strncasecmp( psz_arturl, "file://", 7 ) ||
-        !strncasecmp( psz_arturl, "attachment://", 13 ) )
-        goto out; /* no fetch required */
-
     stream_t* source = vlc_stream_NewURL( fetcher->owner, psz_arturl );
 
     if( !source )
-        goto error;
+        return VLC_EGENERIC;
 
     struct vlc_memstream output_stream;
     vlc_memstream_open( &output_stream );
@@ -339,43 +583,70 @@ static void RunDownloader(void *userdata)
     vlc_stream_Delete( source );
 
     if( vlc_memstream_close( &output_stream ) )
-        goto error;
+        return VLC_EGENERIC;
 
     if( vlc_killed() )
     {
         free( output_stream.ptr );
-        goto error;
+        return VLC_EGENERIC;
     }
 
-    input_SaveArt( fetcher->owner, task->item, output_stream.ptr,
+    input_SaveArt( fetcher->owner, item, output_stream.ptr,
                    output_stream.length, NULL );
 
     free( output_stream.ptr );
-    AddAlbumCache( fetcher, task->item, true );
+    return VLC_SUCCESS;
+}
 
-out:
-    vlc_interrupt_set(NULL);
+static void RunDownloader(void *userdata)
+{
+    struct task *task = userdata;
+    input_fetcher_t *fetcher = task->fetcher;
+    bool fetched = false;
 
-    if( psz_arturl )
+    vlc_interrupt_set(&task->interrupt);
+
+    ReadAlbumCache( fetcher, task->item );
+
+    char *psz_arturl = input_item_GetArtURL( task->item );
+    if( !psz_arturl )
+        goto end;
+
+    if( strncasecmp( psz_arturl, "file://", 7 ) &&
+        strncasecmp( psz_arturl, "attachment://", 13 ) )
     {
-        var_SetAddress( fetcher->owner, "item-change", task->item );
-        input_item_SetArtFetched( task->item, true );
+        /* Concurrent downloads of the same art wait for the first one, and
+         * then find its result in the cache */
+        struct fetcher_inflight *inflight;
+        if( FetcherBegin( fetcher, "url", psz_arturl, &inflight ) )
+            goto end;
+
+        int ret = VLC_SUCCESS;
+        if( ReadArtURLCache( fetcher, task->item, psz_arturl ) &&
+            input_FindArtInCacheUsingArtURL( task->item ) )
+            ret = Download( fetcher, task->item, psz_arturl );
+
+        if( ret == VLC_SUCCESS )
+            AddArtURLCache( fetcher, task->item, psz_arturl );
+        FetcherEnd( fetcher, inflight );
+
+        if( ret != VLC_SUCCESS )
+            goto end;
+
+        AddAlbumCache( fetcher, task->item, true );
     }
 
-    free( psz_arturl );
-    NotifyArtFetchEnded(task, psz_arturl != NULL);
-    FetcherRemoveTask(fetcher, task);
-    TaskDelete(task);
-    return;
+    var_SetAddress( fetcher->owner, "item-change", task->item );
+    input_item_SetArtFetched( task->item, true );
+    fetched = true;
 
-error:
+end:
     vlc_interrupt_set(NULL);
 
-    FREENULL( psz_arturl );
-    NotifyArtFetchEnded(task, false);
+    free( psz_arturl );
+    NotifyArtFetchEnded(task, fetched);
     FetcherRemoveTask(fetcher, task);
     TaskDelete(task);
-    goto out;
 }
 
 static void RunSearchLocal(void *userdata)
@@ -388,7 +659,9 @@ static void RunSearchLocal(void *userdata)
     if( SearchByScope( task, FETCHER_SCOPE_LOCAL ) == VLC_SUCCESS )
         goto end; /* done */
 
-    if( var_InheritBool( fetcher->owner, "metadata-network-access" ) ||
+    if( vlc_killed() )
+        NotifyArtFetchEnded(task, false);
+    else if( var_InheritBool( fetcher->owner, "metadata-network-access" ) ||
         task->options & META_REQUEST_OPTION_FETCH_NETWORK )
     {
         int ret = Submit(fetcher, fetcher->executor_network, task->item,
@@ -417,7 +690,8 @@ static void RunSearchNetwork(void *userdata)
 
     if( SearchByScope( task, FETCHER_SCOPE_NETWORK ) != VLC_SUCCESS )
     {
-        input_item_SetArtNotFound( task->item, true );
+        if( !vlc_killed() )
+            input_item_SetArtNotFound( task->item, true );
         NotifyArtFetchEnded(task, false);
     }
 
@@ -467,8 +741,13 @@ input_fetcher_t* input_fetcher_New( vlc_object_t* owner )
 
     vlc_mutex_init(&fetcher->lock);
     vlc_list_init(&fetcher->submitted_tasks);
+    vlc_mutex_init(&fetcher->inflight_lock);
+    vlc_cond_init(&fetcher->inflight_wait);
+    vlc_list_init(&fetcher->inflight);
 
-    vlc_dictionary_init( &fetcher->album_cache, 0 );
+    CacheInit( &fetcher->album_cache );
+    CacheInit( &fetcher->url_cache );
+    CacheInit( &fetcher->notfound_cache );
 
     return fetcher;
 }
@@ -501,7 +780,10 @@ CancelAllTasks(input_fetcher_t *fetcher)
             vlc_list_remove(&task->node);
             TaskDelete(task);
         }
-        /* Otherwise, the task will be finished and destroyed after run() */
+        else
+            /* The task will be finished and destroyed after run(), do not
+             * wait for its network requests or for other tasks */
+            vlc_interrupt_kill(&task->interrupt);
     }
 
     vlc_mutex_unlock(&fetcher->lock);
@@ -515,6 +797,9 @@ void input_fetcher_Delete( input_fetcher_t* fetcher )
     vlc_executor_Delete(fetcher->executor_network);
     vlc_executor_Delete(fetcher->executor_downloader);
 
-    vlc_dictionary_clear( &fetcher->album_cache, FreeCacheEntry, NULL );
+    assert(vlc_list_is_empty(&fetcher->inflight));
+    CacheClear( &fetcher->album_cache );
+    CacheClear( &fetcher->url_cache );
+    CacheClear( &fetcher->notfound_cache );
     free( fetcher );
 }
@@ -25,16 +25,23 @@
 #include <vlc_common.h>
 #include <vlc_atomic.h>
 #include <vlc_executor.h>
+#include <vlc_interrupt.h>
+#include <vlc_modules.h>
+#include <vlc_meta.h>
 
 #include "input/input_interface.h"
 #include "input/input_internal.h"
+#include "input/demux.h"
+#include "input/stream.h"
 #include "preparser.h"
 #include "fetcher.h"
+#include "cache.h"
 
 struct input_preparser_t
 {
     vlc_object_t* owner;
     input_fetcher_t* fetcher;
+    preparse_cache_t *cache;
     vlc_executor_t *executor;
     vlc_tick_t default_timeout;
     atomic_bool deactivated;
@@ -63,6 +70,14 @@ struct task
 
     atomic_bool interrupted;
 
+    /* Batch mode: items are probed one after the other on the same worker,
+     * task->item being the one currently processed */
+    input_item_t **batch;
+    size_t batch_count;
+    vlc_interrupt_t *interrupt;
+    vlc_timer_t deadline_timer;
+    atomic_bool deadline_reached;
+
     struct vlc_runnable runnable; /**< to be passed to the executor */
 
     struct vlc_list node; /**< node of input_preparser_t.submitted_tasks */
@@ -101,6 +116,10 @@ TaskNew(input_preparser_t *preparser, input_item_t *item,
 
     atomic_init(&task->interrupted, false);
 
+    task->batch = NULL;
+    task->batch_count = 0;
+    task->interrupt = NULL;
+
     task->runnable.run = RunnableRun;
     task->runnable.userdata = task;
 
@@ -111,9 +130,76 @@ static void
 TaskDelete(struct task *task)
 {
     input_item_Release(task->item);
+    if (task->batch)
+    {
+        for (size_t i = 0; i < task->batch_count; ++i)
+            input_item_Release(task->batch[i]);
+        free(task->batch);
+        vlc_timer_destroy(task->deadline_timer);
+        vlc_interrupt_destroy(task->interrupt);
+    }
     free(task);
 }
 
+static void
+OnBatchDeadline(void *task_)
+{
+    struct task *task = task_;
+
+    /* Interrupt the running probe, if any */
+    atomic_store(&task->deadline_reached, true);
+    vlc_interrupt_kill(task->interrupt);
+}
+
+static struct task *
+TaskNewBatch(input_preparser_t *preparser, input_item_t **items, size_t count,
+             input_item_meta_request_option_t options,
+             const input_preparser_callbacks_t *cbs, void *userdata,
+             void *id, vlc_tick_t timeout)
+{
+    assert(count > 0);
+
+    input_item_t **batch = vlc_alloc(count, sizeof(*batch));
+    if (!batch)
+        return NULL;
+
+    vlc_interrupt_t *interrupt = vlc_interrupt_create();
+    if (!interrupt)
+    {
+        free(batch);
+        return NULL;
+    }
+
+    struct task *task =
+        TaskNew(preparser, items[0], options, cbs, userdata, id, timeout);
+    if (!task)
+    {
+        vlc_interrupt_destroy(interrupt);
+        free(batch);
+        return NULL;
+    }
+
+    if (vlc_timer_create(&task->deadline_timer, OnBatchDeadline, task))
+    {
+        TaskDelete(task);
+        vlc_interrupt_destroy(interrupt);
+        free(batch);
+        return NULL;
+    }
+    atomic_init(&task->deadline_reached, false);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        batch[i] = items[i];
+        input_item_Hold(items[i]);
+    }
+    task->batch = batch;
+    task->batch_count = count;
+    task->interrupt = interrupt;
+
+    return task;
+}
+
 static void
 PreparserAddTask(input_preparser_t *preparser, struct task *task)
 {
@@ -138,6 +224,16 @@ NotifyPreparseEnded(struct task *task)
                                      task->userdata);
 }
 
+static void
+NotifyBatchEnded(struct task *task, size_t from,
+                 enum input_item_preparse_status status)
+{
+    if (!task->cbs || !task->cbs->on_preparse_ended)
+        return;
+    for (size_t i = from; i < task->batch_count; ++i)
+        task->cbs->on_preparse_ended(task->batch[i], status, task->userdata);
+}
+
 static void
 OnParserEnded(input_item_t *item, int status, void *task_)
 {
@@ -255,11 +351,236 @@ Fetch(struct task *task)
     vlc_mutex_unlock(&task->lock);
 }
 
+static es_out_id_t *
+ProbeEsOutAdd(es_out_t *out, input_source_t *in, const es_format_t *fmt)
+{
+    VLC_UNUSED(in); VLC_UNUSED(fmt);
+    /* Any non-NULL id, so that demuxers do not fail to open */
+    return (es_out_id_t *)out;
+}
+
+static int
+ProbeEsOutSend(es_out_t *out, es_out_id_t *id, block_t *block)
+{
+    VLC_UNUSED(out); VLC_UNUSED(id);
+    block_Release(block);
+    return VLC_SUCCESS;
+}
+
+static void
+ProbeEsOutDel(es_out_t *out, es_out_id_t *id)
+{
+    VLC_UNUSED(out); VLC_UNUSED(id);
+}
+
+static int
+ProbeEsOutControl(es_out_t *out, input_source_t *in, int query, va_list args)
+{
+    VLC_UNUSED(out); VLC_UNUSED(in); VLC_UNUSED(query); VLC_UNUSED(args);
+    return VLC_EGENERIC;
+}
+
+static const struct es_out_callbacks probe_es_out_cbs = {
+    .add = ProbeEsOutAdd,
+    .send = ProbeEsOutSend,
+    .del = ProbeEsOutDel,
+    .control = ProbeEsOutControl,
+};
+
+static void
+ProbeMetaReader(vlc_object_t *obj, input_item_t *item, vlc_meta_t *meta)
+{
+    demux_meta_t *demux_meta =
+        vlc_custom_create(obj, sizeof(*demux_meta), "demux meta");
+    if (!demux_meta)
+        return;
+    demux_meta->p_item = item;
+
+    module_t *reader = module_need(demux_meta, "meta reader", NULL, false);
+    if (reader)
+    {
+        if (demux_meta->p_meta)
+        {
+            vlc_meta_Merge(meta, demux_meta->p_meta);
+            vlc_meta_Delete(demux_meta->p_meta);
+        }
+        /* Attachments are not extracted when probing */
+        for (int i = 0; i < demux_meta->i_attachments; ++i)
+            vlc_input_attachment_Release(demux_meta->attachments[i]);
+        free(demux_meta->attachments);
+        module_unneed(demux_meta, reader);
+    }
+    vlc_object_delete(demux_meta);
+}
+
+/**
+ * Lightweight preparsing of a local file: open the demuxer and read its meta
+ * data and duration, without an input thread nor an ES output.
+ *
+ * Returns an error if the item needs a full preparse instead (directories,
+ * playlists, access-demuxers...).
+ */
+static int
+Probe(struct task *task)
+{
+    input_item_t *item = task->item;
+    vlc_object_t *obj = task->preparser->owner;
+
+    vlc_mutex_lock(&item->lock);
+    char *uri = item->i_type == ITEM_TYPE_FILE && !item->b_net
+              ? strdup(item->psz_uri) : NULL;
+    vlc_mutex_unlock(&item->lock);
+    if (!uri)
+        return VLC_EGENERIC;
+
+    int ret = VLC_EGENERIC;
+    stream_t *stream = stream_AccessNew(obj, NULL, NULL, true, uri);
+    if (!stream)
+        goto end;
+    if (stream->pf_readdir != NULL ||
+        (stream->pf_read == NULL && stream->pf_block == NULL))
+    {
+        vlc_stream_Delete(stream);
+        goto end;
+    }
+    stream = stream_FilterAutoNew(stream);
+
+    es_out_t out = { .cbs = &probe_es_out_cbs };
+    demux_t *demux = demux_NewAdvanced(obj, NULL, "any", uri, stream, &out,
+                                       true);
+    if (!demux)
+    {
+        vlc_stream_Delete(stream);
+        goto end;
+    }
+
+    if (demux->pf_readdir == NULL)
+    {
+        vlc_meta_t *meta = vlc_meta_New();
+        if (meta)
+        {
+            bool has_meta = !demux_Control(demux, DEMUX_GET_META, meta);
+            bool has_unsupported;
+            if (demux_Control(demux, DEMUX_HAS_UNSUPPORTED_META,
+                              &has_unsupported))
+                has_unsupported = true;
+            if (!has_meta || has_unsupported)
+                ProbeMetaReader(obj, item, meta);
+
+            vlc_mutex_lock(&item->lock);
+            vlc_meta_Merge(item->p_meta, meta);
+            vlc_mutex_unlock(&item->lock);
+            if (vlc_meta_Get(meta, vlc_meta_Title))
+                input_item_SetName(item, vlc_meta_Get(meta, vlc_meta_Title));
+            vlc_meta_Delete(meta);
+        }
+
+        vlc_tick_t length;
+        if (!demux_Control(demux, DEMUX_GET_LENGTH, &length) && length > 0)
+            input_item_SetDuration(item, length);
+        ret = VLC_SUCCESS;
+    }
+    demux_Delete(demux);
+
+end:
+    free(uri);
+    return ret;
+}
+
+static void
+RunBatchItem(struct task *task, vlc_tick_t deadline)
+{
+    preparse_cache_t *cache = task->preparser->cache;
+    bool cached = false;
+
+    if (cache && preparse_cache_Apply(cache, task->item))
+    {
+        task->preparse_status = ITEM_PREPARSE_DONE;
+        cached = true;
+    }
+    else if (Probe(task) == VLC_SUCCESS)
+        task->preparse_status = ITEM_PREPARSE_DONE;
+    else if (atomic_load(&task->deadline_reached))
+        task->preparse_status = ITEM_PREPARSE_TIMEOUT;
+    else if (!atomic_load(&task->interrupted))
+        Parse(task, deadline);
+
+    if (task->preparse_status == ITEM_PREPARSE_TIMEOUT)
+        return;
+
+    if (atomic_load(&task->interrupted))
+        return;
+
+    if (cache && !cached && task->preparse_status == ITEM_PREPARSE_DONE)
+        preparse_cache_Store(cache, task->item);
+
+    Fetch(task);
+
+    if (atomic_load(&task->interrupted))
+        return;
+
+    input_item_SetPreparsed(task->item, true);
+}
+
+static void
+RunBatch(struct task *task)
+{
+    /* The timeout is a budget for the whole batch */
+    vlc_tick_t deadline = task->timeout
+                        ? vlc_tick_now() + task->timeout * task->batch_count
+                        : VLC_TICK_INVALID;
+
+    vlc_interrupt_t *oldctx = vlc_interrupt_set(task->interrupt);
+    if (deadline != VLC_TICK_INVALID)
+        vlc_timer_schedule(task->deadline_timer, true, deadline, 0);
+
+    for (size_t i = 0; i < task->batch_count; ++i)
+    {
+        vlc_mutex_lock(&task->lock);
+        bool interrupted = atomic_load(&task->interrupted);
+        if (!interrupted)
+        {
+            input_item_Release(task->item);
+            task->item = task->batch[i];
+            input_item_Hold(task->item);
+            task->parser = NULL;
+            task->preparse_ended = false;
+            task->preparse_status = ITEM_PREPARSE_SKIPPED;
+            task->fetch_ended = false;
+        }
+        vlc_mutex_unlock(&task->lock);
+
+        if (interrupted)
+        {
+            NotifyBatchEnded(task, i, ITEM_PREPARSE_SKIPPED);
+            break;
+        }
+        if (atomic_load(&task->deadline_reached) ||
+            (deadline != VLC_TICK_INVALID && vlc_tick_now() >= deadline))
+        {
+            NotifyBatchEnded(task, i, ITEM_PREPARSE_TIMEOUT);
+            break;
+        }
+
+        RunBatchItem(task, deadline);
+        NotifyPreparseEnded(task);
+    }
+
+    vlc_timer_disarm(task->deadline_timer);
+    vlc_interrupt_set(oldctx);
+}
+
 static void
 RunnableRun(void *userdata)
 {
     struct task *task = userdata;
 
+    if (task->batch)
+    {
+        RunBatch(task);
+        goto end_batch;
+    }
+
     vlc_tick_t deadline = task->timeout ? vlc_tick_now() + task->timeout
                                         : VLC_TICK_INVALID;
 
@@ -280,6 +601,7 @@ RunnableRun(void *userdata)
 
 end:
     NotifyPreparseEnded(task);
+end_batch:;
     input_preparser_t *preparser = task->preparser;
     PreparserRemoveTask(preparser, task);
     TaskDelete(task);
@@ -296,6 +618,10 @@ Interrupt(struct task *task)
     task->preparse_ended = true;
     vlc_mutex_unlock(&task->lock);
     vlc_cond_signal(&task->cond_ended);
+
+    /* Interrupt a running probe */
+    if (task->interrupt)
+        vlc_interrupt_kill(task->interrupt);
 }
 
 input_preparser_t* input_preparser_New( vlc_object_t *parent )
@@ -322,6 +648,10 @@ input_preparser_t* input_preparser_New( vlc_object_t *parent )
 
     preparser->owner = parent;
     preparser->fetcher = input_fetcher_New( parent );
+    preparser->cache = var_InheritBool( parent, "preparse-cache" )
+                     ? preparse_cache_New( parent,
+                           var_InheritInteger( parent, "preparse-cache-size" ) )
+                     : NULL;
     atomic_init( &preparser->deactivated, false );
 
     vlc_mutex_init(&preparser->lock);
@@ -333,14 +663,9 @@ input_preparser_t* input_preparser_New( vlc_object_t *parent )
     return preparser;
 }
 
-int input_preparser_Push( input_preparser_t *preparser,
-    input_item_t *item, input_item_meta_request_option_t i_options,
-    const input_preparser_callbacks_t *cbs, void *cbs_userdata,
-    int timeout_ms, void *id )
+static bool PreparserAccepts( input_item_t *item,
+                              input_item_meta_request_option_t i_options )
 {
-    if( atomic_load( &preparser->deactivated ) )
-        return VLC_EGENERIC;
-
     vlc_mutex_lock( &item->lock );
     enum input_item_type_e i_type = item->i_type;
     int b_net = item->b_net;
@@ -354,13 +679,25 @@ int input_preparser_Push( input_preparser_t *preparser,
         case ITEM_TYPE_FILE:
         case ITEM_TYPE_DIRECTORY:
         case ITEM_TYPE_PLAYLIST:
-            if( !b_net || i_options & META_REQUEST_OPTION_SCOPE_NETWORK )
-                break;
-            /* fallthrough */
+            return !b_net || i_options & META_REQUEST_OPTION_SCOPE_NETWORK;
         default:
-            if (cbs && cbs->on_preparse_ended)
-                cbs->on_preparse_ended(item, ITEM_PREPARSE_SKIPPED, cbs_userdata);
-            return VLC_SUCCESS;
+            return false;
+    }
+}
+
+int input_preparser_Push( input_preparser_t *preparser,
+    input_item_t *item, input_item_meta_request_option_t i_options,
+    const input_preparser_callbacks_t *cbs, void *cbs_userdata,
+    int timeout_ms, void *id )
+{
+    if( atomic_load( &preparser->deactivated ) )
+        return VLC_EGENERIC;
+
+    if( !PreparserAccepts( item, i_options ) )
+    {
+        if (cbs && cbs->on_preparse_ended)
+            cbs->on_preparse_ended(item, ITEM_PREPARSE_SKIPPED, cbs_userdata);
+        return VLC_SUCCESS;
     }
 
     vlc_tick_t timeout = timeout_ms == -1 ? preparser->default_timeout
@@ -376,6 +713,49 @@ int input_preparser_Push( input_preparser_t *preparser,
     return VLC_SUCCESS;
 }
 
+int input_preparser_PushBatch( input_preparser_t *preparser,
+    input_item_t **items, size_t count,
+    input_item_meta_request_option_t i_options,
+    const input_preparser_callbacks_t *cbs, void *cbs_userdata,
+    int timeout_ms, void *id )
+{
+    if( atomic_load( &preparser->deactivated ) )
+        return VLC_EGENERIC;
+
+    input_item_t **accepted = vlc_alloc( count, sizeof(*accepted) );
+    if( !accepted )
+        return VLC_ENOMEM;
+
+    size_t accepted_count = 0;
+    for( size_t i = 0; i < count; ++i )
+    {
+        if( PreparserAccepts( items[i], i_options ) )
+            accepted[accepted_count++] = items[i];
+        else if (cbs && cbs->on_preparse_ended)
+            cbs->on_preparse_ended(items[i], ITEM_PREPARSE_SKIPPED,
+                                   cbs_userdata);
+    }
+
+    int ret = VLC_SUCCESS;
+    if( accepted_count > 0 )
+    {
+        vlc_tick_t timeout = timeout_ms == -1 ? preparser->default_timeout
+                                              : VLC_TICK_FROM_MS(timeout_ms);
+        struct task *task =
+            TaskNewBatch(preparser, accepted, accepted_count, i_options, cbs,
+                         cbs_userdata, id, timeout);
+        if( task )
+        {
+            PreparserAddTask(preparser, task);
+            vlc_executor_Submit(preparser->executor, &task->runnable);
+        }
+        else
+            ret = VLC_ENOMEM;
+    }
+    free( accepted );
+    return ret;
+}
+
 void input_preparser_fetcher_Push( input_preparser_t *preparser,
     input_item_t *item, input_item_meta_request_option_t options,
     const input_fetcher_callbacks_t *cbs, void *cbs_userdata )
@@ -398,7 +778,10 @@ void input_preparser_Cancel( input_preparser_t *preparser, void *id )
                 vlc_executor_Cancel(preparser->executor, &task->runnable);
             if (canceled)
             {
-                NotifyPreparseEnded(task);
+                if (task->batch)
+                    NotifyBatchEnded(task, 0, ITEM_PREPARSE_SKIPPED);
+                else
+                    NotifyPreparseEnded(task);
                 vlc_list_remove(&task->node);
                 TaskDelete(task);
             }
@@ -427,5 +810,8 @@ void input_preparser_Delete( input_preparser_t *preparser )
     if( preparser->fetcher )
         input_fetcher_Delete( preparser->fetcher );
 
+    if( preparser->cache )
+        preparse_cache_Delete( preparser->cache );
+
     free( preparser );
 }
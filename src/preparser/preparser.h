@@ -60,6 +60,32 @@ int input_preparser_Push( input_preparser_t *, input_item_t *,
                            void *cbs_userdata,
                            int timeout, void *id );
 
+/**
+ * This function enqueues a batch of items to be preparsed.
+ *
+ * The items are processed in order by a single worker, so that several
+ * batches can run in parallel on the "preparse-threads" workers. Local files
+ * are probed without spawning an input thread: only the demuxer is opened,
+ * to read the meta data and the duration (ES are not reported). Other items,
+ * playlists and directories fall back to a regular preparse. If enabled, the
+ * "preparse-cache" is looked up first, and filled with probed results.
+ *
+ * @param timeout same as input_preparser_Push(), but the budget is shared by
+ * the whole batch: its deadline is timeout * count. Items not started
+ * before the deadline are reported with ITEM_PREPARSE_TIMEOUT.
+ * @param id unique id provided by the caller, to cancel the whole batch with
+ * input_preparser_Cancel()
+ * @returns VLC_SUCCESS if the items were scheduled for preparsing, an error
+ * code otherwise. on_preparse_ended is invoked once per item, unless an error
+ * is returned (items skipped because of their type are notified anyway).
+ */
+int input_preparser_PushBatch( input_preparser_t *, input_item_t **items,
+                               size_t count,
+                               input_item_meta_request_option_t,
+                               const input_preparser_callbacks_t *cbs,
+                               void *cbs_userdata,
+                               int timeout, void *id );
+
 void input_preparser_fetcher_Push( input_preparser_t *, input_item_t *,
                                    input_item_meta_request_option_t,
                                    const input_fetcher_callbacks_t *cbs,
@@ -394,6 +394,19 @@ picture_pool_t *vout_GetPool(vout_display_t *vd, unsigned count)
     return osys->pool;
 }
 
+picture_pool_t *vout_GetDirectPool(vout_display_t *vd,
+                                   const video_format_t *fmt, unsigned count)
+{
+    if (vd->ops->pool == NULL || vout_IsDisplayFiltered(vd))
+        return NULL;
+    if (fmt->i_chroma != vd->fmt->i_chroma
+     || fmt->i_width != vd->fmt->i_width
+     || fmt->i_height != vd->fmt->i_height)
+        return NULL;
+
+    return vd->ops->pool(vd, count);
+}
+
 bool vout_IsDisplayFiltered(vout_display_t *vd)
 {
     vout_display_priv_t *osys = container_of(vd, vout_display_priv_t, display);
@@ -23,6 +23,7 @@
 #ifndef LIBVLC_VOUT_STATISTIC_H
 # define LIBVLC_VOUT_STATISTIC_H
 # include <stdatomic.h>
+# include "../input/input_internal.h"
 
 /* NOTE: Both statistics are atomic on their own, so one might be older than
  * the other one. Currently, only one of them is updated at a time, so this
@@ -31,6 +32,8 @@ typedef struct {
     atomic_uint displayed;
     atomic_uint lost;
     atomic_uint late;
+    input_latency_t filter; /* time spent in the filter chains */
+    input_latency_t slack; /* time left before the display deadline */
 } vout_statistic_t;
 
 static inline void vout_statistic_Init(vout_statistic_t *stat)
@@ -38,6 +41,8 @@ static inline void vout_statistic_Init(vout_statistic_t *stat)
     atomic_init(&stat->displayed, 0);
     atomic_init(&stat->lost, 0);
     atomic_init(&stat->late, 0);
+    input_latency_Init(&stat->filter);
+    input_latency_Init(&stat->slack);
 }
 
 static inline void vout_statistic_Clean(vout_statistic_t *stat)
@@ -56,6 +61,13 @@ static inline void vout_statistic_GetReset(vout_statistic_t *stat,
     *late = atomic_exchange_explicit(&stat->late, 0, memory_order_relaxed);
 }
 
+static inline void vout_statistic_GetResetLatency(vout_statistic_t *stat,
+                                                  struct input_es_latency *es)
+{
+    input_latency_Merge(&es->stages[VLC_LATENCY_FILTER], &stat->filter);
+    input_latency_Merge(&es->stages[VLC_LATENCY_DISPLAY_SLACK], &stat->slack);
+}
+
 static inline void vout_statistic_AddDisplayed(vout_statistic_t *stat,
                                                int displayed)
 {
@@ -73,4 +85,16 @@ static inline void vout_statistic_AddLate(vout_statistic_t *stat, int late)
     atomic_fetch_add_explicit(&stat->late, late, memory_order_relaxed);
 }
 
+static inline void vout_statistic_AddFilter(vout_statistic_t *stat,
+                                            vlc_tick_t duration)
+{
+    input_latency_Add(&stat->filter, duration);
+}
+
+static inline void vout_statistic_AddSlack(vout_statistic_t *stat,
+                                           vlc_tick_t slack)
+{
+    input_latency_Add(&stat->slack, slack);
+}
+
 #endif
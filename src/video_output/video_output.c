@@ -354,6 +354,14 @@ void vout_GetResetStatistic(vout_thread_t *vout, unsigned *restrict displayed,
     vout_statistic_GetReset( &sys->statistic, displayed, lost, late );
 }
 
+void vout_GetResetLatency(vout_thread_t *vout,
+                          struct input_es_latency *latency)
+{
+    vout_thread_sys_t *sys = VOUT_THREAD_TO_SYS(vout);
+    assert(!sys->dummy);
+    vout_statistic_GetResetLatency(&sys->statistic, latency);
+}
+
 bool vout_IsEmpty(vout_thread_t *vout)
 {
     vout_thread_sys_t *sys = VOUT_THREAD_TO_SYS(vout);
@@ -479,6 +487,20 @@ picture_t *vout_GetPicture(vout_thread_t *vout)
     return picture;
 }
 
+picture_pool_t *vout_GetDecoderPool(vout_thread_t *vout,
+                                    const video_format_t *fmt, unsigned count)
+{
+    vout_thread_sys_t *sys = VOUT_THREAD_TO_SYS(vout);
+    picture_pool_t *pool = NULL;
+    assert(!sys->dummy);
+
+    vlc_mutex_lock(&sys->display_lock);
+    if (sys->display != NULL)
+        pool = vout_GetDirectPool(sys->display, fmt, count);
+    vlc_mutex_unlock(&sys->display_lock);
+    return pool;
+}
+
 /**
  * It gives to the vout a picture to be displayed.
  *
@@ -1140,7 +1162,9 @@ static picture_t *ThreadDisplayPreparePicture(vout_thread_sys_t *vout, bool reus
         sys->displayed.timestamp     = decoded->date;
         sys->displayed.is_interlaced = !decoded->b_progressive;
 
+        vlc_tick_t start = vlc_tick_now();
         picture = filter_chain_VideoFilter(sys->filter.chain_static, sys->displayed.decoded);
+        vout_statistic_AddFilter(&sys->statistic, vlc_tick_now() - start);
     }
 
     vlc_mutex_unlock(&sys->filter.lock);
@@ -1222,8 +1246,11 @@ static int ThreadDisplayRenderPicture(vout_thread_sys_t *vout, bool render_now)
     vout_chrono_Start(&sys->render);
 
     vlc_mutex_lock(&sys->filter.lock);
+    vlc_tick_t start = vlc_tick_now();
     picture_t *filtered = filter_chain_VideoFilter(sys->filter.chain_interactive, sys->displayed.current);
+    vlc_tick_t end = vlc_tick_now();
     vlc_mutex_unlock(&sys->filter.lock);
+    vout_statistic_AddFilter(&sys->statistic, end - start);
 
     if (!filtered)
         return VLC_EGENERIC;
@@ -1416,6 +1443,8 @@ static int ThreadDisplayRenderPicture(vout_thread_sys_t *vout, bool render_now)
     system_now = vlc_tick_now();
     if (!render_now)
     {
+        vout_statistic_AddSlack(&sys->statistic, system_pts - system_now);
+
         if (unlikely(system_now > system_pts))
         {
             /* vd->prepare took too much time. Tell the clock that the pts was
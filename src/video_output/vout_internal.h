@@ -92,6 +92,17 @@ void vout_Stop(vout_thread_t *);
  */
 void vout_StopDisplay(vout_thread_t *);
 
+/**
+ * Get pictures to decode into from the display, if it supports it.
+ *
+ * \param fmt the decoder output format
+ * \param count the number of pictures needed by the decoder
+ * \return a picture pool owned by the caller, or NULL if the decoder must
+ * allocate its own pictures
+ */
+picture_pool_t *vout_GetDecoderPool(vout_thread_t *, const video_format_t *fmt,
+                                    unsigned count);
+
 /**
  * Set the new source format for a started vout
  *
@@ -186,6 +197,15 @@ void vout_MouseState(vout_thread_t *, const vlc_mouse_t *);
 void vout_GetResetStatistic( vout_thread_t *p_vout, unsigned *pi_displayed,
                              unsigned *pi_lost, unsigned *pi_late );
 
+struct input_es_latency;
+
+/**
+ * This function will move the latency statistics (filtering and display
+ * slack) to the given ES latency instrumentation.
+ */
+void vout_GetResetLatency( vout_thread_t *p_vout,
+                           struct input_es_latency *latency );
+
 /**
  * This function will force to display the next picture while paused
  */
@@ -77,6 +77,37 @@ typedef struct VLC_VECTOR(struct spu_channel) spu_channel_vector;
 typedef struct VLC_VECTOR(subpicture_t *) spu_prerender_vector;
 #define SPU_CHROMALIST_COUNT 8
 
+/* Rendered text region, reused by regions with the same text and layout */
+#define SPU_CACHE_SIZE 16
+typedef struct {
+    /* Key */
+    text_segment_t *text;                 /* copy of the source text */
+    int x;
+    int y;
+    int align;
+    int text_align;
+    int max_width;
+    int max_height;
+    bool noregionbg;
+    bool gridmode;
+    bool balanced_text;
+    int original_width;
+    int original_height;
+    int text_scale;
+    vlc_fourcc_t chroma_list[SPU_CHROMALIST_COUNT+1];
+
+    /* Rendered region */
+    video_format_t fmt;
+    picture_t *picture;
+    int out_x;
+    int out_y;
+
+    /* Last conversion/scaling of the rendered picture */
+    subpicture_region_private_t *scaled;
+
+    uint64_t last_use;
+} spu_cache_entry_t;
+
 struct spu_private_t {
     vlc_mutex_t  lock;            /* lock to protect all followings fields */
     input_thread_t *input;
@@ -126,9 +157,20 @@ struct spu_private_t {
         video_format_t  fmtsrc;
         video_format_t  fmtdst;
         vlc_fourcc_t    chroma_list[SPU_CHROMALIST_COUNT+1];
+        bool            external_scale;
+        filter_t       *scale_yuvp;
+        filter_t       *scale;
         bool            live;
     } prerender;
 
+    /* Rendered text regions, shared by the vout and prerendering threads */
+    struct
+    {
+        vlc_mutex_t       lock;
+        spu_cache_entry_t entries[SPU_CACHE_SIZE];
+        uint64_t          date;
+    } cache;
+
     /* */
     vlc_tick_t          last_sort_date;
     vout_thread_t       *vout;
@@ -314,6 +356,197 @@ static filter_t *SpuRenderCreateAndLoadScale(vlc_object_t *object,
     return scale;
 }
 
+static bool StringIsEqual(const char *s0, const char *s1)
+{
+    if (s0 == NULL || s1 == NULL)
+        return s0 == s1;
+    return !strcmp(s0, s1);
+}
+
+static bool TextStyleIsEqual(const text_style_t *s0, const text_style_t *s1)
+{
+    if (s0 == NULL || s1 == NULL)
+        return s0 == s1;
+    return StringIsEqual(s0->psz_fontname, s1->psz_fontname) &&
+           StringIsEqual(s0->psz_monofontname, s1->psz_monofontname) &&
+           s0->i_features == s1->i_features &&
+           s0->i_style_flags == s1->i_style_flags &&
+           s0->f_font_relsize == s1->f_font_relsize &&
+           s0->i_font_size == s1->i_font_size &&
+           s0->i_font_color == s1->i_font_color &&
+           s0->i_font_alpha == s1->i_font_alpha &&
+           s0->i_spacing == s1->i_spacing &&
+           s0->i_outline_color == s1->i_outline_color &&
+           s0->i_outline_alpha == s1->i_outline_alpha &&
+           s0->i_outline_width == s1->i_outline_width &&
+           s0->i_shadow_color == s1->i_shadow_color &&
+           s0->i_shadow_alpha == s1->i_shadow_alpha &&
+           s0->i_shadow_width == s1->i_shadow_width &&
+           s0->i_background_color == s1->i_background_color &&
+           s0->i_background_alpha == s1->i_background_alpha &&
+           s0->e_wrapinfo == s1->e_wrapinfo;
+}
+
+static bool TextSegmentsAreEqual(const text_segment_t *s0,
+                                 const text_segment_t *s1)
+{
+    for (; s0 != NULL && s1 != NULL; s0 = s0->p_next, s1 = s1->p_next)
+    {
+        if (!StringIsEqual(s0->psz_text, s1->psz_text) ||
+            !TextStyleIsEqual(s0->style, s1->style))
+            return false;
+
+        const text_segment_ruby_t *r0 = s0->p_ruby, *r1 = s1->p_ruby;
+        for (; r0 != NULL && r1 != NULL; r0 = r0->p_next, r1 = r1->p_next)
+            if (!StringIsEqual(r0->psz_base, r1->psz_base) ||
+                !StringIsEqual(r0->psz_rt, r1->psz_rt))
+                return false;
+        if (r0 != r1)
+            return false;
+    }
+    return s0 == s1;
+}
+
+static void SpuCacheEntryClean(spu_cache_entry_t *entry)
+{
+    if (entry->text == NULL)
+        return;
+    text_segment_ChainDelete(entry->text);
+    entry->text = NULL;
+    video_format_Clean(&entry->fmt);
+    picture_Release(entry->picture);
+    if (entry->scaled)
+        subpicture_region_private_Delete(entry->scaled);
+    entry->scaled = NULL;
+}
+
+static void SpuCacheFlush(spu_private_t *sys)
+{
+    vlc_mutex_lock(&sys->cache.lock);
+    for (size_t i = 0; i < SPU_CACHE_SIZE; i++)
+        SpuCacheEntryClean(&sys->cache.entries[i]);
+    vlc_mutex_unlock(&sys->cache.lock);
+}
+
+static subpicture_region_private_t *
+SpuRegionPrivateDuplicate(const subpicture_region_private_t *src)
+{
+    subpicture_region_private_t *dst =
+        subpicture_region_private_New((video_format_t *)&src->fmt);
+    if (dst)
+        dst->p_picture = picture_Hold(src->p_picture);
+    return dst;
+}
+
+/**
+ * Looks up a text region with the same text and layout in the cache.
+ *
+ * On success, the region is updated as if it was rendered by the text
+ * renderer, and gets the last conversion of the rendered picture if any.
+ * The cache lock must be held.
+ */
+static bool SpuCacheGetText(spu_private_t *sys, const spu_cache_entry_t *key,
+                            subpicture_region_t *region)
+{
+    for (size_t i = 0; i < SPU_CACHE_SIZE; i++)
+    {
+        spu_cache_entry_t *entry = &sys->cache.entries[i];
+
+        if (entry->text == NULL ||
+            entry->x != key->x || entry->y != key->y ||
+            entry->align != key->align ||
+            entry->text_align != key->text_align ||
+            entry->max_width != key->max_width ||
+            entry->max_height != key->max_height ||
+            entry->noregionbg != key->noregionbg ||
+            entry->gridmode != key->gridmode ||
+            entry->balanced_text != key->balanced_text ||
+            entry->original_width != key->original_width ||
+            entry->original_height != key->original_height ||
+            entry->text_scale != key->text_scale ||
+            memcmp(entry->chroma_list, key->chroma_list,
+                   sizeof (key->chroma_list)) ||
+            !TextSegmentsAreEqual(entry->text, region->p_text))
+            continue;
+
+        video_format_t fmt;
+        if (video_format_Copy(&fmt, &entry->fmt) != VLC_SUCCESS)
+            return false;
+        video_format_Clean(&region->fmt);
+        region->fmt = fmt;
+        if (region->p_picture)
+            picture_Release(region->p_picture);
+        region->p_picture = picture_Hold(entry->picture);
+        region->i_x = entry->out_x;
+        region->i_y = entry->out_y;
+
+        if (region->p_private)
+            subpicture_region_private_Delete(region->p_private);
+        region->p_private = entry->scaled ?
+                            SpuRegionPrivateDuplicate(entry->scaled) : NULL;
+
+        entry->last_use = ++sys->cache.date;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Stores a rendered text region in the cache, replacing the least recently
+ * used entry. The cache lock must be held.
+ */
+static void SpuCachePutText(spu_private_t *sys, const spu_cache_entry_t *key,
+                            const subpicture_region_t *region)
+{
+    spu_cache_entry_t *entry = &sys->cache.entries[0];
+    for (size_t i = 1; i < SPU_CACHE_SIZE && entry->text != NULL; i++)
+        if (sys->cache.entries[i].text == NULL ||
+            sys->cache.entries[i].last_use < entry->last_use)
+            entry = &sys->cache.entries[i];
+    SpuCacheEntryClean(entry);
+
+    text_segment_t *text = text_segment_Copy(region->p_text);
+    if (text == NULL)
+        return;
+
+    *entry = *key;
+    if (video_format_Copy(&entry->fmt, &region->fmt) != VLC_SUCCESS)
+    {
+        text_segment_ChainDelete(text);
+        entry->text = NULL;
+        return;
+    }
+    entry->text = text;
+    entry->picture = picture_Hold(region->p_picture);
+    entry->out_x = region->i_x;
+    entry->out_y = region->i_y;
+    entry->scaled = NULL;
+    entry->last_use = ++sys->cache.date;
+}
+
+/**
+ * Remembers the conversion of a rendered text region, so that the next
+ * regions with the same text do not need to be converted again.
+ */
+static void SpuCachePutScaled(spu_private_t *sys,
+                              const subpicture_region_t *region)
+{
+    vlc_mutex_lock(&sys->cache.lock);
+    for (size_t i = 0; i < SPU_CACHE_SIZE; i++)
+    {
+        spu_cache_entry_t *entry = &sys->cache.entries[i];
+
+        if (entry->text == NULL || entry->picture != region->p_picture)
+            continue;
+
+        if (entry->scaled)
+            subpicture_region_private_Delete(entry->scaled);
+        entry->scaled = SpuRegionPrivateDuplicate(region->p_private);
+        break;
+    }
+    vlc_mutex_unlock(&sys->cache.lock);
+}
+
 static int SpuRenderText(spu_t *spu,
                           subpicture_region_t *region,
                           int i_original_width,
@@ -331,6 +564,33 @@ static int SpuRenderText(spu_t *spu,
         return VLC_EGENERIC;
     }
 
+    spu_cache_entry_t key = {
+        .x = region->i_x,
+        .y = region->i_y,
+        .align = region->i_align,
+        .text_align = region->i_text_align,
+        .max_width = region->i_max_width,
+        .max_height = region->i_max_height,
+        .noregionbg = region->b_noregionbg,
+        .gridmode = region->b_gridmode,
+        .balanced_text = region->b_balanced_text,
+        .original_width = i_original_width,
+        .original_height = i_original_height,
+        .text_scale = var_InheritInteger(text, "sub-text-scale"),
+    };
+    for (size_t i = 0; i < SPU_CHROMALIST_COUNT && chroma_list[i]; i++)
+        key.chroma_list[i] = chroma_list[i];
+
+    vlc_mutex_lock(&sys->cache.lock);
+    bool cached = region->p_text != NULL &&
+                  SpuCacheGetText(sys, &key, region);
+    vlc_mutex_unlock(&sys->cache.lock);
+    if (cached)
+    {
+        vlc_mutex_unlock(&sys->textlock);
+        return VLC_SUCCESS;
+    }
+
     // assume rendered text is in sRGB if nothing is set
     if (region->fmt.transfer == TRANSFER_FUNC_UNDEF)
         region->fmt.transfer = TRANSFER_FUNC_SRGB;
@@ -350,6 +610,14 @@ static int SpuRenderText(spu_t *spu,
 
     int i_ret = text->ops->render(text, region, region, chroma_list);
 
+    if (i_ret == VLC_SUCCESS && region->p_text != NULL &&
+        region->p_picture != NULL && region->fmt.i_chroma != VLC_CODEC_TEXT)
+    {
+        vlc_mutex_lock(&sys->cache.lock);
+        SpuCachePutText(sys, &key, region);
+        vlc_mutex_unlock(&sys->cache.lock);
+    }
+
     vlc_mutex_unlock(&sys->textlock);
     return i_ret;
 }
@@ -785,6 +1053,119 @@ spu_SelectSubpictures(spu_t *spu, vlc_tick_t system_now,
 
 
 
+/**
+ * Computes the scaling of a region from the original picture size to the
+ * destination size.
+ */
+static spu_scale_t SpuRegionScale(const video_format_t *fmt_dst,
+                                  const subpicture_t *subpic,
+                                  const subpicture_region_t *region)
+{
+    /* Compute region scale AR */
+    unsigned sar_num = region->fmt.i_sar_num;
+    unsigned sar_den = region->fmt.i_sar_den;
+    if (sar_num <= 0 || sar_den <= 0) {
+
+        const uint64_t i_sar_num = (uint64_t)fmt_dst->i_visible_width  *
+                                   fmt_dst->i_sar_num * subpic->i_original_picture_height;
+        const uint64_t i_sar_den = (uint64_t)fmt_dst->i_visible_height *
+                                   fmt_dst->i_sar_den * subpic->i_original_picture_width;
+
+        vlc_ureduce(&sar_num, &sar_den, i_sar_num, i_sar_den, 65536);
+    }
+
+    /* Compute scaling from original size to destination size
+     * FIXME The current scaling ensure that the heights match, the width being
+     * cropped.
+     */
+    return spu_scale_createq((int64_t)fmt_dst->i_visible_height                 * fmt_dst->i_sar_den * sar_num,
+                             (int64_t)subpic->i_original_picture_height * fmt_dst->i_sar_num * sar_den,
+                             fmt_dst->i_visible_height,
+                             subpic->i_original_picture_height);
+}
+
+static bool SpuChromaIsSupported(const vlc_fourcc_t *chroma_list,
+                                 vlc_fourcc_t chroma)
+{
+    for (size_t i = 0; chroma_list[i]; i++)
+        if (chroma_list[i] == chroma)
+            return true;
+    return false;
+}
+
+/**
+ * Converts and/or scales the picture of a region to the given size and
+ * chroma, with the given filters.
+ */
+static subpicture_region_private_t *SpuConvertRegion(vlc_object_t *obj,
+                                                     filter_t *scale,
+                                                     filter_t *scale_yuvp,
+                                                     const subpicture_region_t *region,
+                                                     unsigned dst_width,
+                                                     unsigned dst_height,
+                                                     vlc_fourcc_t dst_chroma,
+                                                     bool convert_chroma)
+{
+    const bool using_palette = region->fmt.i_chroma == VLC_CODEC_YUVP;
+
+    picture_t *picture = region->p_picture;
+    picture_Hold(picture);
+
+    /* Convert YUVP to YUVA/RGBA first for better scaling quality */
+    if (using_palette) {
+        scale_yuvp->fmt_in.video = region->fmt;
+
+        scale_yuvp->fmt_out.video = region->fmt;
+        scale_yuvp->fmt_out.video.i_chroma = dst_chroma;
+
+        picture = scale_yuvp->ops->filter_video(scale_yuvp, picture);
+        assert(picture == NULL || !picture_HasChainedPics(picture)); // no chaining
+        if (!picture) {
+            /* Well we will try conversion+scaling */
+            msg_Warn(obj, "%4.4s to %4.4s conversion failed",
+                     (const char*)&scale_yuvp->fmt_in.video.i_chroma,
+                     (const char*)&scale_yuvp->fmt_out.video.i_chroma);
+        }
+    }
+
+    /* Conversion(except from YUVP)/Scaling */
+    if (picture &&
+        (picture->format.i_visible_width  != dst_width ||
+         picture->format.i_visible_height != dst_height ||
+         (convert_chroma && !using_palette)))
+    {
+        scale->fmt_in.video  = picture->format;
+        scale->fmt_out.video = picture->format;
+        if (using_palette)
+            scale->fmt_in.video.i_chroma = dst_chroma;
+        if (convert_chroma)
+            scale->fmt_out.i_codec        =
+            scale->fmt_out.video.i_chroma = dst_chroma;
+
+        scale->fmt_out.video.i_width  =
+        scale->fmt_out.video.i_visible_width = dst_width;
+        scale->fmt_out.video.i_height =
+        scale->fmt_out.video.i_visible_height = dst_height;
+
+        picture = scale->ops->filter_video(scale, picture);
+        assert(picture == NULL || !picture_HasChainedPics(picture)); // no chaining
+        if (!picture)
+            msg_Err(obj, "scaling failed");
+    }
+
+    if (!picture)
+        return NULL;
+
+    subpicture_region_private_t *private =
+        subpicture_region_private_New(&picture->format);
+    if (!private) {
+        picture_Release(picture);
+        return NULL;
+    }
+    private->p_picture = picture;
+    return private;
+}
+
 /**
  * It will transform the provided region into another region suitable for rendering.
  */
@@ -950,11 +1331,8 @@ static void SpuRenderRegion(spu_t *spu,
     region_fmt = region->fmt;
     region_picture = region->p_picture;
 
-    bool convert_chroma = true;
-    for (int i = 0; chroma_list[i] && convert_chroma; i++) {
-        if (region_fmt.i_chroma == chroma_list[i])
-            convert_chroma = false;
-    }
+    const bool convert_chroma = !SpuChromaIsSupported(chroma_list,
+                                                      region_fmt.i_chroma);
 
     /* Scale from rendered size to destination size */
     if (scale_size.w != SCALE_UNIT || scale_size.h != SCALE_UNIT || convert_chroma)
@@ -987,71 +1365,12 @@ static void SpuRenderRegion(spu_t *spu,
 
         /* Scale if needed into cache */
         if (!region->p_private && dst_width > 0 && dst_height > 0) {
-            filter_t *scale = sys->scale;
-
-            picture_t *picture = region->p_picture;
-            picture_Hold(picture);
-
-            /* Convert YUVP to YUVA/RGBA first for better scaling quality */
-            if (using_palette) {
-                filter_t *scale_yuvp = sys->scale_yuvp;
-
-                scale_yuvp->fmt_in.video = region->fmt;
-
-                scale_yuvp->fmt_out.video = region->fmt;
-                scale_yuvp->fmt_out.video.i_chroma = chroma_list[0];
-
-                picture = scale_yuvp->ops->filter_video(scale_yuvp, picture);
-                assert(picture == NULL || !picture_HasChainedPics(picture)); // no chaining
-                if (!picture) {
-                    /* Well we will try conversion+scaling */
-                    msg_Warn(spu, "%4.4s to %4.4s conversion failed",
-                             (const char*)&scale_yuvp->fmt_in.video.i_chroma,
-                             (const char*)&scale_yuvp->fmt_out.video.i_chroma);
-                }
-            }
-
-            /* Conversion(except from YUVP)/Scaling */
-            if (picture &&
-                (picture->format.i_visible_width  != dst_width ||
-                 picture->format.i_visible_height != dst_height ||
-                 (convert_chroma && !using_palette)))
-            {
-                scale->fmt_in.video  = picture->format;
-                scale->fmt_out.video = picture->format;
-                if (using_palette)
-                    scale->fmt_in.video.i_chroma = chroma_list[0];
-                if (convert_chroma)
-                    scale->fmt_out.i_codec        =
-                    scale->fmt_out.video.i_chroma = chroma_list[0];
-
-                scale->fmt_out.video.i_width  = dst_width;
-                scale->fmt_out.video.i_height = dst_height;
-
-                scale->fmt_out.video.i_visible_width =
-                    spu_scale_w(region->fmt.i_visible_width, scale_size);
-                scale->fmt_out.video.i_visible_height =
-                    spu_scale_h(region->fmt.i_visible_height, scale_size);
-
-                picture = scale->ops->filter_video(scale, picture);
-                assert(picture == NULL || !picture_HasChainedPics(picture)); // no chaining
-                if (!picture)
-                    msg_Err(spu, "scaling failed");
-            }
-
-            /* */
-            if (picture) {
-                region->p_private = subpicture_region_private_New(&picture->format);
-                if (region->p_private) {
-                    region->p_private->p_picture = picture;
-                    if (!region->p_private->p_picture) {
-                        subpicture_region_private_Delete(region->p_private);
-                        region->p_private = NULL;
-                    }
-                } else {
-                    picture_Release(picture);
-                }
-            }
+            region->p_private = SpuConvertRegion(VLC_OBJECT(spu), sys->scale,
+                                                 sys->scale_yuvp, region,
+                                                 dst_width, dst_height,
+                                                 chroma_list[0], convert_chroma);
+            if (region->p_private && region->p_text)
+                SpuCachePutScaled(sys, region);
         }
 
         /* And use the scaled picture */
@@ -1211,27 +1530,7 @@ static subpicture_t *SpuRenderSubpictures(spu_t *spu,
         for (region = subpic->p_region; region != NULL; region = region->p_next) {
             spu_area_t area;
 
-            /* Compute region scale AR */
-            video_format_t region_fmt = region->fmt;
-            if (region_fmt.i_sar_num <= 0 || region_fmt.i_sar_den <= 0) {
-
-                const uint64_t i_sar_num = (uint64_t)fmt_dst->i_visible_width  *
-                                           fmt_dst->i_sar_num * subpic->i_original_picture_height;
-                const uint64_t i_sar_den = (uint64_t)fmt_dst->i_visible_height *
-                                           fmt_dst->i_sar_den * subpic->i_original_picture_width;
-
-                vlc_ureduce(&region_fmt.i_sar_num, &region_fmt.i_sar_den,
-                            i_sar_num, i_sar_den, 65536);
-            }
-
-            /* Compute scaling from original size to destination size
-             * FIXME The current scaling ensure that the heights match, the width being
-             * cropped.
-             */
-            spu_scale_t scale = spu_scale_createq((int64_t)fmt_dst->i_visible_height                 * fmt_dst->i_sar_den * region_fmt.i_sar_num,
-                                                  (int64_t)subpic->i_original_picture_height * fmt_dst->i_sar_num * region_fmt.i_sar_den,
-                                                  fmt_dst->i_visible_height,
-                                                  subpic->i_original_picture_height);
+            spu_scale_t scale = SpuRegionScale(fmt_dst, subpic, region);
 
             /* Check scale validity */
             if (scale.w <= 0 || scale.h <= 0)
@@ -1413,9 +1712,11 @@ static int SubSourceDelProxyCallbacks(filter_t *filter, void *opaque)
 static void spu_PrerenderWake(spu_private_t *sys,
                               const video_format_t *fmt_dst,
                               const video_format_t *fmt_src,
-                              const vlc_fourcc_t *chroma_list)
+                              const vlc_fourcc_t *chroma_list,
+                              bool external_scale)
 {
     vlc_mutex_lock(&sys->prerender.lock);
+    sys->prerender.external_scale = external_scale;
     if(!video_format_IsSimilar(fmt_dst, &sys->prerender.fmtdst))
     {
         video_format_Clean(&sys->prerender.fmtdst);
@@ -1516,6 +1817,55 @@ static void spu_PrerenderText(spu_t *spu, subpicture_t *p_subpic,
     }
 }
 
+/**
+ * Converts and scales the regions of a subpicture for the current output,
+ * so that the vout thread only has to blend them.
+ */
+static void spu_PrerenderScale(spu_t *spu, subpicture_t *p_subpic,
+                               const video_format_t *fmtdst,
+                               const vlc_fourcc_t *chroma_list,
+                               bool external_scale)
+{
+    spu_private_t *sys = spu->p;
+
+    if (!sys->prerender.scale || !sys->prerender.scale_yuvp ||
+        fmtdst->i_visible_width == 0 || fmtdst->i_visible_height == 0)
+        return;
+
+    subpicture_region_t *region;
+    for (region = p_subpic->p_region; region != NULL; region = region->p_next)
+    {
+        if (region->p_private || !region->p_picture ||
+            region->fmt.i_chroma == VLC_CODEC_TEXT)
+            continue;
+
+        video_format_AdjustColorSpace(&region->fmt);
+
+        spu_scale_t scale = external_scale ? spu_scale_unit()
+                          : SpuRegionScale(fmtdst, p_subpic, region);
+        if (scale.w <= 0 || scale.h <= 0)
+            continue;
+
+        const bool convert_chroma = !SpuChromaIsSupported(chroma_list,
+                                                          region->fmt.i_chroma);
+        if (scale.w == SCALE_UNIT && scale.h == SCALE_UNIT && !convert_chroma)
+            continue;
+
+        const unsigned dst_width  = spu_scale_w(region->fmt.i_visible_width,  scale);
+        const unsigned dst_height = spu_scale_h(region->fmt.i_visible_height, scale);
+        if (dst_width == 0 || dst_height == 0)
+            continue;
+
+        region->p_private = SpuConvertRegion(VLC_OBJECT(spu),
+                                             sys->prerender.scale,
+                                             sys->prerender.scale_yuvp,
+                                             region, dst_width, dst_height,
+                                             chroma_list[0], convert_chroma);
+        if (region->p_private && region->p_text)
+            SpuCachePutScaled(sys, region);
+    }
+}
+
 static void * spu_PrerenderThread(void *priv)
 {
     spu_t *spu = priv;
@@ -1547,14 +1897,18 @@ static void * spu_PrerenderThread(void *priv)
              }
         }
         vlc_vector_remove(&sys->prerender.vector, i_idx);
-        memcpy(chroma_list, sys->prerender.chroma_list, SPU_CHROMALIST_COUNT);
+        memcpy(chroma_list, sys->prerender.chroma_list,
+               SPU_CHROMALIST_COUNT * sizeof (*chroma_list));
         video_format_Copy(&fmtdst, &sys->prerender.fmtdst);
         video_format_Copy(&fmtsrc, &sys->prerender.fmtsrc);
+        const bool external_scale = sys->prerender.external_scale;
 
         vlc_mutex_unlock(&sys->prerender.lock);
 
         spu_PrerenderText(spu, sys->prerender.p_processed,
                           &fmtsrc, &fmtdst, chroma_list);
+        spu_PrerenderScale(spu, sys->prerender.p_processed,
+                           &fmtdst, chroma_list, external_scale);
 
         video_format_Clean(&fmtdst);
         video_format_Clean(&fmtsrc);
@@ -1585,6 +1939,12 @@ static void spu_Cleanup(spu_t *spu)
     if (sys->scale)
         FilterRelease(sys->scale);
 
+    if (sys->prerender.scale_yuvp)
+        FilterRelease(sys->prerender.scale_yuvp);
+
+    if (sys->prerender.scale)
+        FilterRelease(sys->prerender.scale);
+
     filter_chain_ForEach(sys->source_chain, SubSourceClean, spu);
     if (sys->vout)
         filter_chain_ForEach(sys->source_chain,
@@ -1608,6 +1968,8 @@ static void spu_Cleanup(spu_t *spu)
     vlc_vector_clear(&sys->prerender.vector);
     video_format_Clean(&sys->prerender.fmtdst);
     video_format_Clean(&sys->prerender.fmtsrc);
+
+    SpuCacheFlush(sys);
 }
 
 /**
@@ -1683,8 +2045,14 @@ spu_t *spu_Create(vlc_object_t *object, vout_thread_t *vout)
     sys->prerender.p_processed = NULL;
     sys->prerender.chroma_list[0] = 0;
     sys->prerender.chroma_list[SPU_CHROMALIST_COUNT] = 0;
+    sys->prerender.external_scale = false;
     sys->prerender.live = true;
 
+    vlc_mutex_init(&sys->cache.lock);
+    for (size_t i = 0; i < SPU_CACHE_SIZE; i++)
+        sys->cache.entries[i].text = NULL;
+    sys->cache.date = 0;
+
     /* Load text and scale module */
     sys->text = SpuRenderCreateAndLoadText(spu);
     vlc_mutex_init(&sys->textlock);
@@ -1699,6 +2067,12 @@ spu_t *spu_Create(vlc_object_t *object, vout_thread_t *vout)
     sys->scale_yuvp = SpuRenderCreateAndLoadScale(VLC_OBJECT(spu),
                                                   VLC_CODEC_YUVP, VLC_CODEC_YUVA, false);
 
+    /* Same converters for the prerendering thread, which converts and scales
+     * the regions before they are displayed. They are optional. */
+    sys->prerender.scale = SpuRenderCreateAndLoadScale(VLC_OBJECT(spu),
+                                                       VLC_CODEC_YUVA, VLC_CODEC_RGBA, true);
+    sys->prerender.scale_yuvp = SpuRenderCreateAndLoadScale(VLC_OBJECT(spu),
+                                                            VLC_CODEC_YUVP, VLC_CODEC_YUVA, false);
 
     if (!sys->source_chain || !sys->filter_chain || !sys->text || !sys->scale
      || !sys->scale_yuvp)
@@ -1737,6 +2111,8 @@ void spu_Attach(spu_t *spu, input_thread_t *input)
         if (spu->p->text)
             FilterRelease(spu->p->text);
         spu->p->text = SpuRenderCreateAndLoadText(spu);
+        /* The fonts may come from the input attachments */
+        SpuCacheFlush(spu->p);
         vlc_mutex_unlock(&spu->p->textlock);
     }
     vlc_mutex_unlock(&spu->p->lock);
@@ -1945,7 +2321,7 @@ subpicture_t *spu_Render(spu_t *spu,
                                                           : chroma_list_default_rgb;
 
     /* wake up prerenderer, we have some video size and chroma */
-    spu_PrerenderWake(sys, fmt_dst, fmt_src, chroma_list);
+    spu_PrerenderWake(sys, fmt_dst, fmt_src, chroma_list, external_scale);
 
     vlc_mutex_lock(&sys->lock);
 
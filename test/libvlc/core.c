@@ -96,6 +96,22 @@ static void test_audio_output (void)
     libvlc_release (vlc);
 }
 
+static void test_memory_usage (void)
+{
+    size_t current, peak;
+
+    test_log ("Testing libvlc_memory_usage_get()\n");
+
+    for (int type = libvlc_memory_decoder; type <= libvlc_memory_adaptive;
+         type++)
+    {
+        assert (libvlc_memory_usage_get (type, &current, &peak) == 0);
+        assert (current <= peak);
+    }
+    assert (libvlc_memory_usage_get (libvlc_memory_adaptive + 1,
+                                     &current, &peak) == -1);
+}
+
 int main (void)
 {
     test_init();
@@ -103,6 +119,7 @@ int main (void)
     test_core (test_defaults_args, test_defaults_nargs);
     test_audiovideofilterlists (test_defaults_args, test_defaults_nargs);
     test_audio_output ();
+    test_memory_usage ();
 
     return 0;
 }
@@ -0,0 +1,326 @@
+/*****************************************************************************
+ * livehttp.c: HTTP live streaming output test
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/* Feeds fragmented MP4 to the livehttp output serving LL-HLS from memory, and
+ * checks the partial segments and preload hints of the playlist, the blocking
+ * playlist reloads (_HLS_msn/_HLS_part), the blocking preload hint requests,
+ * and the eviction of the old segments. */
+
+#include "../../libvlc/test.h"
+#include "../../../lib/libvlc_internal.h"
+
+#include <vlc_common.h>
+#include <vlc_block.h>
+#include <vlc_sout.h>
+
+#include <string.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#define PART_MS     250
+#define MOOF_SIZE   100
+#define MDAT_SIZE   900 /* including its header */
+#define NUMSEGS     2
+
+static unsigned port;
+static vlc_tick_t written; /**< duration of the fragments written */
+
+static unsigned FreePort( void )
+{
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_addr.s_addr = htonl( INADDR_LOOPBACK ),
+    };
+    socklen_t len = sizeof (addr);
+
+    int fd = socket( AF_INET, SOCK_STREAM, 0 );
+    assert( fd != -1 );
+    int ret = bind( fd, (struct sockaddr *)&addr, sizeof (addr) );
+    assert( ret == 0 );
+    ret = getsockname( fd, (struct sockaddr *)&addr, &len );
+    assert( ret == 0 );
+    close( fd );
+    return ntohs( addr.sin_port );
+}
+
+/* Sends a request, the answer is read with Answer() */
+static int Request( const char *path, const char *range )
+{
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons( port ),
+        .sin_addr.s_addr = htonl( INADDR_LOOPBACK ),
+    };
+
+    int fd = socket( AF_INET, SOCK_STREAM, 0 );
+    assert( fd != -1 );
+    int ret = connect( fd, (struct sockaddr *)&addr, sizeof (addr) );
+    assert( ret == 0 );
+
+    char req[256];
+    int len = snprintf( req, sizeof (req), "GET %s HTTP/1.1\r\n"
+                        "Host: 127.0.0.1\r\nConnection: close\r\n%s%s%s\r\n",
+                        path, range ? "Range: bytes=" : "", range ? range : "",
+                        range ? "\r\n" : "" );
+    assert( len > 0 && (size_t)len < sizeof (req) );
+    ret = send( fd, req, len, 0 );
+    assert( ret == len );
+    return fd;
+}
+
+/* Whether the answer is still blocked by the server */
+static bool Blocked( int fd )
+{
+    struct pollfd ufd = { .fd = fd, .events = POLLIN };
+    return poll( &ufd, 1, 300 ) == 0;
+}
+
+/* Reads the whole answer, returns its status, and its body in *body */
+static int Answer( int fd, char **body, size_t *size )
+{
+    char *buf = NULL;
+    size_t len = 0;
+
+    for( ;; )
+    {
+        buf = realloc( buf, len + 4097 );
+        assert( buf != NULL );
+        ssize_t val = recv( fd, buf + len, 4096, 0 );
+        assert( val >= 0 );
+        if( val == 0 )
+            break;
+        len += val;
+    }
+    close( fd );
+    buf[len] = '\0';
+
+    int status;
+    int ret = sscanf( buf, "HTTP/1.%*u %d", &status );
+    assert( ret == 1 );
+    char *data = strstr( buf, "\r\n\r\n" );
+    assert( data != NULL );
+    data += 4;
+
+    *size = len - ( data - buf );
+    *body = malloc( *size + 1 );
+    assert( *body != NULL );
+    memcpy( *body, data, *size + 1 );
+    free( buf );
+    return status;
+}
+
+static int Get( const char *path, const char *range, char **body,
+                size_t *size )
+{
+    return Answer( Request( path, range ), body, size );
+}
+
+static char *Playlist( const char *path )
+{
+    char *body;
+    size_t size;
+    int status = Get( path, NULL, &body, &size );
+    assert( status == 200 );
+    return body;
+}
+
+/* Writes a block starting with a box header, of the given box size */
+static void WriteBlock( sout_access_out_t *access, const char *type,
+                        size_t size, size_t boxsize, uint32_t flags,
+                        vlc_tick_t length )
+{
+    block_t *block = block_Alloc( size );
+    assert( block != NULL );
+    memset( block->p_buffer, written / VLC_TICK_FROM_MS(PART_MS), size );
+    SetDWBE( block->p_buffer, boxsize );
+    memcpy( &block->p_buffer[4], type, 4 );
+    block->i_flags = flags;
+    block->i_dts = VLC_TICK_0 + written;
+    block->i_length = length;
+    ssize_t ret = sout_AccessOutWrite( access, block );
+    assert( ret >= 0 );
+}
+
+/* Writes a fragment, as written by the mp4 muxer, which is a part on its own:
+ * its payload bytes are its number */
+static void WriteFragment( sout_access_out_t *access, bool independent )
+{
+    const vlc_tick_t length = VLC_TICK_FROM_MS(PART_MS);
+
+    WriteBlock( access, "moof", MOOF_SIZE, MOOF_SIZE,
+                independent ? BLOCK_FLAG_TYPE_I : BLOCK_FLAG_TYPE_P, length );
+    WriteBlock( access, "mdat", 8, MDAT_SIZE, 0, 0 );
+    block_t *data = block_Alloc( MDAT_SIZE - 8 );
+    assert( data != NULL );
+    memset( data->p_buffer, written / length, data->i_buffer );
+    data->i_dts = VLC_TICK_0 + written;
+    ssize_t ret = sout_AccessOutWrite( access, data );
+    assert( ret >= 0 );
+    written += length;
+}
+
+static unsigned Count( const char *text, const char *str )
+{
+    unsigned count = 0;
+    for( const char *p = text; ( p = strstr( p, str ) ) != NULL; p++ )
+        count++;
+    return count;
+}
+
+/* The value of a tag attribute of the last line starting with tag */
+static char *Attribute( const char *text, const char *tag, const char *name )
+{
+    const char *line = NULL;
+    for( const char *p = text; ( p = strstr( p, tag ) ) != NULL; p++ )
+        line = p;
+    assert( line != NULL );
+
+    size_t linelen = strcspn( line, "\n" );
+    size_t namelen = strlen( name );
+    for( const char *p = line; p < line + linelen; p++ )
+        if( !strncmp( p, name, namelen ) && p[namelen] == '=' &&
+            ( p[-1] == ',' || p[-1] == ':' ) )
+        {
+            p += namelen + 1;
+            if( *p == '"' )
+                p++;
+            return strndup( p, strcspn( p, "\",\n" ) );
+        }
+    assert( !"attribute not found" );
+    return NULL;
+}
+
+static sout_access_out_t *Create( vlc_object_t *obj, unsigned numsegs )
+{
+    char *config;
+    int ret = asprintf( &config, "livehttp{seglen=1,numsegs=%u,delsegs=false,"
+                        "part-length=%u,httpd,index=/live.m3u8,"
+                        "index-url=/seg-#.mp4}", numsegs, PART_MS );
+    assert( ret != -1 );
+    sout_access_out_t *access = sout_AccessOutNew( obj, config, "/seg-#.mp4" );
+    free( config );
+    return access;
+}
+
+int main( void )
+{
+    test_init();
+
+    port = FreePort();
+    char portarg[32];
+    sprintf( portarg, "--http-port=%u", port );
+
+    const char *argv[test_defaults_nargs + 2];
+    for( int i = 0; i < test_defaults_nargs; i++ )
+        argv[i] = test_defaults_args[i];
+    argv[test_defaults_nargs] = "--http-host=127.0.0.1";
+    argv[test_defaults_nargs + 1] = portarg;
+
+    libvlc_instance_t *vlc = libvlc_new( test_defaults_nargs + 2, argv );
+    assert( vlc != NULL );
+    vlc_object_t *obj = VLC_OBJECT(vlc->p_libvlc_int);
+
+    /* The segments served from memory must be limited */
+    assert( Create( obj, 0 ) == NULL );
+
+    sout_access_out_t *access = Create( obj, NUMSEGS );
+    assert( access != NULL );
+
+    WriteBlock( access, "ftyp", 24, 24, BLOCK_FLAG_HEADER, 0 );
+    WriteBlock( access, "moov", 200, 200, BLOCK_FLAG_HEADER, 0 );
+    WriteFragment( access, true );
+
+    char *text = Playlist( "/live.m3u8" );
+    assert( strstr( text, "#EXT-X-VERSION:9\n" ) != NULL );
+    assert( strstr( text, "#EXT-X-ALLOW-CACHE" ) == NULL );
+    assert( strstr( text, "#EXT-X-SERVER-CONTROL:CAN-BLOCK-RELOAD=YES,"
+                          "PART-HOLD-BACK=0.750\n" ) != NULL );
+    assert( strstr( text, "#EXT-X-PART-INF:PART-TARGET=0.250\n" ) != NULL );
+    assert( strstr( text, "#EXT-X-MAP:URI=" ) != NULL );
+    assert( strstr( text, "#EXT-X-MEDIA-SEQUENCE:1\n" ) != NULL );
+    assert( strstr( text, "#EXT-X-PART:DURATION=0.250,URI=\"/seg-1.mp4\","
+                          "BYTERANGE=1000@0,INDEPENDENT=YES\n" ) != NULL );
+    assert( strstr( text, "#EXT-X-PRELOAD-HINT:TYPE=PART,URI=\"/seg-1.mp4\","
+                          "BYTERANGE-START=1000\n" ) != NULL );
+    assert( Count( text, "#EXTINF" ) == 0 );
+    free( text );
+
+    /* The next part of the segment is not published yet */
+    int fd = Request( "/live.m3u8?_HLS_msn=1&_HLS_part=1", NULL );
+    assert( Blocked( fd ) );
+    /* Too far ahead */
+    char *body;
+    size_t size;
+    assert( Get( "/live.m3u8?_HLS_msn=4", NULL, &body, &size ) == 400 );
+    free( body );
+
+    /* The preload hint blocks until the part is available */
+    int hint = Request( "/seg-1.mp4", "1000-" );
+    assert( Blocked( hint ) );
+
+    WriteFragment( access, false );
+
+    assert( Answer( fd, &text, &size ) == 200 );
+    assert( Count( text, "#EXT-X-PART:" ) == 2 );
+    assert( strstr( text, "BYTERANGE=1000@1000\n" ) != NULL );
+    char *start = Attribute( text, "#EXT-X-PRELOAD-HINT", "BYTERANGE-START" );
+    assert( !strcmp( start, "2000" ) );
+    free( start );
+    free( text );
+
+    assert( Answer( hint, &body, &size ) == 206 );
+    assert( size == MOOF_SIZE + MDAT_SIZE );
+    assert( !memcmp( &body[4], "moof", 4 ) );
+    assert( body[size - 1] == 1 );
+    free( body );
+
+    /* Published parts are served right away */
+    assert( Get( "/seg-1.mp4", "0-999", &body, &size ) == 206 );
+    assert( size == MOOF_SIZE + MDAT_SIZE && body[size - 1] == 0 );
+    free( body );
+
+    /* Complete the first segment: waiting for the end of a segment */
+    fd = Request( "/live.m3u8?_HLS_msn=1", NULL );
+    assert( Blocked( fd ) );
+    for( unsigned i = 0; i < 3; i++ )
+        WriteFragment( access, true );
+    assert( Answer( fd, &text, &size ) == 200 );
+    /* Segments do not exceed the target duration */
+    assert( strstr( text, "#EXTINF:0.75,\n/seg-1.mp4\n" ) != NULL );
+    assert( strstr( text, "URI=\"/seg-2.mp4\",BYTERANGE=1000@0,"
+                          "INDEPENDENT=YES\n" ) != NULL );
+    free( text );
+
+    /* Old segments are removed from the playlist and from the server */
+    for( unsigned i = 0; i < 4 * ( NUMSEGS + 3 ); i++ )
+        WriteFragment( access, true );
+    text = Playlist( "/live.m3u8" );
+    assert( strstr( text, "#EXT-X-MEDIA-SEQUENCE:1\n" ) == NULL );
+    assert( strstr( text, "/seg-1.mp4\n" ) == NULL );
+    free( text );
+    assert( Get( "/seg-1.mp4", NULL, &body, &size ) == 404 );
+    free( body );
+
+    sout_AccessOutDelete( access );
+    libvlc_release( vlc );
+    return 0;
+}
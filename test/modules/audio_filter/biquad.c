@@ -0,0 +1,199 @@
+/*****************************************************************************
+ * biquad.c: multi-channel biquad filters test and benchmark
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/* Checks that the vector kernels give the same results as the scalar ones.
+ * When given a number of iterations, also compares their throughput. */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <vlc_common.h>
+#include <vlc_tick.h>
+#include "../../../modules/audio_filter/biquad.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+const char vlc_module_name[] = "test_biquad";
+
+#define SAMPLES 1024
+#define MAX_CHANNELS 9
+#define BANDS 5
+
+static float input[SAMPLES * MAX_CHANNELS];
+static float ref[SAMPLES * MAX_CHANNELS];
+static float output[SAMPLES * MAX_CHANNELS];
+
+/* Peaking sections, as computed by param_eq */
+static float coeffs[5 * 5];
+/* Band-pass sections, as computed by equalizer */
+static float alpha[BANDS], beta[BANDS], gamma_[BANDS], amp[BANDS];
+
+static void init_coeffs( void )
+{
+    for( unsigned s = 0; s < 5; s++ )
+    {
+        float w = 2.f * M_PI * (100.f * (s + 1) * (s + 1)) / 48000.f;
+        float a = sinf( w ) / 2.f;
+        float g = powf( 10.f, (s % 2 ? -6.f : 6.f) / 40.f );
+        float a0 = 1.f + a / g;
+
+        coeffs[5 * s + 0] = (1.f + a * g) / a0;
+        coeffs[5 * s + 1] = -2.f * cosf( w ) / a0;
+        coeffs[5 * s + 2] = (1.f - a * g) / a0;
+        coeffs[5 * s + 3] = -2.f * cosf( w ) / a0;
+        coeffs[5 * s + 4] = (1.f - a / g) / a0;
+    }
+
+    for( unsigned b = 0; b < BANDS; b++ )
+    {
+        alpha[b] = 0.003f * (b + 1);
+        beta[b] = 0.99f - 0.005f * b;
+        gamma_[b] = 1.98f - 0.01f * b;
+        amp[b] = (b % 3) ? 0.2f : -0.1f;
+    }
+}
+
+typedef void (*cascade_t)( biquad_t *, float *, const float *, unsigned,
+                           const float * );
+typedef void (*bank_t)( biquad_t *, float *, const float *, unsigned,
+                        const float *, const float *, const float *,
+                        const float *, float, float );
+
+static void run( biquad_t *bq, cascade_t cascade, bank_t bank, float *out )
+{
+    biquad_Reset( bq );
+    if( cascade != NULL )
+        /* In two halves, to check the history */
+        for( unsigned i = 0; i < 2; i++ )
+            cascade( bq, out + i * (SAMPLES / 2) * bq->channels,
+                     input + i * (SAMPLES / 2) * bq->channels, SAMPLES / 2,
+                     coeffs );
+    else
+        for( unsigned i = 0; i < 2; i++ )
+            bank( bq, out + i * (SAMPLES / 2) * bq->channels,
+                  input + i * (SAMPLES / 2) * bq->channels, SAMPLES / 2,
+                  alpha, beta, gamma_, amp, 0.25f, 1.5f );
+}
+
+static int compare( const char *name, unsigned channels )
+{
+    for( unsigned i = 0; i < SAMPLES * channels; i++ )
+        if( fabsf( output[i] - ref[i] ) > 1e-4f * (1.f + fabsf( ref[i] )) )
+        {
+            fprintf( stderr, "%s, %u channels: sample %u channel %u: "
+                     "%f instead of %f\n", name, channels, i / channels,
+                     i % channels, output[i], ref[i] );
+            return -1;
+        }
+    return 0;
+}
+
+static int check( unsigned channels )
+{
+    biquad_t bq;
+
+    if( biquad_Init( &bq, 5, channels ) )
+        return -1;
+
+    int ret = 0;
+    for( int topology = 0; topology < 2 && ret == 0; topology++ )
+    {
+        bool b_cascade = topology == 0;
+        const char *name = b_cascade ? "cascade" : "bank";
+
+        run( &bq, b_cascade ? biquad_Cascade_C : NULL,
+             b_cascade ? NULL : biquad_Bank_C, ref );
+#ifdef BIQUAD_HAS_VECTORSIZE
+        run( &bq, b_cascade ? biquad_Cascade_V4 : NULL,
+             b_cascade ? NULL : biquad_Bank_V4, output );
+        ret = compare( name, channels );
+#endif
+#ifdef BIQUAD_X86
+        if( ret == 0 && vlc_CPU_AVX() )
+        {
+            run( &bq, b_cascade ? biquad_Cascade_AVX : NULL,
+                 b_cascade ? NULL : biquad_Bank_AVX, output );
+            ret = compare( name, channels );
+        }
+#endif
+    }
+    biquad_Clean( &bq );
+    return ret;
+}
+
+static vlc_tick_t bench( biquad_t *bq, cascade_t cascade, bank_t bank,
+                         unsigned count )
+{
+    vlc_tick_t start = vlc_tick_now();
+
+    for( unsigned i = 0; i < count; i++ )
+        run( bq, cascade, bank, output );
+    return vlc_tick_now() - start;
+}
+
+int main( int argc, char *argv[] )
+{
+    unsigned count = argc > 1 ? strtoul( argv[1], NULL, 10 ) : 0;
+
+    srand( 0 );
+    for( size_t i = 0; i < ARRAY_SIZE(input); i++ )
+        input[i] = rand() / (float) RAND_MAX * 2.f - 1.f;
+    init_coeffs();
+
+    for( unsigned channels = 1; channels <= MAX_CHANNELS; channels++ )
+        if( check( channels ) )
+            return 1;
+
+    if( count == 0 )
+        return 0;
+
+    static const unsigned layouts[] = { 2, 6, 8 };
+    for( size_t i = 0; i < ARRAY_SIZE(layouts); i++ )
+    {
+        const unsigned channels = layouts[i];
+        biquad_t bq;
+
+        if( biquad_Init( &bq, 5, channels ) )
+            return 1;
+
+        for( int topology = 0; topology < 2; topology++ )
+        {
+            bool b_cascade = topology == 0;
+            double frames = (double) count * SAMPLES;
+            vlc_tick_t scalar = bench( &bq,
+                b_cascade ? biquad_Cascade_C : NULL,
+                b_cascade ? NULL : biquad_Bank_C, count );
+            vlc_tick_t best = bench( &bq,
+                b_cascade ? bq.cascade : NULL,
+                b_cascade ? NULL : bq.bank, count );
+
+            printf( "%u channels, %s: %.1f Mframes/s, best %.1f Mframes/s "
+                    "(x%.2f)\n", channels, b_cascade ? "cascade" : "bank",
+                    scalar ? frames / US_FROM_VLC_TICK( scalar ) : 0.,
+                    best ? frames / US_FROM_VLC_TICK( best ) : 0.,
+                    best ? (double) scalar / best : 0. );
+        }
+        biquad_Clean( &bq );
+    }
+    return 0;
+}
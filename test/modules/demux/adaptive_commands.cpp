@@ -0,0 +1,212 @@
+/*****************************************************************************
+ * adaptive_commands.cpp
+ *****************************************************************************
+ * Copyright (C) 2026 VideoLAN and VLC Authors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#undef NDEBUG
+
+#include "../modules/demux/adaptive/plumbing/CommandsQueue.cpp"
+
+#include <vector>
+#include <cassert>
+#include <vlc_common.h>
+#include <vlc_block.h>
+#include <vlc_memusage.h>
+
+using namespace adaptive;
+
+/* The queue only needs the real ES of the fake ones */
+FakeESOutID::FakeESOutID( FakeESOut *, const es_format_t * )
+{
+    fakeesout = nullptr;
+    p_real_es_id = nullptr;
+    pending_delete = false;
+}
+
+FakeESOutID::~FakeESOutID()
+{
+}
+
+void FakeESOutID::setRealESID( es_out_id_t *id )
+{
+    p_real_es_id = id;
+}
+
+es_out_id_t * FakeESOutID::realESID()
+{
+    return p_real_es_id;
+}
+
+void FakeESOutID::create()
+{
+}
+
+static unsigned released;
+
+void FakeESOutID::release()
+{
+    released++;
+}
+
+void FakeESOutID::notifyData()
+{
+}
+
+/* Records the dates of the blocks sent */
+static std::vector<vlc_tick_t> sent;
+
+static int Send( es_out_t *, es_out_id_t *, block_t *p_block )
+{
+    sent.push_back( p_block->i_dts );
+    block_Release( p_block );
+    return VLC_SUCCESS;
+}
+
+static const struct es_out_callbacks cbs =
+{
+    nullptr, Send, nullptr, nullptr, nullptr, nullptr,
+};
+
+static es_out_t out = { &cbs };
+static char realid;
+
+static block_t * newBlock( vlc_tick_t dts )
+{
+    block_t *p_block = block_Alloc( 100 );
+    assert( p_block );
+    p_block->i_dts = p_block->i_pts = dts;
+    return p_block;
+}
+
+static void send( CommandsQueue &queue, FakeESOutID *id, vlc_tick_t dts )
+{
+    const CommandsFactory *factory = queue.factory();
+    queue.Schedule( factory->createEsOutSendCommand( id, newBlock( dts ) ) );
+}
+
+static void pcr( CommandsQueue &queue, vlc_tick_t time )
+{
+    queue.Schedule( queue.factory()->createEsOutControlPCRCommand( 0, time ) );
+}
+
+static void check( const std::vector<vlc_tick_t> &expected )
+{
+    assert( sent == expected );
+    sent.clear();
+}
+
+/* Blocks are reordered between PCRs, but not across commands without time */
+static void test_order( FakeESOutID *id )
+{
+    CommandsQueue queue( new CommandsFactory() );
+
+    send( queue, id, VLC_TICK_0 + 30 );
+    send( queue, id, VLC_TICK_0 + 10 );
+    send( queue, id, VLC_TICK_0 + 20 );
+    pcr( queue, VLC_TICK_0 + 20 );
+    assert( queue.getBufferingLevel() == VLC_TICK_0 + 20 );
+    assert( queue.getFirstDTS() == VLC_TICK_0 + 10 );
+
+    queue.Process( &out, VLC_TICK_0 + 20 );
+    check( { VLC_TICK_0 + 10, VLC_TICK_0 + 20 } );
+
+    send( queue, id, VLC_TICK_0 + 50 );
+    queue.Schedule( queue.factory()->creatEsOutControlResetPCRCommand() );
+    send( queue, id, VLC_TICK_0 + 40 );
+    pcr( queue, VLC_TICK_0 + 100 );
+
+    /* Stops at the discontinuity, once data was sent */
+    queue.Process( &out, VLC_TICK_0 + 100 );
+    check( { VLC_TICK_0 + 30, VLC_TICK_0 + 50 } );
+    queue.Process( &out, VLC_TICK_0 + 100 );
+    check( { VLC_TICK_0 + 40 } );
+    assert( queue.isEmpty() );
+
+    /* Stops at deletion too */
+    send( queue, id, VLC_TICK_0 + 110 );
+    queue.Schedule( queue.factory()->createEsOutDelCommand( id ) );
+    pcr( queue, VLC_TICK_0 + 200 );
+    queue.Process( &out, VLC_TICK_0 + 200 );
+    check( { VLC_TICK_0 + 110 } );
+    assert( released == 0 );
+    queue.Process( &out, VLC_TICK_0 + 200 );
+    assert( released == 1 );
+    assert( queue.isEmpty() );
+}
+
+/* Aborting releases both the committed and the incoming commands */
+static void test_abort( FakeESOutID *id )
+{
+    CommandsQueue queue( new CommandsFactory() );
+    size_t usage, peak;
+
+    /* More than a chunk of the pool */
+    for( unsigned i = 0; i < 1000; i++ )
+        send( queue, id, VLC_TICK_0 + i );
+    pcr( queue, VLC_TICK_0 + 1000 );
+    send( queue, id, VLC_TICK_0 + 1001 );
+
+    vlc_memusage_Get( VLC_MEMUSAGE_ADAPTIVE, &usage, &peak );
+    assert( usage == 1001 * 100 );
+
+    queue.Abort( true );
+    assert( queue.isEmpty() );
+    assert( queue.getBufferingLevel() == VLC_TICK_INVALID );
+    vlc_memusage_Get( VLC_MEMUSAGE_ADAPTIVE, &usage, &peak );
+    assert( usage == 0 );
+    assert( sent.empty() );
+    /* The pool asserts that all its commands were released */
+}
+
+/* Released slots are reused, bigger allocations fall back to the heap */
+static void test_pool()
+{
+    CommandsPool pool;
+
+    void *a = pool.allocate( 16 );
+    void *b = pool.allocate( 16 );
+    assert( a && b && a != b );
+    CommandsPool::release( a );
+    assert( pool.allocate( 32 ) == a );
+
+    void *big = pool.allocate( 4096 );
+    assert( big );
+    memset( big, 0, 4096 );
+    CommandsPool::release( big );
+
+    CommandsPool::release( a );
+    CommandsPool::release( b );
+}
+
+int main()
+{
+    es_format_t fmt;
+    es_format_Init( &fmt, VIDEO_ES, VLC_CODEC_H264 );
+    FakeESOutID id( nullptr, &fmt );
+    id.setRealESID( reinterpret_cast<es_out_id_t *>( &realid ) );
+
+    test_order( &id );
+    test_abort( &id );
+    test_pool();
+
+    es_format_Clean( &fmt );
+    return 0;
+}
@@ -0,0 +1,198 @@
+/*****************************************************************************
+ * csa.c: CSA batch (de)scrambling test and benchmark
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/* Checks that the batch functions give the same results as the per packet
+ * ones. When given a number of iterations, also compares their throughput. */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#define TS_NO_CSA_CK_MSG
+#include <vlc_common.h>
+#include <vlc_tick.h>
+#include "../../../modules/mux/mpeg/csa.c"
+
+#include <stdlib.h>
+#include <stdio.h>
+
+const char vlc_module_name[] = "test_csa";
+
+#define PACKETS (3 * CSA_BATCH_PACKETS + 5)
+
+static uint8_t packets[PACKETS][188];
+
+/* Random packets, with random adaptation fields */
+static void fill_packets( bool b_scrambled )
+{
+    for( size_t i = 0; i < PACKETS; i++ )
+    {
+        uint8_t *p = packets[i];
+
+        for( int j = 0; j < 188; j++ )
+            p[j] = rand();
+        p[0] = 0x47;
+        p[3] = (p[3] & 0x3f) | 0x10;
+        if( b_scrambled )
+            p[3] |= (rand() & 1) ? 0xc0 : 0x80;
+        switch( i % 4 )
+        {
+            case 0:
+                break; /* no adaptation field */
+            case 1:
+                p[3] |= 0x20;
+                p[4] = rand() % 184;
+                break;
+            case 2:
+                p[3] |= 0x20;
+                p[4] = 183 - rand() % 16; /* at most 2 blocks */
+                break;
+            default:
+                p[3] |= 0x20;
+                p[4] = rand() % 8;
+                break;
+        }
+    }
+}
+
+static int check( csa_t *csa, bool b_encrypt, int i_pkt_size )
+{
+    static uint8_t ref[PACKETS][188];
+    uint8_t *pkts[PACKETS];
+
+    fill_packets( !b_encrypt );
+    memcpy( ref, packets, sizeof (ref) );
+
+    for( size_t i = 0; i < PACKETS; i++ )
+    {
+        pkts[i] = packets[i];
+        if( b_encrypt )
+            csa_Encrypt( csa, ref[i], i_pkt_size );
+        else
+            csa_Decrypt( csa, ref[i], i_pkt_size );
+    }
+
+    /* uneven batches */
+    for( size_t i = 0, count = 1; i < PACKETS; i += count, count *= 3 )
+    {
+        count = __MIN( count, PACKETS - i );
+        if( b_encrypt )
+            csa_EncryptBatch( csa, &pkts[i], count, i_pkt_size );
+        else
+            csa_DecryptBatch( csa, &pkts[i], count, i_pkt_size );
+    }
+
+    for( size_t i = 0; i < PACKETS; i++ )
+    {
+        if( memcmp( packets[i], ref[i], 188 ) )
+        {
+            fprintf( stderr, "%s mismatch (packet %zu, size %d)\n",
+                     b_encrypt ? "encryption" : "decryption", i, i_pkt_size );
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static vlc_tick_t bench( csa_t *csa, bool b_encrypt, bool b_batch,
+                         unsigned count )
+{
+    uint8_t *pkts[PACKETS];
+
+    fill_packets( !b_encrypt );
+    for( size_t i = 0; i < PACKETS; i++ )
+        pkts[i] = packets[i];
+
+    vlc_tick_t start = vlc_tick_now();
+    for( unsigned i = 0; i < count; i++ )
+    {
+        if( b_batch )
+        {
+            if( b_encrypt )
+                csa_EncryptBatch( csa, pkts, PACKETS, 188 );
+            else
+            {
+                /* descramble the same packets again */
+                for( size_t j = 0; j < PACKETS; j++ )
+                    packets[j][3] |= 0x80;
+                csa_DecryptBatch( csa, pkts, PACKETS, 188 );
+            }
+        }
+        else
+        {
+            for( size_t j = 0; j < PACKETS; j++ )
+            {
+                if( b_encrypt )
+                    csa_Encrypt( csa, packets[j], 188 );
+                else
+                {
+                    packets[j][3] |= 0x80;
+                    csa_Decrypt( csa, packets[j], 188 );
+                }
+            }
+        }
+    }
+    return vlc_tick_now() - start;
+}
+
+int main( int argc, char *argv[] )
+{
+    unsigned count = argc > 1 ? strtoul( argv[1], NULL, 10 ) : 0;
+    char odd[] = "0x0123456789abcdef", even[] = "fedcba9876543210";
+
+    csa_t *csa = csa_New();
+    if( csa == NULL )
+        return 1;
+    csa_SetCW( NULL, csa, odd, true );
+    csa_SetCW( NULL, csa, even, false );
+
+    srand( 0 );
+    for( int i = 0; i < 2; i++ )
+    {
+        csa_UseKey( NULL, csa, i );
+        if( check( csa, true, 188 ) || check( csa, false, 188 ) ||
+            check( csa, true, 100 ) || check( csa, false, 100 ) ||
+            check( csa, true, 12 ) || check( csa, false, 12 ) )
+        {
+            csa_Delete( csa );
+            return 1;
+        }
+    }
+
+    if( count > 0 )
+    {
+        for( int i = 0; i < 2; i++ )
+        {
+            const bool b_encrypt = i == 0;
+            vlc_tick_t scalar = bench( csa, b_encrypt, false, count );
+            vlc_tick_t batch = bench( csa, b_encrypt, true, count );
+            double bytes = (double) count * PACKETS * 188;
+
+            printf( "%s: %.1f MB/s, batch %.1f MB/s (x%.2f)\n",
+                    b_encrypt ? "encryption" : "decryption",
+                    scalar ? bytes / US_FROM_VLC_TICK( scalar ) : 0.,
+                    batch ? bytes / US_FROM_VLC_TICK( batch ) : 0.,
+                    batch ? (double) scalar / batch : 0. );
+        }
+    }
+
+    csa_Delete( csa );
+    return 0;
+}
@@ -96,6 +96,67 @@ const uint8_t test_samples_raw_h264[] = {
 };
 const size_t test_samples_raw_h264_len = 761;
 
+/* Input block reporting its release */
+struct tracked
+{
+    block_t self;
+    bool *released;
+    uint8_t data[];
+};
+
+static void tracked_release(block_t *block)
+{
+    struct tracked *t = container_of(block, struct tracked, self);
+
+    *t->released = true;
+    free(t);
+}
+
+static const struct vlc_block_callbacks tracked_cbs = { tracked_release };
+
+/* The parameter sets are kept for the whole stream: they must not keep the
+ * input block they were found in */
+static int test_sps_reference(const char *run,
+                              const uint8_t *p_data, size_t i_data,
+                              const struct params_s *params)
+{
+    const size_t i_first = 100; /* SPS, PPS and the first slice */
+    bool released = false;
+
+    decoder_t *p = create_packetizer(params->vlc, 0, 0, params->codec);
+    EXPECT(p != NULL && p->p_module != NULL);
+
+    struct tracked *t = malloc(sizeof (*t) + i_first);
+    EXPECT(t != NULL);
+    memcpy(t->data, p_data, i_first);
+    t->released = &released;
+    block_t *in = block_Init(&t->self, &tracked_cbs, t->data, i_first);
+    in->i_dts = VLC_TICK_0;
+
+    /* Up to the next SPS, which would replace the stored one */
+    size_t i_rest = i_first;
+    while(i_rest + 4 < i_data && memcmp(&p_data[i_rest], "\x00\x00\x01\x67", 4))
+        i_rest++;
+    i_rest -= i_first;
+
+    block_t *rest = block_Alloc(i_rest);
+    EXPECT(rest != NULL);
+    memcpy(rest->p_buffer, &p_data[i_first], i_rest);
+
+    block_t *out;
+    while((out = p->pf_packetize(p, &in)) != NULL)
+        block_Release(out);
+    while((out = p->pf_packetize(p, &rest)) != NULL)
+        block_Release(out);
+
+    /* The first input was entirely consumed, while its SPS is stored */
+    EXPECT(released);
+    EXPECT(p->fmt_out.i_extra > 0);
+
+    delete_packetizer(p);
+    return OK;
+}
+
 int main(void)
 {
     test_init();
@@ -128,6 +189,9 @@ int main(void)
     RUN("skip 1st Iframe", test_packetize,
         test_samples_raw_h264 + 10, test_samples_raw_h264_len - 10, 0);
 
+    RUN("sps", test_sps_reference,
+        test_samples_raw_h264, test_samples_raw_h264_len, 0);
+
     libvlc_release(vlc);
     return 0;
 }
@@ -0,0 +1,246 @@
+/*****************************************************************************
+ * views.c: packetizer helper fragment views test
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/* Checks that the fragments lying within one input block reference it rather
+ * than copy it, that the input lives until the last fragment is released, and
+ * that the copy path still handles fragments straddling input blocks. */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#undef NDEBUG
+#include <assert.h>
+
+#include <vlc_common.h>
+#include <vlc_block.h>
+#include <vlc_block_helper.h>
+
+#include "../modules/packetizer/startcode_helper.h"
+#include "../modules/packetizer/packetizer_helper.h"
+
+const char vlc_module_name[] = "test_packetizer_views";
+
+/* Input block reporting its release */
+struct tracked
+{
+    block_t self;
+    bool *released;
+    uint8_t data[];
+};
+
+static void TrackedRelease( block_t *block )
+{
+    struct tracked *t = container_of( block, struct tracked, self );
+
+    *t->released = true;
+    free( t );
+}
+
+static const struct vlc_block_callbacks tracked_cbs = { TrackedRelease };
+
+static block_t *TrackedNew( const uint8_t *data, size_t size, bool *released )
+{
+    struct tracked *t = malloc( sizeof (*t) + size );
+    assert( t != NULL );
+    memcpy( t->data, data, size );
+    t->released = released;
+    *released = false;
+    return block_Init( &t->self, &tracked_cbs, t->data, size );
+}
+
+/* Pass-through packetizer callbacks */
+static void Reset( void *priv, bool flush )
+{
+    (void) priv; (void) flush;
+}
+
+static block_t *Parse( void *priv, bool *used_ts, block_t *frag )
+{
+    (void) priv;
+    *used_ts = false;
+    return frag;
+}
+
+static int Validate( void *priv, block_t *frag )
+{
+    (void) priv; (void) frag;
+    return 0;
+}
+
+static const uint8_t startcode[3] = { 0, 0, 1 };
+static const uint8_t prepend[1] = { 0 };
+
+#define OUT_MAX 8
+
+/* Packetizes the inputs then drains, returns the number of fragments */
+static size_t Packetize( packetizer_t *pack, block_t **in, size_t count,
+                         block_t **out )
+{
+    size_t n = 0;
+
+    for( size_t i = 0; i <= count; i++ )
+    {
+        block_t *block = (i < count) ? in[i] : NULL;
+        block_t *frag;
+
+        while( (frag = packetizer_Packetize( pack, (i < count) ? &block : NULL )) )
+        {
+            assert( n < OUT_MAX );
+            out[n++] = frag;
+        }
+    }
+    return n;
+}
+
+static bool Within( const block_t *frag, const uint8_t *data, size_t size )
+{
+    return frag->p_buffer >= data && frag->p_buffer + frag->i_buffer <= data + size;
+}
+
+static void test_single_block( void )
+{
+    static const uint8_t data[] = {
+        0, 0, 1, 0x65, 0x11, 0x22,
+        0, 0, 1, 0x41, 0x33,
+        0, 0, 1, 0x41, 0x44, 0x55, 0x66,
+    };
+    packetizer_t pack;
+    block_t *out[OUT_MAX];
+    bool released;
+
+    packetizer_Init( &pack, startcode, 3, startcode_FindAnnexB, NULL, 0, 4,
+                     Reset, Parse, Validate, NULL, NULL );
+
+    block_t *in = TrackedNew( data, sizeof (data), &released );
+    const uint8_t *buf = in->p_buffer;
+    size_t n = Packetize( &pack, &in, 1, out );
+    packetizer_Clean( &pack );
+
+    assert( n == 3 );
+    assert( out[0]->i_buffer == 6 && out[1]->i_buffer == 5
+         && out[2]->i_buffer == 7 );
+
+    /* Views on the input: no copy */
+    for( size_t i = 0; i < n; i++ )
+    {
+        assert( packetizer_IsView( out[i] ) );
+        assert( Within( out[i], buf, sizeof (data) ) );
+    }
+    assert( !memcmp( out[1]->p_buffer, &data[6], 5 ) );
+
+    /* Contiguous views gather into a single view, still without copy */
+    out[0]->p_next = out[1];
+    block_t *au = packetizer_ChainGather( out[0] );
+    assert( au != NULL && packetizer_IsView( au ) );
+    assert( au->p_buffer == buf && au->i_buffer == 11 );
+
+    /* The input lives until the last fragment is gone */
+    assert( !released );
+    block_Release( au );
+    assert( !released );
+    block_Release( out[2] );
+    assert( released );
+}
+
+static void test_straddling( void )
+{
+    static const uint8_t data[2][7] = {
+        { 0, 0, 1, 0x65, 0x11, 0, 0 },
+        { 1, 0x41, 0x22, 0x33, 0, 0, 1 },
+    };
+    packetizer_t pack;
+    block_t *out[OUT_MAX], *in[2];
+    bool released[2];
+
+    packetizer_Init( &pack, startcode, 3, startcode_FindAnnexB, NULL, 0, 4,
+                     Reset, Parse, Validate, NULL, NULL );
+
+    in[0] = TrackedNew( data[0], sizeof (data[0]), &released[0] );
+    in[1] = TrackedNew( data[1], sizeof (data[1]), &released[1] );
+    size_t n = Packetize( &pack, in, 2, out );
+    packetizer_Clean( &pack );
+
+    /* The first fragment lies within the first input, the second one
+     * straddles both inputs and is copied */
+    assert( n == 2 );
+    static const uint8_t first[] = { 0, 0, 1, 0x65, 0x11 };
+    static const uint8_t second[] = { 0, 0, 1, 0x41, 0x22, 0x33 };
+    assert( out[0]->i_buffer == sizeof (first) );
+    assert( !memcmp( out[0]->p_buffer, first, sizeof (first) ) );
+    assert( out[1]->i_buffer == sizeof (second) );
+    assert( !memcmp( out[1]->p_buffer, second, sizeof (second) ) );
+    assert( packetizer_IsView( out[0] ) );
+    assert( !packetizer_IsView( out[1] ) );
+
+    /* Mixed chains are gathered by copy */
+    out[0]->p_next = out[1];
+    block_t *au = packetizer_ChainGather( out[0] );
+    assert( au != NULL && au->i_buffer == sizeof (first) + sizeof (second) );
+    assert( !memcmp( au->p_buffer, first, sizeof (first) ) );
+    assert( !memcmp( au->p_buffer + sizeof (first), second, sizeof (second) ) );
+    block_Release( au );
+    assert( released[0] && released[1] );
+}
+
+static void test_prepend( void )
+{
+    /* A 4 bytes startcode, then a 3 bytes one */
+    static const uint8_t data[] = {
+        0, 0, 0, 1, 0x65, 0x11, 0x22,
+        0xff, 0, 0, 1, 0x41, 0x33, 0x44,
+        0, 0, 0, 1, 0x41,
+    };
+    packetizer_t pack;
+    block_t *out[OUT_MAX];
+    bool released;
+
+    packetizer_Init( &pack, startcode, 3, startcode_FindAnnexB,
+                     prepend, 1, 4, Reset, Parse, Validate, NULL, NULL );
+
+    block_t *in = TrackedNew( data, sizeof (data), &released );
+    const uint8_t *buf = in->p_buffer;
+    size_t n = Packetize( &pack, &in, 1, out );
+    packetizer_Clean( &pack );
+
+    assert( n >= 2 );
+    /* The prepend is already in the input: view */
+    assert( packetizer_IsView( out[0] ) );
+    assert( Within( out[0], buf, sizeof (data) ) );
+    assert( out[0]->p_buffer[0] == 0 && out[0]->p_buffer[3] == 1
+         && out[0]->p_buffer[4] == 0x65 );
+    /* It is not: copied with the prepend */
+    assert( !packetizer_IsView( out[1] ) );
+    static const uint8_t second[] = { 0, 0, 0, 1, 0x41, 0x33, 0x44 };
+    assert( out[1]->i_buffer >= sizeof (second) );
+    assert( !memcmp( out[1]->p_buffer, second, sizeof (second) ) );
+
+    for( size_t i = 0; i < n; i++ )
+        block_Release( out[i] );
+    assert( released );
+}
+
+int main( void )
+{
+    test_single_block();
+    test_straddling();
+    test_prepend();
+    return 0;
+}
@@ -0,0 +1,231 @@
+/*****************************************************************************
+ * prefetch.c: prefetch stream filter test
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/* Reads through the prefetch filter from a slow access provided by this
+ * test, until the buffer has grown to its maximum size. Reads and seeks
+ * are done while the buffer is resized, and must return the bytes of the
+ * access at the right offsets. */
+
+#define MODULE_NAME test_prefetch
+#define MODULE_STRING "test_prefetch"
+#undef __PLUGIN__
+
+#include "../../libvlc/test.h"
+#include "../../../lib/libvlc_internal.h"
+
+#include <vlc_common.h>
+#include <vlc_plugin.h>
+#include <vlc_stream.h>
+
+#define SIZE        (32 << 20)
+#define BUFFER_SIZE 4 /* KiB, the initial and minimum size */
+#define BUFFER_MAX  64 /* KiB */
+#define READ_DELAY  VLC_TICK_FROM_MS(10)
+
+#define STR_(x) #x
+#define STR(x) STR_(x)
+
+static uint8_t Byte(uint64_t offset)
+{
+    return (offset * 2654435761u) >> 24;
+}
+
+/* Slow access */
+static ssize_t AccessRead(stream_t *access, void *buf, size_t len)
+{
+    uint64_t *offset = access->p_sys;
+    uint8_t *p = buf;
+
+    vlc_tick_wait(vlc_tick_now() + READ_DELAY);
+
+    if (len > SIZE - *offset)
+        len = SIZE - *offset;
+    for (size_t i = 0; i < len; i++)
+        p[i] = Byte(*offset + i);
+    *offset += len;
+    return len;
+}
+
+static int AccessSeek(stream_t *access, uint64_t offset)
+{
+    *(uint64_t *)access->p_sys = offset;
+    return VLC_SUCCESS;
+}
+
+static int AccessControl(stream_t *access, int query, va_list args)
+{
+    (void) access;
+
+    switch (query)
+    {
+        case STREAM_CAN_SEEK:
+        case STREAM_CAN_PAUSE:
+        case STREAM_CAN_CONTROL_PACE:
+            *va_arg(args, bool *) = true;
+            break;
+        case STREAM_CAN_FASTSEEK:
+            *va_arg(args, bool *) = false;
+            break;
+        case STREAM_GET_SIZE:
+            *va_arg(args, uint64_t *) = SIZE;
+            break;
+        case STREAM_GET_PTS_DELAY:
+            *va_arg(args, vlc_tick_t *) = DEFAULT_PTS_DELAY;
+            break;
+        case STREAM_SET_PAUSE_STATE:
+            break;
+        default:
+            return VLC_EGENERIC;
+    }
+    return VLC_SUCCESS;
+}
+
+static int AccessOpen(vlc_object_t *obj)
+{
+    stream_t *access = (stream_t *)obj;
+    uint64_t *offset = vlc_obj_malloc(obj, sizeof (*offset));
+
+    if (unlikely(offset == NULL))
+        return VLC_ENOMEM;
+
+    *offset = 0;
+    access->p_sys = offset;
+    access->pf_read = AccessRead;
+    access->pf_block = NULL;
+    access->pf_seek = AccessSeek;
+    access->pf_control = AccessControl;
+    return VLC_SUCCESS;
+}
+
+const char vlc_module_name[] = MODULE_STRING;
+
+vlc_module_begin()
+    set_capability("access", 0)
+    set_callback(AccessOpen)
+    add_shortcut("slow")
+vlc_module_end()
+
+typedef int (*vlc_plugin_cb)(vlc_set_cb, void *);
+
+VLC_EXPORT vlc_plugin_cb vlc_static_modules[] = {
+    VLC_SYMBOL(vlc_entry),
+    NULL
+};
+
+static void Check(stream_t *s, size_t len)
+{
+    uint64_t offset = vlc_stream_Tell(s);
+    uint8_t buf[8192];
+
+    assert(len <= sizeof (buf));
+    if (len > SIZE - offset)
+        len = SIZE - offset;
+
+    ssize_t val = vlc_stream_Read(s, buf, len);
+    assert(val >= 0 && (size_t)val == len);
+    for (size_t i = 0; i < len; i++)
+        assert(buf[i] == Byte(offset + i));
+    assert(vlc_stream_Tell(s) == offset + len);
+}
+
+static void Seek(stream_t *s, uint64_t offset)
+{
+    int ret = vlc_stream_Seek(s, offset);
+    assert(ret == VLC_SUCCESS);
+    assert(vlc_stream_Tell(s) == offset);
+}
+
+static size_t Level(stream_t *s, size_t *size)
+{
+    size_t level;
+    int ret = vlc_stream_Control(s, STREAM_GET_BUFFER_LEVEL, &level, size);
+
+    assert(ret == VLC_SUCCESS);
+    assert(level <= *size);
+    return level;
+}
+
+int main(void)
+{
+    test_init();
+
+    const char *argv[test_defaults_nargs + 2];
+    for (int i = 0; i < test_defaults_nargs; i++)
+        argv[i] = test_defaults_args[i];
+    argv[test_defaults_nargs] = "--prefetch-buffer-size=" STR(BUFFER_SIZE);
+    argv[test_defaults_nargs + 1] = "--prefetch-buffer-max=" STR(BUFFER_MAX);
+
+    libvlc_instance_t *vlc = libvlc_new(test_defaults_nargs + 2, argv);
+    assert(vlc != NULL);
+    vlc_object_t *obj = VLC_OBJECT(vlc->p_libvlc_int);
+
+    /* The prefetch filter is inserted for accesses without fast seek */
+    stream_t *s = vlc_stream_NewURL(obj, "slow://");
+    assert(s != NULL);
+
+    size_t size, last_size;
+    Level(s, &last_size);
+    assert(last_size == BUFFER_SIZE << 10);
+
+    /* Read faster than the access until the buffer stops growing. After
+     * each resize, seek back into (or before) the data moved to the new
+     * buffer, and forward past it. */
+    unsigned resizes = 0;
+    for (unsigned i = 0; last_size < BUFFER_MAX << 10; i++)
+    {
+        assert(vlc_stream_Tell(s) < SIZE / 2);
+        Check(s, 1 + (i * 997) % 8192);
+
+        Level(s, &size);
+        assert(size >= last_size);
+        if (size > last_size)
+        {
+            uint64_t offset = vlc_stream_Tell(s);
+
+            Seek(s, offset - 3000);
+            Check(s, 5000);
+            Seek(s, offset + 20000);
+            Check(s, 100);
+            resizes++;
+        }
+        last_size = size;
+    }
+    assert(resizes > 0);
+
+    /* The larger buffer is filled while the reader is idle */
+    vlc_tick_wait(vlc_tick_now() + 20 * READ_DELAY);
+    assert(Level(s, &size) > BUFFER_SIZE << 10);
+    assert(size == BUFFER_MAX << 10);
+
+    /* Back to the beginning, then jump to the end and read up to it */
+    Seek(s, 0);
+    Check(s, 8192);
+    Seek(s, SIZE - (1 << 20));
+    while (vlc_stream_Tell(s) < SIZE)
+        Check(s, 8192);
+
+    uint8_t byte;
+    assert(vlc_stream_Read(s, &byte, 1) == 0);
+    assert(vlc_stream_Eof(s));
+
+    vlc_stream_Delete(s);
+    libvlc_release(vlc);
+    return 0;
+}
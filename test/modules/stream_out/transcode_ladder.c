@@ -0,0 +1,258 @@
+/*****************************************************************************
+ * transcode_ladder.c: transcode renditions ladder test
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/* Feeds raw pictures to a transcode chain with a renditions ladder, and checks
+ * that every rendition is output as its own ES, with all the pictures scaled
+ * to its size. The encoder, scaler and output are provided by this test. */
+
+#define MODULE_NAME test_transcode_ladder
+#define MODULE_STRING "test_transcode_ladder"
+#undef __PLUGIN__
+
+#include "../../libvlc/test.h"
+#include "../../../lib/libvlc_internal.h"
+
+#include <vlc_common.h>
+#include <vlc_plugin.h>
+#include <vlc_codec.h>
+#include <vlc_filter.h>
+#include <vlc_picture.h>
+#include <vlc_sout.h>
+
+#include <string.h>
+
+#define WIDTH   640
+#define HEIGHT  480
+#define FRAMES  12
+#define MAX_ES  4
+
+static const unsigned sizes[][2] = {
+    { WIDTH, HEIGHT }, { 320, 240 }, { 160, 120 },
+};
+
+struct es_result
+{
+    unsigned width, height; /**< size of the first picture */
+    unsigned frames;
+    bool mismatch; /**< a picture did not have the size of the first */
+    bool eos;
+};
+
+static struct
+{
+    vlc_mutex_t lock;
+    unsigned es_count; /**< ES added to the output */
+    struct es_result es[MAX_ES];
+} results = { .lock = VLC_STATIC_MUTEX };
+
+/* Encoder: outputs the size of each picture it is given */
+static block_t *Encode( encoder_t *enc, picture_t *pic )
+{
+    (void) enc;
+    if( pic == NULL )
+        return NULL;
+
+    block_t *block = block_Alloc( 2 * sizeof (unsigned) );
+    if( block == NULL )
+        return NULL;
+
+    unsigned size[2] = { pic->format.i_visible_width,
+                         pic->format.i_visible_height };
+    memcpy( block->p_buffer, size, sizeof (size) );
+    block->i_pts = block->i_dts = pic->date;
+    return block;
+}
+
+static int OpenEncoder( vlc_object_t *obj )
+{
+    encoder_t *enc = (encoder_t *)obj;
+
+    if( enc->fmt_out.i_cat != VIDEO_ES )
+        return VLC_EGENERIC;
+
+    enc->fmt_in.i_codec = VLC_CODEC_I420;
+    enc->pf_encode_video = Encode;
+    return VLC_SUCCESS;
+}
+
+/* Scaler: only updates the format, the pixels do not matter here */
+static picture_t *Scale( filter_t *filter, picture_t *pic )
+{
+    picture_t *out = filter_NewPicture( filter );
+    if( out != NULL )
+        picture_CopyProperties( out, pic );
+    picture_Release( pic );
+    return out;
+}
+
+static const struct vlc_filter_operations scale_ops = {
+    .filter_video = Scale,
+};
+
+static int OpenScaler( vlc_object_t *obj )
+{
+    filter_t *filter = (filter_t *)obj;
+
+    if( filter->fmt_in.video.i_chroma != VLC_CODEC_I420
+     || filter->fmt_out.video.i_chroma != VLC_CODEC_I420 )
+        return VLC_EGENERIC;
+
+    filter->ops = &scale_ops;
+    return VLC_SUCCESS;
+}
+
+/* Output: checks what is received on each ES */
+static void *Add( sout_stream_t *stream, const es_format_t *fmt )
+{
+    (void) stream;
+    if( fmt->i_cat != VIDEO_ES )
+        return NULL;
+
+    vlc_mutex_lock( &results.lock );
+    assert( results.es_count < MAX_ES );
+    uintptr_t index = results.es_count++;
+    vlc_mutex_unlock( &results.lock );
+    return (void *)(index + 1);
+}
+
+static void Del( sout_stream_t *stream, void *id )
+{
+    (void) stream; (void) id;
+}
+
+static int Send( sout_stream_t *stream, void *id, block_t *chain )
+{
+    (void) stream;
+
+    vlc_mutex_lock( &results.lock );
+    for( block_t *block = chain; block != NULL; block = block->p_next )
+    {
+        unsigned size[2];
+
+        assert( block->i_buffer == sizeof (size) );
+        memcpy( size, block->p_buffer, sizeof (size) );
+
+        struct es_result *es = &results.es[(uintptr_t)id - 1];
+        if( es->frames++ == 0 )
+        {
+            es->width = size[0];
+            es->height = size[1];
+        }
+        else if( es->width != size[0] || es->height != size[1] )
+            es->mismatch = true;
+        if( block->i_flags & BLOCK_FLAG_END_OF_SEQUENCE )
+            es->eos = true;
+    }
+    vlc_mutex_unlock( &results.lock );
+    block_ChainRelease( chain );
+    return VLC_SUCCESS;
+}
+
+static const struct sout_stream_operations ops = {
+    Add, Del, Send, NULL, NULL,
+};
+
+static int OpenOutput( vlc_object_t *obj )
+{
+    ((sout_stream_t *)obj)->ops = &ops;
+    return VLC_SUCCESS;
+}
+
+const char vlc_module_name[] = MODULE_STRING;
+
+vlc_module_begin()
+    set_capability( "encoder", 0 )
+    add_shortcut( "test_ladder_enc" )
+    set_callback( OpenEncoder )
+    add_submodule()
+    set_capability( "video converter", 10000 )
+    set_callback( OpenScaler )
+    add_submodule()
+    set_capability( "sout output", 0 )
+    add_shortcut( "test_ladder_out" )
+    set_callback( OpenOutput )
+vlc_module_end()
+
+typedef int (*vlc_plugin_cb)(vlc_set_cb, void *);
+
+VLC_EXPORT vlc_plugin_cb vlc_static_modules[] = {
+    VLC_SYMBOL(vlc_entry),
+    NULL
+};
+
+int main( void )
+{
+    test_init();
+
+    libvlc_instance_t *vlc = libvlc_new( test_defaults_nargs,
+                                         test_defaults_args );
+    assert( vlc != NULL );
+
+    sout_stream_t *stream = sout_StreamChainNew( VLC_OBJECT(vlc->p_libvlc_int),
+        "transcode{vcodec=mp2v,venc=test_ladder_enc,"
+        "ladder=\"320x240,160x120@200\"}:test_ladder_out", NULL );
+    assert( stream != NULL );
+
+    es_format_t fmt;
+    es_format_Init( &fmt, VIDEO_ES, VLC_CODEC_I420 );
+    fmt.video.i_chroma = VLC_CODEC_I420;
+    fmt.video.i_width = fmt.video.i_visible_width = WIDTH;
+    fmt.video.i_height = fmt.video.i_visible_height = HEIGHT;
+    fmt.video.i_sar_num = fmt.video.i_sar_den = 1;
+    fmt.video.i_frame_rate = 25;
+    fmt.video.i_frame_rate_base = 1;
+
+    void *id = sout_StreamIdAdd( stream, &fmt );
+    assert( id != NULL );
+
+    for( unsigned i = 0; i < FRAMES; i++ )
+    {
+        block_t *block = block_Alloc( WIDTH * HEIGHT * 3 / 2 );
+        assert( block != NULL );
+        memset( block->p_buffer, 0x80, block->i_buffer );
+        block->i_pts = block->i_dts = VLC_TICK_0 + i * VLC_TICK_FROM_MS(40);
+        block->i_length = VLC_TICK_FROM_MS(40);
+        if( i == FRAMES - 1 )
+            block->i_flags |= BLOCK_FLAG_END_OF_SEQUENCE;
+        sout_StreamIdSend( stream, id, block );
+    }
+
+    sout_StreamIdDel( stream, id );
+    sout_StreamChainDelete( stream, NULL );
+    libvlc_release( vlc );
+
+    /* One ES per rendition, on top of the main one */
+    assert( results.es_count == ARRAY_SIZE(sizes) );
+
+    for( size_t i = 0; i < ARRAY_SIZE(sizes); i++ )
+    {
+        /* ES are added in any order, find the one of that size */
+        size_t j = 0;
+        while( j < results.es_count && (results.es[j].width != sizes[i][0]
+                                     || results.es[j].height != sizes[i][1]) )
+            j++;
+        assert( j < results.es_count );
+        assert( !results.es[j].mismatch );
+        assert( results.es[j].frames == FRAMES );
+        /* The end of sequence drains every encoder */
+        assert( results.es[j].eos );
+    }
+    return 0;
+}
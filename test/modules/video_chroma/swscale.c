@@ -0,0 +1,155 @@
+/*****************************************************************************
+ * swscale.c: swscale video converter test
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/* Scales a 4:2:0 picture with and without threads, and checks that the
+ * outputs are identical. Skipped if the swscale plugin is not available. */
+
+#include "../../libvlc/test.h"
+#include "../../../lib/libvlc_internal.h"
+
+#include <vlc_common.h>
+#include <vlc_modules.h>
+#include <vlc_filter.h>
+#include <vlc_picture.h>
+
+const char vlc_module_name[] = "test_swscale";
+
+#define WIDTH_IN   1920
+#define HEIGHT_IN  1080
+#define WIDTH_OUT  1280
+#define HEIGHT_OUT 720
+
+static picture_t *NewPicture( filter_t *filter )
+{
+    return picture_NewFromFormat( &filter->fmt_out.video );
+}
+
+static const struct filter_video_callbacks owner_cbs =
+{
+    .buffer_new = NewPicture,
+};
+
+static picture_t *NewInput( const video_format_t *fmt )
+{
+    picture_t *pic = picture_NewFromFormat( fmt );
+    assert( pic != NULL );
+
+    /* Gradients with noise, so that every line differs */
+    uint32_t seed = 1;
+    for( int i = 0; i < pic->i_planes; i++ )
+    {
+        plane_t *p = &pic->p[i];
+
+        for( int y = 0; y < p->i_visible_lines; y++ )
+            for( int x = 0; x < p->i_visible_pitch; x++ )
+            {
+                seed = seed * 1103515245 + 12345;
+                p->p_pixels[y * p->i_pitch + x] =
+                    (x + 3 * y) / 4 + ((seed >> 16) & 31);
+            }
+    }
+    return pic;
+}
+
+/* Converts a copy of the input with the given number of threads */
+static picture_t *Convert( vlc_object_t *obj, picture_t *in,
+                           const video_format_t *fmt_out, int threads )
+{
+    filter_t *filter = vlc_object_create( obj, sizeof (*filter) );
+    assert( filter != NULL );
+
+    var_Create( filter, "swscale-threads", VLC_VAR_INTEGER );
+    var_SetInteger( filter, "swscale-threads", threads );
+
+    es_format_InitFromVideo( &filter->fmt_in, &in->format );
+    es_format_InitFromVideo( &filter->fmt_out, fmt_out );
+    filter->owner.video = &owner_cbs;
+
+    filter->p_module = module_need( filter, "video converter", "swscale",
+                                    true );
+    if( filter->p_module == NULL )
+    {
+        es_format_Clean( &filter->fmt_out );
+        es_format_Clean( &filter->fmt_in );
+        vlc_object_delete( filter );
+        return NULL;
+    }
+
+    picture_t *out = filter->ops->filter_video( filter, picture_Clone( in ) );
+    assert( out != NULL );
+
+    filter_Close( filter );
+    module_unneed( filter, filter->p_module );
+    es_format_Clean( &filter->fmt_out );
+    es_format_Clean( &filter->fmt_in );
+    vlc_object_delete( filter );
+    return out;
+}
+
+int main( void )
+{
+    test_init();
+
+    libvlc_instance_t *vlc = libvlc_new( test_defaults_nargs,
+                                         test_defaults_args );
+    assert( vlc != NULL );
+    vlc_object_t *obj = VLC_OBJECT(vlc->p_libvlc_int);
+
+    video_format_t fmt_in, fmt_out;
+    video_format_Init( &fmt_in, VLC_CODEC_I420 );
+    video_format_Setup( &fmt_in, VLC_CODEC_I420, WIDTH_IN, HEIGHT_IN,
+                        WIDTH_IN, HEIGHT_IN, 1, 1 );
+    video_format_Init( &fmt_out, VLC_CODEC_I420 );
+    video_format_Setup( &fmt_out, VLC_CODEC_I420, WIDTH_OUT, HEIGHT_OUT,
+                        WIDTH_OUT, HEIGHT_OUT, 1, 1 );
+
+    picture_t *in = NewInput( &fmt_in );
+    picture_t *ref = Convert( obj, in, &fmt_out, 1 );
+    if( ref == NULL )
+    {
+        picture_Release( in );
+        libvlc_release( vlc );
+        return 77;
+    }
+
+    for( int threads = 2; threads <= 8; threads *= 2 )
+    {
+        picture_t *out = Convert( obj, in, &fmt_out, threads );
+        assert( out != NULL );
+        assert( out->i_planes == ref->i_planes );
+
+        for( int i = 0; i < ref->i_planes; i++ )
+        {
+            const plane_t *a = &ref->p[i], *b = &out->p[i];
+
+            assert( a->i_visible_lines == b->i_visible_lines );
+            for( int y = 0; y < a->i_visible_lines; y++ )
+                assert( !memcmp( &a->p_pixels[y * a->i_pitch],
+                                 &b->p_pixels[y * b->i_pitch],
+                                 a->i_visible_pitch ) );
+        }
+        picture_Release( out );
+    }
+
+    picture_Release( ref );
+    picture_Release( in );
+    libvlc_release( vlc );
+    return 0;
+}
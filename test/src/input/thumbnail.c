@@ -29,6 +29,9 @@
 #include <errno.h>
 
 #define MOCK_DURATION VLC_TICK_FROM_SEC( 5 * 60 )
+/* Long enough to time out while demuxing the audio before the video track */
+#define MOCK_TIMEOUT_DURATION VLC_TICK_FROM_SEC( 100 * 60 * 60 )
+#define MOCK_TIMEOUT_VIDEO_AT VLC_TICK_FROM_SEC( 50 * 60 * 60 )
 
 const struct
 {
@@ -207,6 +210,193 @@ static void test_cancel_thumbnail( libvlc_instance_t* p_vlc )
     vlc_thumbnailer_Release( p_thumbnailer );
 }
 
+static const vlc_tick_t batch_times[] = {
+    VLC_TICK_FROM_SEC( 120 ),
+    VLC_TICK_FROM_SEC( 30 ),
+    VLC_TICK_FROM_SEC( 60 ),
+    /* after the end of the media, must fail */
+    MOCK_DURATION + VLC_TICK_FROM_SEC( 100 ),
+};
+
+struct test_batch_ctx
+{
+    vlc_cond_t cond;
+    vlc_mutex_t lock;
+    unsigned width;
+    unsigned height;
+    size_t count;
+    size_t last_index;
+    bool received[ARRAY_SIZE(batch_times)];
+};
+
+static void thumbnailer_batch_callback( void* data, size_t index,
+                                        picture_t* thumbnail )
+{
+    struct test_batch_ctx* p_ctx = data;
+    vlc_mutex_lock( &p_ctx->lock );
+
+    assert( index < ARRAY_SIZE(batch_times) );
+    assert( !p_ctx->received[index] && "Thumbnail notified twice" );
+    /* Thumbnails are notified by increasing time */
+    if ( p_ctx->count > 0 )
+        assert( batch_times[p_ctx->last_index] < batch_times[index] );
+
+    if ( batch_times[index] < MOCK_DURATION )
+    {
+        assert( thumbnail != NULL );
+        assert( thumbnail->format.i_chroma == VLC_CODEC_ARGB );
+        assert( thumbnail->format.i_visible_width == p_ctx->width );
+        assert( thumbnail->format.i_visible_height == p_ctx->height );
+    }
+    else
+        assert( thumbnail == NULL );
+
+    p_ctx->received[index] = true;
+    p_ctx->last_index = index;
+    p_ctx->count++;
+    vlc_cond_signal( &p_ctx->cond );
+    vlc_mutex_unlock( &p_ctx->lock );
+}
+
+static void test_batch_thumbnails( libvlc_instance_t* p_vlc )
+{
+    vlc_thumbnailer_t* p_thumbnailer = vlc_thumbnailer_Create(
+                VLC_OBJECT( p_vlc->p_libvlc_int ) );
+    assert( p_thumbnailer != NULL );
+
+    struct test_batch_ctx ctx;
+    vlc_cond_init( &ctx.cond );
+    vlc_mutex_init( &ctx.lock );
+
+    char* psz_mrl;
+    if ( asprintf( &psz_mrl, "mock://video_track_count=1;length=%" PRId64
+                   ";video_chroma=ARGB;video_width=640;video_height=480",
+                   MOCK_DURATION ) < 0 )
+        assert( !"Failed to allocate mock mrl" );
+    input_item_t* p_item = input_item_New( psz_mrl, "mock item" );
+    assert( p_item != NULL );
+
+    static const struct
+    {
+        unsigned width, height;
+        unsigned expected_width, expected_height;
+    } sizes[] = {
+        { 0, 0, 640, 480 },
+        /* keep the aspect ratio */
+        { 64, 0, 64, 48 },
+        { 0, 120, 160, 120 },
+        { 100, 100, 100, 100 },
+    };
+
+    for ( size_t i = 0; i < ARRAY_SIZE(sizes); ++i )
+    {
+        ctx.width = sizes[i].expected_width;
+        ctx.height = sizes[i].expected_height;
+        ctx.count = 0;
+        for ( size_t j = 0; j < ARRAY_SIZE(batch_times); ++j )
+            ctx.received[j] = false;
+
+        vlc_mutex_lock( &ctx.lock );
+        vlc_thumbnailer_request_t* p_req = vlc_thumbnailer_RequestBatch(
+            p_thumbnailer, batch_times, ARRAY_SIZE(batch_times),
+            i % 2 ? VLC_THUMBNAILER_SEEK_PRECISE : VLC_THUMBNAILER_SEEK_FAST,
+            sizes[i].width, sizes[i].height, p_item, VLC_TICK_FROM_SEC( 1 ),
+            thumbnailer_batch_callback, &ctx );
+        assert( p_req != NULL );
+
+        while ( ctx.count < ARRAY_SIZE(batch_times) )
+        {
+            vlc_tick_t timeout = vlc_tick_now() + VLC_TICK_FROM_SEC( 5 );
+            int res = vlc_cond_timedwait( &ctx.cond, &ctx.lock, timeout );
+            assert( res != ETIMEDOUT );
+        }
+        vlc_mutex_unlock( &ctx.lock );
+    }
+
+    input_item_Release( p_item );
+    free( psz_mrl );
+
+    vlc_thumbnailer_Release( p_thumbnailer );
+}
+
+/* A thumbnail timing out must not shift the following ones, even if it is
+ * decoded later on */
+static const vlc_tick_t timeout_times[] = {
+    /* long before the video track, which is reached after the timeout */
+    VLC_TICK_FROM_SEC( 10 ),
+    MOCK_TIMEOUT_VIDEO_AT + VLC_TICK_FROM_SEC( 60 ),
+    MOCK_TIMEOUT_VIDEO_AT + VLC_TICK_FROM_SEC( 120 ),
+};
+
+struct test_timeout_ctx
+{
+    vlc_cond_t cond;
+    vlc_mutex_t lock;
+    size_t count;
+};
+
+static void thumbnailer_timeout_callback( void* data, size_t index,
+                                          picture_t* thumbnail )
+{
+    struct test_timeout_ctx* p_ctx = data;
+    vlc_mutex_lock( &p_ctx->lock );
+
+    assert( index == p_ctx->count );
+    if ( index == 0 )
+        assert( thumbnail == NULL && "Expected a timeout" );
+    else
+    {
+        /* The picture taken at the requested time, not a late one */
+        assert( thumbnail != NULL );
+        assert( thumbnail->date >= timeout_times[index] &&
+                thumbnail->date < timeout_times[index] + VLC_TICK_FROM_SEC( 1 ) );
+    }
+
+    p_ctx->count++;
+    vlc_cond_signal( &p_ctx->cond );
+    vlc_mutex_unlock( &p_ctx->lock );
+}
+
+static void test_batch_timeout( libvlc_instance_t* p_vlc )
+{
+    vlc_thumbnailer_t* p_thumbnailer = vlc_thumbnailer_Create(
+                VLC_OBJECT( p_vlc->p_libvlc_int ) );
+    assert( p_thumbnailer != NULL );
+
+    struct test_timeout_ctx ctx;
+    vlc_cond_init( &ctx.cond );
+    vlc_mutex_init( &ctx.lock );
+    ctx.count = 0;
+
+    char* psz_mrl;
+    if ( asprintf( &psz_mrl, "mock://video_track_count=1;audio_track_count=1"
+                   ";length=%" PRId64 ";video_chroma=ARGB;video_add_track_at=%"
+                   PRId64, MOCK_TIMEOUT_DURATION, MOCK_TIMEOUT_VIDEO_AT ) < 0 )
+        assert( !"Failed to allocate mock mrl" );
+    input_item_t* p_item = input_item_New( psz_mrl, "mock item" );
+    assert( p_item != NULL );
+
+    vlc_mutex_lock( &ctx.lock );
+    vlc_thumbnailer_request_t* p_req = vlc_thumbnailer_RequestBatch(
+        p_thumbnailer, timeout_times, ARRAY_SIZE(timeout_times),
+        VLC_THUMBNAILER_SEEK_PRECISE, 0, 0, p_item, VLC_TICK_FROM_MS( 500 ),
+        thumbnailer_timeout_callback, &ctx );
+    assert( p_req != NULL );
+
+    while ( ctx.count < ARRAY_SIZE(timeout_times) )
+    {
+        vlc_tick_t timeout = vlc_tick_now() + VLC_TICK_FROM_SEC( 5 );
+        int res = vlc_cond_timedwait( &ctx.cond, &ctx.lock, timeout );
+        assert( res != ETIMEDOUT );
+    }
+    vlc_mutex_unlock( &ctx.lock );
+
+    input_item_Release( p_item );
+    free( psz_mrl );
+
+    vlc_thumbnailer_Release( p_thumbnailer );
+}
+
 int main()
 {
     test_init();
@@ -220,6 +410,8 @@ int main()
 
     test_thumbnails( vlc );
     test_cancel_thumbnail( vlc );
+    test_batch_thumbnails( vlc );
+    test_batch_timeout( vlc );
 
     libvlc_release( vlc );
 }
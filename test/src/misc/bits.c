@@ -335,6 +335,154 @@ static int test_annexb( const char *psz_tag )
     for(size_t i=0; i<ARRAY_SIZE(seinalunesc); i++)
         test_assert(bs_read(&bs, 8), seinalunesc[i]);
 
+    /* same with the fast reader */
+    bs_fast_t fbs;
+    bs_fast_init_ep3b( &fbs, &annexb, ARRAY_SIZE(annexb) );
+    for( size_t i=0; i<ARRAY_SIZE(unesc)*8; i++ )
+    {
+        test_assert(bs_fast_aligned( &fbs ), !!(i%8 == 0));
+        test_assert(bs_fast_pos( &fbs ), i);
+        test_assert(bs_fast_read1( &fbs ), (unesc[i/8] >> (7 - i%8)) & 1);
+    }
+    test_assert(bs_fast_eof( &fbs ), 1);
+    test_assert(bs_fast_error( &fbs ), false);
+
+    bs_fast_init_ep3b( &fbs, vpsnal, ARRAY_SIZE(vpsnal) );
+    for(size_t i=0; i<ARRAY_SIZE(vpsnalunesc); i++)
+        test_assert(bs_fast_read(&fbs, 8), vpsnalunesc[i]);
+    test_assert(bs_fast_eof( &fbs ), 1);
+
+    bs_fast_init_ep3b( &fbs, seinal, ARRAY_SIZE(seinal) );
+    for(size_t i=0; i<ARRAY_SIZE(seinalunesc); i++)
+        test_assert(bs_fast_read(&fbs, 8), seinalunesc[i]);
+    test_assert(bs_fast_eof( &fbs ), 1);
+
+    return 0;
+}
+
+static int test_fast( const char *psz_tag )
+{
+    const uint8_t data[] = { 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF };
+    const uint8_t expgolomb[] = { 0x15, 0x23 };
+    bs_fast_t bs;
+
+    bs_fast_init( &bs, NULL, 0 );
+    test_assert( bs_fast_pos(&bs), 0 );
+    test_assert( bs_fast_eof(&bs), true );
+    test_assert( bs_fast_error(&bs), false );
+    bs_fast_skip( &bs, 3 );
+    test_assert( bs_fast_error(&bs), true );
+
+    bs_fast_init( &bs, data, ARRAY_SIZE(data) );
+    test_assert( bs_fast_read(&bs, 4), 0x0A );
+    test_assert( bs_fast_read(&bs, 12), 0xABB );
+    test_assert( bs_fast_pos(&bs), 16 );
+    bs_fast_skip( &bs, 4 );
+    test_assert( bs_fast_read(&bs, 8), 0xCD );
+    test_assert( bs_fast_aligned(&bs), false );
+    bs_fast_align( &bs );
+    test_assert( bs_fast_pos(&bs), 32 );
+    test_assert( bs_fast_read(&bs, 16), 0xEEFF );
+    test_assert( bs_fast_error(&bs), false );
+    test_assert( bs_fast_eof(&bs), true );
+
+    bs_fast_init( &bs, data, ARRAY_SIZE(data) );
+    test_assert( bs_fast_read(&bs, 32), 0xAABBCCDD );
+    test_assert( bs_fast_read(&bs, 0), 0 );
+    test_assert( bs_fast_pos(&bs), 32 );
+
+    bs_fast_init( &bs, expgolomb, ARRAY_SIZE(expgolomb) );
+    test_assert( bs_fast_read_ue(&bs), 0x09 );
+    test_assert( bs_fast_error(&bs), false );
+    test_assert( bs_fast_read1(&bs), 1 );
+    test_assert( bs_fast_read_se(&bs), 2 );
+    test_assert( bs_fast_error(&bs), false );
+    test_assert( bs_fast_read_se(&bs), -1 );
+    test_assert( bs_fast_eof(&bs), true );
+    test_assert( bs_fast_error(&bs), false );
+    bs_fast_read_ue( &bs );
+    test_assert( bs_fast_error(&bs), true );
+
+    /* overflows */
+    bs_fast_init( &bs, data, 2 );
+    bs_fast_skip( &bs, 8 );
+    test_assert( bs_fast_read(&bs, 8 + 2), 0xBB << 2 ); /* truncated read */
+    test_assert( bs_fast_error(&bs), true );
+    test_assert( bs_fast_eof(&bs), true );
+    test_assert( bs_fast_pos(&bs), 16 );
+
+    bs_fast_init( &bs, data, 2 );
+    bs_fast_skip( &bs, 2 );
+    test_assert( bs_fast_error(&bs), false );
+    bs_fast_skip( &bs, 40 );
+    test_assert( bs_fast_error(&bs), true );
+    test_assert( bs_fast_pos(&bs), 16 );
+
+    /* compare with bs_t, over escaped data with many zero bytes */
+    uint8_t buf[512];
+    uint32_t seed = 0x12345678;
+    for( size_t i=0; i<ARRAY_SIZE(buf); i++ )
+    {
+        seed = seed * 1103515245 + 12345;
+        const uint8_t values[] = { 0x00, 0x00, 0x00, 0x03, 0x01, 0x80 };
+        buf[i] = (seed >> 16) % 4 ? values[(seed >> 8) % ARRAY_SIZE(values)]
+                                  : seed >> 24;
+    }
+
+    for( unsigned run=0; run<64; run++ )
+    {
+        /* like NAL units, bs_t does not unescape from the first byte */
+        if( buf[run] == 0x00 )
+            continue;
+
+        bs_t ref;
+        struct hxxx_bsfw_ep3b_ctx_s bsctx;
+        hxxx_bsfw_ep3b_ctx_init( &bsctx );
+        bs_init_custom( &ref, &buf[run], ARRAY_SIZE(buf) - run,
+                        &hxxx_bsfw_ep3b_callbacks, &bsctx );
+        bs_fast_init_ep3b( &bs, &buf[run], ARRAY_SIZE(buf) - run );
+
+        while( !bs_error( &ref ) && !bs_eof( &ref ) )
+        {
+            seed = seed * 1103515245 + 12345;
+            unsigned count = (seed >> 8) % 33;
+            switch( (seed >> 16) % 5 )
+            {
+                case 0:
+                    test_assert( bs_fast_read1(&bs), bs_read1(&ref) );
+                    break;
+                case 1:
+                    test_assert( bs_fast_read(&bs, count), bs_read(&ref, count) );
+                    break;
+                case 2:
+                {
+                    /* bs_t does not fail on codes longer than 32 bits */
+                    uint_fast32_t val = bs_fast_read_ue( &bs );
+                    uint_fast32_t refval = bs_read_ue( &ref );
+                    if( !bs_fast_error( &bs ) )
+                        test_assert( val, refval );
+                    break;
+                }
+                case 3:
+                {
+                    int_fast32_t val = bs_fast_read_se( &bs );
+                    int_fast32_t refval = bs_read_se( &ref );
+                    if( !bs_fast_error( &bs ) )
+                        test_assert( val, refval );
+                    break;
+                }
+                case 4:
+                    bs_skip( &ref, count );
+                    bs_fast_skip( &bs, count );
+                    break;
+            }
+            if( bs_error( &ref ) || bs_fast_error( &bs ) )
+                break;
+            test_assert( bs_fast_pos(&bs), bs_pos(&ref) );
+            test_assert( bs_fast_aligned(&bs), bs_aligned(&ref) );
+        }
+    }
+
     return 0;
 }
 
@@ -376,5 +524,8 @@ int main( void )
     if( test_annexb( "annexb ") )
         return 1;
 
+    if( test_fast( "fast" ) )
+        return 1;
+
     return 0;
 }
@@ -0,0 +1,142 @@
+/*****************************************************************************
+ * bits_bench.c: bitstream readers benchmark
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/* Compares bs_t (with the emulation prevention forwarding callbacks, as used
+ * by the H.264/HEVC packetizers) and bs_fast_t, by reading parameter sets and
+ * slice headers the way the packetizers do: NAL header, then a mix of flags,
+ * fixed size fields and Exp-Golomb codes.
+ *
+ * Not run by "make check": build it with "make test_src_misc_bits_bench",
+ * and optionally pass the number of iterations. */
+
+#include "../../libvlc/test.h"
+#include <vlc_bits.h>
+#include <vlc_tick.h>
+#include "../../../modules/packetizer/hxxx_ep3b.h"
+
+#include <stdlib.h>
+
+/* from the packetizer test samples */
+static const uint8_t h264_sps[] = {
+    0x67, 0xf4, 0x00, 0x0a, 0x91, 0x9b, 0x2b, 0xd0, 0x80, 0x00, 0x00, 0x03,
+    0x00, 0x80, 0x00, 0x00, 0x19, 0x07, 0x89, 0x12, 0xcb };
+static const uint8_t h264_pps[] = { 0x68, 0xeb, 0xec, 0x44, 0x84, 0x40 };
+static const uint8_t h264_slice[] = {
+    0x41, 0x9a, 0x68, 0x49, 0xa8, 0x41, 0x68, 0x99, 0x4c, 0x08, 0x4f, 0xff,
+    0xfe, 0xc1 };
+static const uint8_t hevc_sps[] = {
+    0x42, 0x01, 0x01, 0x04, 0x08, 0x00, 0x00, 0x03, 0x00, 0x9e, 0x08, 0x00,
+    0x00, 0x03, 0x00, 0x00, 0x1e, 0x90, 0x11, 0x08, 0xb2, 0xca, 0xcd, 0x57,
+    0x95, 0xcd, 0x40, 0x80, 0x80, 0x01, 0x00, 0x00, 0x03, 0x00, 0x01, 0x00,
+    0x00, 0x03, 0x00, 0x19, 0x08 };
+static const uint8_t hevc_slice[] = {
+    0x02, 0x01, 0xd0, 0x29, 0x4b, 0xe1, 0x0c, 0x20, 0xa4, 0xfa, 0x44 };
+
+struct sample
+{
+    const char *name;
+    const uint8_t *data;
+    size_t size;
+};
+
+static const struct sample samples[] = {
+    { "h264 sps",   h264_sps,   sizeof (h264_sps) },
+    { "h264 pps",   h264_pps,   sizeof (h264_pps) },
+    { "h264 slice", h264_slice, sizeof (h264_slice) },
+    { "hevc sps",   hevc_sps,   sizeof (hevc_sps) },
+    { "hevc slice", hevc_slice, sizeof (hevc_slice) },
+};
+
+/* Reads the whole payload, returns a checksum of the values read (values
+ * read past the end differ between the readers) */
+#define PARSE(prefix, s) \
+    uint32_t sum = prefix##read( s, 8 ); /* NAL header */ \
+    for( unsigned i = 0; !prefix##eof( s ); i++ ) \
+    { \
+        uint32_t val; \
+        switch( i % 4 ) \
+        { \
+            case 0: val = prefix##read1( s ); break; \
+            case 1: val = prefix##read_ue( s ); break; \
+            case 2: val = prefix##read( s, 1 + i % 7 ); break; \
+            default: val = prefix##read_se( s ); break; \
+        } \
+        if( prefix##error( s ) ) \
+            break; \
+        sum += val; \
+    } \
+    return sum;
+
+static uint32_t parse_bs( const struct sample *sample )
+{
+    bs_t s;
+    struct hxxx_bsfw_ep3b_ctx_s bsctx;
+    hxxx_bsfw_ep3b_ctx_init( &bsctx );
+    bs_init_custom( &s, sample->data, sample->size,
+                    &hxxx_bsfw_ep3b_callbacks, &bsctx );
+    PARSE(bs_, &s)
+}
+
+static uint32_t parse_bs_fast( const struct sample *sample )
+{
+    bs_fast_t s;
+    bs_fast_init_ep3b( &s, sample->data, sample->size );
+    PARSE(bs_fast_, &s)
+}
+
+static vlc_tick_t bench( uint32_t (*parse)(const struct sample *),
+                         const struct sample *sample, unsigned count,
+                         volatile uint32_t *sum )
+{
+    vlc_tick_t start = vlc_tick_now();
+    for( unsigned i = 0; i < count; i++ )
+        *sum += parse( sample );
+    return vlc_tick_now() - start;
+}
+
+int main( int argc, char *argv[] )
+{
+    unsigned count = argc > 1 ? strtoul( argv[1], NULL, 10 ) : 1000000;
+    volatile uint32_t sum = 0;
+
+    test_init();
+
+    if( count == 0 )
+        return 1;
+
+    for( size_t i = 0; i < ARRAY_SIZE(samples); i++ )
+    {
+        if( parse_bs( &samples[i] ) != parse_bs_fast( &samples[i] ) )
+        {
+            printf( "%s: readers mismatch\n", samples[i].name );
+            return 1;
+        }
+
+        vlc_tick_t bs = bench( parse_bs, &samples[i], count, &sum );
+        vlc_tick_t fast = bench( parse_bs_fast, &samples[i], count, &sum );
+
+        printf( "%-10s: bs_t %5"PRId64" ns, bs_fast_t %5"PRId64" ns (x%.2f)\n",
+                samples[i].name, NS_FROM_VLC_TICK( bs ) / count,
+                NS_FROM_VLC_TICK( fast ) / count,
+                fast ? (double) bs / fast : 0. );
+    }
+
+    return 0;
+}
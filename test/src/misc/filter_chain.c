@@ -0,0 +1,217 @@
+/*****************************************************************************
+ * filter_chain.c: video filter chain pictures recycling test
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/* Runs pictures through a chain of filters provided by this test, and checks
+ * that the intermediate pictures are recycled, that the pools grow when a
+ * filter keeps pictures, and that pictures outlive the chain. */
+
+#define MODULE_NAME test_filter_chain
+#define MODULE_STRING "test_filter_chain"
+#undef __PLUGIN__
+
+#include "../../libvlc/test.h"
+#include "../../../lib/libvlc_internal.h"
+
+#include <vlc_common.h>
+#include <vlc_plugin.h>
+#include <vlc_filter.h>
+#include <vlc_picture.h>
+
+#define WIDTH  64
+#define HEIGHT 48
+#define FRAMES 100
+#define HOLD   6 /* pictures kept by the "hold" filter, like a deinterlacer */
+#define MAX_BUFFERS 64
+
+/* Pixel buffers of the pictures output by the filters */
+static const void *buffers[MAX_BUFFERS];
+static size_t buffer_count;
+
+static void SeenBuffer( const void *p )
+{
+    for( size_t i = 0; i < buffer_count; i++ )
+        if( buffers[i] == p )
+            return;
+    assert( buffer_count < MAX_BUFFERS );
+    buffers[buffer_count++] = p;
+}
+
+/* Copies the first pixel to a new picture */
+static picture_t *Copy( filter_t *filter, picture_t *pic )
+{
+    picture_t *out = filter_NewPicture( filter );
+    if( out != NULL )
+    {
+        SeenBuffer( out->p[0].p_pixels );
+        picture_CopyProperties( out, pic );
+        out->p[0].p_pixels[0] = pic->p[0].p_pixels[0];
+    }
+    picture_Release( pic );
+    return out;
+}
+
+/* Same as Copy, but keeps the last HOLD input pictures */
+typedef struct
+{
+    picture_t *held[HOLD];
+    unsigned next;
+} hold_sys_t;
+
+static picture_t *Hold( filter_t *filter, picture_t *pic )
+{
+    hold_sys_t *sys = filter->p_sys;
+
+    if( sys->held[sys->next] != NULL )
+        picture_Release( sys->held[sys->next] );
+    sys->held[sys->next] = picture_Hold( pic );
+    sys->next = (sys->next + 1) % HOLD;
+    return Copy( filter, pic );
+}
+
+static void Flush( filter_t *filter )
+{
+    hold_sys_t *sys = filter->p_sys;
+
+    for( unsigned i = 0; i < HOLD; i++ )
+        if( sys->held[i] != NULL )
+        {
+            picture_Release( sys->held[i] );
+            sys->held[i] = NULL;
+        }
+}
+
+static void Close( filter_t *filter )
+{
+    Flush( filter );
+    free( filter->p_sys );
+}
+
+static const struct vlc_filter_operations copy_ops = {
+    .filter_video = Copy,
+};
+
+static const struct vlc_filter_operations hold_ops = {
+    .filter_video = Hold, .flush = Flush, .close = Close,
+};
+
+static int OpenCopy( vlc_object_t *obj )
+{
+    filter_t *filter = (filter_t *)obj;
+
+    filter->ops = &copy_ops;
+    return VLC_SUCCESS;
+}
+
+static int OpenHold( vlc_object_t *obj )
+{
+    filter_t *filter = (filter_t *)obj;
+
+    filter->p_sys = calloc( 1, sizeof (hold_sys_t) );
+    if( filter->p_sys == NULL )
+        return VLC_ENOMEM;
+    filter->ops = &hold_ops;
+    return VLC_SUCCESS;
+}
+
+const char vlc_module_name[] = MODULE_STRING;
+
+vlc_module_begin()
+    set_capability( "video filter", 0 )
+    add_shortcut( "test_copy" )
+    set_callback( OpenCopy )
+    add_submodule()
+    set_capability( "video filter", 0 )
+    add_shortcut( "test_hold" )
+    set_callback( OpenHold )
+vlc_module_end()
+
+typedef int (*vlc_plugin_cb)(vlc_set_cb, void *);
+
+VLC_EXPORT vlc_plugin_cb vlc_static_modules[] = {
+    VLC_SYMBOL(vlc_entry),
+    NULL
+};
+
+static picture_t *NewInput( const es_format_t *fmt, unsigned i )
+{
+    picture_t *pic = picture_NewFromFormat( &fmt->video );
+    assert( pic != NULL );
+    pic->p[0].p_pixels[0] = i;
+    pic->date = VLC_TICK_0 + i;
+    return pic;
+}
+
+static void test_chain( vlc_object_t *obj, const es_format_t *fmt,
+                        const char *last, size_t max_buffers )
+{
+    filter_chain_t *chain = filter_chain_NewVideo( obj, false, NULL );
+    assert( chain != NULL );
+    filter_chain_Reset( chain, fmt, NULL, fmt );
+    assert( filter_chain_AppendFilter( chain, "test_copy", NULL, fmt ) );
+    assert( filter_chain_AppendFilter( chain, "test_copy", NULL, fmt ) );
+    assert( filter_chain_AppendFilter( chain, last, NULL, fmt ) );
+
+    buffer_count = 0;
+    for( unsigned i = 0; i < FRAMES; i++ )
+    {
+        picture_t *out = filter_chain_VideoFilter( chain, NewInput( fmt, i ) );
+
+        /* The pools grow rather than starving the filters */
+        assert( out != NULL );
+        assert( out->p[0].p_pixels[0] == (uint8_t)i );
+        assert( out->date == VLC_TICK_0 + i );
+        picture_Release( out );
+    }
+    /* Recycled: only as many buffers as pictures in flight */
+    assert( buffer_count <= max_buffers );
+
+    /* Output pictures remain valid after the chain, and its pools, are gone */
+    picture_t *out = filter_chain_VideoFilter( chain, NewInput( fmt, 42 ) );
+    assert( out != NULL );
+    filter_chain_Delete( chain );
+    assert( out->p[0].p_pixels[0] == 42 );
+    memset( out->p[0].p_pixels, 0, out->p[0].i_pitch * out->p[0].i_lines );
+    picture_Release( out );
+}
+
+int main( void )
+{
+    test_init();
+
+    libvlc_instance_t *vlc = libvlc_new( test_defaults_nargs,
+                                         test_defaults_args );
+    assert( vlc != NULL );
+
+    es_format_t fmt;
+    es_format_Init( &fmt, VIDEO_ES, VLC_CODEC_I420 );
+    video_format_Setup( &fmt.video, VLC_CODEC_I420, WIDTH, HEIGHT,
+                        WIDTH, HEIGHT, 1, 1 );
+
+    /* Each picture is released before the next one is filtered: one buffer
+     * per filter */
+    test_chain( VLC_OBJECT(vlc->p_libvlc_int), &fmt, "test_copy", 3 );
+    /* The last filter keeps pictures: the pool feeding it grows from 4
+     * (3 + the filters after it) to 8 pictures */
+    test_chain( VLC_OBJECT(vlc->p_libvlc_int), &fmt, "test_hold", 1 + 4 + 8 + 1 );
+
+    es_format_Clean( &fmt );
+    libvlc_release( vlc );
+    return 0;
+}
@@ -0,0 +1,115 @@
+/*****************************************************************************
+ * memusage.c: memory usage accounting test
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "../../libvlc/test.h"
+
+#include <vlc_common.h>
+#include <vlc_block.h>
+#include <vlc_memusage.h>
+
+/* Not used by anything else in this process */
+#define TAG VLC_MEMUSAGE_TIMESHIFT
+
+static void check_usage( size_t current, size_t peak )
+{
+    size_t cur, max;
+
+    vlc_memusage_Get( TAG, &cur, &max );
+    assert( cur == current );
+    assert( max == peak );
+}
+
+static block_t *block_New( size_t size )
+{
+    block_t *block = block_Alloc( size );
+    assert( block != NULL );
+    return block;
+}
+
+static void test_dequeue( void )
+{
+    block_fifo_t *fifo = block_FifoNew();
+    assert( fifo != NULL );
+    vlc_fifo_SetMemUsage( fifo, TAG );
+
+    block_FifoPut( fifo, block_New( 100 ) );
+    block_FifoPut( fifo, block_New( 200 ) );
+    check_usage( 300, 300 );
+
+    /* A chain is accounted as a whole */
+    block_t *chain = block_New( 30 );
+    chain->p_next = block_New( 70 );
+    block_FifoPut( fifo, chain );
+    check_usage( 400, 400 );
+
+    /* Dequeuing lowers the current usage, not the peak */
+    block_Release( block_FifoGet( fifo ) );
+    check_usage( 300, 400 );
+    block_Release( block_FifoGet( fifo ) );
+    check_usage( 100, 400 );
+
+    block_FifoPut( fifo, block_New( 50 ) );
+    check_usage( 150, 400 );
+
+    vlc_fifo_Lock( fifo );
+    block_t *all = vlc_fifo_DequeueAllUnlocked( fifo );
+    vlc_fifo_Unlock( fifo );
+    check_usage( 0, 400 );
+    block_ChainRelease( all );
+
+    block_FifoRelease( fifo );
+    check_usage( 0, 400 );
+}
+
+static void test_release( void )
+{
+    block_fifo_t *fifo = block_FifoNew();
+    assert( fifo != NULL );
+    vlc_fifo_SetMemUsage( fifo, TAG );
+
+    block_FifoPut( fifo, block_New( 300 ) );
+    block_FifoPut( fifo, block_New( 300 ) );
+    check_usage( 600, 600 );
+
+    /* The blocks still queued are accounted when the FIFO is released */
+    block_FifoRelease( fifo );
+    check_usage( 0, 600 );
+}
+
+static void test_untagged( void )
+{
+    block_fifo_t *fifo = block_FifoNew();
+    assert( fifo != NULL );
+
+    block_FifoPut( fifo, block_New( 1000 ) );
+    check_usage( 0, 600 );
+    block_FifoRelease( fifo );
+}
+
+int main( void )
+{
+    test_init();
+
+    check_usage( 0, 0 );
+    test_dequeue();
+    test_release();
+    test_untagged();
+    return 0;
+}
@@ -0,0 +1,188 @@
+/*****************************************************************************
+ * messages.c: asynchronous message log test
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/* Logs from several threads with --log-async to a logger provided by this
+ * test, and checks that the messages are written from another thread, in
+ * emission order, and that every message is either written or accounted
+ * for as dropped. */
+
+#define MODULE_NAME test_messages
+#define MODULE_STRING "test_messages"
+#undef __PLUGIN__
+
+#include "../../libvlc/test.h"
+#include "../../../lib/libvlc_internal.h"
+
+#include <stdio.h>
+
+#include <vlc_common.h>
+#include <vlc_plugin.h>
+#include <vlc_threads.h>
+
+#define THREADS  4
+#define MESSAGES 2000 /* per emitting thread, more than the queues hold */
+#define EARLY    100 /* from the main thread, fewer than the queues hold */
+#define LONG_LEN 1000
+
+/* Only accessed by the writer thread, until the instance is released */
+static unsigned received[THREADS + 1];
+static unsigned last[THREADS + 1];
+static unsigned long dropped;
+static unsigned long_received;
+static unsigned flushes;
+
+static void Log( void *opaque, int type, const vlc_log_t *item,
+                 const char *format, va_list ap )
+{
+    char msg[LONG_LEN + 1];
+    unsigned long count;
+    unsigned thread, seq;
+
+    (void) opaque; (void) type;
+    vsnprintf( msg, sizeof (msg), format, ap );
+
+    if( sscanf( msg, "%lu message(s) dropped", &count ) == 1 )
+    {
+        dropped += count;
+        return;
+    }
+    if( strcmp( item->psz_module, MODULE_STRING ) )
+        return;
+
+    /* Written by the asynchronous log thread */
+    assert( item->tid != vlc_thread_id() );
+
+    if( msg[0] == 'x' )
+    {
+        assert( strspn( msg, "x" ) == LONG_LEN );
+        long_received++;
+        return;
+    }
+
+    int ret = sscanf( msg, "thread %u message %u", &thread, &seq );
+    assert( ret == 2 );
+    assert( thread <= THREADS );
+    /* In emission order */
+    assert( received[thread] == 0 || seq > last[thread] );
+    last[thread] = seq;
+    received[thread]++;
+}
+
+static void Flush( void *opaque )
+{
+    (void) opaque;
+    flushes++;
+}
+
+static const struct vlc_logger_operations ops =
+{
+    Log, NULL, Flush,
+};
+
+static const struct vlc_logger_operations *Open( vlc_object_t *obj,
+                                                 void **sysp )
+{
+    (void) obj;
+    *sysp = NULL;
+    return &ops;
+}
+
+const char vlc_module_name[] = MODULE_STRING;
+
+vlc_module_begin()
+    set_capability( "logger", 1000 )
+    set_callback( Open )
+vlc_module_end()
+
+typedef int (*vlc_plugin_cb)(vlc_set_cb, void *);
+
+VLC_EXPORT vlc_plugin_cb vlc_static_modules[] = {
+    VLC_SYMBOL(vlc_entry),
+    NULL
+};
+
+struct emitter
+{
+    vlc_object_t *obj;
+    unsigned id;
+};
+
+static void *Emit( void *data )
+{
+    struct emitter *e = data;
+
+    for( unsigned i = 0; i < MESSAGES; i++ )
+        msg_Info( e->obj, "thread %u message %u", e->id, i );
+    return NULL;
+}
+
+int main( void )
+{
+    test_init();
+
+    const char *argv[test_defaults_nargs + 1];
+    for( int i = 0; i < test_defaults_nargs; i++ )
+        argv[i] = test_defaults_args[i];
+    argv[test_defaults_nargs] = "--log-async";
+
+    libvlc_instance_t *vlc = libvlc_new( test_defaults_nargs + 1, argv );
+    assert( vlc != NULL );
+    vlc_object_t *obj = VLC_OBJECT(vlc->p_libvlc_int);
+
+    /* Messages longer than a queue slot are kept whole */
+    char long_msg[LONG_LEN + 1];
+    memset( long_msg, 'x', LONG_LEN );
+    long_msg[LONG_LEN] = '\0';
+    msg_Info( obj, "%s", long_msg );
+
+    for( unsigned i = 0; i < EARLY; i++ )
+        msg_Info( obj, "thread 0 message %u", i );
+
+    vlc_thread_t threads[THREADS];
+    struct emitter emitters[THREADS];
+
+    for( unsigned i = 0; i < THREADS; i++ )
+    {
+        emitters[i].obj = obj;
+        emitters[i].id = i + 1;
+        int ret = vlc_clone( &threads[i], Emit, &emitters[i],
+                             VLC_THREAD_PRIORITY_LOW );
+        assert( ret == 0 );
+    }
+    for( unsigned i = 0; i < THREADS; i++ )
+        vlc_join( threads[i], NULL );
+
+    /* Pending messages are written before the instance is gone */
+    libvlc_release( vlc );
+
+    assert( long_received == 1 );
+    assert( received[0] == EARLY );
+
+    unsigned long total = 0;
+    for( unsigned i = 1; i <= THREADS; i++ )
+    {
+        assert( received[i] <= MESSAGES );
+        total += received[i];
+    }
+    /* Dropped messages may include messages from the instance itself */
+    assert( total + dropped >= THREADS * MESSAGES );
+    assert( flushes > 0 );
+    return 0;
+}
@@ -0,0 +1,148 @@
+/*****************************************************************************
+ * cache.c: preparse results cache test
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/* Checks that the cache keeps at most its maximum number of entries,
+ * evicting the least recently used ones, including when it is loaded again
+ * with a smaller maximum. */
+
+#include "../../libvlc/test.h"
+#include "../lib/libvlc_internal.h"
+
+#include <vlc_common.h>
+#include <vlc_input_item.h>
+#include "../src/preparser/cache.c"
+
+#include <unistd.h>
+
+const char vlc_module_name[] = "test_preparse_cache";
+
+#define FILES 4
+
+static char dir[] = "/tmp/vlc-test-preparse-XXXXXX";
+static char *paths[FILES];
+static input_item_t *items[FILES];
+
+static void CreateItems( void )
+{
+    for( unsigned i = 0; i < FILES; i++ )
+    {
+        int ret = asprintf( &paths[i], "%s/file%u", dir, i );
+        assert( ret != -1 );
+        FILE *file = fopen( paths[i], "w" );
+        assert( file != NULL );
+        fclose( file );
+
+        char *uri = vlc_path2uri( paths[i], NULL );
+        assert( uri != NULL );
+        items[i] = input_item_New( uri, NULL );
+        assert( items[i] != NULL );
+        free( uri );
+
+        char title[16];
+        sprintf( title, "title %u", i );
+        input_item_SetTitle( items[i], title );
+        input_item_SetDuration( items[i], VLC_TICK_FROM_SEC(i + 1) );
+    }
+}
+
+/* Whether the cache knows an item, checked on a blank copy of it */
+static bool Cached( preparse_cache_t *cache, unsigned i )
+{
+    char *uri = input_item_GetURI( items[i] );
+    input_item_t *copy = input_item_New( uri, NULL );
+    assert( copy != NULL );
+    free( uri );
+
+    bool cached = preparse_cache_Apply( cache, copy );
+    if( cached )
+    {
+        char *title = input_item_GetTitle( copy );
+        char expected[16];
+        sprintf( expected, "title %u", i );
+        assert( title != NULL && !strcmp( title, expected ) );
+        free( title );
+        assert( input_item_GetDuration( copy ) == VLC_TICK_FROM_SEC(i + 1) );
+    }
+    input_item_Release( copy );
+    return cached;
+}
+
+int main( void )
+{
+    test_init();
+
+    char *tmp = mkdtemp( dir );
+    assert( tmp != NULL );
+    setenv( "XDG_CACHE_HOME", dir, 1 );
+
+    libvlc_instance_t *vlc = libvlc_new( test_defaults_nargs,
+                                         test_defaults_args );
+    assert( vlc != NULL );
+    vlc_object_t *obj = VLC_OBJECT(vlc->p_libvlc_int);
+
+    CreateItems();
+
+    preparse_cache_t *cache = preparse_cache_New( obj, 3 );
+    assert( cache != NULL );
+    for( unsigned i = 0; i < 3; i++ )
+        preparse_cache_Store( cache, items[i] );
+
+    /* Using 0 makes 1 the least recently used entry */
+    assert( Cached( cache, 0 ) );
+    preparse_cache_Store( cache, items[3] );
+    assert( cache->count == 3 );
+    assert( !Cached( cache, 1 ) );
+    assert( Cached( cache, 0 ) );
+    assert( Cached( cache, 2 ) );
+    assert( Cached( cache, 3 ) );
+
+    /* Storing a known item replaces it */
+    preparse_cache_Store( cache, items[0] );
+    assert( cache->count == 3 );
+
+    char *cache_path = strdup( cache->path );
+    assert( cache_path != NULL );
+    preparse_cache_Delete( cache );
+
+    /* Saved from the least to the most recently used: 2, 3, 0. With a smaller
+     * maximum, loading evicts 2. */
+    cache = preparse_cache_New( obj, 2 );
+    assert( cache != NULL );
+    assert( cache->count == 2 );
+    assert( !Cached( cache, 2 ) );
+    assert( Cached( cache, 3 ) );
+    assert( Cached( cache, 0 ) );
+    preparse_cache_Delete( cache );
+
+    for( unsigned i = 0; i < FILES; i++ )
+    {
+        input_item_Release( items[i] );
+        unlink( paths[i] );
+        free( paths[i] );
+    }
+    libvlc_release( vlc );
+
+    unlink( cache_path );
+    *strrchr( cache_path, '/' ) = '\0';
+    rmdir( cache_path );
+    free( cache_path );
+    rmdir( dir );
+    return 0;
+}